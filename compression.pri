@@ -0,0 +1,31 @@
+#****************************************************************************
+#* Copyright (c) 2021, Fougue Ltd. <http://www.fougue.pro>
+#* All rights reserved.
+#* See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+#****************************************************************************
+
+# zlib, required for gzip and zip compressed files
+# On Unix the system library is used unless ZLIB_ROOT is defined
+!isEmpty(ZLIB_ROOT)|unix {
+    message(zlib ON)
+    !isEmpty(ZLIB_ROOT) {
+        INCLUDEPATH += $$ZLIB_ROOT/include
+        LIBS += -L$$ZLIB_ROOT/lib
+    }
+
+    win32:LIBS += -lzlib
+    else:LIBS += -lz
+    DEFINES += HAVE_ZLIB
+} else {
+    message(zlib OFF)
+}
+
+# zstd, required for Zstandard compressed files
+isEmpty(ZSTD_ROOT) {
+    message(zstd OFF)
+} else {
+    message(zstd ON)
+    INCLUDEPATH += $$ZSTD_ROOT/include
+    LIBS += -L$$ZSTD_ROOT/lib -lzstd
+    DEFINES += HAVE_ZSTD
+}
@@ -52,6 +52,8 @@ macx {
 
 *win* {
     LIBS += -lUser32
+    # For GetProcessMemoryInfo()
+    LIBS += -lPsapi
 }
 
 INCLUDEPATH += \
@@ -190,6 +192,9 @@ win* {
     write_file($$OUT_PWD/installer/opencascade_dlls.iss, CASCADE_INNOSETUP_DLLS)
 }
 
+# Compressed input files
+include(compression.pri)
+
 # gmio
 isEmpty(GMIO_ROOT) {
     message(gmio OFF)
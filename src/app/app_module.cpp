@@ -21,6 +21,7 @@
 #include <BRepBndLib.hxx>
 #include <QtCore/QDir>
 #include <QtGui/QGuiApplication>
+#include <algorithm>
 #include <iterator>
 
 namespace Mayo {
@@ -43,7 +44,9 @@ AppModule::AppModule(Application* app)
       sectionId_graphicsClipPlanes(
           app->settings()->addSection(this->groupId_graphics, textId("clipPlanes"))),
       sectionId_graphicsMeshDefaults(
-          app->settings()->addSection(this->groupId_graphics, textId("meshDefaults")))
+          app->settings()->addSection(this->groupId_graphics, textId("meshDefaults"))),
+      groupId_import(app->settings()->addGroup(textId("import"))),
+      groupId_export(app->settings()->addGroup(textId("export")))
 {
     auto settings = app->settings();
 
@@ -113,9 +116,8 @@ AppModule::AppModule(Application* app)
     settings->addSetting(&this->meshDefaultsShowEdges, this->sectionId_graphicsMeshDefaults);
     settings->addSetting(&this->meshDefaultsShowNodes, this->sectionId_graphicsMeshDefaults);
     // Import
-    auto groupId_Import = settings->addGroup(textId("import"));
     for (const IO::Format& format : app->ioSystem()->readerFormats()) {
-        auto sectionId_format = settings->addSection(groupId_Import, format.identifier);
+        auto sectionId_format = settings->addSection(this->groupId_import, format.identifier);
         const IO::FactoryReader* factory = app->ioSystem()->findFactoryReader(format);
         std::unique_ptr<PropertyGroup> ptrGroup = factory->createProperties(format, settings);
         if (ptrGroup) {
@@ -130,9 +132,8 @@ AppModule::AppModule(Application* app)
     }
 
     // Export
-    auto groupId_Export = settings->addGroup(textId("export"));
     for (const IO::Format& format : app->ioSystem()->writerFormats()) {
-        auto sectionId_format = settings->addSection(groupId_Export, format.identifier);
+        auto sectionId_format = settings->addSection(this->groupId_export, format.identifier);
         const IO::FactoryWriter* factory = app->ioSystem()->findFactoryWriter(format);
         std::unique_ptr<PropertyGroup> ptrGroup = factory->createProperties(format, settings);
         if (ptrGroup) {
@@ -287,7 +288,7 @@ const RecentFile* AppModule::findRecentFile(const FilePath& fp) const
     return itFound != listRecentFile.cend() ? &(*itFound) : nullptr;
 }
 
-void AppModule::recordRecentFileThumbnail(GuiDocument* guiDoc)
+void AppModule::recordRecentFileThumbnail(GuiDocument* guiDoc, GuiOffscreenRenderer* renderer)
 {
     if (!guiDoc)
         return;
@@ -300,7 +301,7 @@ void AppModule::recordRecentFileThumbnail(GuiDocument* guiDoc)
         return;
 
     RecentFile newRecentFile = *recentFile;
-    const bool okRecord = newRecentFile.recordThumbnail(guiDoc, this->recentFileThumbnailSize());
+    const bool okRecord = newRecentFile.recordThumbnail(guiDoc, this->recentFileThumbnailSize(), renderer);
     if (!okRecord)
         return;
 
@@ -311,28 +312,6 @@ void AppModule::recordRecentFileThumbnail(GuiDocument* guiDoc)
     this->recentFiles.setValue(newListRecentFile);
 }
 
-void AppModule::recordRecentFileThumbnails(GuiApplication* guiApp)
-{
-    if (!guiApp)
-        return;
-
-    const RecentFiles& listRecentFile = this->recentFiles.value();
-    RecentFiles newListRecentFile = listRecentFile;
-    for (GuiDocument* guiDoc : guiApp->guiDocuments()) {
-        const RecentFile* recentFile = this->findRecentFile(guiDoc->document()->filePath());
-        if (!recentFile || !recentFile->isThumbnailOutOfSync())
-            continue; // Skip
-
-        RecentFile newRecentFile = *recentFile;
-        if (newRecentFile.recordThumbnail(guiDoc, this->recentFileThumbnailSize())) {
-            auto indexRecentFile = std::distance(&listRecentFile.front(), recentFile);
-            newListRecentFile.at(indexRecentFile) = newRecentFile;
-        }
-    }
-
-    this->recentFiles.setValue(newListRecentFile);
-}
-
 static QuantityLength shapeChordalDeflection(const TopoDS_Shape& shape)
 {
     // Excerpted from Prs3d::GetDeflection(...)
@@ -414,19 +393,8 @@ AppModule* AppModule::get(const ApplicationPtr& app)
 
 void AppModule::onPropertyChanged(Property* prop)
 {
-    if (prop == &this->meshDefaultsColor
-            || prop == &this->meshDefaultsEdgeColor
-            || prop == &this->meshDefaultsMaterial
-            || prop == &this->meshDefaultsShowEdges
-            || prop == &this->meshDefaultsShowNodes)
-    {
-        auto values = GraphicsMeshObjectDriver::defaultValues();
-        values.color = this->meshDefaultsColor.value();
-        values.edgeColor = this->meshDefaultsEdgeColor.value();
-        values.material = static_cast<Graphic3d_NameOfMaterial>(this->meshDefaultsMaterial.value());
-        values.showEdges = this->meshDefaultsShowEdges.value();
-        values.showNodes = this->meshDefaultsShowNodes.value();
-        GraphicsMeshObjectDriver::setDefaultValues(values);
+    if (this->isMeshDefaultsProperty(prop)) {
+        this->applyMeshDefaults();
     }
     else if (prop == &this->meshingQuality) {
         const bool isUserDefined = this->meshingQuality.value() == BRepMeshQuality::UserDefined;
@@ -438,4 +406,41 @@ void AppModule::onPropertyChanged(Property* prop)
     PropertyGroup::onPropertyChanged(prop);
 }
 
+void AppModule::onPropertiesChanged(Span<Property* const> spanProp)
+{
+    // Mesh defaults are applied once for the whole batch
+    const bool hasMeshDefaultsChanged = std::any_of(spanProp.begin(), spanProp.end(), [=](const Property* prop) {
+        return this->isMeshDefaultsProperty(prop);
+    });
+    if (hasMeshDefaultsChanged)
+        this->applyMeshDefaults();
+
+    for (Property* prop : spanProp) {
+        if (this->isMeshDefaultsProperty(prop))
+            PropertyGroup::onPropertyChanged(prop);
+        else
+            this->onPropertyChanged(prop);
+    }
+}
+
+bool AppModule::isMeshDefaultsProperty(const Property* prop) const
+{
+    return prop == &this->meshDefaultsColor
+            || prop == &this->meshDefaultsEdgeColor
+            || prop == &this->meshDefaultsMaterial
+            || prop == &this->meshDefaultsShowEdges
+            || prop == &this->meshDefaultsShowNodes;
+}
+
+void AppModule::applyMeshDefaults()
+{
+    auto values = GraphicsMeshObjectDriver::defaultValues();
+    values.color = this->meshDefaultsColor.value();
+    values.edgeColor = this->meshDefaultsEdgeColor.value();
+    values.material = static_cast<Graphic3d_NameOfMaterial>(this->meshDefaultsMaterial.value());
+    values.showEdges = this->meshDefaultsShowEdges.value();
+    values.showNodes = this->meshDefaultsShowNodes.value();
+    GraphicsMeshObjectDriver::setDefaultValues(values);
+}
+
 } // namespace Mayo
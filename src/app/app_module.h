@@ -54,8 +54,7 @@ public:
 
     void prependRecentFile(const FilePath& fp);
     const RecentFile* findRecentFile(const FilePath& fp) const;
-    void recordRecentFileThumbnail(GuiDocument* guiDoc);
-    void recordRecentFileThumbnails(GuiApplication* guiApp);
+    void recordRecentFileThumbnail(GuiDocument* guiDoc, GuiOffscreenRenderer* renderer = nullptr);
     QSize recentFileThumbnailSize() const { return { 190, 150 }; }
 
     OccBRepMeshParameters brepMeshParameters(const TopoDS_Shape& shape) const;
@@ -104,12 +103,19 @@ public:
     PropertyEnumeration meshDefaultsMaterial{ this, textId("material"), OcctEnums::Graphic3d_NameOfMaterial() };
     PropertyBool meshDefaultsShowEdges{ this, textId("showEgesOn") };
     PropertyBool meshDefaultsShowNodes{ this, textId("showNodesOn") };
+    // Import/Export(one section per format, holding reader/writer parameters)
+    const Settings_GroupIndex groupId_import;
+    const Settings_GroupIndex groupId_export;
 
 protected:
     // from PropertyGroup
     void onPropertyChanged(Property* prop) override;
+    void onPropertiesChanged(Span<Property* const> spanProp) override;
 
 private:
+    bool isMeshDefaultsProperty(const Property* prop) const;
+    void applyMeshDefaults();
+
     Application* m_app = nullptr;
     std::vector<std::unique_ptr<PropertyGroup>> m_vecPtrPropertyGroup;
     std::unordered_map<QByteArray, PropertyGroup*> m_mapFormatReaderParameters;
@@ -0,0 +1,151 @@
+/****************************************************************************
+** Copyright (c) 2021, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#include "dialog_clash_detection.h"
+#include "ui_dialog_clash_detection.h"
+
+#include "../base/application.h"
+#include "../base/caf_utils.h"
+#include "../base/document.h"
+#include "../base/string_utils.h"
+#include "../base/task_manager.h"
+#include "../base/unit_system.h"
+#include "../gui/gui_application.h"
+#include "../gui/gui_document.h"
+#include "app_module.h"
+
+#include <QtWidgets/QHeaderView>
+
+namespace Mayo {
+
+DialogClashDetection::DialogClashDetection(GuiDocument* guiDoc, QWidget* parent)
+    : QDialog(parent),
+      m_ui(new Ui_DialogClashDetection),
+      m_guiDoc(guiDoc)
+{
+    m_ui->setupUi(this);
+    m_ui->treeWidget_Clashes->header()->setSectionResizeMode(QHeaderView::ResizeToContents);
+
+    QObject::connect(
+                m_ui->btn_Detect, &QAbstractButton::clicked,
+                this, &DialogClashDetection::startDetection);
+    QObject::connect(
+                m_ui->treeWidget_Clashes, &QTreeWidget::itemSelectionChanged,
+                this, &DialogClashDetection::onCurrentClashChanged);
+    QObject::connect(
+                guiDoc->guiApplication(), &GuiApplication::guiDocumentErased,
+                this, [=](GuiDocument* erasedGuiDoc) {
+        if (erasedGuiDoc == m_guiDoc) {
+            m_guiDoc = nullptr;
+            this->reject();
+        }
+    });
+    // Signal TaskManager::ended is emitted from worker thread, so connection is queued
+    QObject::connect(
+                TaskManager::globalInstance(), &TaskManager::ended,
+                this, &DialogClashDetection::onTaskEnded);
+}
+
+DialogClashDetection::~DialogClashDetection()
+{
+    // Task result(if any) is owned by the task itself, so it can safely end after this dialog
+    if (m_isTaskRunning)
+        TaskManager::globalInstance()->requestAbort(m_taskId);
+
+    if (m_guiDoc)
+        m_guiDoc->setHighlightedNodes({});
+
+    delete m_ui;
+}
+
+void DialogClashDetection::startDetection()
+{
+    if (m_isTaskRunning || !m_guiDoc)
+        return;
+
+    m_guiDoc->setHighlightedNodes({});
+    m_ui->treeWidget_Clashes->clear();
+    m_vecClash.clear();
+    m_ui->btn_Detect->setEnabled(false);
+    m_ui->label_Status->setText(tr("Detecting clashes..."));
+
+    const DocumentPtr doc = m_guiDoc->document();
+    ClashDetection::Options options;
+    options.clearance = m_ui->spin_Clearance->value();
+    options.fnComputeMesh = [](const TopoDS_Shape& shape, TaskProgress* progress) {
+        AppModule::get(Application::instance())->computeBRepMesh(shape, progress);
+    };
+    auto ptrResult = std::make_shared<std::vector<ClashDetection::Clash>>();
+    m_ptrTaskResult = ptrResult;
+    auto taskMgr = TaskManager::globalInstance();
+    m_taskId = taskMgr->newTask([=](TaskProgress* progress) {
+        *ptrResult = ClashDetection::compute(doc, options, progress);
+    });
+    taskMgr->setTitle(m_taskId, tr("Clash detection %1").arg(doc->name()));
+    m_isTaskRunning = true;
+    taskMgr->run(m_taskId);
+}
+
+void DialogClashDetection::onTaskEnded(TaskId taskId)
+{
+    if (!m_isTaskRunning || taskId != m_taskId)
+        return;
+
+    m_isTaskRunning = false;
+    m_ui->btn_Detect->setEnabled(true);
+    m_vecClash = std::move(*m_ptrTaskResult);
+    m_ptrTaskResult.reset();
+    if (!m_guiDoc)
+        return;
+
+    const Tree<TDF_Label>& modelTree = m_guiDoc->document()->modelTree();
+    auto fnNodeName = [&](TreeNodeId nodeId) {
+        return CafUtils::labelAttrStdName(modelTree.nodeData(nodeId));
+    };
+    const StringUtils::TextOptions textOptions = AppModule::get(Application::instance())->defaultTextOptions();
+    auto fnLength = [&](double v) {
+        const UnitSystem::TranslateResult trLength = UnitSystem::translate(textOptions.unitSchema, v * Quantity_Millimeter);
+        return StringUtils::text(trLength.value, textOptions) + QString::fromUtf8(trLength.strUnit);
+    };
+    QList<QTreeWidgetItem*> listItem;
+    int interferenceCount = 0;
+    for (const ClashDetection::Clash& clash : m_vecClash) {
+        const bool isInterference = clash.type == ClashDetection::Type::Interference;
+        auto item = new QTreeWidgetItem;
+        item->setText(0, fnNodeName(clash.instance1));
+        item->setText(1, fnNodeName(clash.instance2));
+        item->setText(2, isInterference ? tr("Interference") : tr("Clearance"));
+        item->setText(3, fnLength(isInterference ? clash.penetrationDepth : clash.distance));
+        listItem.push_back(item);
+        if (isInterference)
+            ++interferenceCount;
+    }
+
+    m_ui->treeWidget_Clashes->addTopLevelItems(listItem);
+    m_ui->label_Status->setText(
+                tr("%1 interference(s), %2 clearance violation(s)")
+                .arg(interferenceCount)
+                .arg(int(m_vecClash.size()) - interferenceCount));
+}
+
+void DialogClashDetection::onCurrentClashChanged()
+{
+    if (!m_guiDoc)
+        return;
+
+    const QModelIndex index = m_ui->treeWidget_Clashes->currentIndex();
+    const int row = index.isValid() ? index.row() : -1;
+    if (row >= 0 && row < int(m_vecClash.size())) {
+        const ClashDetection::Clash& clash = m_vecClash.at(row);
+        const TreeNodeId arrayNodeId[] = { clash.instance1, clash.instance2 };
+        m_guiDoc->setHighlightedNodes(arrayNodeId);
+    }
+    else {
+        m_guiDoc->setHighlightedNodes({});
+    }
+}
+
+} // namespace Mayo
@@ -0,0 +1,41 @@
+/****************************************************************************
+** Copyright (c) 2021, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#pragma once
+
+#include "../base/clash_detection.h"
+#include "../base/task_common.h"
+
+#include <QtWidgets/QDialog>
+#include <memory>
+#include <vector>
+
+namespace Mayo {
+
+class GuiDocument;
+
+// Runs clash detection on the instances of a document, clashing pairs are listed and the
+// instances of the current pair are highlighted in the 3D view
+class DialogClashDetection : public QDialog {
+    Q_OBJECT
+public:
+    DialogClashDetection(GuiDocument* guiDoc, QWidget* parent = nullptr);
+    ~DialogClashDetection();
+
+private:
+    void startDetection();
+    void onTaskEnded(TaskId taskId);
+    void onCurrentClashChanged();
+
+    class Ui_DialogClashDetection* m_ui = nullptr;
+    GuiDocument* m_guiDoc = nullptr;
+    TaskId m_taskId = 0;
+    bool m_isTaskRunning = false;
+    std::shared_ptr<std::vector<ClashDetection::Clash>> m_ptrTaskResult;
+    std::vector<ClashDetection::Clash> m_vecClash;
+};
+
+} // namespace Mayo
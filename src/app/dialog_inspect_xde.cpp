@@ -60,9 +60,14 @@ namespace Mayo {
 namespace Internal {
 
 enum TreeWidgetItemRole {
-    TreeWidgetItem_TdfLabelRole = Qt::UserRole + 1
+    TreeWidgetItem_TdfLabelRole = Qt::UserRole + 1,
+    TreeWidgetItem_MoreChildrenRole, // Index of the next child label to be loaded
+    TreeWidgetItem_NamedShapeRole // Attribute item whose details are computed on expansion
 };
 
+// Maximum count of child labels loaded at once
+static constexpr int LabelChildrenPageSize = 1000;
+
 static void loadLabelAttributes(const TDF_Label& label, QTreeWidgetItem* treeItem)
 {
     for (TDF_AttributeIterator it(label); it.More(); it.Next()) {
@@ -112,11 +117,14 @@ static void loadLabelAttributes(const TDF_Label& label, QTreeWidgetItem* treeIte
                         AppModule::get(Application::instance())->defaultTextOptions());
         }
         else if (attrId == TNaming_NamedShape::GetID()) {
-            const auto& namedShape = static_cast<const TNaming_NamedShape&>(*ptrAttr);
-            text = "TNaming_NamedShape";
-            value = DialogInspectXde::tr("ShapeType=%1, Evolution=%2")
-                    .arg(MetaEnum::name(namedShape.Get().ShapeType()).data())
-                    .arg(MetaEnum::name(namedShape.Evolution()).data());
+            // Description is computed on expansion, see loadNamedShapeProperties()
+            auto attrTreeItem = new QTreeWidgetItem;
+            attrTreeItem->setText(0, "TNaming_NamedShape");
+            attrTreeItem->setData(0, TreeWidgetItem_TdfLabelRole, QVariant::fromValue(label));
+            attrTreeItem->setData(0, TreeWidgetItem_NamedShapeRole, true);
+            attrTreeItem->setChildIndicatorPolicy(QTreeWidgetItem::ShowIndicator);
+            treeItem->addChild(attrTreeItem);
+            continue;
         }
         else {
             std::stringstream sstream;
@@ -585,6 +593,23 @@ static void loadLabelGeomToleranceProperties(const TDF_Label& label, QTreeWidget
     treeItem->addChildren(listItemProp);
 }
 
+static void loadNamedShapeProperties(const TDF_Label& label, QTreeWidgetItem* treeItem)
+{
+    Handle_TNaming_NamedShape namedShape;
+    if (!label.FindAttribute(TNaming_NamedShape::GetID(), namedShape))
+        return;
+
+    const TopoDS_Shape shape = namedShape->Get();
+    QList<QTreeWidgetItem*> listItemProp;
+    listItemProp.push_back(createPropertyTreeItem("Evolution", MetaEnum::name(namedShape->Evolution())));
+    if (!shape.IsNull()) {
+        listItemProp.push_back(createPropertyTreeItem("ShapeType", MetaEnum::name(shape.ShapeType())));
+        listItemProp.push_back(createPropertyTreeItem("SubShapes", shape));
+    }
+
+    treeItem->addChildren(listItemProp);
+}
+
 static void loadLabel(const TDF_Label& label, QTreeWidgetItem* treeItem)
 {
     treeItem->setData(0, TreeWidgetItem_TdfLabelRole, QVariant::fromValue(label));
@@ -593,16 +618,39 @@ static void loadLabel(const TDF_Label& label, QTreeWidgetItem* treeItem)
     const QString stdName = CafUtils::labelAttrStdName(label);
     if (!stdName.isEmpty())
         treeItem->setText(0, treeItem->text(0) + " " + stdName);
+
+    // Child labels are loaded on expansion, see loadChildrenLabels()
+    if (label.HasChild())
+        treeItem->setChildIndicatorPolicy(QTreeWidgetItem::ShowIndicator);
 }
 
-static void deepLoadChildrenLabels(const TDF_Label& label, QTreeWidgetItem* treeItem)
+// Loads a page of child labels starting at 'firstChildIndex'
+// If there are remaining child labels then a "More" item is added to load the next page
+static void loadChildrenLabels(const TDF_Label& label, QTreeWidgetItem* treeItem, int firstChildIndex)
 {
-    for (TDF_ChildIterator it(label, Standard_False); it.More(); it.Next()) {
-        const TDF_Label childLabel = it.Value();
-        auto childTreeItem = new QTreeWidgetItem(treeItem);
-        loadLabel(childLabel, childTreeItem);
-        deepLoadChildrenLabels(childLabel, childTreeItem);
+    QList<QTreeWidgetItem*> listChildItem;
+    int childIndex = 0;
+    TDF_ChildIterator it(label, Standard_False);
+    for (; it.More() && childIndex < firstChildIndex; it.Next())
+        ++childIndex;
+
+    for (; it.More() && childIndex < firstChildIndex + LabelChildrenPageSize; it.Next()) {
+        auto childTreeItem = new QTreeWidgetItem;
+        loadLabel(it.Value(), childTreeItem);
+        listChildItem.push_back(childTreeItem);
+        ++childIndex;
+    }
+
+    if (it.More()) {
+        auto moreTreeItem = new QTreeWidgetItem;
+        moreTreeItem->setText(0, DialogInspectXde::tr("More... (%1 of %2 labels loaded)")
+                              .arg(childIndex)
+                              .arg(label.NbChildren()));
+        moreTreeItem->setData(0, TreeWidgetItem_MoreChildrenRole, childIndex);
+        listChildItem.push_back(moreTreeItem);
     }
+
+    treeItem->addChildren(listChildItem);
 }
 
 } // namespace Internal
@@ -617,6 +665,12 @@ DialogInspectXde::DialogInspectXde(QWidget *parent)
     QObject::connect(
                 m_ui->treeWidget_Document, &QTreeWidget::itemClicked,
                 this, &DialogInspectXde::onLabelTreeWidgetItemClicked);
+    QObject::connect(
+                m_ui->treeWidget_Document, &QTreeWidget::itemExpanded,
+                this, &DialogInspectXde::onLabelTreeWidgetItemExpanded);
+    QObject::connect(
+                m_ui->treeWidget_LabelProps, &QTreeWidget::itemExpanded,
+                this, &DialogInspectXde::onPropertyTreeWidgetItemExpanded);
 }
 
 DialogInspectXde::~DialogInspectXde()
@@ -637,7 +691,6 @@ void DialogInspectXde::load(const Handle_TDocStd_Document& doc)
         const TDF_Label label = doc->Main();
         auto treeItem = new QTreeWidgetItem;
         Internal::loadLabel(label, treeItem);
-        Internal::deepLoadChildrenLabels(label, treeItem);
         m_ui->treeWidget_Document->addTopLevelItem(treeItem);
         treeItem->setExpanded(true);
     }
@@ -645,6 +698,15 @@ void DialogInspectXde::load(const Handle_TDocStd_Document& doc)
 
 void DialogInspectXde::onLabelTreeWidgetItemClicked(QTreeWidgetItem *item, int /*column*/)
 {
+    const QVariant varMoreChildren = item->data(0, Internal::TreeWidgetItem_MoreChildrenRole);
+    if (varMoreChildren.isValid()) {
+        QTreeWidgetItem* parentItem = item->parent();
+        const auto parentLabel = parentItem->data(0, Internal::TreeWidgetItem_TdfLabelRole).value<TDF_Label>();
+        delete item;
+        Internal::loadChildrenLabels(parentLabel, parentItem, varMoreChildren.toInt());
+        return;
+    }
+
     const QVariant varLabel = item->data(0, Internal::TreeWidgetItem_TdfLabelRole);
     if (varLabel.isValid()) {
         m_ui->treeWidget_LabelProps->clear();
@@ -688,9 +750,31 @@ void DialogInspectXde::onLabelTreeWidgetItemClicked(QTreeWidgetItem *item, int /
             Internal::loadLabelGeomToleranceProperties(label, fnCreateLabelTreeItem(tr("GeomTolerance")));
     }
 
-    m_ui->treeWidget_LabelProps->expandAll();
+    // Expand only the top-level items, nested items might be costly to load
+    for (int i = 0; i < m_ui->treeWidget_LabelProps->topLevelItemCount(); ++i)
+        m_ui->treeWidget_LabelProps->topLevelItem(i)->setExpanded(true);
+
     for (int i = 0; i < m_ui->treeWidget_LabelProps->columnCount(); ++i)
         m_ui->treeWidget_LabelProps->resizeColumnToContents(i);
 }
 
+void DialogInspectXde::onLabelTreeWidgetItemExpanded(QTreeWidgetItem* item)
+{
+    const QVariant varLabel = item->data(0, Internal::TreeWidgetItem_TdfLabelRole);
+    if (varLabel.isValid() && item->childCount() == 0)
+        Internal::loadChildrenLabels(varLabel.value<TDF_Label>(), item, 0);
+}
+
+void DialogInspectXde::onPropertyTreeWidgetItemExpanded(QTreeWidgetItem* item)
+{
+    const QVariant varLabel = item->data(0, Internal::TreeWidgetItem_TdfLabelRole);
+    if (!varLabel.isValid() || item->childCount() != 0)
+        return;
+
+    if (item->data(0, Internal::TreeWidgetItem_NamedShapeRole).toBool()) {
+        Internal::loadNamedShapeProperties(varLabel.value<TDF_Label>(), item);
+        m_ui->treeWidget_LabelProps->resizeColumnToContents(1);
+    }
+}
+
 } // namespace Mayo
@@ -22,6 +22,8 @@ public:
 
 private:
     void onLabelTreeWidgetItemClicked(QTreeWidgetItem* item, int column);
+    void onLabelTreeWidgetItemExpanded(QTreeWidgetItem* item);
+    void onPropertyTreeWidgetItemExpanded(QTreeWidgetItem* item);
 
     class Ui_DialogInspectXde* m_ui = nullptr;
     Handle_TDocStd_Document m_doc;
@@ -0,0 +1,125 @@
+/****************************************************************************
+** Copyright (c) 2021, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#include "dialog_performance_stats.h"
+#include "ui_dialog_performance_stats.h"
+
+#include "../base/string_utils.h"
+#include "../gui/gui_render_stats.h"
+#include "widgets_utils.h"
+
+#include <QtWidgets/QFileDialog>
+#include <QtWidgets/QPushButton>
+
+namespace Mayo {
+
+DialogPerformanceStats::DialogPerformanceStats(GuiRenderStats* stats, QWidget* parent)
+    : QDialog(parent),
+      m_ui(new Ui_DialogPerformanceStats),
+      m_stats(stats)
+{
+    m_ui->setupUi(this);
+
+    auto refreshBtn = new QPushButton(tr("Refresh"), this);
+    auto resetBtn = new QPushButton(tr("Reset"), this);
+    auto exportBtn = new QPushButton(tr("Export JSON"), this);
+    m_ui->buttonBox->addButton(refreshBtn, QDialogButtonBox::ActionRole);
+    m_ui->buttonBox->addButton(resetBtn, QDialogButtonBox::ResetRole);
+    m_ui->buttonBox->addButton(exportBtn, QDialogButtonBox::ActionRole);
+    QObject::connect(
+                refreshBtn, &QAbstractButton::clicked,
+                this, &DialogPerformanceStats::refresh);
+    QObject::connect(
+                resetBtn, &QAbstractButton::clicked,
+                this, &DialogPerformanceStats::resetStats);
+    QObject::connect(
+                exportBtn, &QAbstractButton::clicked,
+                this, &DialogPerformanceStats::exportJson);
+
+    this->refresh();
+}
+
+DialogPerformanceStats::~DialogPerformanceStats()
+{
+    delete m_ui;
+}
+
+void DialogPerformanceStats::refresh()
+{
+    QTreeWidget* treeWidget = m_ui->treeWidget_Stats;
+    treeWidget->clear();
+    auto fnAddItem = [](QTreeWidgetItem* parentItem, const QString& text, const QString& value = QString()) {
+        auto item = new QTreeWidgetItem(parentItem);
+        item->setText(0, text);
+        item->setText(1, value);
+        return item;
+    };
+    auto fnAddTopItem = [=](const QString& text) {
+        auto item = new QTreeWidgetItem(treeWidget);
+        item->setText(0, text);
+        return item;
+    };
+    auto fnMs = [](double ms) { return tr("%1ms").arg(ms, 0, 'f', 2); };
+    auto fnAddDuration = [=](QTreeWidgetItem* parentItem, const GuiRenderStats::Duration& duration) {
+        fnAddItem(parentItem, tr("Count"), QString::number(duration.count));
+        fnAddItem(parentItem, tr("Average"), fnMs(duration.averageMs()));
+        fnAddItem(parentItem, tr("Min"), fnMs(duration.minMs));
+        fnAddItem(parentItem, tr("Max"), fnMs(duration.maxMs));
+        fnAddItem(parentItem, tr("Total"), fnMs(duration.totalMs));
+    };
+    auto fnAddCounters = [=](QTreeWidgetItem* parentItem, const GuiRenderStats::FrameCounters& counters) {
+        fnAddItem(parentItem, tr("Layers"), QString::number(counters.layerCount));
+        fnAddItem(parentItem, tr("Structures"), QString::number(counters.structureCount));
+        fnAddItem(parentItem, tr("Elements"), QString::number(counters.elementCount));
+        fnAddItem(parentItem, tr("Triangles"), QString::number(counters.triangleCount));
+        fnAddItem(parentItem, tr("Points"), QString::number(counters.pointCount));
+        fnAddItem(parentItem, tr("GPU memory(geometry)"), StringUtils::bytesText(counters.gpuMemoryGeometry));
+        fnAddItem(parentItem, tr("GPU memory(textures)"), StringUtils::bytesText(counters.gpuMemoryTextures));
+        fnAddItem(parentItem, tr("GPU memory(frame buffers)"), StringUtils::bytesText(counters.gpuMemoryFrameBuffers));
+    };
+
+    fnAddDuration(fnAddTopItem(tr("Frame time")), m_stats->frameTime());
+
+    QTreeWidgetItem* itemHistogram = fnAddTopItem(tr("Frame time histogram"));
+    const auto& bounds = GuiRenderStats::FrameTimeBucketBounds;
+    const Span<const int64_t> histogram = m_stats->frameTimeHistogram();
+    for (unsigned i = 0; i < histogram.size(); ++i) {
+        const QString strBucket =
+                i < bounds.size() ?
+                    tr("<= %1ms").arg(bounds.at(i)) :
+                    tr("> %1ms").arg(bounds.back());
+        fnAddItem(itemHistogram, strBucket, QString::number(histogram[i]));
+    }
+
+    fnAddCounters(fnAddTopItem(tr("Last frame")), m_stats->lastFrameCounters());
+    fnAddCounters(fnAddTopItem(tr("Peak frame")), m_stats->peakFrameCounters());
+
+    QTreeWidgetItem* itemBuildTimes = fnAddTopItem(tr("Presentation build times"));
+    for (const auto& [driverName, duration] : m_stats->presentationBuildTimes())
+        fnAddDuration(fnAddItem(itemBuildTimes, QString::fromStdString(driverName)), duration);
+
+    treeWidget->expandAll();
+    treeWidget->resizeColumnToContents(0);
+}
+
+void DialogPerformanceStats::resetStats()
+{
+    m_stats->reset();
+    this->refresh();
+}
+
+void DialogPerformanceStats::exportJson()
+{
+    const QString filepath = QFileDialog::getSaveFileName(
+                this, tr("Select JSON file"), QString(), tr("JSON files(*.json)"));
+    if (filepath.isEmpty())
+        return;
+
+    if (!m_stats->writeJson(filepath))
+        WidgetsUtils::asyncMsgBoxCritical(this, tr("Error"), tr("Failed to write file '%1'").arg(filepath));
+}
+
+} // namespace Mayo
@@ -0,0 +1,31 @@
+/****************************************************************************
+** Copyright (c) 2021, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#pragma once
+
+#include <QtWidgets/QDialog>
+
+namespace Mayo {
+
+class GuiRenderStats;
+
+// Shows 3D rendering statistics collected application-wide, which can be exported to JSON
+class DialogPerformanceStats : public QDialog {
+    Q_OBJECT
+public:
+    DialogPerformanceStats(GuiRenderStats* stats, QWidget* parent = nullptr);
+    ~DialogPerformanceStats();
+
+private:
+    void refresh();
+    void resetStats();
+    void exportJson();
+
+    class Ui_DialogPerformanceStats* m_ui = nullptr;
+    GuiRenderStats* m_stats = nullptr;
+};
+
+} // namespace Mayo
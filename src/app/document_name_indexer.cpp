@@ -0,0 +1,182 @@
+/****************************************************************************
+** Copyright (c) 2021, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#include "document_name_indexer.h"
+
+#include "../base/caf_utils.h"
+#include "../base/task_manager.h"
+
+#include <QtCore/QTimer>
+#include <utility>
+#include <vector>
+
+namespace Mayo {
+
+struct DocumentNameIndexer::DocumentData {
+    DocumentPtr doc;
+    std::unique_ptr<DocumentNameIndex> index;
+    std::shared_ptr<Job> job;
+    int revision = 0;
+};
+
+struct DocumentNameIndexer::Job {
+    TaskId taskId = 0;
+    int revision = 0;
+    // Snapshot of the model tree names, taken in the main thread as OCAF labels must not be
+    // accessed by the task(labels can be renamed or destroyed meanwhile)
+    std::vector<DocumentNameIndex::Entry> vecEntry;
+    std::unique_ptr<DocumentNameIndex> result;
+};
+
+DocumentNameIndexer::DocumentNameIndexer(QObject* parent)
+    : QObject(parent),
+      m_taskMgr(new TaskManager(this))
+{
+    // Signal TaskManager::ended is emitted from worker thread, so connection is queued
+    QObject::connect(m_taskMgr, &TaskManager::ended, this, &DocumentNameIndexer::onTaskEnded);
+}
+
+DocumentNameIndexer::~DocumentNameIndexer()
+{
+    // Pending tasks(if any) are waited by TaskManager destructor, their result is simply discarded
+    QObject::disconnect(m_taskMgr, nullptr, this, nullptr);
+}
+
+void DocumentNameIndexer::addDocument(const DocumentPtr& doc)
+{
+    if (!doc || this->findDocumentData(doc->identifier()))
+        return;
+
+    auto data = std::make_unique<DocumentData>();
+    data->doc = doc;
+    m_mapDocData.insert({ doc->identifier(), std::move(data) });
+
+    // Note: 'doc' must not be captured as DocumentPtr, this would keep it alive forever
+    const Document::Identifier docIdent = doc->identifier();
+    QObject::connect(doc.get(), &Document::entityAdded, this, [=]{
+        this->invalidate(docIdent);
+    });
+    QObject::connect(doc.get(), &Document::entityAboutToBeDestroyed, this, [=]{
+        // Entity is still in the model tree at this point, so invalidate once it's gone
+        QTimer::singleShot(0, this, [=]{ this->invalidate(docIdent); });
+    });
+    QObject::connect(doc.get(), &Document::labelNameChanged, this, [=](const TDF_Label& label) {
+        this->onLabelNameChanged(docIdent, label);
+    });
+
+    if (doc->entityCount() > 0)
+        this->invalidate(docIdent);
+}
+
+void DocumentNameIndexer::removeDocument(const DocumentPtr& doc)
+{
+    const DocumentData* data = this->findDocumentData(doc);
+    if (!data)
+        return;
+
+    QObject::disconnect(doc.get(), nullptr, this, nullptr);
+    if (data->job)
+        m_taskMgr->requestAbort(data->job->taskId);
+
+    m_mapDocData.erase(doc->identifier());
+}
+
+const DocumentNameIndex* DocumentNameIndexer::index(const DocumentPtr& doc) const
+{
+    const DocumentData* data = this->findDocumentData(doc);
+    return data ? data->index.get() : nullptr;
+}
+
+bool DocumentNameIndexer::isIndexing(const DocumentPtr& doc) const
+{
+    const DocumentData* data = this->findDocumentData(doc);
+    return data ? data->job != nullptr : false;
+}
+
+DocumentNameIndexer::DocumentData* DocumentNameIndexer::findDocumentData(Document::Identifier docIdent)
+{
+    auto itFound = m_mapDocData.find(docIdent);
+    return itFound != m_mapDocData.end() ? itFound->second.get() : nullptr;
+}
+
+const DocumentNameIndexer::DocumentData* DocumentNameIndexer::findDocumentData(const DocumentPtr& doc) const
+{
+    auto itFound = doc ? m_mapDocData.find(doc->identifier()) : m_mapDocData.cend();
+    return itFound != m_mapDocData.cend() ? itFound->second.get() : nullptr;
+}
+
+void DocumentNameIndexer::invalidate(Document::Identifier docIdent)
+{
+    DocumentData* data = this->findDocumentData(docIdent);
+    if (!data)
+        return;
+
+    ++data->revision;
+    if (!data->job)
+        this->startJob(data); // Otherwise job will be restarted on completion
+}
+
+void DocumentNameIndexer::startJob(DocumentData* data)
+{
+    auto job = std::make_shared<Job>();
+    job->revision = data->revision;
+    const Tree<TDF_Label>& modelTree = data->doc->modelTree();
+    traverseTree(modelTree, [&](TreeNodeId nodeId) {
+        job->vecEntry.push_back({ nodeId, CafUtils::labelAttrStdName(modelTree.nodeData(nodeId)) });
+    });
+
+    data->job = job;
+    job->taskId = m_taskMgr->newTask([=](TaskProgress* progress) {
+        if (TaskProgress::isAbortRequested(progress))
+            return;
+
+        auto index = std::make_unique<DocumentNameIndex>();
+        index->build(job->vecEntry);
+        job->vecEntry.clear();
+        job->result = std::move(index);
+    });
+    m_taskMgr->run(job->taskId);
+}
+
+void DocumentNameIndexer::onTaskEnded(TaskId taskId)
+{
+    for (const auto& mapPair : m_mapDocData) {
+        DocumentData* data = mapPair.second.get();
+        if (!data->job || data->job->taskId != taskId)
+            continue;
+
+        const std::shared_ptr<Job> job = std::move(data->job);
+        if (job->revision != data->revision) {
+            // Document changed meanwhile, current index(if any) is kept until the new one is ready
+            this->startJob(data);
+        }
+        else if (job->result) {
+            data->index = std::move(job->result);
+            emit this->indexChanged(data->doc);
+        }
+
+        return;
+    }
+}
+
+void DocumentNameIndexer::onLabelNameChanged(Document::Identifier docIdent, const TDF_Label& label)
+{
+    DocumentData* data = this->findDocumentData(docIdent);
+    if (!data)
+        return;
+
+    if (data->job)
+        ++data->revision; // Running job was started with the previous name
+
+    if (data->index) {
+        const QString name = CafUtils::labelAttrStdName(label);
+        for (TreeNodeId nodeId : data->doc->treeNodes(label))
+            data->index->setName(nodeId, name);
+        emit this->indexChanged(data->doc);
+    }
+}
+
+} // namespace Mayo
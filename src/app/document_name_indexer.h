@@ -0,0 +1,55 @@
+/****************************************************************************
+** Copyright (c) 2021, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#pragma once
+
+#include "../base/document.h"
+#include "../base/document_name_index.h"
+#include "../base/task_common.h"
+
+#include <QtCore/QObject>
+#include <memory>
+#include <unordered_map>
+
+namespace Mayo {
+
+class TaskManager;
+
+// Maintains a DocumentNameIndex for each registered document
+// Index is (re)built in a background task when entities are added or destroyed, and is updated
+// in-place when a label is renamed
+class DocumentNameIndexer : public QObject {
+    Q_OBJECT
+public:
+    DocumentNameIndexer(QObject* parent = nullptr);
+    ~DocumentNameIndexer();
+
+    void addDocument(const DocumentPtr& doc);
+    void removeDocument(const DocumentPtr& doc);
+
+    // Returns null if index of 'doc' isn't built yet
+    const DocumentNameIndex* index(const DocumentPtr& doc) const;
+    bool isIndexing(const DocumentPtr& doc) const;
+
+signals:
+    void indexChanged(const Mayo::DocumentPtr& doc);
+
+private:
+    struct DocumentData;
+    struct Job;
+
+    DocumentData* findDocumentData(Document::Identifier docIdent);
+    const DocumentData* findDocumentData(const DocumentPtr& doc) const;
+    void invalidate(Document::Identifier docIdent);
+    void startJob(DocumentData* data);
+    void onTaskEnded(TaskId taskId);
+    void onLabelNameChanged(Document::Identifier docIdent, const TDF_Label& label);
+
+    TaskManager* m_taskMgr = nullptr;
+    std::unordered_map<Document::Identifier, std::unique_ptr<DocumentData>> m_mapDocData;
+};
+
+} // namespace Mayo
@@ -6,15 +6,23 @@
 
 #include "document_tree_node_properties_providers.h"
 
+#include "../base/application.h"
 #include "../base/caf_utils.h"
 #include "../base/document.h"
 #include "../base/document_tree_node.h"
+#include "../base/mass_properties.h"
 #include "../base/mesh_utils.h"
 #include "../base/meta_enum.h"
 #include "../base/string_utils.h"
+#include "../base/task_manager.h"
+#include "../base/unit_system.h"
 #include "../base/xcaf.h"
+#include "app_module.h"
 
 #include <TDataXtd_Triangulation.hxx>
+#include <array>
+#include <cmath>
+#include <vector>
 
 namespace Mayo {
 
@@ -22,7 +30,9 @@ class XCaf_DocumentTreeNodePropertiesProvider::Properties : public PropertyGroup
     MAYO_DECLARE_TEXT_ID_FUNCTIONS(Mayo::XCaf_DocumentTreeNodeProperties)
 public:
     Properties(const DocumentTreeNode& treeNode)
-        : m_label(treeNode.label())
+        : m_doc(treeNode.document()),
+          m_label(treeNode.label()),
+          m_treeNodeId(treeNode.id())
     {
         const TDF_Label& label = m_label;
         const XCaf& xcaf = treeNode.document()->xcaf();
@@ -87,6 +97,25 @@ public:
                 this->removeProperty(&m_propertyValidationVolume);
         }
 
+        // Computed mass properties, expressed in the absolute coordinate system
+        // Products of the subtree not memoized yet are computed in a task(only once, whatever their
+        // instance count), properties are then updated when the task ends
+        {
+            // Shapes are resolved here in the GUI thread, the task doesn't access the document
+            std::vector<TDF_Label> vecNodeLabel;
+            const Tree<TDF_Label>& modelTree = m_doc->modelTree();
+            traverseTree(treeNode.id(), modelTree, [&](TreeNodeId nodeId) {
+                vecNodeLabel.push_back(modelTree.nodeData(nodeId));
+            });
+            // Assembly properties are combined from components, only parts need computation
+            MassPropertiesCache::ProductShapes products =
+                    m_doc->massPropertiesCache().findProductsToCompute(vecNodeLabel);
+            if (!products.vecLabel.empty())
+                this->startMassPropertiesTask(std::move(products));
+            else
+                this->updateMassProperties();
+        }
+
         // Referred entity's properties
         if (XCaf::isShapeReference(label)) {
             m_labelReferred = XCaf::shapeReferred(label);
@@ -124,12 +153,75 @@ public:
         m_propertyReferredName.setUserReadOnly(false);
     }
 
+    ~Properties()
+    {
+        // Task only references the document, so it can safely end after these properties
+        if (m_isMassPropertiesTaskRunning)
+            TaskManager::globalInstance()->requestAbort(m_massPropertiesTaskId);
+    }
+
+    void startMassPropertiesTask(MassPropertiesCache::ProductShapes&& products)
+    {
+        for (Property* prop : this->massProperties())
+            prop->setEnabled(false);
+
+        m_propertyComputedInertia.setValue(textIdTr("Computing..."));
+        auto taskMgr = TaskManager::globalInstance();
+        // Signal TaskManager::ended is emitted from worker thread, so connection is queued
+        QObject::connect(taskMgr, &TaskManager::ended, this, [=](TaskId taskId) {
+            if (m_isMassPropertiesTaskRunning && taskId == m_massPropertiesTaskId) {
+                m_isMassPropertiesTaskRunning = false;
+                this->updateMassProperties();
+            }
+        });
+        const DocumentPtr doc = m_doc;
+        m_massPropertiesTaskId = taskMgr->newTask([=, products = std::move(products)](TaskProgress* progress) {
+            doc->massPropertiesCache().computeProducts(products, progress);
+        });
+        taskMgr->setTitle(m_massPropertiesTaskId, textIdTr("Mass properties %1").arg(m_propertyName.value()));
+        m_isMassPropertiesTaskRunning = true;
+        taskMgr->run(m_massPropertiesTaskId);
+    }
+
+    // Products of the subtree are expected to be memoized, so this is quick
+    void updateMassProperties()
+    {
+        const MassProperties massProps =
+                m_doc->massPropertiesCache().treeNodeProperties(m_doc->modelTree(), m_treeNodeId);
+        for (Property* prop : this->massProperties())
+            prop->setEnabled(massProps.isValid);
+
+        if (massProps.isValid) {
+            m_propertyComputedVolume.setQuantity(massProps.volume);
+            m_propertyComputedArea.setQuantity(massProps.area);
+            m_propertyComputedCentroid.setValue(massProps.centroid);
+            // Inertia is computed with unit density, so it's expressed in length^5
+            const std::array<double, 3> moments = massProps.principalMoments();
+            const double refLength = std::pow(std::abs(moments.at(2)), 1 / 5.);
+            const auto schema = AppModule::get(Application::instance())->unitSystemSchema.value();
+            const UnitSystem::TranslateResult trLength = UnitSystem::translate(schema, refLength, Unit::Length);
+            const double factor = std::pow(trLength.factor, 5);
+            m_propertyComputedInertia.setValue(
+                        QString("%1, %2, %3 %4⁵")
+                        .arg(moments.at(0) / factor).arg(moments.at(1) / factor).arg(moments.at(2) / factor)
+                        .arg(QString::fromUtf8(trLength.strUnit)));
+        }
+        else {
+            m_propertyComputedInertia.setValue({});
+        }
+    }
+
+    std::array<Property*, 4> massProperties()
+    {
+        return { &m_propertyComputedVolume, &m_propertyComputedArea, &m_propertyComputedCentroid, &m_propertyComputedInertia };
+    }
+
     void onPropertyChanged(Property* prop) override
     {
         if (prop == &m_propertyName)
-            CafUtils::setLabelAttrStdName(m_label, m_propertyName.value());
+            m_doc->setLabelName(m_label, m_propertyName.value());
         else if (prop == &m_propertyReferredName)
-            CafUtils::setLabelAttrStdName(m_labelReferred, m_propertyReferredName.value());
+            m_doc->setLabelName(m_labelReferred, m_propertyReferredName.value());
 
         PropertyGroupSignals::onPropertyChanged(prop);
     }
@@ -142,6 +234,10 @@ public:
     PropertyOccPnt m_propertyValidationCentroid{ this, textId("Centroid") };
     PropertyArea m_propertyValidationArea{ this, textId("Area") };
     PropertyVolume m_propertyValidationVolume{ this, textId("Volume") };
+    PropertyVolume m_propertyComputedVolume{ this, textId("ComputedVolume") };
+    PropertyArea m_propertyComputedArea{ this, textId("ComputedArea") };
+    PropertyOccPnt m_propertyComputedCentroid{ this, textId("ComputedCentroid") };
+    PropertyQString m_propertyComputedInertia{ this, textId("ComputedInertia") };
 
     PropertyQString m_propertyReferredName{ this, textId("ProductName") };
     PropertyOccColor m_propertyReferredColor{ this, textId("ProductColor") };
@@ -149,8 +245,12 @@ public:
     PropertyArea m_propertyReferredValidationArea{ this, textId("ProductArea") };
     PropertyVolume m_propertyReferredValidationVolume{ this, textId("ProductVolume") };
 
+    DocumentPtr m_doc;
     TDF_Label m_label;
     TDF_Label m_labelReferred;
+    TreeNodeId m_treeNodeId = 0;
+    TaskId m_massPropertiesTaskId = 0;
+    bool m_isMassPropertiesTaskRunning = false;
 };
 
 bool XCaf_DocumentTreeNodePropertiesProvider::supports(const DocumentTreeNode& treeNode) const
@@ -5,15 +5,19 @@
 ****************************************************************************/
 
 #include "../base/application.h"
+#include "../base/bom_report.h"
 #include "../base/document_tree_node_properties_provider.h"
 #include "../base/io_system.h"
+#include "../base/memory_stats.h"
 #include "../base/messenger.h"
 #include "../base/settings.h"
 #include "../base/task_manager.h"
+#include "../base/tracing.h"
 #include "../io_gmio/io_gmio.h"
 #include "../io_occ/io_occ.h"
 #include "../graphics/graphics_object_driver.h"
 #include "../gui/gui_application.h"
+#include "../gui/gui_offscreen_renderer.h"
 #include "app_module.h"
 #include "console.h"
 #include "document_tree_node_properties_providers.h"
@@ -27,17 +31,24 @@
 #include <QtCore/QtDebug>
 #include <QtCore/QCommandLineParser>
 #include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
 #include <QtCore/QSettings>
 #include <QtCore/QTimer>
 #include <QtCore/QTranslator>
+#include <QtGui/QImage>
 #include <QtWidgets/QApplication>
 
 #include <Message.hxx>
 
 #include <cstdlib>
 #include <iostream>
+#include <initializer_list>
 #include <iomanip>
 #include <memory>
+#include <optional>
 #include <unordered_map>
 
 #ifdef Q_OS_WIN
@@ -51,11 +62,57 @@ class Main { Q_DECLARE_TR_FUNCTIONS(Mayo::Main) };
 struct CommandLineArguments {
     QString themeName;
     FilePath filepathSettings;
+    bool binarySettingsStorage = false;
     std::vector<FilePath> listFilepathToExport;
+    FilePath filepathBom;
     std::vector<FilePath> listFilepathToOpen;
+    std::vector<FilePath> listFilepathToRender;
+    QSize renderSize = { 1024, 768 };
+    std::optional<V3d_TypeOfOrientation> renderViewOrientation = V3d_XposYnegZpos;
+    FilePath filepathRenderStats;
+    FilePath filepathTrace;
+    FilePath filepathStats;
     bool cliProgressReport = true;
 };
 
+// Returns the 3D view orientation corresponding to 'name', or nothing if unknown
+static std::optional<V3d_TypeOfOrientation> findViewOrientation(const QString& name)
+{
+    static const std::pair<const char*, V3d_TypeOfOrientation> arrayViewOrientation[] = {
+        { "iso", V3d_XposYnegZpos },
+        { "back", V3d_Ypos },
+        { "front", V3d_Yneg },
+        { "left", V3d_Xneg },
+        { "right", V3d_Xpos },
+        { "top", V3d_Zpos },
+        { "bottom", V3d_Zneg }
+    };
+    for (const auto& pair : arrayViewOrientation) {
+        if (name.compare(QLatin1String(pair.first), Qt::CaseInsensitive) == 0)
+            return pair.second;
+    }
+
+    return {};
+}
+
+// Returns the size parsed from string 'str' of the form WIDTHxHEIGHT(eg "1024x768")
+// Returned size is invalid in case of parse error
+static QSize parseSize(const QString& str)
+{
+    const QStringList listToken = str.toLower().split(QLatin1Char('x'));
+    if (listToken.size() != 2)
+        return {};
+
+    bool okWidth = false;
+    bool okHeight = false;
+    const int width = listToken.at(0).trimmed().toInt(&okWidth);
+    const int height = listToken.at(1).trimmed().toInt(&okHeight);
+    if (!okWidth || !okHeight || width <= 0 || height <= 0)
+        return {};
+
+    return { width, height };
+}
+
 static CommandLineArguments processCommandLine()
 {
     CommandLineArguments args;
@@ -79,13 +136,72 @@ static CommandLineArguments processCommandLine()
                 Main::tr("filepath"));
     cmdParser.addOption(cmdFileSettings);
 
+    const QCommandLineOption cmdSettingsStorage(
+                QStringList{ "settings-storage" },
+                Main::tr("Format of the application settings storage: 'native'(default) or 'binary'. "
+                         "Binary storage is faster to load, it's initialized with the native settings "
+                         "on first use"),
+                Main::tr("format"));
+    cmdParser.addOption(cmdSettingsStorage);
+
     const QCommandLineOption cmdFileToExport(
                 QStringList{ "e", "export" },
                 Main::tr("Export opened files into an output file, can be repeated for different "
-                         "formats(eg. -e file.stp -e file.igs...)"),
+                         "formats(eg. -e file.stp -e file.igs...). Suffix .gz or .zst compresses the "
+                         "output(eg. -e file.stl.gz)"),
                 Main::tr("filepath"));
     cmdParser.addOption(cmdFileToExport);
 
+    const QCommandLineOption cmdFileBom(
+                QStringList{ "bom" },
+                Main::tr("Write the bill of materials(products, instance counts, volume, area, "
+                         "centroid, bounding box, color) of opened files, format is CSV or JSON "
+                         "depending on file suffix(CLI-mode only)"),
+                Main::tr("filepath"));
+    cmdParser.addOption(cmdFileBom);
+
+    const QCommandLineOption cmdFileToRender(
+                QStringList{ "r", "render" },
+                Main::tr("Render opened files into image files without any window, can be repeated "
+                         "for each input file(eg. -r a.png -r b.png a.stp b.stp)"),
+                Main::tr("filepath"));
+    cmdParser.addOption(cmdFileToRender);
+
+    const QCommandLineOption cmdRenderSize(
+                QStringList{ "size" },
+                Main::tr("Size of the rendered images(CLI-mode only), default is 1024x768"),
+                Main::tr("WIDTHxHEIGHT"));
+    cmdParser.addOption(cmdRenderSize);
+
+    const QCommandLineOption cmdRenderView(
+                QStringList{ "view" },
+                Main::tr("Orientation of the 3D view for the rendered images(CLI-mode only)"
+                         "(iso|front|back|left|right|top|bottom), default is iso"),
+                Main::tr("name"));
+    cmdParser.addOption(cmdRenderView);
+
+    const QCommandLineOption cmdRenderStats(
+                QStringList{ "render-stats" },
+                Main::tr("Write rendering statistics(frame times, elements drawn, GPU memory, ...) "
+                         "to a JSON file(CLI-mode only)"),
+                Main::tr("filepath"));
+    cmdParser.addOption(cmdRenderStats);
+
+    const QCommandLineOption cmdFileTrace(
+                QStringList{ "trace" },
+                Main::tr("Record timings of application phases(I/O, meshing, graphics, ...) and "
+                         "write them on exit to a JSON file in Chrome trace format"),
+                Main::tr("filepath"));
+    cmdParser.addOption(cmdFileTrace);
+
+    const QCommandLineOption cmdFileStats(
+                QStringList{ "stats" },
+                Main::tr("Write statistics of opened files(estimated memory held by B-Rep shapes, "
+                         "triangulations, attributes, ...), peak memory of the process and time "
+                         "spent per phase to a JSON file(CLI-mode only)"),
+                Main::tr("filepath"));
+    cmdParser.addOption(cmdFileStats);
+
     const QCommandLineOption cmdCliNoProgress(
                 QStringList{ "no-progress" },
                 Main::tr("Disable progress reporting in console output(CLI-mode only)"));
@@ -106,11 +222,37 @@ static CommandLineArguments processCommandLine()
     if (cmdParser.isSet(cmdFileSettings))
         args.filepathSettings = filepathFrom(cmdParser.value(cmdFileSettings));
 
+    if (cmdParser.isSet(cmdSettingsStorage))
+        args.binarySettingsStorage = cmdParser.value(cmdSettingsStorage).compare("binary", Qt::CaseInsensitive) == 0;
+
     if (cmdParser.isSet(cmdFileToExport)) {
         for (const QString& strFilepath : cmdParser.values(cmdFileToExport))
             args.listFilepathToExport.push_back(filepathFrom(strFilepath));
     }
 
+    if (cmdParser.isSet(cmdFileBom))
+        args.filepathBom = filepathFrom(cmdParser.value(cmdFileBom));
+
+    if (cmdParser.isSet(cmdFileToRender)) {
+        for (const QString& strFilepath : cmdParser.values(cmdFileToRender))
+            args.listFilepathToRender.push_back(filepathFrom(strFilepath));
+    }
+
+    if (cmdParser.isSet(cmdRenderSize))
+        args.renderSize = parseSize(cmdParser.value(cmdRenderSize));
+
+    if (cmdParser.isSet(cmdRenderView))
+        args.renderViewOrientation = findViewOrientation(cmdParser.value(cmdRenderView));
+
+    if (cmdParser.isSet(cmdRenderStats))
+        args.filepathRenderStats = filepathFrom(cmdParser.value(cmdRenderStats));
+
+    if (cmdParser.isSet(cmdFileTrace))
+        args.filepathTrace = filepathFrom(cmdParser.value(cmdFileTrace));
+
+    if (cmdParser.isSet(cmdFileStats))
+        args.filepathStats = filepathFrom(cmdParser.value(cmdFileStats));
+
     for (const QString& posArg : cmdParser.positionalArguments())
         args.listFilepathToOpen.push_back(filepathFrom(posArg));
 
@@ -197,6 +339,53 @@ static void initGui(GuiApplication* guiApp)
     guiApp->graphicsObjectDriverTable()->addDriver(std::make_unique<GraphicsMeshObjectDriver>());
 }
 
+// Collects emitted error messages into a single string object
+struct ErrorMessageCollect : public Messenger {
+    QString message;
+    void emitMessage(MessageType msgType, const QString& text) override {
+        if (msgType == MessageType::Error)
+            message += text + " ";
+    }
+};
+
+// Writes to JSON file 'fpStats' the memory statistics of the current process and of the document
+// where 'args' input files were imported, along with the time spent per phase(traced spans)
+static bool cli_writeStats(
+        const FilePath& fpStats, const CommandLineArguments& args, const DocumentMemoryStats& docMemoryStats)
+{
+    QJsonArray jsonFiles;
+    for (const FilePath& fp : args.listFilepathToOpen)
+        jsonFiles.append(filepathTo<QString>(fp));
+
+    QJsonObject jsonDocument;
+    jsonDocument.insert("files", jsonFiles);
+    jsonDocument.insert("memory", docMemoryStats.toJson());
+
+    QJsonArray jsonPhases;
+    for (const Tracing::SpanStatistics& spanStats : Tracing::spanStatistics()) {
+        QJsonObject jsonPhase;
+        jsonPhase.insert("name", QString::fromStdString(spanStats.name));
+        jsonPhase.insert("category", QString::fromStdString(spanStats.category));
+        jsonPhase.insert("count", double(spanStats.count));
+        jsonPhase.insert("totalMs", spanStats.totalUs / 1000.);
+        jsonPhase.insert("maxMs", spanStats.maxUs / 1000.);
+        jsonPhases.append(jsonPhase);
+    }
+
+    const ProcessMemoryStats processMemoryStats = ProcessMemoryStats::current();
+    QJsonObject jsonStats;
+    jsonStats.insert("residentBytes", double(processMemoryStats.residentBytes));
+    jsonStats.insert("peakResidentBytes", double(processMemoryStats.peakResidentBytes));
+    jsonStats.insert("documents", QJsonArray{ jsonDocument });
+    jsonStats.insert("phases", jsonPhases);
+
+    QFile file(filepathTo<QString>(fpStats));
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+
+    return file.write(QJsonDocument(jsonStats).toJson()) != -1;
+}
+
 // Asynchronously exports input file(s) listed in 'args'
 // Calls 'fnContinuation' at the end of execution
 static void cli_asyncExportDocuments(
@@ -218,15 +407,8 @@ static void cli_asyncExportDocuments(
         std::unordered_map<TaskId, int> mapTaskLineWidth;
         // Count of progress lines in console after last call to fnPrintProgress()
         int lastPrintProgressLineCount = 0;
-    };
-
-    // Collects emitted error messages into a single string object
-    struct ErrorMessageCollect : public Messenger {
-        QString message;
-        void emitMessage(MessageType msgType, const QString& text) override {
-            if (msgType == MessageType::Error)
-                message += text + " ";
-        }
+        // Memory held by the document of imported files, computed if statistics are requested
+        DocumentMemoryStats docMemoryStats;
     };
 
     auto helper = new Helper; // Allocated on heap because current function is asynchronous
@@ -301,7 +483,10 @@ static void cli_asyncExportDocuments(
             fnPrintProgress();
     });
 
-    helper->exportTaskCount = int(args.listFilepathToExport.size());
+    helper->exportTaskCount =
+            int(args.listFilepathToExport.size())
+            + (!args.filepathBom.empty() ? 1 : 0)
+            + (!args.filepathStats.empty() ? 1 : 0);
     QObject::connect(taskMgr, &TaskManager::ended, app, [=]{
         if (helper->exportTaskCount == 0) {
             bool okExport = true;
@@ -310,6 +495,18 @@ static void cli_asyncExportDocuments(
                 okExport = okExport && status->success;
             }
 
+            // Statistics are written once all other tasks are finished, so phase times are complete
+            if (!args.filepathStats.empty()) {
+                const QString strFilepathStats = filepathTo<QString>(args.filepathStats);
+                if (cli_writeStats(args.filepathStats, args, helper->docMemoryStats)) {
+                    qInfo().noquote() << Main::tr("Statistics written to %1").arg(strFilepathStats);
+                }
+                else {
+                    qCritical().noquote() << Main::tr("Failed to write statistics file '%1'").arg(strFilepathStats);
+                    okExport = false;
+                }
+            }
+
             fnExit(okExport ? EXIT_SUCCESS : EXIT_FAILURE);
         }
     });
@@ -365,6 +562,7 @@ static void cli_asyncExportDocuments(
                             .targetFormat(format)
                             .withItems(appItems)
                             .withParameters(appModule->findWriterParameters(format))
+                            .withCompression(IO::compressionFromFilepathSuffix(filepath))
                             .withMessenger(&errorCollect)
                             .withTaskProgress(progress)
                             .execute();
@@ -378,12 +576,127 @@ static void cli_asyncExportDocuments(
         taskMgr->setTitle(taskId, Main::tr("Exporting %1...").arg(strFilename));
     }
 
+    // Run BOM operation(asynchronous)
+    if (!args.filepathBom.empty()) {
+        const QString strFilepathBom = filepathTo<QString>(args.filepathBom);
+        BomReport::WriteOptions bomOptions;
+        bomOptions.schema = appModule->unitSystemSchema.value();
+        bomOptions.decimalCount = appModule->unitSystemDecimals.value();
+        const TaskId taskId = taskMgr->newTask([=](TaskProgress* progress) {
+                const std::vector<BomReport::Row> vecRow = BomReport::compute(doc, progress);
+                QFile file(strFilepathBom);
+                const bool okBom =
+                        file.open(QIODevice::WriteOnly)
+                        && BomReport::write(&file, BomReport::findFormat(args.filepathBom), vecRow, bomOptions);
+                const QString msg =
+                        okBom ?
+                            Main::tr("BOM written to %1").arg(strFilepathBom) :
+                            Main::tr("Failed to write BOM file '%1'").arg(strFilepathBom);
+                taskMgr->setTitle(progress->taskId(), msg);
+                helper->mapTaskStatus.at(progress->taskId())->success = okBom;
+                helper->mapTaskStatus.at(progress->taskId())->finished = true;
+                --(helper->exportTaskCount);
+        });
+        helper->mapTaskStatus.insert({ taskId, std::make_unique<TaskStatus>() });
+        taskMgr->setTitle(taskId, Main::tr("Computing BOM..."));
+    }
+
+    // Run memory statistics operation(asynchronous)
+    if (!args.filepathStats.empty()) {
+        const TaskId taskId = taskMgr->newTask([=](TaskProgress* progress) {
+                helper->docMemoryStats = DocumentMemoryStats::compute(doc, progress);
+                taskMgr->setTitle(progress->taskId(), Main::tr("Statistics computed"));
+                helper->mapTaskStatus.at(progress->taskId())->success = true;
+                helper->mapTaskStatus.at(progress->taskId())->finished = true;
+                --(helper->exportTaskCount);
+        });
+        helper->mapTaskStatus.insert({ taskId, std::make_unique<TaskStatus>() });
+        taskMgr->setTitle(taskId, Main::tr("Computing statistics..."));
+    }
+
     taskMgr->foreachTask([=](TaskId taskId) {
         if (taskId != importTaskId)
             taskMgr->run(taskId, TaskAutoDestroy::Off);
     });
 }
 
+// Renders input file(s) listed in 'args' into image files, without any visible window
+// Each input file is imported in a distinct document which is closed once rendered. All documents
+// are rendered with the same graphic driver, ie a single OpenGL context
+static int cli_renderDocuments(GuiApplication* guiApp, const CommandLineArguments& args)
+{
+    Application* app = guiApp->application().get();
+    auto appModule = AppModule::get(app);
+
+    // Suppress output from OpenCascade
+    Message::DefaultMessenger()->RemovePrinters(Message_Printer::get_type_descriptor());
+
+    GuiOffscreenRenderer renderer;
+    GuiOffscreenRenderer::Parameters renderParams;
+    renderParams.size = args.renderSize;
+    renderParams.viewOrientation = args.renderViewOrientation.value();
+    renderParams.collectStats = !args.filepathRenderStats.empty();
+    TaskManager taskMgr;
+    bool okRenderAll = true;
+    for (unsigned i = 0; i < args.listFilepathToOpen.size(); ++i) {
+        const FilePath& fpInput = args.listFilepathToOpen.at(i);
+        const QString strFilepathImage = filepathTo<QString>(args.listFilepathToRender.at(i));
+        DocumentPtr doc = app->newDocument();
+        doc->setName(filepathTo<QString>(fpInput.stem()));
+        doc->setFilePath(fpInput);
+
+        // Import operation is synchronous, document entities are then mapped in the graphics scene
+        // as soon as they're added
+        ErrorMessageCollect errorCollect;
+        bool okImport = false;
+        const TaskId taskId = taskMgr.newTask([&](TaskProgress* progress) {
+            okImport = app->ioSystem()->importInDocument()
+                    .targetDocument(doc)
+                    .withFilepath(fpInput)
+                    .withParametersProvider(appModule)
+                    .withEntityPostProcess([=](TDF_Label labelEntity, TaskProgress* progress) {
+                        appModule->computeBRepMesh(labelEntity, progress);
+                    })
+                    .withEntityPostProcessRequiredIf(&IO::formatProvidesBRep)
+                    .withEntityPostProcessInfoProgress(20, Main::tr("Mesh BRep shapes"))
+                    .withMessenger(&errorCollect)
+                    .withTaskProgress(progress)
+                    .execute();
+        });
+        taskMgr.exec(taskId);
+
+        bool okRender = false;
+        if (okImport) {
+            const QImage img = renderer.renderImage(guiApp->findGuiDocument(doc), renderParams);
+            okRender = !img.isNull() && img.save(strFilepathImage);
+            if (!okRender)
+                errorCollect.message = Main::tr("Failed to render image '%1'").arg(strFilepathImage);
+        }
+
+        if (okRender)
+            qInfo().noquote() << Main::tr("Rendered %1").arg(strFilepathImage);
+        else
+            qCritical().noquote() << errorCollect.message;
+
+        okRenderAll = okRenderAll && okRender;
+        renderer.releaseView();
+        app->closeDocument(doc);
+    }
+
+    if (!args.filepathRenderStats.empty()) {
+        const QString strFilepathStats = filepathTo<QString>(args.filepathRenderStats);
+        if (guiApp->renderStats()->writeJson(strFilepathStats)) {
+            qInfo().noquote() << Main::tr("Rendering statistics written to %1").arg(strFilepathStats);
+        }
+        else {
+            qCritical().noquote() << Main::tr("Failed to write rendering statistics to '%1'").arg(strFilepathStats);
+            okRenderAll = false;
+        }
+    }
+
+    return okRenderAll ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
 // Initializes and runs Mayo application
 static int runApp(QCoreApplication* qtApp)
 {
@@ -395,11 +708,29 @@ static int runApp(QCoreApplication* qtApp)
         std::exit(EXIT_FAILURE);
     };
 
+    // Helper function: write recorded trace(if requested) once application event loop is over
+    auto fnExitWriteTrace = [&](int code) {
+        if (args.filepathTrace.empty())
+            return code;
+
+        const QString strFilepathTrace = filepathTo<QString>(args.filepathTrace);
+        if (!Tracing::writeChromeTrace(strFilepathTrace)) {
+            qCritical().noquote() << Main::tr("Failed to write trace file '%1'").arg(strFilepathTrace);
+            return EXIT_FAILURE;
+        }
+
+        qInfo().noquote() << Main::tr("Trace written to %1").arg(strFilepathTrace);
+        return code;
+    };
+
     // Helper function: load application settings from INI file(if provided) otherwise use the
     // application regular storage(eg registry on Windows)
-    auto fnLoadAppSettings = [&](Settings* appSettings) {
+    // Note: loading from application storage is lazy, so only the groups actually needed are read
+    auto fnLoadAppSettings = [&](Settings* appSettings, std::initializer_list<Settings::GroupIndex> groups) {
         if (args.filepathSettings.empty()) {
             appSettings->load();
+            for (Settings::GroupIndex groupId : groups)
+                appSettings->loadGroup(groupId);
         }
         else {
             const QString strFilepathSettings = filepathTo<QString>(args.filepathSettings);
@@ -411,6 +742,11 @@ static int runApp(QCoreApplication* qtApp)
         }
     };
 
+    // Enable tracing first so that initialization is recorded as well. Statistics also require
+    // tracing, to report the time spent per phase
+    if (!args.filepathTrace.empty() || !args.filepathStats.empty())
+        Tracing::setEnabled(true);
+
     // Initialize Base application
     initBase(qtApp);
     auto app = Application::instance().get();
@@ -418,26 +754,65 @@ static int runApp(QCoreApplication* qtApp)
     // Register AppModule
     auto appModule = new AppModule(app);
     app->settings()->setPropertyValueConversion(*appModule);
+    if (args.binarySettingsStorage)
+        app->settings()->setStorageFormat(Settings::StorageFormat::Binary);
 
     // Process CLI
-    if (!args.listFilepathToExport.empty()) {
+    if (!args.listFilepathToExport.empty() || !args.filepathBom.empty() || !args.filepathStats.empty()) {
         if (args.listFilepathToOpen.empty())
             fnCriticalExit(Main::tr("No input files -> nothing to export"));
 
+        if (!args.filepathBom.empty() && BomReport::findFormat(args.filepathBom) == BomReport::Format::None)
+            fnCriticalExit(Main::tr("Unsupported BOM file format(expected .csv or .json)"));
+
         app->settings()->resetAll();
-        fnLoadAppSettings(app->settings());
+        // GUI and graphics settings aren't needed
+        fnLoadAppSettings(app->settings(), {
+                              appModule->groupId_system,
+                              appModule->groupId_meshing,
+                              appModule->groupId_import,
+                              appModule->groupId_export });
         QTimer::singleShot(0, qtApp, [=]{
             cli_asyncExportDocuments(app, args, [=](int retcode) { qtApp->exit(retcode); });
         });
-        return qtApp->exec();
+        return fnExitWriteTrace(qtApp->exec());
+    }
+
+    // Process CLI rendering
+    if (!args.listFilepathToRender.empty()) {
+        if (args.listFilepathToOpen.empty())
+            fnCriticalExit(Main::tr("No input files -> nothing to render"));
+
+        if (args.listFilepathToRender.size() != args.listFilepathToOpen.size())
+            fnCriticalExit(Main::tr("Count of image files must be equal to count of input files"));
+
+        if (!args.renderSize.isValid())
+            fnCriticalExit(Main::tr("Invalid image size"));
+
+        if (!args.renderViewOrientation)
+            fnCriticalExit(Main::tr("Unknown view orientation"));
+
+        // Theme is required by GuiDocument, but no need to call Theme::setup()
+        globalTheme.reset(createTheme(args.themeName));
+        if (!globalTheme)
+            fnCriticalExit(Main::tr("Failed to load theme '%1'").arg(args.themeName));
+
+        auto guiApp = new GuiApplication(app);
+        initGui(guiApp);
+        app->settings()->resetAll();
+        fnLoadAppSettings(app->settings(), {
+                              appModule->groupId_system,
+                              appModule->groupId_meshing,
+                              appModule->groupId_graphics,
+                              appModule->groupId_import });
+        QTimer::singleShot(0, qtApp, [=]{ qtApp->exit(cli_renderDocuments(guiApp, args)); });
+        return fnExitWriteTrace(qtApp->exec());
     }
 
     // Initialize Gui application
     auto guiApp = new GuiApplication(app);
     initGui(guiApp);
-    QObject::connect(
-                guiApp, &GuiApplication::guiDocumentErased,
-                appModule, &AppModule::recordRecentFileThumbnail);
+    auto thumbnailRecorder = new RecentFilesThumbnailRecorder(guiApp, appModule);
 
     // Register WidgetModelTreeBuilter prototypes
     WidgetModelTree::addPrototypeBuilder(std::make_unique<WidgetModelTreeBuilder_Mesh>());
@@ -455,19 +830,30 @@ static int runApp(QCoreApplication* qtApp)
     MainWindow mainWindow(guiApp);
     mainWindow.setWindowTitle(QCoreApplication::applicationName());
     mainWindow.show();
+    app->settings()->resetAll();
+    fnLoadAppSettings(app->settings(), {
+                          appModule->groupId_system,
+                          appModule->groupId_application,
+                          appModule->groupId_meshing,
+                          appModule->groupId_graphics });
+    // Import/export parameters(one section per format) are loaded once the main window is on
+    // screen, before any document is opened. DialogOptions loads the sections it displays anyway
+    QTimer::singleShot(0, [=]{
+        app->settings()->loadGroup(appModule->groupId_import);
+        app->settings()->loadGroup(appModule->groupId_export);
+    });
     if (!args.listFilepathToOpen.empty()) {
         QTimer::singleShot(0, [&]{ mainWindow.openDocumentsFromList(args.listFilepathToOpen); });
     }
 
-    app->settings()->resetAll();
-    fnLoadAppSettings(app->settings());
     const int code = qtApp->exec();
-    appModule->recordRecentFileThumbnails(guiApp);
+    thumbnailRecorder->flushAll();
     app->settings()->save();
-    return code;
+    return fnExitWriteTrace(code);
 }
 
 static bool isAppCliMode = false;
+static bool isAppCliRenderMode = false;
 static void onQtAppExit()
 {
 #if defined(Q_OS_WIN) && defined(NDEBUG)
@@ -487,16 +873,29 @@ int main(int argc, char* argv[])
     for (int i = 1; i < argc; ++i) {
         const char* arg = argv[i];
         if (fnArgEqual(arg, "-e") || fnArgEqual(arg, "--export")
+                || fnArgEqual(arg, "--bom")
+                || fnArgEqual(arg, "--stats")
+                || fnArgEqual(arg, "-r") || fnArgEqual(arg, "--render")
                 || fnArgEqual(arg, "-h") || fnArgEqual(arg, "--help")
                 || fnArgEqual(arg, "-v") || fnArgEqual(arg, "--version"))
         {
             Mayo::isAppCliMode = true;
-            break;
         }
+
+        if (fnArgEqual(arg, "-r") || fnArgEqual(arg, "--render"))
+            Mayo::isAppCliRenderMode = true;
     }
 
-    std::unique_ptr<QCoreApplication> ptrApp(
-            Mayo::isAppCliMode ? new QCoreApplication(argc, argv) : new QApplication(argc, argv));
+    // CLI rendering needs theme, pixmaps and GuiDocument objects so a GUI application is required
+    // Its windows are never shown, the "offscreen" platform avoids the need of a display server
+    if (Mayo::isAppCliRenderMode && qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    std::unique_ptr<QCoreApplication> ptrApp;
+    if (Mayo::isAppCliMode && !Mayo::isAppCliRenderMode)
+        ptrApp.reset(new QCoreApplication(argc, argv));
+    else
+        ptrApp.reset(new QApplication(argc, argv));
 
 #if defined(Q_OS_WIN) && defined(NDEBUG)
     if (Mayo::isAppCliMode) {
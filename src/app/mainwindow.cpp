@@ -9,23 +9,31 @@
 
 #include "../base/application.h"
 #include "../base/application_item_selection_model.h"
+#include "../base/bom_report.h"
 #include "../base/cpp_utils.h"
 #include "../base/document.h"
 #include "../base/global.h"
 #include "../base/io_format.h"
 #include "../base/io_system.h"
+#include "../base/memory_stats.h"
 #include "../base/messenger.h"
+#include "../base/property_builtins.h"
 #include "../base/settings.h"
+#include "../base/string_utils.h"
 #include "../base/task_manager.h"
+#include "../base/tracing.h"
 #include "../graphics/graphics_object_driver.h"
 #include "../graphics/graphics_utils.h"
+#include "../graphics/v3d_view_camera_animation.h"
 #include "../gui/gui_application.h"
 #include "../gui/gui_document.h"
 #include "../gui/gui_document_list_model.h"
 #include "app_module.h"
 #include "dialog_about.h"
+#include "dialog_clash_detection.h"
 #include "dialog_inspect_xde.h"
 #include "dialog_options.h"
+#include "dialog_performance_stats.h"
 #include "dialog_save_image_view.h"
 #include "dialog_task_manager.h"
 #include "document_tree_node_properties_providers.h"
@@ -43,6 +51,7 @@
 #  include "windows/win_taskbar_global_progress.h"
 #endif
 
+#include <QtCore/QFile>
 #include <QtCore/QMimeData>
 #include <QtCore/QTime>
 #include <QtCore/QTimer>
@@ -55,12 +64,19 @@
 #include <QtWidgets/QFileDialog>
 #include <QtDebug>
 
+#include <algorithm>
+#include <array>
+#include <memory>
 #include <unordered_set>
 
 namespace Mayo {
 
 namespace Internal {
 
+// Delay before properties editor reflects current selection, so that rapid selection changes(ie
+// scrubbing through the model tree) are coalesced into a single update
+static constexpr int PropertiesEditorUpdateDelay_ms = 50;
+
 static IO::Format formatFromFilter(const QString& filter)
 {
     for (const IO::Format& format : Application::instance()->ioSystem()->readerFormats()) {
@@ -175,6 +191,86 @@ static void handleMessage(Messenger::MessageType msgType, const QString& text, Q
     }
 }
 
+// Read-only properties of the estimated memory held by a document and its graphics objects
+// Document statistics are computed in a task, the properties are updated when the task ends
+class DocumentMemoryProperties : public PropertyGroupSignals {
+    MAYO_DECLARE_TEXT_ID_FUNCTIONS(Mayo::DocumentMemoryProperties)
+public:
+    DocumentMemoryProperties(const DocumentPtr& doc, const GuiDocument* guiDoc)
+        : m_gfxStats(guiDoc ? guiDoc->graphicsMemoryStats() : GuiDocument::GraphicsMemoryStats{})
+    {
+        for (PropertyQString* prop : this->documentProperties())
+            prop->setValue(textIdTr("Computing..."));
+
+        setBytesValue(m_propertyGraphicsPresentations, m_gfxStats.presentationBytes);
+        setBytesValue(m_propertyGraphicsSelection, m_gfxStats.selectionBytes);
+        for (Property* prop : this->properties())
+            prop->setUserReadOnly(true);
+
+        auto ptrDocStats = std::make_shared<DocumentMemoryStats>();
+        auto taskMgr = TaskManager::globalInstance();
+        // Signal TaskManager::ended is emitted from worker thread, so connection is queued
+        QObject::connect(taskMgr, &TaskManager::ended, this, [=](TaskId taskId) {
+            if (m_isTaskRunning && taskId == m_taskId) {
+                m_isTaskRunning = false;
+                this->setDocumentStats(*ptrDocStats);
+            }
+        });
+        // OCAF document is read here in the GUI thread, the task only browses shapes
+        m_taskId = taskMgr->newTask([=, snapshot = DocumentMemoryStats::snapshot(doc)](TaskProgress* progress) {
+            *ptrDocStats = DocumentMemoryStats::compute(snapshot, progress);
+        });
+        taskMgr->setTitle(m_taskId, textIdTr("Memory statistics %1").arg(doc->name()));
+        m_isTaskRunning = true;
+        taskMgr->run(m_taskId);
+    }
+
+    ~DocumentMemoryProperties()
+    {
+        // Task result is owned by the task itself, so it can safely end after these properties
+        if (m_isTaskRunning)
+            TaskManager::globalInstance()->requestAbort(m_taskId);
+    }
+
+    void setDocumentStats(const DocumentMemoryStats& docStats)
+    {
+        setBytesValue(m_propertyTotal, docStats.totalBytes() + m_gfxStats.totalBytes());
+        setBytesValue(m_propertyBRepTopology, docStats.brepTopologyBytes);
+        setBytesValue(m_propertyBRepGeometry, docStats.brepGeometryBytes);
+        setBytesValue(m_propertyTriangulations, docStats.triangulationBytes);
+        m_propertyTriangleCount.setValue(QLocale().toString(qint64(docStats.triangulationTriangleCount)));
+        setBytesValue(m_propertyOcafAttributes, docStats.ocafBytes);
+        setBytesValue(m_propertyModelTree, docStats.modelTreeBytes);
+    }
+
+    std::array<PropertyQString*, 7> documentProperties()
+    {
+        return {
+            &m_propertyTotal, &m_propertyBRepTopology, &m_propertyBRepGeometry, &m_propertyTriangulations,
+            &m_propertyTriangleCount, &m_propertyOcafAttributes, &m_propertyModelTree
+        };
+    }
+
+    static void setBytesValue(PropertyQString& prop, int64_t bytes)
+    {
+        prop.setValue(StringUtils::bytesText(bytes));
+    }
+
+    PropertyQString m_propertyTotal{ this, textId("Total") };
+    PropertyQString m_propertyBRepTopology{ this, textId("BRepTopology") };
+    PropertyQString m_propertyBRepGeometry{ this, textId("BRepGeometry") };
+    PropertyQString m_propertyTriangulations{ this, textId("Triangulations") };
+    PropertyQString m_propertyTriangleCount{ this, textId("TriangleCount") };
+    PropertyQString m_propertyOcafAttributes{ this, textId("OcafAttributes") };
+    PropertyQString m_propertyModelTree{ this, textId("ModelTree") };
+    PropertyQString m_propertyGraphicsPresentations{ this, textId("GraphicsPresentations") };
+    PropertyQString m_propertyGraphicsSelection{ this, textId("GraphicsSelection") };
+
+    const GuiDocument::GraphicsMemoryStats m_gfxStats;
+    TaskId m_taskId = 0;
+    bool m_isTaskRunning = false;
+};
+
 } // namespace Internal
 
 MainWindow::MainWindow(GuiApplication* guiApp, QWidget *parent)
@@ -197,6 +293,11 @@ MainWindow::MainWindow(GuiApplication* guiApp, QWidget *parent)
     m_ui->widget_Properties->setRowHeightFactor(1.4);
     m_ui->widget_Properties->clear();
 
+    m_timerUpdateProperties = new QTimer(this);
+    m_timerUpdateProperties->setSingleShot(true);
+    m_timerUpdateProperties->setInterval(Internal::PropertiesEditorUpdateDelay_ms);
+    QObject::connect(m_timerUpdateProperties, &QTimer::timeout, this, &MainWindow::updatePropertiesEditor);
+
     m_ui->btn_PreviousGuiDocument->setDefaultAction(m_ui->actionPreviousDoc);
     m_ui->btn_NextGuiDocument->setDefaultAction(m_ui->actionNextDoc);
     m_ui->btn_CloseGuiDocument->setDefaultAction(m_ui->actionCloseDoc);
@@ -217,6 +318,7 @@ MainWindow::MainWindow(GuiApplication* guiApp, QWidget *parent)
     m_ui->actionToggleFullscreen->setChecked(this->isFullScreen());
     m_ui->actionToggleOriginTrihedron->setChecked(false);
     m_ui->actionTogglePerformanceStats->setChecked(false);
+    m_ui->actionToggleRecordTrace->setChecked(Tracing::isEnabled());
 
     mayoTheme()->setupHeaderComboBox(m_ui->combo_LeftContents);
     mayoTheme()->setupHeaderComboBox(m_ui->combo_GuiDocuments);
@@ -299,6 +401,27 @@ MainWindow::MainWindow(GuiApplication* guiApp, QWidget *parent)
     QObject::connect(
                 m_ui->actionInspectXDE, &QAction::triggered,
                 this, &MainWindow::inspectXde);
+    QObject::connect(
+                m_ui->actionExportBom, &QAction::triggered,
+                this, &MainWindow::exportBom);
+    QObject::connect(
+                m_ui->actionDetectClashes, &QAction::triggered,
+                this, &MainWindow::detectClashes);
+    QObject::connect(
+                m_ui->actionPerformanceStats, &QAction::triggered,
+                this, &MainWindow::showPerformanceStats);
+    QObject::connect(
+                m_ui->actionToggleRecordTrace, &QAction::toggled,
+                this, [](bool on) {
+        // Each recording starts with an empty trace, events of previous recordings are discarded
+        if (on)
+            Tracing::clear();
+
+        Tracing::setEnabled(on);
+    });
+    QObject::connect(
+                m_ui->actionSaveTrace, &QAction::triggered,
+                this, &MainWindow::saveTrace);
     QObject::connect(
                 m_ui->actionOptions, &QAction::triggered,
                 this, &MainWindow::editOptions);
@@ -342,9 +465,6 @@ MainWindow::MainWindow(GuiApplication* guiApp, QWidget *parent)
     QObject::connect(
                 guiApp, &GuiApplication::guiDocumentAdded,
                 this, &MainWindow::onGuiDocumentAdded);
-    QObject::connect(
-                guiApp, &GuiApplication::guiDocumentErased,
-                this, &MainWindow::onGuiDocumentErased);
     QObject::connect(
                 guiApp->selectionModel(), &ApplicationItemSelectionModel::changed,
                 this, &MainWindow::onApplicationItemSelectionChanged);
@@ -550,6 +670,7 @@ void MainWindow::exportSelectedItems()
                 .targetFormat(format)
                 .withItems(m_guiApp->selectionModel()->selectedItems())
                 .withParameters(AppModule::get(app)->findWriterParameters(format))
+                .withCompression(IO::compressionFromFilepathSuffix(filepathFrom(strFilepath)))
                 .withMessenger(messenger)
                 .withTaskProgress(progress)
                 .execute();
@@ -626,6 +747,61 @@ void MainWindow::inspectXde()
     }
 }
 
+void MainWindow::exportBom()
+{
+    WidgetGuiDocument* widget = this->currentWidgetGuiDocument();
+    const DocumentPtr doc = widget ? widget->guiDocument()->document() : DocumentPtr();
+    if (!doc)
+        return;
+
+    auto lastSettings = Internal::ImportExportSettings::load();
+    const QString strFilepath =
+            QFileDialog::getSaveFileName(
+                this,
+                tr("Select Output File"),
+                filepathTo<QString>(lastSettings.openDir),
+                tr("CSV files(*.csv);;JSON files(*.json)"));
+    if (strFilepath.isEmpty())
+        return;
+
+    const BomReport::Format format = BomReport::findFormat(filepathFrom(strFilepath));
+    if (format == BomReport::Format::None) {
+        WidgetsUtils::asyncMsgBoxCritical(this, tr("Error"), tr("Unsupported file format"));
+        return;
+    }
+
+    auto appModule = AppModule::get(m_guiApp->application());
+    BomReport::WriteOptions options;
+    options.schema = appModule->unitSystemSchema.value();
+    options.decimalCount = appModule->unitSystemDecimals.value();
+    // OCAF document is read here in the GUI thread, the task only gets values and shapes
+    auto taskMgr = TaskManager::globalInstance();
+    const TaskId taskId = taskMgr->newTask([=, snapshot = BomReport::snapshot(doc)](TaskProgress* progress) {
+        const std::vector<BomReport::Row> vecRow = BomReport::compute(snapshot, &doc->massPropertiesCache(), progress);
+        if (progress->isAbortRequested())
+            return;
+
+        auto messenger = MessengerQtSignal::defaultInstance();
+        QFile file(strFilepath);
+        if (file.open(QIODevice::WriteOnly) && BomReport::write(&file, format, vecRow, options))
+            messenger->emitInfo(tr("BOM exported(%1 products)").arg(vecRow.size()));
+        else
+            messenger->emitError(tr("Failed to write BOM file '%1'").arg(strFilepath));
+    });
+    taskMgr->setTitle(taskId, tr("BOM %1").arg(QFileInfo(strFilepath).fileName()));
+    taskMgr->run(taskId);
+}
+
+void MainWindow::detectClashes()
+{
+    WidgetGuiDocument* widget = this->currentWidgetGuiDocument();
+    if (!widget || !widget->guiDocument()->document()->isXCafDocument())
+        return;
+
+    auto dlg = new DialogClashDetection(widget->guiDocument(), this);
+    WidgetsUtils::asyncDialogExec(dlg);
+}
+
 void MainWindow::toggleFullscreen()
 {
     if (this->isFullScreen()) {
@@ -646,6 +822,37 @@ void MainWindow::toggleLeftSidebar()
     m_ui->widget_Left->setVisible(!isVisible);
 }
 
+void MainWindow::showPerformanceStats()
+{
+    auto dlg = new DialogPerformanceStats(m_guiApp->renderStats(), this);
+    WidgetsUtils::asyncDialogExec(dlg);
+}
+
+void MainWindow::saveTrace()
+{
+    if (Tracing::eventCount() == 0) {
+        WidgetsUtils::asyncMsgBoxInfo(
+                    this, tr("Information"), tr("No trace recorded, check 'Record Trace' first"));
+        return;
+    }
+
+    auto lastSettings = Internal::ImportExportSettings::load();
+    const QString strFilepath =
+            QFileDialog::getSaveFileName(
+                this,
+                tr("Select Output File"),
+                filepathTo<QString>(lastSettings.openDir),
+                tr("JSON files(*.json)"));
+    if (strFilepath.isEmpty())
+        return;
+
+    auto messenger = MessengerQtSignal::defaultInstance();
+    if (Tracing::writeChromeTrace(strFilepath))
+        messenger->emitInfo(tr("Trace saved(%1 events)").arg(Tracing::eventCount()));
+    else
+        messenger->emitError(tr("Failed to write trace file '%1'").arg(strFilepath));
+}
+
 void MainWindow::aboutMayo()
 {
     auto dlg = new DialogAbout(this);
@@ -658,57 +865,96 @@ void MainWindow::reportbug()
 }
 
 void MainWindow::onApplicationItemSelectionChanged()
+{
+    Span<const ApplicationItem> spanAppItem = m_guiApp->selectionModel()->selectedItems();
+    if (spanAppItem.empty()) {
+        // Nothing to compute, pending update(if any) is canceled
+        m_timerUpdateProperties->stop();
+        this->updatePropertiesEditor();
+    }
+    else {
+        m_timerUpdateProperties->start(); // Restarted on each change, stale selections are skipped
+    }
+
+    if (spanAppItem.size() == 1) {
+        auto app = m_guiApp->application();
+        if (AppModule::get(app)->linkWithDocumentSelector.value()) {
+            const int index = app->findIndexOfDocument(spanAppItem.front().document());
+            if (index != -1)
+                this->setCurrentDocumentIndex(index);
+        }
+    }
+
+    this->updateControlsActivation();
+}
+
+void MainWindow::updatePropertiesEditor()
 {
     WidgetModelTree* uiModelTree = m_ui->widget_ModelTree;
     WidgetPropertiesEditor* uiProps = m_ui->widget_Properties;
 
+    // Editor must not reference the property groups about to be destroyed
     uiProps->clear();
+    m_ptrCurrentNodeDataProperties.reset();
+    m_ptrCurrentNodeGraphicsProperties.reset();
+
     Span<const ApplicationItem> spanAppItem = m_guiApp->selectionModel()->selectedItems();
-    if (spanAppItem.size() == 1) {
-        const ApplicationItem& item = spanAppItem.front();
-        const DocumentTreeNode& docTreeNode = item.documentTreeNode();
-        if (item.isDocumentTreeNode()) {
-            auto providerTable = m_guiApp->application()->documentTreeNodePropertiesProviderTable();
-            m_ptrCurrentNodeDataProperties = providerTable->properties(docTreeNode);
-            PropertyGroupSignals* dataProps = m_ptrCurrentNodeDataProperties.get();
-            if (dataProps) {
-                uiProps->editProperties(dataProps, uiProps->addGroup(tr("Data")));
-                QObject::connect(dataProps, &PropertyGroupSignals::propertyChanged, this, [=]{
-                    uiModelTree->refreshItemText(item);
-                });
-            }
+    if (spanAppItem.size() == 1 && spanAppItem.front().isDocument()) {
+        const DocumentPtr doc = spanAppItem.front().document();
+        m_ptrCurrentNodeDataProperties =
+                std::make_unique<Internal::DocumentMemoryProperties>(doc, m_guiApp->findGuiDocument(doc));
+        PropertyGroupSignals* memoryProps = m_ptrCurrentNodeDataProperties.get();
+        uiProps->editProperties(memoryProps, uiProps->addGroup(tr("Memory")));
+        QObject::connect(memoryProps, &PropertyGroupSignals::propertyChanged, this, [=](Property* prop) {
+            uiProps->refreshProperty(prop);
+        });
+    }
 
-            GuiDocument* guiDoc = m_guiApp->findGuiDocument(item.document());
-            std::vector<GraphicsObjectPtr> vecGfxObject;
-            guiDoc->foreachGraphicsObject(docTreeNode.id(), [&](GraphicsObjectPtr gfxObject) {
-                vecGfxObject.push_back(std::move(gfxObject));
+    if (spanAppItem.size() == 1 && spanAppItem.front().isDocumentTreeNode()) {
+        const ApplicationItem& item = spanAppItem.front();
+        auto providerTable = m_guiApp->application()->documentTreeNodePropertiesProviderTable();
+        m_ptrCurrentNodeDataProperties = providerTable->properties(item.documentTreeNode());
+        PropertyGroupSignals* dataProps = m_ptrCurrentNodeDataProperties.get();
+        if (dataProps) {
+            uiProps->editProperties(dataProps, uiProps->addGroup(tr("Data")));
+            QObject::connect(dataProps, &PropertyGroupSignals::propertyChanged, this, [=](Property* prop) {
+                uiProps->refreshProperty(prop);
+                uiModelTree->refreshItemText(item);
             });
-            auto commonGfxDriver = GraphicsObjectDriver::getCommon(vecGfxObject);
-            if (commonGfxDriver) {
-                m_ptrCurrentNodeGraphicsProperties = commonGfxDriver->properties(vecGfxObject);
-                GraphicsObjectBasePropertyGroup* gfxProps = m_ptrCurrentNodeGraphicsProperties.get();
-                if (gfxProps) {
-                    uiProps->editProperties(gfxProps, uiProps->addGroup(tr("Graphics")));
-                    QObject::connect(gfxProps, &PropertyGroupSignals::propertyChanged, this, [=]{
-                        guiDoc->graphicsScene()->redraw();
-                    });
-                }
-            }
-        }
-
-        auto app = m_guiApp->application();
-        if (AppModule::get(app)->linkWithDocumentSelector.value()) {
-            const int index = app->findIndexOfDocument(item.document());
-            if (index != -1)
-                this->setCurrentDocumentIndex(index);
         }
     }
-    else {
-        // TODO
-        uiProps->clear();
+
+    // Graphics objects of all selected tree nodes are gathered, so that common values are merged by
+    // a single property group
+    std::vector<GraphicsObjectPtr> vecGfxObject;
+    std::vector<GuiDocument*> vecGuiDoc;
+    for (const ApplicationItem& item : spanAppItem) {
+        if (!item.isDocumentTreeNode())
+            continue;
+
+        GuiDocument* guiDoc = m_guiApp->findGuiDocument(item.document());
+        if (!guiDoc)
+            continue;
+
+        guiDoc->foreachGraphicsObject(item.documentTreeNode().id(), [&](GraphicsObjectPtr gfxObject) {
+            vecGfxObject.push_back(std::move(gfxObject));
+        });
+        if (std::find(vecGuiDoc.cbegin(), vecGuiDoc.cend(), guiDoc) == vecGuiDoc.cend())
+            vecGuiDoc.push_back(guiDoc);
     }
 
-    this->updateControlsActivation();
+    auto commonGfxDriver = GraphicsObjectDriver::getCommon(vecGfxObject);
+    if (commonGfxDriver) {
+        m_ptrCurrentNodeGraphicsProperties = commonGfxDriver->properties(vecGfxObject);
+        GraphicsObjectBasePropertyGroup* gfxProps = m_ptrCurrentNodeGraphicsProperties.get();
+        if (gfxProps) {
+            uiProps->editProperties(gfxProps, uiProps->addGroup(tr("Graphics")));
+            QObject::connect(gfxProps, &PropertyGroupSignals::propertyChanged, this, [=]{
+                for (GuiDocument* guiDoc : vecGuiDoc)
+                    guiDoc->graphicsScene()->redraw();
+            });
+        }
+    }
 }
 
 void MainWindow::onOperationFinished(bool ok, const QString &msg)
@@ -737,6 +983,10 @@ void MainWindow::onGuiDocumentAdded(GuiDocument* guiDoc)
 
     V3dViewController* ctrl = widget->controller();
     QObject::connect(ctrl, &V3dViewController::mouseMoved, [=](const QPoint& pos2d) {
+        // Skip picking while the camera is animated, scene under the cursor keeps changing
+        if (guiDoc->viewCameraAnimation()->state() == QAbstractAnimation::Running)
+            return;
+
         guiDoc->graphicsScene()->highlightAt(pos2d, widget->guiDocument()->v3dView());
         auto selector = guiDoc->graphicsScene()->mainSelector();
         selector->Pick(pos2d.x(), pos2d.y(), guiDoc->v3dView());
@@ -755,11 +1005,6 @@ void MainWindow::onGuiDocumentAdded(GuiDocument* guiDoc)
     QTimer::singleShot(0, this, [=]{ this->setCurrentDocumentIndex(newDocIndex); });
 }
 
-void MainWindow::onGuiDocumentErased(GuiDocument* guiDoc)
-{
-    AppModule::get(m_guiApp->application())->recordRecentFileThumbnail(guiDoc);
-}
-
 void MainWindow::onWidgetFileSystemLocationActivated(const QFileInfo& loc)
 {
     this->openDocument(filepathFrom(loc));
@@ -966,6 +1211,8 @@ void MainWindow::updateControlsActivation()
     m_ui->actionPreviousDoc->setEnabled(!appDocumentsEmpty && currentDocIndex > 0);
     m_ui->actionNextDoc->setEnabled(!appDocumentsEmpty && currentDocIndex < appDocumentsCount - 1);
     m_ui->actionExportSelectedItems->setEnabled(!appDocumentsEmpty);
+    m_ui->actionExportBom->setEnabled(!appDocumentsEmpty);
+    m_ui->actionDetectClashes->setEnabled(!appDocumentsEmpty);
     m_ui->actionToggleLeftSidebar->setEnabled(newMainPage != m_ui->page_MainHome);
     m_ui->combo_GuiDocuments->setEnabled(!appDocumentsEmpty);
 
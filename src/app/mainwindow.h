@@ -12,6 +12,7 @@
 #include <QtWidgets/QMainWindow>
 #include <memory>
 class QFileInfo;
+class QTimer;
 
 namespace Mayo {
 
@@ -58,6 +59,10 @@ private:
     void editOptions();
     void saveImageView();
     void inspectXde();
+    void exportBom();
+    void detectClashes();
+    void showPerformanceStats();
+    void saveTrace();
     // -- Window menu
     void toggleFullscreen();
     void toggleLeftSidebar();
@@ -66,9 +71,9 @@ private:
     void reportbug();
 
     void onApplicationItemSelectionChanged();
+    void updatePropertiesEditor();
     void onOperationFinished(bool ok, const QString& msg);
     void onGuiDocumentAdded(GuiDocument* guiDoc);
-    void onGuiDocumentErased(GuiDocument* guiDoc);
     void onWidgetFileSystemLocationActivated(const QFileInfo& loc);
     void onLeftContentsPageChanged(int pageId);
     void onCurrentDocumentIndexChanged(int idx);
@@ -92,6 +97,7 @@ private:
     GuiApplication* m_guiApp = nullptr;
     class Ui_MainWindow* m_ui = nullptr;
     Qt::WindowStates m_previousWindowState = Qt::WindowNoState;
+    QTimer* m_timerUpdateProperties = nullptr;
     std::unique_ptr<PropertyGroupSignals> m_ptrCurrentNodeDataProperties;
     std::unique_ptr<GraphicsObjectBasePropertyGroup> m_ptrCurrentNodeGraphicsProperties;
 };
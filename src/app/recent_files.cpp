@@ -6,16 +6,18 @@
 
 #include "recent_files.h"
 
-#include "occt_window.h"
+#include "app_module.h"
 #include "theme.h"
-#include "../graphics/graphics_utils.h"
+#include "../gui/gui_application.h"
 #include "../gui/gui_document.h"
-#include "../gui/qtgui_utils.h"
 
-#include <gsl/util>
-//#include <QtGui/QOffscreenSurface>
-#include <QtGui/QWindow>
-#include <Aspect_NeutralWindow.hxx>
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDataStream>
+#include <QtCore/QDir>
+#include <QtCore/QStandardPaths>
+#include <QtCore/QTimer>
+#include <algorithm>
+#include <chrono>
 
 namespace Mayo {
 
@@ -26,7 +28,7 @@ static int64_t lastModifiedTimestamp(const FilePath& fp)
     return std::chrono::duration_cast<std::chrono::seconds>(lastModifiedTime).count();
 }
 
-bool RecentFile::recordThumbnail(GuiDocument* guiDoc, QSize size)
+bool RecentFile::recordThumbnail(GuiDocument* guiDoc, QSize size, GuiOffscreenRenderer* renderer)
 {
     if (!guiDoc)
         return false;
@@ -35,56 +37,20 @@ bool RecentFile::recordThumbnail(GuiDocument* guiDoc, QSize size)
         return false;
 
     if (this->thumbnailTimestamp != lastModifiedTimestamp(this->filepath)) {
-        const GuiDocument::ViewTrihedronMode onEntryTrihedronMode = guiDoc->viewTrihedronMode();
-        const bool onEntryOriginTrihedronVisible = guiDoc->isOriginTrihedronVisible();
-        const QColor bkgColor = mayoTheme()->color(Theme::Color::Palette_Window);
-        Handle_V3d_View view = guiDoc->graphicsScene()->createV3dView();
-        view->ChangeRenderingParams().IsAntialiasingEnabled = true;
-        view->ChangeRenderingParams().NbMsaaSamples = 4;
-        view->SetBackgroundColor(QtGuiUtils::toPreferredColorSpace(bkgColor));
-
-        auto _ = gsl::finally([=]{
-            guiDoc->graphicsScene()->v3dViewer()->SetViewOff(view);
-            guiDoc->setViewTrihedronMode(onEntryTrihedronMode);
-            if (guiDoc->isOriginTrihedronVisible() != onEntryOriginTrihedronVisible)
-                guiDoc->toggleOriginTrihedronVisibility();
-        });
-
-        guiDoc->graphicsScene()->clearSelection();
-        guiDoc->setViewTrihedronMode(GuiDocument::ViewTrihedronMode::None);
-        if (guiDoc->isOriginTrihedronVisible())
-            guiDoc->toggleOriginTrihedronVisibility();
-
-        QWindow window; // TODO Use a pure offscreen window instead
-        window.setBaseSize(size);
-        window.create();
-        Handle_Aspect_NeutralWindow hWnd = new Aspect_NeutralWindow;
-        hWnd->SetSize(size.width(), size.height());
-        hWnd->SetNativeHandle(Aspect_Drawable(window.winId()));
-        view->SetWindow(hWnd);
-
-        GraphicsUtils::V3dView_fitAll(view);
-
-        Image_PixMap pixmap;
-        pixmap.SetTopDown(true);
-        V3d_ImageDumpOptions dumpOptions;
-        dumpOptions.BufferType = Graphic3d_BT_RGB;
-        dumpOptions.Width = size.width();
-        dumpOptions.Height = size.height();
-        bool ok = view->ToPixMap(pixmap, dumpOptions);
-        if (!ok)
+        GuiOffscreenRenderer::Parameters renderParams;
+        renderParams.size = size;
+        renderParams.backgroundColor = mayoTheme()->color(Theme::Color::Palette_Window);
+        GuiOffscreenRenderer tempRenderer;
+        const QImage img = (renderer ? renderer : &tempRenderer)->renderImage(guiDoc, renderParams);
+        if (img.isNull())
             return false;
 
-        const QImage img(pixmap.Data(),
-                         int(pixmap.Width()),
-                         int(pixmap.Height()),
-                         int(pixmap.SizeRowBytes()),
-                         QImage::Format_RGB888);
-        if (img.isNull())
+        RecentFile newRecentFile = *this;
+        newRecentFile.thumbnailTimestamp = lastModifiedTimestamp(this->filepath);
+        if (!RecentFileThumbnailCache::store(newRecentFile, img))
             return false;
 
-        this->thumbnail = QPixmap::fromImage(img);
-        this->thumbnailTimestamp = lastModifiedTimestamp(this->filepath);
+        this->thumbnailTimestamp = newRecentFile.thumbnailTimestamp;
     }
 
     return true;
@@ -92,20 +58,87 @@ bool RecentFile::recordThumbnail(GuiDocument* guiDoc, QSize size)
 
 bool RecentFile::isThumbnailOutOfSync() const
 {
-    return this->thumbnailTimestamp != lastModifiedTimestamp(this->filepath);
+    return this->thumbnailTimestamp != lastModifiedTimestamp(this->filepath)
+            || !filepathIsRegularFile(RecentFileThumbnailCache::thumbnailFilePath(*this));
+}
+
+QPixmap RecentFile::loadThumbnail() const
+{
+    if (this->thumbnailTimestamp == 0)
+        return QPixmap();
+
+    return QPixmap(filepathTo<QString>(RecentFileThumbnailCache::thumbnailFilePath(*this)), "PNG");
+}
+
+namespace Internal {
+
+static QString thumbnailFileNamePrefix(const FilePath& fp)
+{
+    const QByteArray hash = QCryptographicHash::hash(filepathTo<QByteArray>(fp), QCryptographicHash::Sha1);
+    return QString::fromLatin1(hash.toHex()) + "_";
+}
+
+} // namespace Internal
+
+FilePath RecentFileThumbnailCache::dirPath()
+{
+    const QString strCacheDir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    return filepathFrom(strCacheDir) / "thumbnails";
+}
+
+FilePath RecentFileThumbnailCache::thumbnailFilePath(const RecentFile& recentFile)
+{
+    const QString fileName =
+            Internal::thumbnailFileNamePrefix(recentFile.filepath)
+            + QString::number(recentFile.thumbnailTimestamp)
+            + ".png";
+    return RecentFileThumbnailCache::dirPath() / filepathFrom(fileName);
+}
+
+bool RecentFileThumbnailCache::store(const RecentFile& recentFile, const QImage& img)
+{
+    QDir dir(filepathTo<QString>(RecentFileThumbnailCache::dirPath()));
+    if (!dir.mkpath("."))
+        return false;
+
+    const QString strThumbnailFilePath = filepathTo<QString>(thumbnailFilePath(recentFile));
+    if (!img.save(strThumbnailFilePath, "PNG"))
+        return false;
+
+    // Remove previous thumbnails of the recent file
+    const QString strPrefix = Internal::thumbnailFileNamePrefix(recentFile.filepath);
+    for (const QFileInfo& fi : dir.entryInfoList({ strPrefix + "*.png" }, QDir::Files)) {
+        if (fi.absoluteFilePath() != QFileInfo(strThumbnailFilePath).absoluteFilePath())
+            QFile::remove(fi.absoluteFilePath());
+    }
+
+    // Enforce size limit, least recently written thumbnails first
+    const QFileInfoList listThumbnailFileInfo = dir.entryInfoList({ "*.png" }, QDir::Files, QDir::Time);
+    int64_t cacheSize = 0;
+    for (const QFileInfo& fi : listThumbnailFileInfo)
+        cacheSize += fi.size();
+
+    for (auto it = listThumbnailFileInfo.crbegin(); it != listThumbnailFileInfo.crend(); ++it) {
+        if (cacheSize <= RecentFileThumbnailCache::sizeLimit())
+            break;
+
+        if (it->absoluteFilePath() != QFileInfo(strThumbnailFilePath).absoluteFilePath()) {
+            cacheSize -= it->size();
+            QFile::remove(it->absoluteFilePath());
+        }
+    }
+
+    return true;
 }
 
 bool operator==(const RecentFile& lhs, const RecentFile& rhs)
 {
-    return lhs.filepath == rhs.filepath
-            && lhs.thumbnail.cacheKey() == rhs.thumbnail.cacheKey()
-            && lhs.thumbnailTimestamp == rhs.thumbnailTimestamp;
+    return lhs.filepath == rhs.filepath && lhs.thumbnailTimestamp == rhs.thumbnailTimestamp;
 }
 
 QDataStream& operator<<(QDataStream& stream, const RecentFile& recentFile)
 {
     stream << filepathTo<QString>(recentFile.filepath);
-    stream << recentFile.thumbnail;
     stream << qint64(recentFile.thumbnailTimestamp);
     return stream;
 }
@@ -115,13 +148,34 @@ QDataStream& operator>>(QDataStream& stream, RecentFile& recentFile)
     QString strFilepath;
     stream >> strFilepath;
     recentFile.filepath = filepathFrom(strFilepath);
-    stream >> recentFile.thumbnail;
     stream >> reinterpret_cast<qint64&>(recentFile.thumbnailTimestamp);
     return stream;
 }
 
+namespace Internal {
+
+// Stream format where thumbnail pixmaps were embedded, it starts directly with the count of items
+// New format starts with a version tag which can't be mistaken for a count of items
+static constexpr uint32_t RecentFilesStreamVersion2Tag = 0xFFFF0002;
+
+static void readRecentFile_v1(QDataStream& stream, RecentFile& recentFile)
+{
+    QString strFilepath;
+    stream >> strFilepath;
+    recentFile.filepath = filepathFrom(strFilepath);
+    QPixmap thumbnail;
+    stream >> thumbnail;
+    stream >> reinterpret_cast<qint64&>(recentFile.thumbnailTimestamp);
+    // Migrate embedded thumbnail to the cache
+    if (thumbnail.isNull() || !RecentFileThumbnailCache::store(recentFile, thumbnail.toImage()))
+        recentFile.thumbnailTimestamp = 0;
+}
+
+} // namespace Internal
+
 QDataStream& operator<<(QDataStream& stream, const RecentFiles& recentFiles)
 {
+    stream << Internal::RecentFilesStreamVersion2Tag;
     stream << uint32_t(recentFiles.size());
     for (const RecentFile& recent : recentFiles)
         stream << recent;
@@ -133,16 +187,96 @@ QDataStream& operator>>(QDataStream& stream, RecentFiles& recentFiles)
 {
     uint32_t count = 0;
     stream >> count;
+    const bool isVersion1 = count != Internal::RecentFilesStreamVersion2Tag;
+    if (!isVersion1)
+        stream >> count;
+
     recentFiles.clear();
-    for (uint32_t i = 0; i < count; ++i) {
+    for (uint32_t i = 0; i < count && stream.status() == QDataStream::Ok; ++i) {
         RecentFile recent;
-        stream >> recent;
+        if (isVersion1)
+            Internal::readRecentFile_v1(stream, recent);
+        else
+            stream >> recent;
+
         recentFiles.push_back(std::move(recent));
     }
 
     return stream;
 }
 
+RecentFilesThumbnailRecorder::RecentFilesThumbnailRecorder(GuiApplication* guiApp, AppModule* appModule)
+    : QObject(guiApp),
+      m_appModule(appModule),
+      m_timer(new QTimer(this))
+{
+    // Thumbnails are recorded once the application stays idle for a while
+    m_timer->setSingleShot(true);
+    m_timer->setTimerType(Qt::VeryCoarseTimer);
+    m_timer->setInterval(1000);
+    QObject::connect(m_timer, &QTimer::timeout, this, &RecentFilesThumbnailRecorder::processNext);
+
+    QObject::connect(
+                guiApp, &GuiApplication::guiDocumentAdded,
+                this, &RecentFilesThumbnailRecorder::onGuiDocumentAdded);
+    QObject::connect(
+                guiApp, &GuiApplication::guiDocumentErased,
+                this, &RecentFilesThumbnailRecorder::onGuiDocumentErased);
+    for (GuiDocument* guiDoc : guiApp->guiDocuments())
+        this->onGuiDocumentAdded(guiDoc);
+}
+
+void RecentFilesThumbnailRecorder::queue(GuiDocument* guiDoc)
+{
+    if (!guiDoc)
+        return;
+
+    auto itFound = std::find(m_queueGuiDoc.cbegin(), m_queueGuiDoc.cend(), guiDoc);
+    if (itFound == m_queueGuiDoc.cend())
+        m_queueGuiDoc.push_back(guiDoc);
+
+    m_timer->start(); // Restarts in case timer is active, graphics of 'guiDoc' may still be loading
+}
+
+void RecentFilesThumbnailRecorder::flush(GuiDocument* guiDoc)
+{
+    auto itFound = std::find(m_queueGuiDoc.begin(), m_queueGuiDoc.end(), guiDoc);
+    if (itFound != m_queueGuiDoc.end()) {
+        m_queueGuiDoc.erase(itFound);
+        m_appModule->recordRecentFileThumbnail(guiDoc, &m_renderer);
+    }
+}
+
+void RecentFilesThumbnailRecorder::flushAll()
+{
+    m_timer->stop();
+    while (!m_queueGuiDoc.empty())
+        this->flush(m_queueGuiDoc.front());
+}
+
+void RecentFilesThumbnailRecorder::onGuiDocumentAdded(GuiDocument* guiDoc)
+{
+    QObject::connect(guiDoc, &GuiDocument::graphicsBoundingBoxChanged, this, [=]{ this->queue(guiDoc); });
+    this->queue(guiDoc);
+}
+
+void RecentFilesThumbnailRecorder::onGuiDocumentErased(GuiDocument* guiDoc)
+{
+    this->flush(guiDoc);
+    if (m_renderer.viewGuiDocument() == guiDoc)
+        m_renderer.releaseView();
+}
+
+void RecentFilesThumbnailRecorder::processNext()
+{
+    if (m_queueGuiDoc.empty())
+        return;
+
+    this->flush(m_queueGuiDoc.front());
+    if (!m_queueGuiDoc.empty())
+        m_timer->start(100); // Let pending UI events be processed before next document
+}
+
 template<> const char PropertyRecentFiles::TypeName[] = "Mayo::PropertyRecentFiles";
 
 } // namespace Mayo
@@ -8,22 +8,44 @@
 
 #include "../base/filepath.h"
 #include "../base/property_builtins.h"
+#include "../gui/gui_offscreen_renderer.h"
 
 #include <QtCore/QMetaType>
+#include <QtCore/QObject>
 #include <QtGui/QPixmap>
 #include <vector>
 class QDataStream;
+class QTimer;
 
 namespace Mayo {
 
+class AppModule;
+class GuiApplication;
 class GuiDocument;
 
 struct RecentFile {
     FilePath filepath;
-    QPixmap thumbnail;
     int64_t thumbnailTimestamp = 0;
-    bool recordThumbnail(GuiDocument* guiDoc, QSize size);
+    // Renders thumbnail with 'renderer', a temporary one is used if null
+    // The thumbnail image is stored in RecentFileThumbnailCache
+    bool recordThumbnail(GuiDocument* guiDoc, QSize size, GuiOffscreenRenderer* renderer = nullptr);
     bool isThumbnailOutOfSync() const;
+    // Decodes the thumbnail image from RecentFileThumbnailCache, returns null pixmap if none
+    QPixmap loadThumbnail() const;
+};
+
+// On-disk storage of recent file thumbnails, located in the cache directory of the application
+// Each thumbnail is a PNG file named after the hash of the recent file path and the thumbnail
+// timestamp. Least recently written files are removed when the cache exceeds its size limit
+class RecentFileThumbnailCache {
+public:
+    static FilePath dirPath();
+    static FilePath thumbnailFilePath(const RecentFile& recentFile);
+
+    // Writes 'img' as the thumbnail of 'recentFile', replacing any previous thumbnail
+    static bool store(const RecentFile& recentFile, const QImage& img);
+
+    static constexpr int64_t sizeLimit() { return 16 * 1024 * 1024; }
 };
 
 using RecentFiles = std::vector<RecentFile>;
@@ -35,6 +57,35 @@ QDataStream& operator>>(QDataStream& stream, RecentFile& recentFile);
 QDataStream& operator<<(QDataStream& stream, const RecentFiles& recentFiles);
 QDataStream& operator>>(QDataStream& stream, RecentFiles& recentFiles);
 
+// Records thumbnails of recent files in a low-priority job executed by the event loop
+// GuiDocument objects are queued once their graphics are mapped, then processed one at a time when
+// the application is idle. Only documents matching an out-of-sync entry of the recent files(ie the
+// entries shown in the home page) are rendered, with a single offscreen view reused per document
+class RecentFilesThumbnailRecorder : public QObject {
+    Q_OBJECT
+public:
+    RecentFilesThumbnailRecorder(GuiApplication* guiApp, AppModule* appModule);
+
+    // Schedules recording of the thumbnail of 'guiDoc'
+    void queue(GuiDocument* guiDoc);
+
+    // Synchronously records the thumbnail of 'guiDoc' if it's queued
+    void flush(GuiDocument* guiDoc);
+
+    // Synchronously records the thumbnails of all queued documents
+    void flushAll();
+
+private:
+    void onGuiDocumentAdded(GuiDocument* guiDoc);
+    void onGuiDocumentErased(GuiDocument* guiDoc);
+    void processNext();
+
+    AppModule* m_appModule = nullptr;
+    GuiOffscreenRenderer m_renderer;
+    std::vector<GuiDocument*> m_queueGuiDoc;
+    QTimer* m_timer = nullptr;
+};
+
 } // namespace Mayo
 
 Q_DECLARE_METATYPE(Mayo::RecentFiles)
@@ -10,27 +10,29 @@
 #include "../base/bnd_utils.h"
 #include "../base/math_utils.h"
 #include "../base/settings.h"
+#include "../base/string_utils.h"
 #include "../base/tkernel_utils.h"
 #include "../graphics/graphics_utils.h"
+#include "../gui/gui_application.h"
+#include "../gui/gui_document.h"
+#include "../gui/gui_section_engine.h"
 #include "app_module.h"
+#include "property_editor_factory.h"
 #include "ui_widget_clip_planes.h"
 
 #include <algorithm>
-#include <QtCore/QFile>
 #include <Bnd_Box.hxx>
 #include <Graphic3d_ClipPlane.hxx>
-#include <Graphic3d_Texture2Dmanual.hxx>
-#include <Image_AlienPixMap.hxx>
 
 namespace Mayo {
 
-WidgetClipPlanes::WidgetClipPlanes(const Handle_V3d_View& view3d, QWidget* parent)
+WidgetClipPlanes::WidgetClipPlanes(GuiDocument* guiDoc, QWidget* parent)
     : QWidget(parent),
       m_ui(new Ui_WidgetClipPlanes),
-      m_view(view3d)
+      m_view(guiDoc->v3dView()),
+      m_textureCapping(guiDoc->guiApplication()->clipPlaneCappingTexture())
 {
     m_ui->setupUi(this);
-    this->createPlaneCappingTexture();
 
     m_vecClipPlaneData = {
         {
@@ -77,8 +79,18 @@ WidgetClipPlanes::WidgetClipPlanes(const Handle_V3d_View& view3d, QWidget* paren
 #endif
         if (!m_textureCapping.IsNull() && appModule->clipPlanesCappingHatchOn.value())
             data.graphics->SetCappingTexture(m_textureCapping);
+
+        data.sectionEngine = new GuiSectionEngine(guiDoc, this);
+        QObject::connect(
+                    data.sectionEngine, &GuiSectionEngine::sectionChanged,
+                    this, &WidgetClipPlanes::updateSectionLabel);
     }
 
+    QObject::connect(m_ui->check_Section, &QCheckBox::toggled, this, [=]{
+        for (ClipPlaneData& data : m_vecClipPlaneData)
+            this->updateSection(&data);
+    });
+
     const auto settings = Application::instance()->settings();
     QObject::connect(settings, &Settings::changed, this, [=](Property* property) {
         if (property == &appModule->clipPlanesCappingOn) {
@@ -117,6 +129,8 @@ void WidgetClipPlanes::setRanges(const Bnd_Box& bndBox)
         data.ui.check_On->setEnabled(!isBndBoxVoid);
         if (isBndBoxVoid)
             data.ui.check_On->setChecked(false);
+
+        this->updateSection(&data);
     }
 
     m_view->Redraw();
@@ -124,8 +138,10 @@ void WidgetClipPlanes::setRanges(const Bnd_Box& bndBox)
 
 void WidgetClipPlanes::setClippingOn(bool on)
 {
-    for (ClipPlaneData& data : m_vecClipPlaneData)
+    for (ClipPlaneData& data : m_vecClipPlaneData) {
         data.graphics->SetOn(on ? data.ui.check_On->isChecked() : false);
+        this->updateSection(&data);
+    }
 
     m_view->Redraw();
 }
@@ -141,6 +157,7 @@ void WidgetClipPlanes::connectUi(ClipPlaneData* data)
     QObject::connect(ui.check_On, &QCheckBox::clicked, this, [=](bool on) {
         ui.widget_Control->setEnabled(on);
         this->setPlaneOn(gfx, on);
+        this->updateSection(data);
         m_view->Redraw();
     });
 
@@ -165,6 +182,7 @@ void WidgetClipPlanes::connectUi(ClipPlaneData* data)
         const double dPct = ui.spinValueToSliderValue(pos);
         posSlider->setValue(qRound(dPct));
         GraphicsUtils::Gpx3dClipPlane_setPosition(gfx, pos);
+        this->updateSection(data);
         m_view->Redraw();
     });
 
@@ -173,6 +191,7 @@ void WidgetClipPlanes::connectUi(ClipPlaneData* data)
         QSignalBlocker sigBlock(posSpin); Q_UNUSED(sigBlock);
         posSpin->setValue(pos);
         GraphicsUtils::Gpx3dClipPlane_setPosition(gfx, pos);
+        this->updateSection(data);
         m_view->Redraw();
     });
 
@@ -180,6 +199,7 @@ void WidgetClipPlanes::connectUi(ClipPlaneData* data)
         const gp_Dir invNormal = gfx->ToPlane().Axis().Direction().Reversed();
         GraphicsUtils::Gpx3dClipPlane_setNormal(gfx, invNormal);
         GraphicsUtils::Gpx3dClipPlane_setPosition(gfx, data->ui.posSpin()->value());
+        this->updateSection(data);
         m_view->Redraw();
     });
 
@@ -198,6 +218,7 @@ void WidgetClipPlanes::connectUi(ClipPlaneData* data)
                 const auto bbc = BndBoxCoords::get(m_bndBox);
                 this->setPlaneRange(data, MathUtils::planeRange(bbc, normal));
                 GraphicsUtils::Gpx3dClipPlane_setNormal(gfx, normal);
+                this->updateSection(data);
                 m_view->Redraw();
             }
         });
@@ -248,27 +269,36 @@ void WidgetClipPlanes::setPlaneRange(ClipPlaneData* data, const Range& range)
     }
 }
 
-void WidgetClipPlanes::createPlaneCappingTexture()
+void WidgetClipPlanes::updateSection(ClipPlaneData* data)
 {
-    if (!m_textureCapping.IsNull())
-        return;
+    if (m_ui->check_Section->isChecked() && data->graphics->IsOn())
+        data->sectionEngine->requestSection(data->graphics->ToPlane());
+    else
+        data->sectionEngine->clear();
+}
 
-#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 4, 0)
-    QFile file(":/images/graphics/opencascade_hatch_1.png");
-    if (file.open(QIODevice::ReadOnly)) {
-        const QByteArray fileContents = file.readAll();
-        const QByteArray filenameUtf8 = file.fileName().toUtf8();
-        auto fileContentsData = reinterpret_cast<const Standard_Byte*>(fileContents.constData());
-        Handle_Image_AlienPixMap imageCapping = new Image_AlienPixMap;
-        imageCapping->Load(fileContentsData, fileContents.size(), filenameUtf8.constData());
-        m_textureCapping = new Graphic3d_Texture2Dmanual(imageCapping);
-        m_textureCapping->EnableModulate();
-        m_textureCapping->EnableRepeat();
-        m_textureCapping->GetParams()->SetScale(Graphic3d_Vec2(0.05f, -0.05f));
+void WidgetClipPlanes::updateSectionLabel()
+{
+    const auto appModule = AppModule::get(Application::instance());
+    auto fnQuantityText = [=](const BasePropertyQuantity& prop) {
+        const UnitSystem::TranslateResult trRes = PropertyEditorFactory::unitTranslate(&prop);
+        return tr("%1%2").arg(StringUtils::text(trRes.value, appModule->defaultTextOptions()))
+                         .arg(trRes.strUnit);
+    };
+
+    QStringList listText;
+    for (const ClipPlaneData& data : m_vecClipPlaneData) {
+        if (data.sectionEngine->section().isEmpty())
+            continue;
+
+        const GuiSectionEngine::Properties* props = data.sectionEngine->properties();
+        listText.push_back(tr("%1: area %2, perimeter %3")
+                           .arg(data.ui.check_On->text())
+                           .arg(fnQuantityText(props->area))
+                           .arg(fnQuantityText(props->perimeter)));
     }
-#else
-    // TODO Copy the image resource to a temporary file and call Image_AlienPixMap::Load(tempFilePath)
-#endif
+
+    m_ui->label_Section->setText(listText.join('\n'));
 }
 
 WidgetClipPlanes::UiClipPlane::UiClipPlane(QCheckBox* checkOn, QWidget* widgetControl)
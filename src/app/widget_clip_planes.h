@@ -19,10 +19,13 @@ class QAbstractButton;
 
 namespace Mayo {
 
+class GuiDocument;
+class GuiSectionEngine;
+
 class WidgetClipPlanes : public QWidget {
     Q_OBJECT
 public:
-    WidgetClipPlanes(const Handle_V3d_View& view3d, QWidget* parent = nullptr);
+    WidgetClipPlanes(GuiDocument* guiDoc, QWidget* parent = nullptr);
     ~WidgetClipPlanes();
 
     void setRanges(const Bnd_Box& box);
@@ -47,6 +50,7 @@ private:
     struct ClipPlaneData {
         Handle_Graphic3d_ClipPlane graphics;
         UiClipPlane ui;
+        GuiSectionEngine* sectionEngine = nullptr;
     };
 
     using Range = std::pair<double, double>;
@@ -56,7 +60,8 @@ private:
     void setPlaneOn(const Handle_Graphic3d_ClipPlane& plane, bool on);
     void setPlaneRange(ClipPlaneData* data, const Range& range);
 
-    void createPlaneCappingTexture();
+    void updateSection(ClipPlaneData* data);
+    void updateSectionLabel();
 
     class Ui_WidgetClipPlanes* m_ui;
     Handle_V3d_View m_view;
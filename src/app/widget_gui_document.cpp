@@ -8,6 +8,7 @@
 
 #include "../graphics/graphics_utils.h"
 #include "../graphics/v3d_view_camera_animation.h"
+#include "../gui/gui_application.h"
 #include "../gui/gui_document.h"
 #include "button_flat.h"
 #include "theme.h"
@@ -82,6 +83,7 @@ WidgetGuiDocument::WidgetGuiDocument(GuiDocument* guiDoc, QWidget* parent)
       m_qtOccView(new WidgetOccView(guiDoc->v3dView(), this)),
       m_controller(new WidgetOccViewController(m_qtOccView))
 {
+    m_qtOccView->setRenderStats(guiDoc->guiApplication()->renderStats());
     {
         auto layout = new QVBoxLayout;
         layout->setContentsMargins(0, 0, 0, 0);
@@ -150,7 +152,7 @@ void WidgetGuiDocument::toggleWidgetClipPlanes(bool on)
     if (!m_widgetClipPlanes) {
         if (on) {
             auto panel = new Internal::PanelView3d(this);
-            auto widget = new WidgetClipPlanes(m_guiDoc->v3dView(), panel);
+            auto widget = new WidgetClipPlanes(m_guiDoc, panel);
             WidgetsUtils::addContentsWidget(panel, widget);
             panel->show();
             panel->adjustSize();
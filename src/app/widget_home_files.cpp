@@ -82,7 +82,7 @@ public:
         else {
             auto appModule = AppModule::get(Application::instance());
             const RecentFile* recentFile = appModule ? appModule->findRecentFile(filepathFrom(url)) : nullptr;
-            pixmap = recentFile ? recentFile->thumbnail : QPixmap();
+            pixmap = recentFile ? recentFile->loadThumbnail() : QPixmap();
             if (pixmap.isNull()) {
                 const QIcon icon = m_fileIconProvider.icon(QFileInfo(url));
                 pixmap = fnPixmap(icon, 64, 64);
@@ -94,12 +94,43 @@ public:
     }
 
     void reload() {
+        if (this->reloadRecentFileThumbnails())
+            return;
+
         this->beginResetModel();
         this->reloadRecentFiles();
         this->endResetModel();
     }
 
 private:
+    // Updates only the items whose thumbnail changed, returns 'false' if the list of recent files
+    // changed(ie a full reload is then required)
+    // This allows thumbnails to be filled progressively as they get recorded in background
+    bool reloadRecentFileThumbnails() {
+        auto appModule = AppModule::get(Application::instance());
+        const RecentFiles& listRecentFile = appModule->recentFiles.value();
+        if (listRecentFile.size() != m_cacheRecentFiles.size())
+            return false;
+
+        for (unsigned i = 0; i < listRecentFile.size(); ++i) {
+            if (listRecentFile.at(i).filepath != m_cacheRecentFiles.at(i).filepath)
+                return false;
+        }
+
+        for (unsigned i = 0; i < listRecentFile.size(); ++i) {
+            const RecentFile& recentFile = listRecentFile.at(i);
+            if (recentFile == m_cacheRecentFiles.at(i))
+                continue; // Skip
+
+            const int row = int(i) + 2; // Skip "New Document" and "Open Document(s)" items
+            QPixmapCache::remove(m_storage->m_items.at(row).imageUrl);
+            m_cacheRecentFiles.at(i) = recentFile;
+            emit this->dataChanged(this->index(row), this->index(row));
+        }
+
+        return true;
+    }
+
     void reloadRecentFiles() {
         auto app = Application::instance();
         auto appModule = AppModule::get(app);
@@ -107,6 +138,9 @@ private:
         if (m_cacheRecentFiles == listRecentFile)
             return;
 
+        for (auto it = m_storage->m_items.cbegin() + 2; it != m_storage->m_items.cend(); ++it)
+            QPixmapCache::remove(it->imageUrl);
+
         m_storage->m_items.erase(m_storage->m_items.begin() + 2, m_storage->m_items.end());
         auto fnToString = [=](const QDateTime& dateTime) {
             const QString strTime = dateTime.time().toString("HH:mm");
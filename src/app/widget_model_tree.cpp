@@ -12,19 +12,24 @@
 #include "../base/settings.h"
 #include "../base/string_utils.h"
 #include "../gui/gui_application.h"
+#include "document_name_indexer.h"
 #include "item_view_buttons.h"
 #include "theme.h"
 #include "widget_model_tree_builder.h"
 
 #include <QtCore/QtDebug>
 #include <QtCore/QMetaType>
+#include <QtCore/QTimer>
 #include <QtWidgets/QTreeWidget>
 #include <QtWidgets/QTreeWidgetItemIterator>
 
 #include <gsl/util>
+#include <algorithm>
 #include <cassert>
 #include <memory>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 Q_DECLARE_METATYPE(Mayo::DocumentPtr)
 Q_DECLARE_METATYPE(Mayo::DocumentTreeNode)
@@ -113,6 +118,61 @@ static void setTreeItemDocumentTreeNode(QTreeWidgetItem* treeItem, const Documen
     treeItem->setData(0, TreeItemDocumentTreeNodeRole, QVariant::fromValue(node));
 }
 
+static QTreeWidgetItem* findTreeItem(const QTreeWidget* treeWidget, const DocumentPtr& doc)
+{
+    for (int i = 0; i < treeWidget->topLevelItemCount(); ++i) {
+        QTreeWidgetItem* treeItem = treeWidget->topLevelItem(i);
+        if (Internal::treeItemDocument(treeItem) == doc)
+            return treeItem;
+    }
+
+    return nullptr;
+}
+
+// Finds the tree item mapped to 'node' by walking down the tree items of its ancestors
+// Function 'fnFetchChildren'(if any) is called for each tree item along that path, before its
+// children are looked up
+static QTreeWidgetItem* findTreeItem(
+        const QTreeWidget* treeWidget,
+        const DocumentTreeNode& node,
+        const std::function<void(QTreeWidgetItem*)>& fnFetchChildren)
+{
+    QTreeWidgetItem* treeItem = Internal::findTreeItem(treeWidget, node.document());
+    if (!treeItem)
+        return nullptr;
+
+    std::vector<TreeNodeId> vecAncestorId;
+    const Tree<TDF_Label>& modelTree = node.document()->modelTree();
+    for (TreeNodeId id = node.id(); id != 0; id = modelTree.nodeParent(id))
+        vecAncestorId.push_back(id);
+
+    auto fnIsAncestor = [&](TreeNodeId id) {
+        return std::find(vecAncestorId.cbegin(), vecAncestorId.cend(), id) != vecAncestorId.cend();
+    };
+    while (treeItem) {
+        if (fnFetchChildren)
+            fnFetchChildren(treeItem);
+
+        QTreeWidgetItem* treeItemNext = nullptr;
+        for (int i = 0; i < treeItem->childCount() && !treeItemNext; ++i) {
+            QTreeWidgetItem* treeItemChild = treeItem->child(i);
+            const TreeNodeId childNodeId = Internal::treeItemDocumentTreeNode(treeItemChild).id();
+            if (childNodeId == node.id())
+                return treeItemChild;
+
+            if (fnIsAncestor(childNodeId))
+                treeItemNext = treeItemChild;
+        }
+
+        treeItem = treeItemNext;
+    }
+
+    return nullptr;
+}
+
+// Maximum count of tree items shown as search results
+static constexpr int SearchMaxMatchCount = 500;
+
 static ApplicationItem toApplicationItem(const QTreeWidgetItem* treeItem)
 {
     const TreeItemType type = Internal::treeItemType(treeItem);
@@ -164,7 +224,23 @@ WidgetModelTree::WidgetModelTree(QWidget* widget)
         }
     });
 
+    QObject::connect(
+                m_ui->treeWidget_Model, &QTreeWidget::itemExpanded,
+                this, &WidgetModelTree::onTreeItemExpanded);
     this->connectTreeModelDataChanged(true);
+
+    // Search
+    m_nameIndexer = new DocumentNameIndexer(this);
+    m_timerSearch = new QTimer(this);
+    m_timerSearch->setSingleShot(true);
+    m_timerSearch->setInterval(150);
+    QObject::connect(m_ui->lineEdit_Search, &QLineEdit::textChanged, m_timerSearch, qOverload<>(&QTimer::start));
+    QObject::connect(m_timerSearch, &QTimer::timeout, this, &WidgetModelTree::applySearch);
+    QObject::connect(m_ui->btn_SearchIsolate, &QToolButton::toggled, this, &WidgetModelTree::applySearch);
+    QObject::connect(m_nameIndexer, &DocumentNameIndexer::indexChanged, this, [=]{
+        if (!m_ui->lineEdit_Search->text().isEmpty())
+            m_timerSearch->start();
+    });
 }
 
 WidgetModelTree::~WidgetModelTree()
@@ -269,6 +345,11 @@ void WidgetModelTree::setDocument(QTreeWidgetItem* treeItem, const DocumentPtr&
     Internal::setTreeItemDocument(treeItem, doc);
 }
 
+QTreeWidgetItem* WidgetModelTree::findTreeItem(const QTreeWidget* treeWidget, const DocumentTreeNode& node)
+{
+    return Internal::findTreeItem(treeWidget, node, {});
+}
+
 bool WidgetModelTree::holdsDocument(const QTreeWidgetItem* treeItem)
 {
     return Internal::treeItemType(treeItem) == Internal::TreeItemType_Document;
@@ -285,10 +366,19 @@ void WidgetModelTree::onDocumentAdded(const DocumentPtr& doc)
     Internal::setTreeItemDocument(treeItem, doc);
     Q_ASSERT(Internal::treeItemDocument(treeItem) == doc);
     m_ui->treeWidget_Model->addTopLevelItem(treeItem);
+    m_nameIndexer->addDocument(doc);
 }
 
 void WidgetModelTree::onDocumentAboutToClose(const DocumentPtr& doc)
 {
+    m_nameIndexer->removeDocument(doc);
+    // Don't keep 'doc' alive through search results
+    m_vecSearchMatchNode.erase(
+                std::remove_if(
+                    m_vecSearchMatchNode.begin(),
+                    m_vecSearchMatchNode.end(),
+                    [=](const DocumentTreeNode& node) { return node.document() == doc; }),
+                m_vecSearchMatchNode.end());
     delete this->findTreeItem(doc);
 }
 
@@ -299,6 +389,90 @@ void WidgetModelTree::onDocumentNameChanged(const DocumentPtr& doc, const QStrin
         this->findSupportBuilder(doc)->refreshTextTreeItem(doc, treeItem);
 }
 
+void WidgetModelTree::applySearch()
+{
+    QTreeWidget* treeWidget = m_ui->treeWidget_Model;
+
+    // Reset state of previous search, only the items it changed are visited
+    for (const DocumentTreeNode& node : m_vecSearchMatchNode) {
+        QTreeWidgetItem* treeItem = this->findTreeItem(node); // Item might have been destroyed
+        if (treeItem) {
+            QFont font = treeItem->font(0);
+            font.setBold(false);
+            treeItem->setFont(0, font);
+        }
+    }
+
+    m_vecSearchMatchNode.clear();
+    if (m_isSearchIsolateApplied) {
+        for (QTreeWidgetItemIterator it(treeWidget, QTreeWidgetItemIterator::Hidden); *it; ++it)
+            (*it)->setHidden(false);
+
+        m_isSearchIsolateApplied = false;
+    }
+
+    const QString pattern = m_ui->lineEdit_Search->text().trimmed();
+    if (pattern.isEmpty())
+        return;
+
+    // Tree items are created lazily, so only the ancestors of the matching nodes are expanded(which
+    // creates their child items), other parts of the tree are left untouched
+    auto fnExpandAncestorItem = [](QTreeWidgetItem* treeItem) { treeItem->setExpanded(true); };
+    std::unordered_set<QTreeWidgetItem*> setMatchItem;
+    QTreeWidgetItem* firstMatchItem = nullptr;
+    for (int i = 0; i < treeWidget->topLevelItemCount(); ++i) {
+        const DocumentPtr doc = Internal::treeItemDocument(treeWidget->topLevelItem(i));
+        const DocumentNameIndex* index = m_nameIndexer->index(doc);
+        if (!index)
+            continue;
+
+        const Tree<TDF_Label>& modelTree = doc->modelTree();
+        const int maxCount = Internal::SearchMaxMatchCount - int(setMatchItem.size());
+        for (TreeNodeId nodeId : index->findNodes(pattern, maxCount)) {
+            QTreeWidgetItem* treeItem = Internal::findTreeItem(treeWidget, { doc, nodeId }, fnExpandAncestorItem);
+            if (!treeItem && !modelTree.nodeIsRoot(nodeId)) { // Node might be merged in its parent item
+                const DocumentTreeNode parentNode(doc, modelTree.nodeParent(nodeId));
+                treeItem = Internal::findTreeItem(treeWidget, parentNode, fnExpandAncestorItem);
+            }
+
+            if (!treeItem || !setMatchItem.insert(treeItem).second)
+                continue;
+
+            QFont font = treeItem->font(0);
+            font.setBold(true);
+            treeItem->setFont(0, font);
+            m_vecSearchMatchNode.push_back(Internal::treeItemDocumentTreeNode(treeItem));
+            if (!firstMatchItem)
+                firstMatchItem = treeItem;
+        }
+    }
+
+    if (m_ui->btn_SearchIsolate->isChecked()) {
+        std::unordered_set<QTreeWidgetItem*> setAncestorItem;
+        for (QTreeWidgetItem* matchItem : setMatchItem) {
+            for (QTreeWidgetItem* parentItem = matchItem->parent(); parentItem; parentItem = parentItem->parent()) {
+                if (!setAncestorItem.insert(parentItem).second)
+                    break;
+            }
+        }
+
+        // Keep visible the matching items with their ancestors and descendants
+        for (QTreeWidgetItemIterator it(treeWidget); *it; ++it) {
+            QTreeWidgetItem* treeItem = *it;
+            bool isVisible = WidgetModelTree::holdsDocument(treeItem) || setAncestorItem.count(treeItem);
+            for (QTreeWidgetItem* item = treeItem; item && !isVisible; item = item->parent())
+                isVisible = setMatchItem.count(item) != 0;
+
+            treeItem->setHidden(!isVisible);
+        }
+
+        m_isSearchIsolateApplied = true;
+    }
+
+    if (firstMatchItem)
+        treeWidget->scrollToItem(firstMatchItem);
+}
+
 QTreeWidgetItem* WidgetModelTree::loadDocumentEntity(const DocumentTreeNode& node)
 {
     Expects(node.isEntity());
@@ -309,26 +483,28 @@ QTreeWidgetItem* WidgetModelTree::loadDocumentEntity(const DocumentTreeNode& nod
 
 QTreeWidgetItem* WidgetModelTree::findTreeItem(const DocumentPtr& doc) const
 {
-    for (int i = 0; i < m_ui->treeWidget_Model->topLevelItemCount(); ++i) {
-        QTreeWidgetItem* treeItem = m_ui->treeWidget_Model->topLevelItem(i);
-        if (Internal::treeItemDocument(treeItem) == doc)
-            return treeItem;
+    return Internal::findTreeItem(m_ui->treeWidget_Model, doc);
+}
+
+// If 'fetchChildren' is true then tree items not created yet along the path of 'node' are created,
+// otherwise the search stops at the first tree item whose children aren't created
+QTreeWidgetItem* WidgetModelTree::findTreeItem(const DocumentTreeNode& node, bool fetchChildren)
+{
+    if (fetchChildren) {
+        return Internal::findTreeItem(m_ui->treeWidget_Model, node, [=](QTreeWidgetItem* treeItem) {
+            this->fetchTreeItemChildren(treeItem);
+        });
     }
 
-    return nullptr;
+    return Internal::findTreeItem(m_ui->treeWidget_Model, node, {});
 }
 
-QTreeWidgetItem* WidgetModelTree::findTreeItem(const DocumentTreeNode& node) const
+void WidgetModelTree::fetchTreeItemChildren(QTreeWidgetItem* treeItem)
 {
-    QTreeWidgetItem* treeItemDoc = this->findTreeItem(node.document());
-    if (treeItemDoc) {
-        for (QTreeWidgetItemIterator it(treeItemDoc); *it; ++it) {
-            if (Internal::treeItemDocumentTreeNode(*it) == node)
-                return *it;
-        }
+    if (treeItem->childCount() == 0 && this->holdsDocumentTreeNode(treeItem)) {
+        const DocumentTreeNode node = Internal::treeItemDocumentTreeNode(treeItem);
+        this->findSupportBuilder(node)->fetchTreeItemChildren(node, treeItem);
     }
-
-    return nullptr;
 }
 
 WidgetModelTreeBuilder* WidgetModelTree::findSupportBuilder(const DocumentPtr& doc) const
@@ -408,7 +584,7 @@ void WidgetModelTree::onApplicationItemSelectionModelChanged(
             if (!appItem.isDocumentTreeNode())
                 continue;
 
-            QTreeWidgetItem* treeItem = this->findTreeItem(appItem.documentTreeNode());
+            QTreeWidgetItem* treeItem = this->findTreeItem(appItem.documentTreeNode(), on);
             if (!treeItem)
                 continue;
 
@@ -470,6 +646,11 @@ void WidgetModelTree::onTreeModelDataChanged(
     }
 }
 
+void WidgetModelTree::onTreeItemExpanded(QTreeWidgetItem* treeItem)
+{
+    this->fetchTreeItemChildren(treeItem);
+}
+
 void WidgetModelTree::onNodesVisibilityChanged(
         const GuiDocument* guiDoc, const std::unordered_map<TreeNodeId, Qt::CheckState>& mapNodeId)
 {
@@ -480,6 +661,7 @@ void WidgetModelTree::onNodesVisibilityChanged(
     this->connectTreeModelDataChanged(false);
     auto _ = gsl::finally([=]{ this->connectTreeModelDataChanged(true); });
 
+    // Only the tree items already created are updated, the others will query GuiDocument on creation
     auto localMapNodeId = mapNodeId;
     for (QTreeWidgetItemIterator it(treeItemDoc); *it; ++it) {
         QTreeWidgetItem* treeItem = *it;
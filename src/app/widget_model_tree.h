@@ -13,6 +13,7 @@
 #include <QtWidgets/QWidget>
 #include <functional>
 class QItemSelection;
+class QTimer;
 class QTreeWidget;
 class QTreeWidgetItem;
 
@@ -20,6 +21,7 @@ class QTreeWidgetItem;
 
 namespace Mayo {
 
+class DocumentNameIndexer;
 class GuiApplication;
 class WidgetModelTreeBuilder;
 
@@ -51,6 +53,10 @@ public:
     static void setDocumentTreeNode(QTreeWidgetItem* treeItem, const DocumentTreeNode& node);
     static void setDocument(QTreeWidgetItem* treeItem, const DocumentPtr& doc);
 
+    // Returns the tree item mapped to 'node', null if not created yet(tree items are created lazily)
+    // Lookup is done along the ancestors of 'node', there is no traversal of the whole tree widget
+    static QTreeWidgetItem* findTreeItem(const QTreeWidget* treeWidget, const DocumentTreeNode& node);
+
     static bool holdsDocument(const QTreeWidgetItem* treeItem);
     static bool holdsDocumentTreeNode(const QTreeWidgetItem* treeItem);
 
@@ -71,13 +77,17 @@ private:
 
     void onTreeModelDataChanged(
             const QModelIndex& topLeft, const QModelIndex& bottomRight, const QVector<int>& roles);
+    void onTreeItemExpanded(QTreeWidgetItem* treeItem);
     void onNodesVisibilityChanged(
             const GuiDocument* guiDoc, const std::unordered_map<TreeNodeId, Qt::CheckState>& mapNodeId);
 
+    void applySearch();
+
     QTreeWidgetItem* loadDocumentEntity(const DocumentTreeNode& entityNode);
 
     QTreeWidgetItem* findTreeItem(const DocumentPtr& doc) const;
-    QTreeWidgetItem* findTreeItem(const DocumentTreeNode& node) const;
+    QTreeWidgetItem* findTreeItem(const DocumentTreeNode& node, bool fetchChildren = false);
+    void fetchTreeItemChildren(QTreeWidgetItem* treeItem);
 
     WidgetModelTreeBuilder* findSupportBuilder(const DocumentPtr& doc) const;
     WidgetModelTreeBuilder* findSupportBuilder(const DocumentTreeNode& entityNode) const;
@@ -86,6 +96,10 @@ private:
     GuiApplication* m_guiApp = nullptr;
     std::vector<BuilderPtr> m_vecBuilder;
     QString m_refItemTextTemplate;
+    DocumentNameIndexer* m_nameIndexer = nullptr;
+    QTimer* m_timerSearch = nullptr;
+    std::vector<DocumentTreeNode> m_vecSearchMatchNode; // Items highlighted by current search
+    bool m_isSearchIsolateApplied = false;
     QMetaObject::Connection m_connTreeModelDataChanged;
     QMetaObject::Connection m_connTreeWidgetDocumentSelectionChanged;
 };
@@ -33,6 +33,11 @@ public:
     virtual QTreeWidgetItem* createTreeItem(const DocumentPtr& doc);
     virtual QTreeWidgetItem* createTreeItem(const DocumentTreeNode& node);
 
+    // Creates the child items of 'treeItem' which is mapped to 'node'
+    // Called when 'treeItem' is about to be expanded and has no children yet. Builders can create
+    // tree items lazily by setting QTreeWidgetItem::ShowIndicator on items having no children
+    virtual void fetchTreeItemChildren(const DocumentTreeNode& /*node*/, QTreeWidgetItem* /*treeItem*/) {}
+
     QTreeWidget* treeWidget() const { return m_treeWidget; }
     void setTreeWidget(QTreeWidget* tree) { m_treeWidget = tree; }
 
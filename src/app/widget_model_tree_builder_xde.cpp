@@ -1,6 +1,7 @@
 #include "widget_model_tree_builder_xde.h"
 
 #include "../base/application.h"
+#include "../base/application_item_selection_model.h"
 #include "../base/caf_utils.h"
 #include "../base/document.h"
 #include "../base/property_enumeration.h"
@@ -16,9 +17,6 @@
 #include <QtWidgets/QTreeWidget>
 #include <QtWidgets/QTreeWidgetItemIterator>
 
-#include <unordered_map>
-#include <unordered_set>
-
 namespace Mayo {
 
 class WidgetModelTreeBuilder_Xde::Module : public QObject, public PropertyGroup {
@@ -83,36 +81,56 @@ bool WidgetModelTreeBuilder_Xde::supportsDocumentTreeNode(const DocumentTreeNode
 void WidgetModelTreeBuilder_Xde::refreshTextTreeItem(
         const DocumentTreeNode& node, QTreeWidgetItem* treeItem)
 {
-    const TDF_Label labelNode = node.label();
-    TDF_LabelSequence seqLabelRefresh;
-    if (XCaf::isShapeReference(labelNode)
-            && m_module->instanceNameTemplate().contains("%product"))
-    {
-        XCAFDoc_ShapeTool::GetUsers(
-                    XCaf::shapeReferred(labelNode),
-                    seqLabelRefresh,
-                    false /* don't get sub children */);
-    }
-    else {
-        seqLabelRefresh.Append(labelNode);
-    }
+    this->refreshXdeAssemblyNodeItemText(treeItem);
 
-    for (const TDF_Label& labelRefresh : seqLabelRefresh) {
-        QTreeWidgetItem* treeItemLabel = this->findTreeItem(treeItem, labelRefresh);
-        if (treeItemLabel)
-            this->refreshXdeAssemblyNodeItemText(treeItemLabel);
+    // Refresh all occurrences of the product, including instances showing the product name
+    const DocumentPtr doc = node.document();
+    const TDF_Label labelProduct = ThisType::productLabel(node);
+    std::vector<TreeNodeId> vecNodeId = doc->productInstanceTreeNodes(labelProduct);
+    for (TreeNodeId productNodeId : doc->treeNodes(labelProduct))
+        vecNodeId.push_back(productNodeId);
+
+    for (TreeNodeId nodeId : vecNodeId) {
+        QTreeWidgetItem* treeItemRefresh = WidgetModelTree::findTreeItem(this->treeWidget(), { doc, nodeId });
+        if (treeItemRefresh && treeItemRefresh != treeItem)
+            this->refreshXdeAssemblyNodeItemText(treeItemRefresh);
     }
 }
 
 QTreeWidgetItem* WidgetModelTreeBuilder_Xde::createTreeItem(const DocumentTreeNode& node)
 {
     Expects(this->supportsDocumentTreeNode(node));
-    return this->buildXdeTree(nullptr, node);
+    // Child items are created on demand, see fetchTreeItemChildren()
+    return this->createXdeTreeItem(node, Qt::Checked);
+}
+
+void WidgetModelTreeBuilder_Xde::fetchTreeItemChildren(
+        const DocumentTreeNode& node, QTreeWidgetItem* treeItem)
+{
+    if (treeItem->childCount() > 0)
+        return;
+
+    const DocumentPtr doc = node.document();
+    const Tree<TDF_Label>& modelTree = doc->modelTree();
+    const GuiDocument* guiDoc = m_guiApp ? m_guiApp->findGuiDocument(doc) : nullptr;
+    QList<QTreeWidgetItem*> listChildItem;
+    const TreeNodeId contentNodeId = this->xdeContentTreeNodeId(node);
+    for (TreeNodeId childId = modelTree.nodeChildFirst(contentNodeId);
+         childId != 0;
+         childId = modelTree.nodeSiblingNext(childId))
+    {
+        const Qt::CheckState checkState = guiDoc ? guiDoc->nodeVisibleState(childId) : Qt::Checked;
+        listChildItem.push_back(this->createXdeTreeItem({ doc, childId }, checkState));
+    }
+
+    // Items are inserted in one go, this avoids a signal emission per item
+    treeItem->addChildren(listChildItem);
 }
 
 // BEWARE Not thread-safe, should be called from main(GUI) thread
 void WidgetModelTreeBuilder_Xde::registerGuiApplication(GuiApplication* guiApp)
 {
+    m_guiApp = guiApp;
     m_module = Module::get(guiApp->application());
     if (!m_module)
         m_module = new Module(guiApp->application());
@@ -136,80 +154,135 @@ WidgetModelTree_UserActions WidgetModelTreeBuilder_Xde::createUserActions(QObjec
         this->setInstanceNameFormat(action->data().toByteArray());
     });
 
+    // Actions on the product of the selected tree node
+    auto actionSeparator = new QAction(parent);
+    actionSeparator->setSeparator(true);
+    auto actionSelectInstances = new QAction(textId("Select all instances").tr(), parent);
+    auto actionIsolateProduct = new QAction(textId("Isolate product").tr(), parent);
+    QObject::connect(actionSelectInstances, &QAction::triggered, [=]{
+        const DocumentTreeNode node = this->selectedXdeTreeNode();
+        if (!node.isValid())
+            return;
+
+        std::vector<ApplicationItem> vecAppItem;
+        for (TreeNodeId nodeId : this->productOccurrenceTreeNodes(node))
+            vecAppItem.push_back(DocumentTreeNode(node.document(), nodeId));
+
+        m_guiApp->selectionModel()->add(vecAppItem);
+    });
+    QObject::connect(actionIsolateProduct, &QAction::triggered, [=]{
+        const DocumentTreeNode node = this->selectedXdeTreeNode();
+        GuiDocument* guiDoc = node.isValid() ? m_guiApp->findGuiDocument(node.document()) : nullptr;
+        if (!guiDoc)
+            return;
+
+        const DocumentPtr doc = node.document();
+        for (int i = 0; i < doc->entityCount(); ++i)
+            guiDoc->setNodeVisible(doc->entityTreeNodeId(i), false);
+
+        for (TreeNodeId nodeId : this->productOccurrenceTreeNodes(node))
+            guiDoc->setNodeVisible(nodeId, true);
+
+        guiDoc->graphicsScene()->redraw();
+    });
+
+    const std::vector<QAction*> vecActionNameFormat = userActions.items;
+    userActions.items.push_back(actionSeparator);
+    userActions.items.push_back(actionSelectInstances);
+    userActions.items.push_back(actionIsolateProduct);
     userActions.fnSyncItems = [=]{
-        for (QAction* action : userActions.items) {
+        for (QAction* action : vecActionNameFormat) {
             if (action->data().toByteArray() == this->instanceNameFormat())
                 action->setChecked(true);
         }
+
+        const bool hasSelectedXdeNode = this->selectedXdeTreeNode().isValid();
+        actionSelectInstances->setEnabled(hasSelectedXdeNode);
+        actionIsolateProduct->setEnabled(hasSelectedXdeNode);
     };
 
     return userActions;
 }
 
-QTreeWidgetItem* WidgetModelTreeBuilder_Xde::guiCreateXdeTreeNode(
-        QTreeWidgetItem* guiParentNode, const DocumentTreeNode& node)
+// Returns the first selected tree node supported by this builder, null if none
+DocumentTreeNode WidgetModelTreeBuilder_Xde::selectedXdeTreeNode() const
 {
-    auto guiNode = new QTreeWidgetItem(guiParentNode);
-    const QString stdName = CafUtils::labelAttrStdName(node.label());
-    guiNode->setText(0, stdName);
-    WidgetModelTree::setDocumentTreeNode(guiNode, node);
-    const QIcon icon = Module::shapeIcon(node.label());
-    if (!icon.isNull())
-        guiNode->setIcon(0, icon);
+    for (const ApplicationItem& appItem : m_guiApp->selectionModel()->selectedItems()) {
+        if (appItem.isDocumentTreeNode() && this->supportsDocumentTreeNode(appItem.documentTreeNode()))
+            return appItem.documentTreeNode();
+    }
 
-    return guiNode;
+    return DocumentTreeNode::null();
 }
 
-QTreeWidgetItem* WidgetModelTreeBuilder_Xde::buildXdeTree(
-        QTreeWidgetItem* treeItem, const DocumentTreeNode& node)
+// Returns the product label of 'node', this is the referred shape in case of XCAF reference
+TDF_Label WidgetModelTreeBuilder_Xde::productLabel(const DocumentTreeNode& node)
 {
-    Expects(node.isEntity());
+    const TDF_Label label = node.label();
+    return XCaf::isShapeReference(label) ? XCaf::shapeReferred(label) : label;
+}
 
-    std::unordered_map<TreeNodeId, QTreeWidgetItem*> mapNodeIdToTreeItem;
-    std::unordered_set<TreeNodeId> setReferenceNodeId;
+// Returns the tree nodes of the instances of the product of 'node', or the occurrences of the
+// product itself if it has no instance(eg top-level free shape)
+std::vector<TreeNodeId> WidgetModelTreeBuilder_Xde::productOccurrenceTreeNodes(const DocumentTreeNode& node)
+{
     const DocumentPtr doc = node.document();
-    const Tree<TDF_Label>& modelTree = doc->modelTree();
-    traverseTree(node.id(), modelTree, [&](TreeNodeId itNodeId) {
-        const TreeNodeId nodeParentId = modelTree.nodeParent(itNodeId);
-        auto itParentFound = mapNodeIdToTreeItem.find(nodeParentId);
-        QTreeWidgetItem* guiParentNode =
-                itParentFound != mapNodeIdToTreeItem.end() ? itParentFound->second : treeItem;
-        if (m_isMergeXdeReferredShapeOn) {
-            const TDF_Label& nodeLabel = modelTree.nodeData(itNodeId);
-            if (XCaf::isShapeReference(nodeLabel)) {
-                mapNodeIdToTreeItem[itNodeId] = guiParentNode;
-                setReferenceNodeId.insert(itNodeId);
-            }
-            else {
-                auto guiNode = new QTreeWidgetItem(guiParentNode);
-                QString guiNodeText = CafUtils::labelAttrStdName(nodeLabel);
-                TreeNodeId guiNodeId = itNodeId;
-                if (setReferenceNodeId.find(nodeParentId) != setReferenceNodeId.cend()) {
-                    const TDF_Label& refLabel = modelTree.nodeData(nodeParentId);
-                    guiNodeText = this->referenceItemText(refLabel, nodeLabel);
-                    guiNodeId = nodeParentId;
-                    if (!guiParentNode)
-                        mapNodeIdToTreeItem[nodeParentId] = guiNode;
-                }
-
-                guiNode->setText(0, guiNodeText);
-                WidgetModelTree::setDocumentTreeNode(guiNode, DocumentTreeNode(doc, guiNodeId));
-                const QIcon icon = Module::shapeIcon(nodeLabel);
-                if (!icon.isNull())
-                    guiNode->setIcon(0, icon);
-
-                guiNode->setFlags(guiNode->flags() | Qt::ItemIsUserCheckable);
-                guiNode->setCheckState(0, Qt::Checked);
-                mapNodeIdToTreeItem[itNodeId] = guiNode;
-            }
-        }
-        else {
-            auto guiNode = ThisType::guiCreateXdeTreeNode(guiParentNode, { doc, itNodeId });
-            mapNodeIdToTreeItem[itNodeId] = guiNode;
-        }
-    });
+    const TDF_Label labelProduct = ThisType::productLabel(node);
+    std::vector<TreeNodeId> vecNodeId = doc->productInstanceTreeNodes(labelProduct);
+    if (vecNodeId.empty()) {
+        for (TreeNodeId nodeId : doc->treeNodes(labelProduct))
+            vecNodeId.push_back(nodeId);
+    }
+
+    return vecNodeId;
+}
+
+// Creates a detached tree item for 'node', children are not created
+QTreeWidgetItem* WidgetModelTreeBuilder_Xde::createXdeTreeItem(
+        const DocumentTreeNode& node, Qt::CheckState checkState) const
+{
+    const Tree<TDF_Label>& modelTree = node.document()->modelTree();
+    const TDF_Label& nodeLabel = node.label();
+    const TreeNodeId contentNodeId = this->xdeContentTreeNodeId(node);
+    auto treeItem = new QTreeWidgetItem;
+    QIcon icon;
+    if (contentNodeId != node.id()) {
+        // Reference merged with its referred shape
+        const TDF_Label& productLabel = modelTree.nodeData(contentNodeId);
+        treeItem->setText(0, this->referenceItemText(nodeLabel, productLabel));
+        icon = Module::shapeIcon(productLabel);
+    }
+    else {
+        treeItem->setText(0, CafUtils::labelAttrStdName(nodeLabel));
+        icon = Module::shapeIcon(nodeLabel);
+    }
+
+    WidgetModelTree::setDocumentTreeNode(treeItem, node);
+    if (!icon.isNull())
+        treeItem->setIcon(0, icon);
 
-    return mapNodeIdToTreeItem.find(node.id())->second;
+    if (m_isMergeXdeReferredShapeOn) {
+        treeItem->setFlags(treeItem->flags() | Qt::ItemIsUserCheckable);
+        treeItem->setCheckState(0, checkState);
+    }
+
+    if (!modelTree.nodeIsLeaf(contentNodeId))
+        treeItem->setChildIndicatorPolicy(QTreeWidgetItem::ShowIndicator);
+
+    return treeItem;
+}
+
+// Returns the identifier of the tree node providing the children of the item mapped to 'node'
+// This is 'node' itself unless it's a reference to be merged with its referred shape
+TreeNodeId WidgetModelTreeBuilder_Xde::xdeContentTreeNodeId(const DocumentTreeNode& node) const
+{
+    if (m_isMergeXdeReferredShapeOn && XCaf::isShapeReference(node.label())) {
+        const TreeNodeId referredNodeId = node.document()->modelTree().nodeChildFirst(node.id());
+        if (referredNodeId != 0)
+            return referredNodeId;
+    }
+
+    return node.id();
 }
 
 QByteArray WidgetModelTreeBuilder_Xde::instanceNameFormat() const
@@ -232,6 +305,7 @@ void WidgetModelTreeBuilder_Xde::setInstanceNameFormat(const QByteArray& format)
 std::unique_ptr<WidgetModelTreeBuilder> WidgetModelTreeBuilder_Xde::clone() const
 {
     auto builder = std::make_unique<WidgetModelTreeBuilder_Xde>();
+    builder->m_guiApp = this->m_guiApp;
     builder->m_module = this->m_module;
     builder->m_isMergeXdeReferredShapeOn = this->m_isMergeXdeReferredShapeOn;
     return builder;
@@ -264,19 +338,4 @@ QString WidgetModelTreeBuilder_Xde::referenceItemText(
     return itemText;
 }
 
-QTreeWidgetItem* WidgetModelTreeBuilder_Xde::findTreeItem(
-        QTreeWidgetItem* parentTreeItem, const TDF_Label& label) const
-{
-    if (!parentTreeItem)
-        return nullptr;
-
-    for (QTreeWidgetItemIterator it(parentTreeItem); *it; ++it) {
-        const DocumentTreeNode node = WidgetModelTree::documentTreeNode(*it);
-        if (node.label() == label)
-            return *it;
-    }
-
-    return nullptr;
-}
-
 } // namespace Mayo
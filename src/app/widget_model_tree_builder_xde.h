@@ -17,6 +17,7 @@ public:
     bool supportsDocumentTreeNode(const DocumentTreeNode& node) const override;
     void refreshTextTreeItem(const DocumentTreeNode& node, QTreeWidgetItem* treeItem) override;
     QTreeWidgetItem* createTreeItem(const DocumentTreeNode& node) override;
+    void fetchTreeItemChildren(const DocumentTreeNode& node, QTreeWidgetItem* treeItem) override;
 
     void registerGuiApplication(GuiApplication* guiApp) override;
     WidgetModelTree_UserActions createUserActions(QObject* parent) override;
@@ -28,17 +29,19 @@ private:
 
     using ThisType = WidgetModelTreeBuilder_Xde;
 
-    static QTreeWidgetItem* guiCreateXdeTreeNode(
-            QTreeWidgetItem* guiParentNode, const DocumentTreeNode& node);
+    QTreeWidgetItem* createXdeTreeItem(const DocumentTreeNode& node, Qt::CheckState checkState) const;
+    TreeNodeId xdeContentTreeNodeId(const DocumentTreeNode& node) const;
+    DocumentTreeNode selectedXdeTreeNode() const;
+    static TDF_Label productLabel(const DocumentTreeNode& node);
+    static std::vector<TreeNodeId> productOccurrenceTreeNodes(const DocumentTreeNode& node);
 
-    QTreeWidgetItem* buildXdeTree(QTreeWidgetItem* treeItem, const DocumentTreeNode& node);
     void refreshXdeAssemblyNodeItemText(QTreeWidgetItem* item);
     QString referenceItemText(const TDF_Label& instanceLabel, const TDF_Label& productLabel) const;
-    QTreeWidgetItem* findTreeItem(QTreeWidgetItem* parentTreeItem, const TDF_Label& label) const;
 
     QByteArray instanceNameFormat() const;
     void setInstanceNameFormat(const QByteArray& format);
 
+    GuiApplication* m_guiApp = nullptr;
     Module* m_module = nullptr;
     bool m_isMergeXdeReferredShapeOn = true;
 };
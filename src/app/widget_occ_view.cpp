@@ -6,7 +6,9 @@
 
 #include "widget_occ_view.h"
 #include "occt_window.h"
+#include "../gui/gui_render_stats.h"
 
+#include <QtCore/QElapsedTimer>
 #include <QtGui/QResizeEvent>
 
 namespace Mayo {
@@ -47,7 +49,15 @@ void WidgetOccView::showEvent(QShowEvent*)
 
 void WidgetOccView::paintEvent(QPaintEvent*)
 {
+    if (!m_renderStats) {
+        m_view->Redraw();
+        return;
+    }
+
+    QElapsedTimer chrono;
+    chrono.start();
     m_view->Redraw();
+    m_renderStats->recordFrame(m_view, chrono.nsecsElapsed() / 1000000.);
 }
 
 void WidgetOccView::resizeEvent(QResizeEvent* event)
@@ -11,6 +11,8 @@
 
 namespace Mayo {
 
+class GuiRenderStats;
+
 //! Qt wrapper around the V3d_View class
 //! WidgetOccView does not handle input devices interaction like keyboard and mouse
 class WidgetOccView : public QWidget {
@@ -20,6 +22,9 @@ public:
 
     const Handle_V3d_View& v3dView() const;
 
+    // Frames rendered by paintEvent() are recorded into 'stats'(if not null)
+    void setRenderStats(GuiRenderStats* stats) { m_renderStats = stats; }
+
     QPaintEngine* paintEngine() const override;
 
 protected:
@@ -29,6 +34,7 @@ protected:
 
 private:
     Handle_V3d_View m_view;
+    GuiRenderStats* m_renderStats = nullptr;
 };
 
 } // namespace Mayo
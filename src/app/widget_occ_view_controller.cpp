@@ -157,7 +157,7 @@ bool WidgetOccViewController::eventFilter(QObject* watched, QEvent* event)
             this->drawRubberBand(m_posRubberBandStart, currPos);
         }
         else {
-            emit mouseMoved(currPos);
+            this->notifyMouseMoved(currPos);
         }
 
         break;
@@ -7,6 +7,9 @@
 #include "widget_properties_editor.h"
 #include "ui_widget_properties_editor.h"
 
+#include <QtCore/QTimer>
+#include <deque>
+#include <unordered_map>
 #include <vector>
 
 namespace Mayo {
@@ -17,16 +20,20 @@ struct WidgetPropertiesEditor::Group {
 
 class WidgetPropertiesEditor::Private {
 public:
-    void createQtProperty(Property* property, QTreeWidgetItem* parentItem);
+    QTreeWidgetItem* createQtProperty(Property* property, QTreeWidgetItem* parentItem);
+    void addQtProperties(Span<Property* const> spanProperty, QTreeWidgetItem* parentItem);
     QTreeWidgetItem* addLineWidgetItem(QWidget* widget, int height);
     QTreeWidgetItem* findTreeItem(const Property* property) const;
     bool hasGroup(const WidgetPropertiesEditor::Group* group) const;
+    static bool isPropertyItem(const QTreeWidgetItem* treeItem);
 
     Ui_WidgetPropertiesEditor* ui = nullptr;
     PropertyItemDelegate* itemDelegate = nullptr;
-    std::vector<Property*> vecProperty;
+    QTimer* timerResizeColumns = nullptr;
+    std::unordered_map<const Property*, QTreeWidgetItem*> mapPropertyTreeItem;
+    std::vector<QTreeWidgetItem*> vecRecycledTreeItem; // Detached property items, ready for reuse
     std::vector<QWidget*> vecLineWidget;
-    std::vector<WidgetPropertiesEditor::Group> vecGroup;
+    std::deque<WidgetPropertiesEditor::Group> vecGroup; // deque: pointers returned by addGroup() stay valid
 };
 
 WidgetPropertiesEditor::WidgetPropertiesEditor(QWidget *parent)
@@ -40,10 +47,22 @@ WidgetPropertiesEditor::WidgetPropertiesEditor(QWidget *parent)
     d->ui->treeWidget_Browser->setRootIsDecorated(false);
     d->itemDelegate = new PropertyItemDelegate(d->ui->treeWidget_Browser);
     d->ui->treeWidget_Browser->setItemDelegate(d->itemDelegate);
+
+    // Columns are resized once after a batch of edit*() calls, not on each call
+    d->timerResizeColumns = new QTimer(this);
+    d->timerResizeColumns->setSingleShot(true);
+    d->timerResizeColumns->setInterval(0);
+    QObject::connect(d->timerResizeColumns, &QTimer::timeout, this, [=]{
+        d->ui->treeWidget_Browser->resizeColumnToContents(0);
+        d->ui->treeWidget_Browser->resizeColumnToContents(1);
+    });
 }
 
 WidgetPropertiesEditor::~WidgetPropertiesEditor()
 {
+    for (QTreeWidgetItem* treeItem : d->vecRecycledTreeItem)
+        delete treeItem;
+
     delete d->ui;
     delete d;
 }
@@ -71,11 +90,8 @@ void WidgetPropertiesEditor::editProperties(PropertyGroup* propGroup, Group* grp
     if (propGroup) {
         d->ui->stack_Browser->setCurrentWidget(d->ui->page_BrowserDetails);
         QTreeWidgetItem* parentTreeItem = d->hasGroup(grp) ? grp->treeItem : nullptr;
-        for (Property* prop : propGroup->properties())
-            d->createQtProperty(prop, parentTreeItem);
-
-        d->ui->treeWidget_Browser->resizeColumnToContents(0);
-        d->ui->treeWidget_Browser->resizeColumnToContents(1);
+        d->addQtProperties(propGroup->properties(), parentTreeItem);
+        d->timerResizeColumns->start();
     }
 }
 
@@ -84,18 +100,30 @@ void WidgetPropertiesEditor::editProperty(Property* prop, Group* grp)
     if (prop) {
         d->ui->stack_Browser->setCurrentWidget(d->ui->page_BrowserDetails);
         QTreeWidgetItem* parentTreeItem = d->hasGroup(grp) ? grp->treeItem : nullptr;
-        d->createQtProperty(prop, parentTreeItem);
-        d->ui->treeWidget_Browser->resizeColumnToContents(0);
-        d->ui->treeWidget_Browser->resizeColumnToContents(1);
+        d->addQtProperties(Span<Property* const>(&prop, 1), parentTreeItem);
+        d->timerResizeColumns->start();
     }
 }
 
 void WidgetPropertiesEditor::clear()
 {
-    d->vecProperty.clear();
+    // Property items are detached(one batch per parent) and recycled by next edit*() calls, other
+    // items(groups, line widgets) are deleted
+    QTreeWidget* treeWidget = d->ui->treeWidget_Browser;
+    for (const Group& grp : d->vecGroup) {
+        for (QTreeWidgetItem* treeItem : grp.treeItem->takeChildren())
+            d->vecRecycledTreeItem.push_back(treeItem);
+    }
+
+    for (int i = treeWidget->topLevelItemCount() - 1; i >= 0; --i) {
+        if (Private::isPropertyItem(treeWidget->topLevelItem(i)))
+            d->vecRecycledTreeItem.push_back(treeWidget->takeTopLevelItem(i));
+    }
+
+    d->mapPropertyTreeItem.clear();
     d->vecLineWidget.clear();
     d->vecGroup.clear();
-    d->ui->treeWidget_Browser->clear();
+    treeWidget->clear();
 }
 
 void WidgetPropertiesEditor::setPropertyEnabled(const Property* prop, bool on)
@@ -109,6 +137,16 @@ void WidgetPropertiesEditor::setPropertyEnabled(const Property* prop, bool on)
     }
 }
 
+void WidgetPropertiesEditor::refreshProperty(const Property* prop)
+{
+    QTreeWidgetItem* treeItem = d->findTreeItem(prop);
+    if (treeItem) {
+        this->setPropertyEnabled(prop, prop->isEnabled());
+        QTreeWidget* treeWidget = d->ui->treeWidget_Browser;
+        treeWidget->viewport()->update(treeWidget->visualItemRect(treeItem));
+    }
+}
+
 void WidgetPropertiesEditor::setPropertySelectable(const Property* prop, bool on)
 {
     QTreeWidgetItem* treeItem = d->findTreeItem(prop);
@@ -152,19 +190,41 @@ bool WidgetPropertiesEditor::overridePropertyUnitTranslation(
     return d->itemDelegate->overridePropertyUnitTranslation(prop, unitTr);
 }
 
-void WidgetPropertiesEditor::Private::createQtProperty(
+QTreeWidgetItem* WidgetPropertiesEditor::Private::createQtProperty(
         Property* property, QTreeWidgetItem* parentItem)
 {
-    this->vecProperty.push_back(property);
-    auto itemProp = new QTreeWidgetItem;
+    QTreeWidgetItem* itemProp = nullptr;
+    if (!this->vecRecycledTreeItem.empty()) {
+        itemProp = this->vecRecycledTreeItem.back();
+        this->vecRecycledTreeItem.pop_back();
+    }
+    else {
+        itemProp = new QTreeWidgetItem;
+    }
+
+    // Item is detached, so modifications below don't trigger any view update
     const QString labelSpacer = parentItem ? "       " : "";
     itemProp->setText(0, labelSpacer + property->label());
     itemProp->setData(1, Qt::DisplayRole, QVariant::fromValue<Property*>(property));
-    itemProp->setFlags(Qt::ItemIsSelectable | Qt::ItemIsEnabled | Qt::ItemIsEditable);
+    const Qt::ItemFlag flagEnabled = property->isEnabled() ? Qt::ItemIsEnabled : Qt::NoItemFlags;
+    itemProp->setFlags(Qt::ItemIsSelectable | Qt::ItemIsEditable | flagEnabled);
+    this->mapPropertyTreeItem.insert({ property, itemProp });
+    return itemProp;
+}
+
+void WidgetPropertiesEditor::Private::addQtProperties(
+        Span<Property* const> spanProperty, QTreeWidgetItem* parentItem)
+{
+    QList<QTreeWidgetItem*> listTreeItem;
+    listTreeItem.reserve(int(spanProperty.size()));
+    for (Property* prop : spanProperty)
+        listTreeItem.push_back(this->createQtProperty(prop, parentItem));
+
+    // Items are inserted in a single batch, view is notified only once
     if (parentItem)
-        parentItem->addChild(itemProp);
+        parentItem->addChildren(listTreeItem);
     else
-        this->ui->treeWidget_Browser->addTopLevelItem(itemProp);
+        this->ui->treeWidget_Browser->addTopLevelItems(listTreeItem);
 }
 
 QTreeWidgetItem* WidgetPropertiesEditor::Private::addLineWidgetItem(QWidget* widget, int height)
@@ -184,16 +244,8 @@ QTreeWidgetItem* WidgetPropertiesEditor::Private::addLineWidgetItem(QWidget* wid
 
 QTreeWidgetItem* WidgetPropertiesEditor::Private::findTreeItem(const Property* property) const
 {
-    for (QTreeWidgetItemIterator it(this->ui->treeWidget_Browser); *it; ++it) {
-        QTreeWidgetItem* treeItem = *it;
-        const QVariant value = treeItem->data(1, Qt::DisplayRole);
-        if (value.canConvert<Property*>()
-                && qvariant_cast<Property*>(value) == property)
-        {
-            return treeItem;
-        }
-    }
-    return nullptr;
+    auto itFound = this->mapPropertyTreeItem.find(property);
+    return itFound != this->mapPropertyTreeItem.cend() ? itFound->second : nullptr;
 }
 
 bool WidgetPropertiesEditor::Private::hasGroup(const Group *group) const
@@ -203,4 +255,10 @@ bool WidgetPropertiesEditor::Private::hasGroup(const Group *group) const
             && group->treeItem->treeWidget() == ui->treeWidget_Browser;
 }
 
+bool WidgetPropertiesEditor::Private::isPropertyItem(const QTreeWidgetItem* treeItem)
+{
+    const QVariant value = treeItem->data(1, Qt::DisplayRole);
+    return value.canConvert<Property*>() && qvariant_cast<Property*>(value) != nullptr;
+}
+
 } // namespace Mayo
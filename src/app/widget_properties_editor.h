@@ -29,6 +29,8 @@ public:
     void clear();
 
     void setPropertyEnabled(const Property* prop, bool on);
+    // Updates the view after value or "enabled" status of 'prop' was changed outside of the editor
+    void refreshProperty(const Property* prop);
     void setPropertySelectable(const Property* prop, bool on);
 
     void addLineSpacer(int height);
@@ -0,0 +1,272 @@
+/****************************************************************************
+** Copyright (c) 2021, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#include "bom_report.h"
+
+#include "bnd_utils.h"
+#include "caf_utils.h"
+#include "document.h"
+#include "math_utils.h"
+#include "task_progress.h"
+#include "tkernel_utils.h"
+#include "xcaf.h"
+
+#include <BRepBndLib.hxx>
+#include <OSD_Parallel.hxx>
+#include <QtCore/QIODevice>
+#include <QtCore/QTextStream>
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+
+namespace Mayo {
+
+namespace Internal {
+
+// Count of products processed between two progress/abort checks
+static constexpr int BomComputeChunkSize = 256;
+
+// Portion of the progress allocated to the computation of mass properties
+static constexpr double BomMassPropertiesProgressSize = 80.;
+
+static QString csvField(const QString& str)
+{
+    if (!str.contains(QLatin1Char(',')) && !str.contains(QLatin1Char('"')) && !str.contains(QLatin1Char('\n')))
+        return str;
+
+    QString field = str;
+    field.replace(QLatin1String("\""), QLatin1String("\"\""));
+    return QLatin1Char('"') + field + QLatin1Char('"');
+}
+
+static QString jsonString(const QString& str)
+{
+    QString json;
+    json.reserve(str.size() + 2);
+    json += QLatin1Char('"');
+    for (const QChar c : str) {
+        switch (c.unicode()) {
+        case '"': json += QLatin1String("\\\""); break;
+        case '\\': json += QLatin1String("\\\\"); break;
+        case '\b': json += QLatin1String("\\b"); break;
+        case '\f': json += QLatin1String("\\f"); break;
+        case '\n': json += QLatin1String("\\n"); break;
+        case '\r': json += QLatin1String("\\r"); break;
+        case '\t': json += QLatin1String("\\t"); break;
+        default:
+            if (c.unicode() < 0x20)
+                json += QString("\\u%1").arg(int(c.unicode()), 4, 16, QLatin1Char('0'));
+            else
+                json += c;
+        }
+    }
+
+    json += QLatin1Char('"');
+    return json;
+}
+
+} // namespace Internal
+
+BomReport::Snapshot BomReport::snapshot(const DocumentPtr& doc)
+{
+    Snapshot snapshot;
+    if (!doc || !doc->isXCafDocument())
+        return snapshot;
+
+    // Gather unique products along with their instance count
+    // Tree nodes of references are skipped, referred product is the single child node
+    std::unordered_map<TDF_Label, int> mapProductRowIndex;
+    std::vector<TDF_Label> vecProductLabel;
+    const Tree<TDF_Label>& modelTree = doc->modelTree();
+    traverseTree(modelTree, [&](TreeNodeId nodeId) {
+        const TDF_Label& label = modelTree.nodeData(nodeId);
+        if (!XCaf::isShape(label) || XCaf::isShapeReference(label))
+            return;
+
+        auto [it, isNewProduct] = mapProductRowIndex.insert({ label, int(snapshot.vecRow.size()) });
+        if (isNewProduct) {
+            Row row;
+            row.product = label;
+            row.name = CafUtils::labelAttrStdName(label);
+            row.isAssembly = XCaf::isShapeAssembly(label);
+            row.hasColor = doc->xcaf().hasShapeColor(label);
+            if (row.hasColor)
+                row.color = doc->xcaf().shapeColor(label);
+
+            snapshot.vecRow.push_back(std::move(row));
+            // Assembly shape is the compound of its components, already accounted by their rows
+            snapshot.vecShape.push_back(XCaf::isShapeAssembly(label) ? TopoDS_Shape() : XCaf::shape(label));
+            if (!XCaf::isShapeAssembly(label))
+                vecProductLabel.push_back(label);
+        }
+
+        ++snapshot.vecRow.at(it->second).instanceCount;
+    });
+
+    // Products already computed(eg displayed in the properties panel) are taken from the cache
+    snapshot.massPropsProducts = doc->massPropertiesCache().findProductsToCompute(vecProductLabel);
+    return snapshot;
+}
+
+std::vector<BomReport::Row> BomReport::compute(
+        Snapshot snapshot, MassPropertiesCache* massPropsCache, TaskProgress* progress)
+{
+    std::vector<Row>& vecRow = snapshot.vecRow;
+    const std::vector<TopoDS_Shape>& vecShape = snapshot.vecShape;
+    if (massPropsCache) {
+        TaskProgress massPropsProgress(progress, Internal::BomMassPropertiesProgressSize);
+        massPropsCache->computeProducts(snapshot.massPropsProducts, &massPropsProgress);
+    }
+
+    if (TaskProgress::isAbortRequested(progress))
+        return {};
+
+    for (Row& row : vecRow) {
+        if (!row.isAssembly && massPropsCache)
+            massPropsCache->findProperties(row.product, &row.massProperties);
+    }
+
+    const int productCount = int(std::min(vecRow.size(), vecShape.size()));
+    const int progressStart = progress ? progress->value() : 0;
+    for (int iFirst = 0; iFirst < productCount; iFirst += Internal::BomComputeChunkSize) {
+        if (TaskProgress::isAbortRequested(progress))
+            return {};
+
+        const int iEnd = std::min(iFirst + Internal::BomComputeChunkSize, productCount);
+        OSD_Parallel::For(iFirst, iEnd, [&](int i) {
+            if (!vecShape.at(i).IsNull())
+                BRepBndLib::Add(vecShape.at(i), vecRow.at(i).bndBox);
+        });
+        if (progress)
+            progress->setValue(MathUtils::mappedValue(iEnd, 0, productCount, progressStart, 100));
+    }
+
+    return std::move(vecRow);
+}
+
+std::vector<BomReport::Row> BomReport::compute(const DocumentPtr& doc, TaskProgress* progress)
+{
+    if (!doc)
+        return {};
+
+    return BomReport::compute(BomReport::snapshot(doc), &doc->massPropertiesCache(), progress);
+}
+
+BomReport::Format BomReport::findFormat(const FilePath& fp)
+{
+    const QString suffix = filepathTo<QString>(fp.extension()).toLower();
+    if (suffix == ".csv")
+        return Format::Csv;
+    else if (suffix == ".json")
+        return Format::Json;
+
+    return Format::None;
+}
+
+bool BomReport::write(
+        QIODevice* device, Format format, Span<const Row> spanRow, const WriteOptions& options)
+{
+    if (!device || format == Format::None)
+        return false;
+
+    QTextStream stream(device);
+    stream.setCodec("UTF-8");
+    auto fnLength = [&](double v) {
+        return QString::number(UnitSystem::translate(options.schema, v, Unit::Length).value, 'f', options.decimalCount);
+    };
+    auto fnArea = [&](QuantityArea area) {
+        return QString::number(UnitSystem::translate(options.schema, area).value, 'f', options.decimalCount);
+    };
+    auto fnVolume = [&](QuantityVolume volume) {
+        return QString::number(UnitSystem::translate(options.schema, volume).value, 'f', options.decimalCount);
+    };
+    // Inertia is computed with unit density, so it's expressed in length^5
+    const double lengthFactor = UnitSystem::translate(options.schema, 0., Unit::Length).factor;
+    auto fnInertia = [&](double v) {
+        return QString::number(v / std::pow(lengthFactor, 5), 'g', options.decimalCount + 3);
+    };
+    auto fnColor = [](const Row& row) {
+        return row.hasColor ? QString::fromStdString(TKernelUtils::colorToHex(row.color)) : QString();
+    };
+    const QString strLengthUnit = QString::fromUtf8(UnitSystem::translate(options.schema, 0., Unit::Length).strUnit);
+    const QString strAreaUnit = QString::fromUtf8(UnitSystem::translate(options.schema, 0., Unit::Area).strUnit);
+    const QString strVolumeUnit = QString::fromUtf8(UnitSystem::translate(options.schema, 0., Unit::Volume).strUnit);
+    const QString strInertiaUnit = strLengthUnit + QLatin1String("^5");
+
+    if (format == Format::Csv) {
+        stream << "Name,Assembly,Instances,"
+               << "Volume(" << strVolumeUnit << "),Area(" << strAreaUnit << "),"
+               << "CentroidX(" << strLengthUnit << "),CentroidY(" << strLengthUnit << "),CentroidZ(" << strLengthUnit << "),"
+               << "Inertia1(" << strInertiaUnit << "),Inertia2(" << strInertiaUnit << "),Inertia3(" << strInertiaUnit << "),"
+               << "BndBoxMinX(" << strLengthUnit << "),BndBoxMinY(" << strLengthUnit << "),BndBoxMinZ(" << strLengthUnit << "),"
+               << "BndBoxMaxX(" << strLengthUnit << "),BndBoxMaxY(" << strLengthUnit << "),BndBoxMaxZ(" << strLengthUnit << "),"
+               << "Color\n";
+        for (const Row& row : spanRow) {
+            stream << Internal::csvField(row.name) << ','
+                   << (row.isAssembly ? "yes" : "no") << ','
+                   << row.instanceCount << ',';
+            if (row.massProperties.isValid && !row.bndBox.IsVoid()) {
+                const MassProperties& props = row.massProperties;
+                const BndBoxCoords bbc = BndBoxCoords::get(row.bndBox);
+                const std::array<double, 3> moments = props.principalMoments();
+                stream << fnVolume(props.volume) << ',' << fnArea(props.area) << ','
+                       << fnLength(props.centroid.X()) << ',' << fnLength(props.centroid.Y()) << ',' << fnLength(props.centroid.Z()) << ','
+                       << fnInertia(moments.at(0)) << ',' << fnInertia(moments.at(1)) << ',' << fnInertia(moments.at(2)) << ','
+                       << fnLength(bbc.xmin) << ',' << fnLength(bbc.ymin) << ',' << fnLength(bbc.zmin) << ','
+                       << fnLength(bbc.xmax) << ',' << fnLength(bbc.ymax) << ',' << fnLength(bbc.zmax) << ',';
+            }
+            else {
+                stream << ",,,,,,,,,,,,,,";
+            }
+
+            stream << fnColor(row) << '\n';
+        }
+    }
+    else if (format == Format::Json) {
+        auto fnJsonPoint = [&](double x, double y, double z) {
+            return QString("[%1, %2, %3]").arg(fnLength(x), fnLength(y), fnLength(z));
+        };
+        stream << "{\n"
+               << "  \"units\": { "
+               << "\"length\": " << Internal::jsonString(strLengthUnit) << ", "
+               << "\"area\": " << Internal::jsonString(strAreaUnit) << ", "
+               << "\"volume\": " << Internal::jsonString(strVolumeUnit) << ", "
+               << "\"inertia\": " << Internal::jsonString(strInertiaUnit) << " },\n"
+               << "  \"products\": [";
+        bool isFirstRow = true;
+        for (const Row& row : spanRow) {
+            stream << (isFirstRow ? "\n" : ",\n");
+            isFirstRow = false;
+            stream << "    { \"name\": " << Internal::jsonString(row.name)
+                   << ", \"assembly\": " << (row.isAssembly ? "true" : "false")
+                   << ", \"instanceCount\": " << row.instanceCount;
+            if (row.massProperties.isValid && !row.bndBox.IsVoid()) {
+                const MassProperties& props = row.massProperties;
+                const BndBoxCoords bbc = BndBoxCoords::get(row.bndBox);
+                const std::array<double, 3> moments = props.principalMoments();
+                stream << ", \"volume\": " << fnVolume(props.volume)
+                       << ", \"area\": " << fnArea(props.area)
+                       << ", \"centroid\": " << fnJsonPoint(props.centroid.X(), props.centroid.Y(), props.centroid.Z())
+                       << ", \"principalInertia\": ["
+                       << fnInertia(moments.at(0)) << ", " << fnInertia(moments.at(1)) << ", " << fnInertia(moments.at(2)) << ']'
+                       << ", \"boundingBox\": { \"min\": " << fnJsonPoint(bbc.xmin, bbc.ymin, bbc.zmin)
+                       << ", \"max\": " << fnJsonPoint(bbc.xmax, bbc.ymax, bbc.zmax) << " }";
+            }
+
+            if (row.hasColor)
+                stream << ", \"color\": " << Internal::jsonString(fnColor(row));
+
+            stream << " }";
+        }
+
+        stream << "\n  ]\n}\n";
+    }
+
+    stream.flush();
+    return stream.status() == QTextStream::Ok;
+}
+
+} // namespace Mayo
@@ -0,0 +1,85 @@
+/****************************************************************************
+** Copyright (c) 2021, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#pragma once
+
+#include "document_ptr.h"
+#include "filepath.h"
+#include "mass_properties.h"
+#include "quantity.h"
+#include "span.h"
+#include "unit_system.h"
+
+#include <Bnd_Box.hxx>
+#include <Quantity_Color.hxx>
+#include <TDF_Label.hxx>
+#include <TopoDS_Shape.hxx>
+#include <QtCore/QString>
+#include <vector>
+class QIODevice;
+
+namespace Mayo {
+
+class TaskProgress;
+
+// Provides the bill of materials(BOM) of a document, along with geometric properties of products
+// Products are deduplicated: a product referred by several instances in the model tree gives a
+// single row
+class BomReport {
+public:
+    struct Row {
+        TDF_Label product;
+        QString name;
+        bool isAssembly = false;
+        int instanceCount = 0; // Count of occurrences in the whole model tree
+        bool hasColor = false;
+        Quantity_Color color;
+        // Geometric properties, expressed in the product coordinate system
+        // Not computed for assemblies
+        MassProperties massProperties;
+        Bnd_Box bndBox;
+    };
+
+    // Data of a document needed to compute the BOM, read in the thread owning the document
+    // Product labels are only used as keys, so computation of the BOM can run in a worker thread
+    struct Snapshot {
+        std::vector<Row> vecRow; // Geometric properties aren't computed yet
+        std::vector<TopoDS_Shape> vecShape; // Shape of each row, null for assemblies
+        MassPropertiesCache::ProductShapes massPropsProducts; // Products not memoized yet
+    };
+
+    // Reads names, colors, instance counts and shapes of the products of 'doc'
+    // Returns empty snapshot if 'doc' isn't an XCAF document
+    static Snapshot snapshot(const DocumentPtr& doc);
+
+    // Computes geometric properties of the rows of 'snapshot' in parallel, without document access
+    // Mass properties are taken from(and memoized into) 'massPropsCache'
+    // Returns empty array if 'progress' was aborted
+    static std::vector<Row> compute(
+            Snapshot snapshot, MassPropertiesCache* massPropsCache, TaskProgress* progress = nullptr);
+
+    // Same as compute(snapshot(doc), &doc->massPropertiesCache(), progress)
+    // Document is accessed, so it must be owned by the calling thread
+    static std::vector<Row> compute(const DocumentPtr& doc, TaskProgress* progress = nullptr);
+
+    enum class Format { None, Csv, Json };
+    // Returns the format corresponding to the suffix of 'fp'(ie .csv or .json)
+    static Format findFormat(const FilePath& fp);
+
+    struct WriteOptions {
+        UnitSystem::Schema schema = UnitSystem::SI;
+        int decimalCount = 3;
+    };
+
+    // Writes(streams) 'spanRow' into 'device', quantities are translated with UnitSystem
+    static bool write(
+            QIODevice* device, Format format, Span<const Row> spanRow, const WriteOptions& options);
+
+private:
+    BomReport() = default;
+};
+
+} // namespace Mayo
@@ -8,6 +8,7 @@
 
 #include "global.h"
 #include "tkernel_utils.h"
+#include "tracing.h"
 #if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 5, 0)
 #  include "occ_progress_indicator.h"
 #endif
@@ -49,6 +50,7 @@ TopoDS_Shape BRepUtils::shapeFromString(const std::string& str)
 void BRepUtils::computeMesh(
         const TopoDS_Shape& shape, const OccBRepMeshParameters& params, TaskProgress* progress)
 {
+    MAYO_TRACE_SCOPE("BRepUtils::computeMesh", "meshing");
 #if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 5, 0)
     Handle_Message_ProgressIndicator indicator = new OccProgressIndicator(progress);
     BRepMesh_IncrementalMesh mesher(shape, params, TKernelUtils::start(indicator));
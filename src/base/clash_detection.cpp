@@ -0,0 +1,730 @@
+/****************************************************************************
+** Copyright (c) 2021, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#include "clash_detection.h"
+
+#include "brep_utils.h"
+#include "caf_utils.h"
+#include "document.h"
+#include "math_utils.h"
+#include "task_progress.h"
+#include "xcaf.h"
+
+#include <BRep_Tool.hxx>
+#include <BRepClass3d_SolidClassifier.hxx>
+#include <OSD_Parallel.hxx>
+#include <Poly_Triangulation.hxx>
+#include <Precision.hxx>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <unordered_map>
+#include <utility>
+
+namespace Mayo {
+
+namespace Internal {
+
+// Count of instances swept between two progress/abort checks
+static constexpr int ClashBroadPhaseChunkSize = 1024;
+// Count of candidate pairs tested between two progress/abort checks
+static constexpr int ClashNarrowPhaseChunkSize = 256;
+
+using ClashTriangle = std::array<gp_XYZ, 3>;
+
+// Axis-aligned box, lighter than Bnd_Box as millions of them can be visited
+struct ClashBox {
+    gp_XYZ pmin = gp_XYZ(
+                std::numeric_limits<double>::max(),
+                std::numeric_limits<double>::max(),
+                std::numeric_limits<double>::max());
+    gp_XYZ pmax = -pmin;
+
+    bool isVoid() const { return this->pmin.X() > this->pmax.X(); }
+
+    void add(const gp_XYZ& pnt)
+    {
+        this->pmin.SetCoord(
+                    std::min(this->pmin.X(), pnt.X()),
+                    std::min(this->pmin.Y(), pnt.Y()),
+                    std::min(this->pmin.Z(), pnt.Z()));
+        this->pmax.SetCoord(
+                    std::max(this->pmax.X(), pnt.X()),
+                    std::max(this->pmax.Y(), pnt.Y()),
+                    std::max(this->pmax.Z(), pnt.Z()));
+    }
+
+    void add(const ClashBox& other)
+    {
+        if (!other.isVoid()) {
+            this->add(other.pmin);
+            this->add(other.pmax);
+        }
+    }
+
+    // Returns true if 'other' is farther than 'gap' along one axis at least
+    bool isOut(const ClashBox& other, double gap) const
+    {
+        return other.pmin.X() > this->pmax.X() + gap || other.pmax.X() < this->pmin.X() - gap
+                || other.pmin.Y() > this->pmax.Y() + gap || other.pmax.Y() < this->pmin.Y() - gap
+                || other.pmin.Z() > this->pmax.Z() + gap || other.pmax.Z() < this->pmin.Z() - gap;
+    }
+
+    double squareExtent() const { return (this->pmax - this->pmin).SquareModulus(); }
+
+    // Returns the box enclosing the transformed corners of this box
+    ClashBox transformed(const gp_Trsf& trsf) const
+    {
+        ClashBox box;
+        if (this->isVoid())
+            return box;
+
+        for (int i = 0; i < 8; ++i) {
+            gp_XYZ corner(
+                        (i & 1) ? this->pmax.X() : this->pmin.X(),
+                        (i & 2) ? this->pmax.Y() : this->pmin.Y(),
+                        (i & 4) ? this->pmax.Z() : this->pmin.Z());
+            trsf.Transforms(corner);
+            box.add(corner);
+        }
+
+        return box;
+    }
+};
+
+// Triangles of a product along with a bounding volume hierarchy, in product coordinate system
+class ClashProductMesh {
+public:
+    struct Node {
+        ClashBox box;
+        int triangleFirst = 0;
+        int triangleLast = 0; // Past-the-end
+        int childLeft = -1;
+        int childRight = -1;
+        bool isLeaf() const { return this->childLeft < 0; }
+    };
+
+    void build(const TopoDS_Shape& shape)
+    {
+        m_shape = shape;
+        m_hasSolid = TopExp_Explorer(shape, TopAbs_SOLID).More();
+        BRepUtils::forEachSubFace(shape, [&](const TopoDS_Face& face) {
+            TopLoc_Location loc;
+            const Handle_Poly_Triangulation& triangulation = BRep_Tool::Triangulation(face, loc);
+            if (triangulation.IsNull())
+                return;
+
+            // Triangles of reversed faces are flipped so normals are pointing outside of material
+            const bool isFaceReversed = face.Orientation() == TopAbs_REVERSED;
+            const gp_Trsf& trsf = loc.Transformation();
+            const TColgp_Array1OfPnt& vecNode = triangulation->Nodes();
+            for (const Poly_Triangle& polyTri : triangulation->Triangles()) {
+                int n1, n2, n3;
+                polyTri.Get(n1, n2, n3);
+                if (isFaceReversed)
+                    std::swap(n2, n3);
+
+                ClashTriangle tri = {
+                    vecNode.Value(n1).XYZ(), vecNode.Value(n2).XYZ(), vecNode.Value(n3).XYZ()
+                };
+                for (gp_XYZ& pnt : tri)
+                    trsf.Transforms(pnt);
+
+                m_vecTriangle.push_back(std::move(tri));
+            }
+        });
+
+        // Inner point is located just behind the largest triangle, which likely lies on a planar
+        // face where the mesh matches the exact surface
+        double maxArea = 0.;
+        for (const ClashTriangle& tri : m_vecTriangle) {
+            const gp_XYZ vecCross = (tri[1] - tri[0]).Crossed(tri[2] - tri[0]);
+            const double area = vecCross.Modulus() / 2.;
+            if (area > maxArea) {
+                maxArea = area;
+                // Offset is small against the triangle, but far above the classification tolerance
+                const double offset = std::max(1e-3 * std::sqrt(area), 100 * Precision::Confusion());
+                m_innerPoint = (tri[0] + tri[1] + tri[2]) / 3. - (vecCross / (2. * area)) * offset;
+            }
+        }
+
+        m_hasInnerPoint = maxArea > 0.;
+        m_vecNode.clear();
+        if (!m_vecTriangle.empty())
+            this->buildNode(0, int(m_vecTriangle.size()));
+    }
+
+    const ClashBox& box() const
+    {
+        static const ClashBox nullBox;
+        return !m_vecNode.empty() ? m_vecNode.front().box : nullBox;
+    }
+
+    const Node& node(int id) const { return m_vecNode.at(id); }
+    const ClashTriangle& triangle(int id) const { return m_vecTriangle.at(id); }
+
+    // Point located inside the material of the product, relevant only if hasInnerPoint() is true
+    const gp_XYZ& innerPoint() const { return m_innerPoint; }
+    bool hasInnerPoint() const { return m_hasInnerPoint; }
+
+    // Returns true if 'pnt' is strictly inside the solids of the product
+    bool isInside(const gp_XYZ& pnt) const
+    {
+        if (!m_hasSolid)
+            return false;
+
+        const BRepClass3d_SolidClassifier classifier(m_shape, gp_Pnt(pnt), Precision::Confusion());
+        return classifier.State() == TopAbs_IN;
+    }
+
+private:
+    static constexpr int MaxLeafTriangleCount = 4;
+
+    static ClashBox triangleBox(const ClashTriangle& tri)
+    {
+        ClashBox box;
+        for (const gp_XYZ& pnt : tri)
+            box.add(pnt);
+
+        return box;
+    }
+
+    int buildNode(int triangleFirst, int triangleLast)
+    {
+        const int nodeId = int(m_vecNode.size());
+        m_vecNode.emplace_back();
+        Node node;
+        node.triangleFirst = triangleFirst;
+        node.triangleLast = triangleLast;
+        for (int i = triangleFirst; i < triangleLast; ++i)
+            node.box.add(triangleBox(m_vecTriangle.at(i)));
+
+        if (triangleLast - triangleFirst > MaxLeafTriangleCount) {
+            // Median split along the largest axis of the node box
+            const gp_XYZ extents = node.box.pmax - node.box.pmin;
+            const int axis =
+                    extents.X() >= extents.Y() && extents.X() >= extents.Z() ? 1 :
+                    (extents.Y() >= extents.Z() ? 2 : 3);
+            auto fnCenter = [=](const ClashTriangle& tri) {
+                return tri[0].Coord(axis) + tri[1].Coord(axis) + tri[2].Coord(axis);
+            };
+            const int triangleMid = triangleFirst + (triangleLast - triangleFirst) / 2;
+            std::nth_element(
+                        m_vecTriangle.begin() + triangleFirst,
+                        m_vecTriangle.begin() + triangleMid,
+                        m_vecTriangle.begin() + triangleLast,
+                        [=](const ClashTriangle& lhs, const ClashTriangle& rhs) {
+                            return fnCenter(lhs) < fnCenter(rhs);
+                        });
+            node.childLeft = this->buildNode(triangleFirst, triangleMid);
+            node.childRight = this->buildNode(triangleMid, triangleLast);
+        }
+
+        m_vecNode.at(nodeId) = node;
+        return nodeId;
+    }
+
+    TopoDS_Shape m_shape;
+    bool m_hasSolid = false;
+    gp_XYZ m_innerPoint;
+    bool m_hasInnerPoint = false;
+    std::vector<ClashTriangle> m_vecTriangle;
+    std::vector<Node> m_vecNode;
+};
+
+static bool hasMissingTriangulation(const TopoDS_Shape& shape)
+{
+    for (TopExp_Explorer expl(shape, TopAbs_FACE); expl.More(); expl.Next()) {
+        TopLoc_Location loc;
+        if (BRep_Tool::Triangulation(TopoDS::Face(expl.Current()), loc).IsNull())
+            return true;
+    }
+
+    return false;
+}
+
+// Returns the unit normal of 'tri', null vector if triangle is degenerated
+static gp_XYZ triangleNormal(const ClashTriangle& tri)
+{
+    gp_XYZ normal = (tri[1] - tri[0]).Crossed(tri[2] - tri[0]);
+    const double length = normal.Modulus();
+    return length > std::numeric_limits<double>::min() ? normal / length : gp_XYZ();
+}
+
+// Returns true if 'tri1' and 'tri2' cross each other(interval overlap test of T.Möller)
+// Coplanar triangles can't cross, they are touching at most
+static bool trianglesCross(const ClashTriangle& tri1, const ClashTriangle& tri2)
+{
+    const gp_XYZ n1 = triangleNormal(tri1);
+    const gp_XYZ n2 = triangleNormal(tri2);
+    if (n1.SquareModulus() == 0. || n2.SquareModulus() == 0.)
+        return false;
+
+    // Signed distances of the vertices of a triangle to the plane of the other triangle
+    auto fnDistances = [](const gp_XYZ& n, const ClashTriangle& triPlane, const ClashTriangle& tri) {
+        std::array<double, 3> dist;
+        for (int i = 0; i < 3; ++i) {
+            dist[i] = n.Dot(tri[i] - triPlane[0]);
+            if (std::abs(dist[i]) < Precision::Confusion())
+                dist[i] = 0.;
+        }
+
+        return dist;
+    };
+    auto fnIsOneSide = [](const std::array<double, 3>& dist) {
+        return (dist[0] > 0. && dist[1] > 0. && dist[2] > 0.)
+                || (dist[0] < 0. && dist[1] < 0. && dist[2] < 0.);
+    };
+
+    const std::array<double, 3> dist2 = fnDistances(n1, tri1, tri2);
+    if (fnIsOneSide(dist2))
+        return false;
+
+    const std::array<double, 3> dist1 = fnDistances(n2, tri2, tri1);
+    if (fnIsOneSide(dist1))
+        return false;
+
+    if (dist2[0] == 0. && dist2[1] == 0. && dist2[2] == 0.)
+        return false;
+
+    // Project on the axis most aligned with the intersection line of the triangle planes
+    const gp_XYZ dir = n1.Crossed(n2);
+    const int axis =
+            std::abs(dir.X()) >= std::abs(dir.Y()) && std::abs(dir.X()) >= std::abs(dir.Z()) ? 1 :
+            (std::abs(dir.Y()) >= std::abs(dir.Z()) ? 2 : 3);
+    auto fnInterval = [=](const ClashTriangle& tri, const std::array<double, 3>& dist) {
+        std::pair<double, double> interval = {
+            std::numeric_limits<double>::max(), std::numeric_limits<double>::lowest()
+        };
+        auto fnAdd = [&](double t) {
+            interval.first = std::min(interval.first, t);
+            interval.second = std::max(interval.second, t);
+        };
+        for (int i = 0; i < 3; ++i) {
+            const int j = (i + 1) % 3;
+            const double pi = tri[i].Coord(axis);
+            const double pj = tri[j].Coord(axis);
+            if (dist[i] == 0.)
+                fnAdd(pi);
+            else if ((dist[i] > 0. && dist[j] < 0.) || (dist[i] < 0. && dist[j] > 0.))
+                fnAdd(pi + (pj - pi) * dist[i] / (dist[i] - dist[j]));
+        }
+
+        return interval;
+    };
+
+    const std::pair<double, double> interval1 = fnInterval(tri1, dist1);
+    const std::pair<double, double> interval2 = fnInterval(tri2, dist2);
+    return interval1.first <= interval2.second && interval2.first <= interval1.second;
+}
+
+// Returns the point of triangle 'tri' closest to 'pnt'
+// See "Real-Time Collision Detection" by C.Ericson, section 5.1.5
+static gp_XYZ closestPointOnTriangle(const gp_XYZ& pnt, const ClashTriangle& tri)
+{
+    const gp_XYZ& a = tri[0];
+    const gp_XYZ& b = tri[1];
+    const gp_XYZ& c = tri[2];
+    const gp_XYZ ab = b - a;
+    const gp_XYZ ac = c - a;
+    const gp_XYZ ap = pnt - a;
+    const double d1 = ab.Dot(ap);
+    const double d2 = ac.Dot(ap);
+    if (d1 <= 0. && d2 <= 0.)
+        return a;
+
+    const gp_XYZ bp = pnt - b;
+    const double d3 = ab.Dot(bp);
+    const double d4 = ac.Dot(bp);
+    if (d3 >= 0. && d4 <= d3)
+        return b;
+
+    const double vc = d1 * d4 - d3 * d2;
+    if (vc <= 0. && d1 >= 0. && d3 <= 0.)
+        return a + ab * (d1 / (d1 - d3));
+
+    const gp_XYZ cp = pnt - c;
+    const double d5 = ab.Dot(cp);
+    const double d6 = ac.Dot(cp);
+    if (d6 >= 0. && d5 <= d6)
+        return c;
+
+    const double vb = d5 * d2 - d1 * d6;
+    if (vb <= 0. && d2 >= 0. && d6 <= 0.)
+        return a + ac * (d2 / (d2 - d6));
+
+    const double va = d3 * d6 - d5 * d4;
+    if (va <= 0. && (d4 - d3) >= 0. && (d5 - d6) >= 0.)
+        return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+
+    const double denom = 1. / (va + vb + vc);
+    return a + ab * (vb * denom) + ac * (vc * denom);
+}
+
+// Returns the squared distance between segments [p1,q1] and [p2,q2]
+// See "Real-Time Collision Detection" by C.Ericson, section 5.1.9
+static double segmentsSquareDistance(const gp_XYZ& p1, const gp_XYZ& q1, const gp_XYZ& p2, const gp_XYZ& q2)
+{
+    constexpr double epsilon = std::numeric_limits<double>::epsilon();
+    const gp_XYZ d1 = q1 - p1;
+    const gp_XYZ d2 = q2 - p2;
+    const gp_XYZ r = p1 - p2;
+    const double a = d1.SquareModulus();
+    const double e = d2.SquareModulus();
+    const double f = d2.Dot(r);
+    double s = 0.;
+    double t = 0.;
+    if (a <= epsilon && e <= epsilon)
+        return r.SquareModulus();
+
+    if (a <= epsilon) {
+        t = std::clamp(f / e, 0., 1.);
+    }
+    else {
+        const double c = d1.Dot(r);
+        if (e <= epsilon) {
+            s = std::clamp(-c / a, 0., 1.);
+        }
+        else {
+            const double b = d1.Dot(d2);
+            const double denom = a * e - b * b;
+            s = denom != 0. ? std::clamp((b * f - c * e) / denom, 0., 1.) : 0.;
+            t = (b * s + f) / e;
+            if (t < 0.) {
+                t = 0.;
+                s = std::clamp(-c / a, 0., 1.);
+            }
+            else if (t > 1.) {
+                t = 1.;
+                s = std::clamp((b - c) / a, 0., 1.);
+            }
+        }
+    }
+
+    return ((p1 + d1 * s) - (p2 + d2 * t)).SquareModulus();
+}
+
+// Returns the distance between non-crossing triangles 'tri1' and 'tri2'
+static double trianglesDistance(const ClashTriangle& tri1, const ClashTriangle& tri2)
+{
+    double sqrDist = std::numeric_limits<double>::max();
+    for (int i = 0; i < 3; ++i) {
+        sqrDist = std::min(sqrDist, (closestPointOnTriangle(tri1[i], tri2) - tri1[i]).SquareModulus());
+        sqrDist = std::min(sqrDist, (closestPointOnTriangle(tri2[i], tri1) - tri2[i]).SquareModulus());
+        for (int j = 0; j < 3; ++j) {
+            sqrDist = std::min(
+                        sqrDist,
+                        segmentsSquareDistance(tri1[i], tri1[(i + 1) % 3], tri2[j], tri2[(j + 1) % 3]));
+        }
+    }
+
+    return std::sqrt(sqrDist);
+}
+
+// Estimates how deep crossing triangles 'tri1' and 'tri2' are penetrating each other
+// This is the smallest depth of the vertices of a triangle located behind the other triangle
+static double penetrationDepth(const ClashTriangle& tri1, const ClashTriangle& tri2)
+{
+    auto fnDepthBehind = [](const ClashTriangle& triPlane, const ClashTriangle& tri) {
+        const gp_XYZ n = triangleNormal(triPlane);
+        double depth = 0.;
+        for (const gp_XYZ& pnt : tri)
+            depth = std::max(depth, -n.Dot(pnt - triPlane[0]));
+
+        return depth;
+    };
+
+    return std::min(fnDepthBehind(tri1, tri2), fnDepthBehind(tri2, tri1));
+}
+
+// Adds to 'box' the end points of the intersection segment of crossing triangles 'tri1' and 'tri2'
+// These are the points where edges of a triangle are crossing the other triangle
+static void addIntersectionPoints(const ClashTriangle& tri1, const ClashTriangle& tri2, ClashBox* box)
+{
+    auto fnAddEdgeCrossings = [=](const ClashTriangle& triEdges, const ClashTriangle& triPlane) {
+        const gp_XYZ n = triangleNormal(triPlane);
+        for (int i = 0; i < 3; ++i) {
+            const gp_XYZ& p = triEdges[i];
+            const gp_XYZ& q = triEdges[(i + 1) % 3];
+            const double dp = n.Dot(p - triPlane[0]);
+            const double dq = n.Dot(q - triPlane[0]);
+            if ((dp > 0. && dq > 0.) || (dp < 0. && dq < 0.) || dp == dq)
+                continue;
+
+            const gp_XYZ pnt = p + (q - p) * (dp / (dp - dq));
+            if ((closestPointOnTriangle(pnt, triPlane) - pnt).SquareModulus() < Precision::SquareConfusion())
+                box->add(pnt);
+        }
+    };
+    fnAddEdgeCrossings(tri1, tri2);
+    fnAddEdgeCrossings(tri2, tri1);
+}
+
+struct ClashPairResult {
+    bool isInterfering = false;
+    double penetrationDepth = 0.;
+    double minDistance = std::numeric_limits<double>::max();
+    ClashBox intersectionBox; // Encloses the intersection curves
+};
+
+// Tests instances of 'mesh1' and 'mesh2' located with 'trsf1' and 'trsf2'
+// Dual traversal of the BVHs is done in coordinate system of 'mesh1', so only 'mesh2' is transformed
+static ClashPairResult testInstancePair(
+        const ClashProductMesh& mesh1, const gp_Trsf& trsf1,
+        const ClashProductMesh& mesh2, const gp_Trsf& trsf2,
+        double clearance)
+{
+    ClashPairResult result;
+    const gp_Trsf trsf2To1 = trsf1.Inverted() * trsf2;
+    const double gap = std::max(clearance, Precision::Confusion());
+    std::vector<std::pair<int, int>> stackNodePair = { { 0, 0 } };
+    while (!stackNodePair.empty()) {
+        const auto [nodeId1, nodeId2] = stackNodePair.back();
+        stackNodePair.pop_back();
+        const ClashProductMesh::Node& node1 = mesh1.node(nodeId1);
+        const ClashProductMesh::Node& node2 = mesh2.node(nodeId2);
+        const ClashBox box2 = node2.box.transformed(trsf2To1);
+        if (node1.box.isOut(box2, gap))
+            continue;
+
+        if (node1.isLeaf() && node2.isLeaf()) {
+            for (int i2 = node2.triangleFirst; i2 < node2.triangleLast; ++i2) {
+                ClashTriangle tri2 = mesh2.triangle(i2);
+                for (gp_XYZ& pnt : tri2)
+                    trsf2To1.Transforms(pnt);
+
+                for (int i1 = node1.triangleFirst; i1 < node1.triangleLast; ++i1) {
+                    const ClashTriangle& tri1 = mesh1.triangle(i1);
+                    if (trianglesCross(tri1, tri2)) {
+                        const double depth = penetrationDepth(tri1, tri2);
+                        if (depth > Precision::Confusion()) {
+                            result.isInterfering = true;
+                            result.penetrationDepth = std::max(result.penetrationDepth, depth);
+                            addIntersectionPoints(tri1, tri2, &result.intersectionBox);
+                        }
+                        else {
+                            result.minDistance = 0.; // Touching
+                        }
+                    }
+                    else if (clearance > 0. && !result.isInterfering && result.minDistance > 0.) {
+                        result.minDistance = std::min(result.minDistance, trianglesDistance(tri1, tri2));
+                    }
+                }
+            }
+        }
+        else if (node2.isLeaf() || (!node1.isLeaf() && node1.box.squareExtent() >= box2.squareExtent())) {
+            stackNodePair.emplace_back(node1.childLeft, nodeId2);
+            stackNodePair.emplace_back(node1.childRight, nodeId2);
+        }
+        else {
+            stackNodePair.emplace_back(nodeId1, node2.childLeft);
+            stackNodePair.emplace_back(nodeId1, node2.childRight);
+        }
+    }
+
+    // No crossing found: an instance may still be inside the other one, or both may be coincident
+    // Then a point inside the material of an instance is classified against the other one
+    if (!result.isInterfering && !mesh1.box().isOut(mesh2.box().transformed(trsf2To1), 0.)) {
+        gp_XYZ innerPnt2 = mesh2.innerPoint();
+        trsf2To1.Transforms(innerPnt2);
+        gp_XYZ innerPnt1 = mesh1.innerPoint();
+        trsf2To1.Inverted().Transforms(innerPnt1);
+        const bool isInside2 = mesh2.hasInnerPoint() && mesh1.isInside(innerPnt2);
+        const bool isInside1 = !isInside2 && mesh1.hasInnerPoint() && mesh2.isInside(innerPnt1);
+        if (isInside1 || isInside2) {
+            // No intersection curve to bound the depth, so it's the smallest extent of the inner instance
+            const ClashBox& innerBox = isInside2 ? mesh2.box() : mesh1.box();
+            const gp_XYZ extents = innerBox.pmax - innerBox.pmin;
+            result.isInterfering = true;
+            result.penetrationDepth = std::min({ extents.X(), extents.Y(), extents.Z() });
+        }
+    }
+
+    // Depth estimated from triangles is excessive with large triangles(eg planar faces), so it's
+    // bounded by the smallest extent of the intersection curves
+    if (result.isInterfering && !result.intersectionBox.isVoid()) {
+        const gp_XYZ extents = result.intersectionBox.pmax - result.intersectionBox.pmin;
+        const double minExtent = std::min({ extents.X(), extents.Y(), extents.Z() });
+        result.penetrationDepth = std::min(result.penetrationDepth, minExtent);
+    }
+
+    return result;
+}
+
+} // namespace Internal
+
+std::vector<ClashDetection::Clash> ClashDetection::compute(
+        const DocumentPtr& doc, const Options& options, TaskProgress* progress)
+{
+    std::vector<Clash> vecClash;
+    if (!doc || !doc->isXCafDocument())
+        return vecClash;
+
+    // Gather instances along with their unique products
+    struct Instance {
+        TreeNodeId treeNodeId;
+        int productIndex;
+        gp_Trsf trsf;
+        Internal::ClashBox box;
+    };
+    std::vector<Instance> vecInstance;
+    std::vector<TopoDS_Shape> vecProductShape;
+    std::unordered_map<TDF_Label, int> mapProductIndex;
+    const Tree<TDF_Label>& modelTree = doc->modelTree();
+    for (TreeNodeId instanceId : ClashDetection::instanceTreeNodes(doc)) {
+        const TDF_Label& instanceLabel = modelTree.nodeData(instanceId);
+        const TDF_Label productLabel =
+                XCaf::isShapeReference(instanceLabel) ? XCaf::shapeReferred(instanceLabel) : instanceLabel;
+        auto [it, isNewProduct] = mapProductIndex.insert({ productLabel, int(vecProductShape.size()) });
+        if (isNewProduct)
+            vecProductShape.push_back(XCaf::shape(productLabel));
+
+        Instance instance;
+        instance.treeNodeId = instanceId;
+        instance.productIndex = it->second;
+        instance.trsf = XCaf::shapeAbsoluteLocation(modelTree, instanceId).Transformation();
+        vecInstance.push_back(std::move(instance));
+    }
+
+    // Mesh products lacking triangulation, serially as the mesher is itself parallel
+    const int productCount = int(vecProductShape.size());
+    if (options.fnComputeMesh) {
+        TaskProgress meshProgress(progress, 20);
+        for (int i = 0; i < productCount; ++i) {
+            if (TaskProgress::isAbortRequested(progress))
+                return {};
+
+            if (Internal::hasMissingTriangulation(vecProductShape.at(i)))
+                options.fnComputeMesh(vecProductShape.at(i), nullptr);
+
+            meshProgress.setValue(MathUtils::mappedValue(i + 1, 0, productCount, 0, 100));
+        }
+    }
+
+    // Index product triangles, shapes are retrieved above in the calling thread
+    std::vector<Internal::ClashProductMesh> vecProductMesh(vecProductShape.size());
+    OSD_Parallel::For(0, productCount, [&](int i) {
+        vecProductMesh.at(i).build(vecProductShape.at(i));
+    });
+    if (TaskProgress::isAbortRequested(progress))
+        return {};
+
+    for (Instance& instance : vecInstance)
+        instance.box = vecProductMesh.at(instance.productIndex).box().transformed(instance.trsf);
+
+    // Broad phase: sweep and prune along X axis
+    const double gap = std::max(options.clearance, Precision::Confusion());
+    std::vector<int> vecSortedInstance;
+    vecSortedInstance.reserve(vecInstance.size());
+    for (int i = 0; i < int(vecInstance.size()); ++i) {
+        if (!vecInstance.at(i).box.isVoid())
+            vecSortedInstance.push_back(i);
+    }
+
+    std::sort(vecSortedInstance.begin(), vecSortedInstance.end(), [&](int lhs, int rhs) {
+        return vecInstance.at(lhs).box.pmin.X() < vecInstance.at(rhs).box.pmin.X();
+    });
+    const int sortedCount = int(vecSortedInstance.size());
+    const int broadChunkCount =
+            (sortedCount + Internal::ClashBroadPhaseChunkSize - 1) / Internal::ClashBroadPhaseChunkSize;
+    std::vector<std::vector<std::pair<int, int>>> vecChunkPair(broadChunkCount);
+    OSD_Parallel::For(0, broadChunkCount, [&](int iChunk) {
+        const int iFirst = iChunk * Internal::ClashBroadPhaseChunkSize;
+        const int iEnd = std::min(iFirst + Internal::ClashBroadPhaseChunkSize, sortedCount);
+        for (int i = iFirst; i < iEnd; ++i) {
+            const int instanceIndex = vecSortedInstance.at(i);
+            const Internal::ClashBox& box = vecInstance.at(instanceIndex).box;
+            for (int j = i + 1; j < sortedCount; ++j) {
+                const int otherIndex = vecSortedInstance.at(j);
+                const Internal::ClashBox& otherBox = vecInstance.at(otherIndex).box;
+                if (otherBox.pmin.X() > box.pmax.X() + gap)
+                    break;
+
+                if (!box.isOut(otherBox, gap))
+                    vecChunkPair.at(iChunk).emplace_back(instanceIndex, otherIndex);
+            }
+        }
+    });
+
+    std::vector<std::pair<int, int>> vecCandidatePair;
+    for (std::vector<std::pair<int, int>>& vecPair : vecChunkPair) {
+        vecCandidatePair.insert(vecCandidatePair.end(), vecPair.cbegin(), vecPair.cend());
+        vecPair = {}; // Release memory
+    }
+
+    // Narrow phase: triangle tests of candidate pairs
+    const int pairCount = int(vecCandidatePair.size());
+    std::vector<Internal::ClashPairResult> vecPairResult(vecCandidatePair.size());
+    {
+        TaskProgress narrowProgress(progress, options.fnComputeMesh ? 80 : 100);
+        for (int iFirst = 0; iFirst < pairCount; iFirst += Internal::ClashNarrowPhaseChunkSize) {
+            if (TaskProgress::isAbortRequested(progress))
+                return {};
+
+            const int iEnd = std::min(iFirst + Internal::ClashNarrowPhaseChunkSize, pairCount);
+            OSD_Parallel::For(iFirst, iEnd, [&](int i) {
+                const Instance& instance1 = vecInstance.at(vecCandidatePair.at(i).first);
+                const Instance& instance2 = vecInstance.at(vecCandidatePair.at(i).second);
+                vecPairResult.at(i) = Internal::testInstancePair(
+                            vecProductMesh.at(instance1.productIndex), instance1.trsf,
+                            vecProductMesh.at(instance2.productIndex), instance2.trsf,
+                            options.clearance);
+            });
+            narrowProgress.setValue(MathUtils::mappedValue(iEnd, 0, pairCount, 0, 100));
+        }
+    }
+
+    for (int i = 0; i < pairCount; ++i) {
+        const Internal::ClashPairResult& pairResult = vecPairResult.at(i);
+        Clash clash;
+        clash.instance1 = vecInstance.at(vecCandidatePair.at(i).first).treeNodeId;
+        clash.instance2 = vecInstance.at(vecCandidatePair.at(i).second).treeNodeId;
+        if (pairResult.isInterfering) {
+            clash.type = Type::Interference;
+            clash.penetrationDepth = pairResult.penetrationDepth;
+            vecClash.push_back(clash);
+        }
+        else if (options.clearance > 0. && pairResult.minDistance < options.clearance) {
+            clash.type = Type::Clearance;
+            clash.distance = pairResult.minDistance;
+            vecClash.push_back(clash);
+        }
+    }
+
+    std::sort(vecClash.begin(), vecClash.end(), [](const Clash& lhs, const Clash& rhs) {
+        if (lhs.type != rhs.type)
+            return lhs.type == Type::Interference;
+
+        return lhs.type == Type::Interference ?
+                    lhs.penetrationDepth > rhs.penetrationDepth :
+                    lhs.distance < rhs.distance;
+    });
+    return vecClash;
+}
+
+std::vector<TreeNodeId> ClashDetection::instanceTreeNodes(const DocumentPtr& doc)
+{
+    std::vector<TreeNodeId> vecInstanceId;
+    if (!doc)
+        return vecInstanceId;
+
+    // Same mapping as GuiDocument, where graphics objects are attached to references of leaf products
+    const Tree<TDF_Label>& modelTree = doc->modelTree();
+    traverseTree(modelTree, [&](TreeNodeId nodeId) {
+        const TDF_Label& label = modelTree.nodeData(nodeId);
+        if (!modelTree.nodeIsLeaf(nodeId) || !XCaf::isShape(label) || XCaf::isShapeReference(label))
+            return;
+
+        const TreeNodeId parentId = modelTree.nodeParent(nodeId);
+        const bool isReferred = parentId != 0 && XCaf::isShapeReference(modelTree.nodeData(parentId));
+        vecInstanceId.push_back(isReferred ? parentId : nodeId);
+    });
+
+    return vecInstanceId;
+}
+
+} // namespace Mayo
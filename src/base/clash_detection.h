@@ -0,0 +1,60 @@
+/****************************************************************************
+** Copyright (c) 2021, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#pragma once
+
+#include "document_ptr.h"
+#include "libtree.h"
+
+#include <TopoDS_Shape.hxx>
+#include <functional>
+#include <vector>
+
+namespace Mayo {
+
+class TaskProgress;
+
+// Detects clashes between the part instances of a document
+// Broad phase sweeps the world bounding boxes of the instances, narrow phase tests the triangles
+// of the product meshes. Each product is indexed(triangle BVH) once whatever its instance count
+class ClashDetection {
+public:
+    enum class Type {
+        Interference, // Instances are crossing each other, or one is inside the other(eg coincident)
+        Clearance     // Instances are closer than the clearance distance(or touching)
+    };
+
+    struct Clash {
+        TreeNodeId instance1 = 0;
+        TreeNodeId instance2 = 0;
+        Type type = Type::Interference;
+        double penetrationDepth = 0.; // Estimated, relevant for Type::Interference only
+        double distance = 0.; // Minimum distance, relevant for Type::Clearance only
+    };
+
+    struct Options {
+        // If > 0 then instances closer than this distance are reported as Type::Clearance
+        // Otherwise only interferences are detected, touching instances being ignored
+        double clearance = 0.;
+        // Called for products having faces without triangulation, these faces are ignored if null
+        std::function<void(const TopoDS_Shape&, TaskProgress*)> fnComputeMesh;
+    };
+
+    // Returns the clashes found in 'doc', interferences first(deepest first) and then clearance
+    // violations(closest first)
+    // Returns empty array if 'doc' isn't an XCAF document or if 'progress' was aborted
+    static std::vector<Clash> compute(
+            const DocumentPtr& doc, const Options& options, TaskProgress* progress = nullptr);
+
+    // Returns the tree nodes of 'doc' considered as part instances: XCAF references of leaf
+    // products, or leaf products not referenced(eg free shapes)
+    static std::vector<TreeNodeId> instanceTreeNodes(const DocumentPtr& doc);
+
+private:
+    ClashDetection() = default;
+};
+
+} // namespace Mayo
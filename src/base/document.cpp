@@ -10,6 +10,7 @@
 #include <TDF_ChildIterator.hxx>
 #include <TDF_TagSource.hxx>
 #include <XCAFDoc_DocumentTool.hxx>
+#include <algorithm>
 #include <set>
 
 namespace Mayo {
@@ -38,6 +39,12 @@ void Document::setName(const QString& name)
     emit this->nameChanged(name);
 }
 
+void Document::setLabelName(const TDF_Label& label, const QString& name)
+{
+    CafUtils::setLabelAttrStdName(label, name);
+    emit this->labelNameChanged(label);
+}
+
 const FilePath& Document::filePath() const
 {
     return m_filePath;
@@ -100,6 +107,7 @@ DocumentTreeNode Document::entityTreeNode(int index) const
 void Document::rebuildModelTree()
 {
     m_modelTree.clear();
+    m_mapLabelTreeNodes.clear();
     const bool xcafIsNull = m_xcaf.isNull();
     if (!xcafIsNull) {
         for (const TDF_Label& label : m_xcaf.topLevelFreeShapes())
@@ -115,6 +123,27 @@ void Document::rebuildModelTree()
             m_modelTree.appendChild(0, childLabel);
         }
     }
+
+    for (TreeNodeId entityId : m_modelTree.roots())
+        this->indexTreeNodes(entityId);
+}
+
+Span<const TreeNodeId> Document::treeNodes(const TDF_Label& label) const
+{
+    auto itFound = m_mapLabelTreeNodes.find(label);
+    return itFound != m_mapLabelTreeNodes.cend() ? Span<const TreeNodeId>(itFound->second) : Span<const TreeNodeId>();
+}
+
+std::vector<TreeNodeId> Document::productInstanceTreeNodes(const TDF_Label& productLabel) const
+{
+    std::vector<TreeNodeId> vecInstanceId;
+    for (TreeNodeId productId : this->treeNodes(productLabel)) {
+        const TreeNodeId parentId = m_modelTree.nodeParent(productId);
+        if (parentId != 0 && XCaf::isShapeReference(m_modelTree.nodeData(parentId)))
+            vecInstanceId.push_back(parentId);
+    }
+
+    return vecInstanceId;
 }
 
 DocumentPtr Document::findFrom(const TDF_Label& label)
@@ -146,6 +175,7 @@ void Document::addEntityTreeNode(const TDF_Label& label)
 
     // TODO Allow custom population of the model tree for the new entity
     const TreeNodeId nodeId = m_xcaf.deepBuildAssemblyTree(0, label);
+    this->indexTreeNodes(nodeId);
     emit this->entityAdded(nodeId);
 
 #if 0
@@ -164,11 +194,34 @@ void Document::destroyEntity(TreeNodeId entityTreeNodeId)
         return;
 
     emit this->entityAboutToBeDestroyed(entityTreeNodeId);
+    this->unindexTreeNodes(entityTreeNodeId);
+    m_massPropsCache.clear();
     entityLabel.ForgetAllAttributes();
     entityLabel.Nullify();
     m_modelTree.removeRoot(entityTreeNodeId);
 }
 
+void Document::indexTreeNodes(TreeNodeId rootId)
+{
+    traverseTree(rootId, m_modelTree, [=](TreeNodeId id) {
+        m_mapLabelTreeNodes[m_modelTree.nodeData(id)].push_back(id);
+    });
+}
+
+void Document::unindexTreeNodes(TreeNodeId rootId)
+{
+    traverseTree(rootId, m_modelTree, [=](TreeNodeId id) {
+        auto itFound = m_mapLabelTreeNodes.find(m_modelTree.nodeData(id));
+        if (itFound == m_mapLabelTreeNodes.end())
+            return;
+
+        std::vector<TreeNodeId>& vecNodeId = itFound->second;
+        vecNodeId.erase(std::remove(vecNodeId.begin(), vecNodeId.end(), id), vecNodeId.end());
+        if (vecNodeId.empty())
+            m_mapLabelTreeNodes.erase(itFound);
+    });
+}
+
 void Document::BeforeClose()
 {
     TDocStd_Document::BeforeClose();
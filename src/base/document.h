@@ -6,12 +6,16 @@
 
 #pragma once
 
+#include "caf_utils.h"
 #include "document_ptr.h"
 #include "document_tree_node.h"
 #include "filepath.h"
 #include "libtree.h"
+#include "mass_properties.h"
 #include "xcaf.h"
 #include <QtCore/QObject>
+#include <unordered_map>
+#include <vector>
 
 namespace Mayo {
 
@@ -57,8 +61,20 @@ public:
     const Tree<TDF_Label>& modelTree() const { return m_modelTree; }
     void rebuildModelTree();
 
+    // Returns the model tree nodes mapped to 'label'. For a product(ie XCAF referred shape) these
+    // are its occurrences in the model tree
+    Span<const TreeNodeId> treeNodes(const TDF_Label& label) const;
+    // Returns the model tree nodes of the instances(ie XCAF references) of 'productLabel'
+    std::vector<TreeNodeId> productInstanceTreeNodes(const TDF_Label& productLabel) const;
+
+    // Memoized mass properties of the products, cleared when an entity is destroyed
+    MassPropertiesCache& massPropertiesCache() { return m_massPropsCache; }
+
     static DocumentPtr findFrom(const TDF_Label& label);
 
+    // Changes the name attribute of 'label' and emits signal labelNameChanged()
+    void setLabelName(const TDF_Label& label, const QString& name);
+
     TDF_Label newEntityLabel();
     void addEntityTreeNode(const TDF_Label& label);
     void destroyEntity(TreeNodeId entityTreeNodeId);
@@ -67,6 +83,7 @@ signals:
     void nameChanged(const QString& name);
     void entityAdded(Mayo::TreeNodeId entityTreeNodeId);
     void entityAboutToBeDestroyed(Mayo::TreeNodeId entityTreeNodeId);
+    void labelNameChanged(const TDF_Label& label);
     //void itemPropertyChanged(DocumentItem* docItem, Property* prop);
 
 public: // -- from TDocStd_Document
@@ -85,6 +102,8 @@ private:
 
     Document();
     void initXCaf();
+    void indexTreeNodes(TreeNodeId rootId);
+    void unindexTreeNodes(TreeNodeId rootId);
     void setIdentifier(Identifier ident) { m_identifier = ident; }
 
     Identifier m_identifier = -1;
@@ -92,6 +111,8 @@ private:
     FilePath m_filePath;
     XCaf m_xcaf;
     Tree<TDF_Label> m_modelTree;
+    std::unordered_map<TDF_Label, std::vector<TreeNodeId>> m_mapLabelTreeNodes;
+    MassPropertiesCache m_massPropsCache;
 };
 
 } // namespace Mayo
@@ -0,0 +1,168 @@
+/****************************************************************************
+** Copyright (c) 2021, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#include "document_name_index.h"
+
+#include <algorithm>
+
+namespace Mayo {
+
+namespace Internal {
+
+static constexpr int TrigramSize = 3;
+
+} // namespace Internal
+
+void DocumentNameIndex::build(const std::vector<Entry>& vecEntry)
+{
+    this->clear();
+    TreeNodeId maxNodeId = 0;
+    for (const Entry& entry : vecEntry)
+        maxNodeId = std::max(maxNodeId, entry.nodeId);
+
+    m_vecFoldedName.resize(maxNodeId + 1);
+    m_vecHasName.resize(maxNodeId + 1, false);
+    m_vecSortedNodeId.reserve(vecEntry.size());
+    for (const Entry& entry : vecEntry) {
+        if (m_vecHasName.at(entry.nodeId))
+            continue;
+
+        m_vecFoldedName.at(entry.nodeId) = entry.name.toCaseFolded();
+        m_vecHasName.at(entry.nodeId) = true;
+        m_vecSortedNodeId.push_back(entry.nodeId);
+        for (TrigramKey key : DocumentNameIndex::trigramKeys(m_vecFoldedName.at(entry.nodeId)))
+            m_mapTrigramNodes[key].push_back(entry.nodeId);
+    }
+
+    std::sort(
+                m_vecSortedNodeId.begin(),
+                m_vecSortedNodeId.end(),
+                [=](TreeNodeId lhs, TreeNodeId rhs) { return this->isNameLess(lhs, rhs); });
+}
+
+void DocumentNameIndex::clear()
+{
+    m_vecFoldedName.clear();
+    m_vecHasName.clear();
+    m_vecSortedNodeId.clear();
+    m_mapTrigramNodes.clear();
+}
+
+void DocumentNameIndex::setName(TreeNodeId nodeId, const QString& name)
+{
+    auto fnIsNameLess = [=](TreeNodeId lhs, TreeNodeId rhs) { return this->isNameLess(lhs, rhs); };
+    std::vector<TrigramKey> vecOldKey;
+    if (this->contains(nodeId)) {
+        // Remove from sorted array, while the old name is still in place
+        auto range = std::equal_range(
+                    m_vecSortedNodeId.begin(), m_vecSortedNodeId.end(), nodeId, fnIsNameLess);
+        auto itFound = std::find(range.first, range.second, nodeId);
+        if (itFound != range.second)
+            m_vecSortedNodeId.erase(itFound);
+
+        vecOldKey = DocumentNameIndex::trigramKeys(m_vecFoldedName.at(nodeId));
+    }
+    else {
+        if (nodeId >= m_vecFoldedName.size()) {
+            m_vecFoldedName.resize(nodeId + 1);
+            m_vecHasName.resize(nodeId + 1, false);
+        }
+
+        m_vecHasName.at(nodeId) = true;
+    }
+
+    m_vecFoldedName.at(nodeId) = name.toCaseFolded();
+    m_vecSortedNodeId.insert(
+                std::upper_bound(m_vecSortedNodeId.begin(), m_vecSortedNodeId.end(), nodeId, fnIsNameLess),
+                nodeId);
+
+    // Trigram entries of the old name are kept, they're filtered out by findNodes() anyway
+    for (TrigramKey key : DocumentNameIndex::trigramKeys(m_vecFoldedName.at(nodeId))) {
+        if (std::binary_search(vecOldKey.cbegin(), vecOldKey.cend(), key))
+            continue;
+
+        std::vector<TreeNodeId>& vecNodeId = m_mapTrigramNodes[key];
+        if (std::find(vecNodeId.cbegin(), vecNodeId.cend(), nodeId) == vecNodeId.cend())
+            vecNodeId.push_back(nodeId);
+    }
+}
+
+bool DocumentNameIndex::contains(TreeNodeId nodeId) const
+{
+    return nodeId < m_vecHasName.size() && m_vecHasName.at(nodeId);
+}
+
+std::vector<TreeNodeId> DocumentNameIndex::findNodes(const QString& pattern, int maxCount) const
+{
+    std::vector<TreeNodeId> vecNodeId;
+    const QString foldedPattern = pattern.toCaseFolded();
+    if (foldedPattern.isEmpty() || maxCount == 0)
+        return vecNodeId;
+
+    auto fnAddNode = [&](TreeNodeId nodeId) {
+        vecNodeId.push_back(nodeId);
+        return maxCount < 0 || int(vecNodeId.size()) < maxCount;
+    };
+
+    if (foldedPattern.size() < Internal::TrigramSize) {
+        auto it = std::lower_bound(
+                    m_vecSortedNodeId.cbegin(),
+                    m_vecSortedNodeId.cend(),
+                    foldedPattern,
+                    [=](TreeNodeId nodeId, const QString& str) { return m_vecFoldedName.at(nodeId) < str; });
+        for (; it != m_vecSortedNodeId.cend(); ++it) {
+            if (!m_vecFoldedName.at(*it).startsWith(foldedPattern) || !fnAddNode(*it))
+                break;
+        }
+    }
+    else {
+        // Candidates are taken from the smallest trigram list, then checked against the full pattern
+        const std::vector<TreeNodeId>* ptrVecCandidate = nullptr;
+        for (TrigramKey key : DocumentNameIndex::trigramKeys(foldedPattern)) {
+            auto itFound = m_mapTrigramNodes.find(key);
+            if (itFound == m_mapTrigramNodes.cend())
+                return vecNodeId;
+
+            if (!ptrVecCandidate || itFound->second.size() < ptrVecCandidate->size())
+                ptrVecCandidate = &itFound->second;
+        }
+
+        for (TreeNodeId nodeId : *ptrVecCandidate) {
+            if (m_vecFoldedName.at(nodeId).contains(foldedPattern) && !fnAddNode(nodeId))
+                break;
+        }
+    }
+
+    return vecNodeId;
+}
+
+// Returns the sorted and unique trigram keys of 'str'
+std::vector<DocumentNameIndex::TrigramKey> DocumentNameIndex::trigramKeys(const QString& str)
+{
+    std::vector<TrigramKey> vecKey;
+    if (str.size() < Internal::TrigramSize)
+        return vecKey;
+
+    vecKey.reserve(str.size() - Internal::TrigramSize + 1);
+    for (int i = 0; i + Internal::TrigramSize <= str.size(); ++i) {
+        const TrigramKey key =
+                (TrigramKey(str.at(i).unicode()) << 32)
+                | (TrigramKey(str.at(i + 1).unicode()) << 16)
+                | TrigramKey(str.at(i + 2).unicode());
+        vecKey.push_back(key);
+    }
+
+    std::sort(vecKey.begin(), vecKey.end());
+    vecKey.erase(std::unique(vecKey.begin(), vecKey.end()), vecKey.end());
+    return vecKey;
+}
+
+bool DocumentNameIndex::isNameLess(TreeNodeId lhs, TreeNodeId rhs) const
+{
+    return m_vecFoldedName.at(lhs) < m_vecFoldedName.at(rhs);
+}
+
+} // namespace Mayo
@@ -0,0 +1,54 @@
+/****************************************************************************
+** Copyright (c) 2021, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#pragma once
+
+#include "libtree.h"
+#include <QtCore/QString>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace Mayo {
+
+// Provides fast lookup of document tree nodes by name, comparison is case-insensitive
+// Patterns shorter than 3 characters are matched against the beginning of the names(sorted array
+// lookup), longer patterns are matched anywhere in the names(trigram index lookup)
+class DocumentNameIndex {
+public:
+    struct Entry {
+        TreeNodeId nodeId;
+        QString name;
+    };
+
+    // Replaces contents of the index
+    void build(const std::vector<Entry>& vecEntry);
+    void clear();
+
+    // Adds or updates the name associated to tree node 'nodeId'
+    void setName(TreeNodeId nodeId, const QString& name);
+
+    bool contains(TreeNodeId nodeId) const;
+    int size() const { return int(m_vecSortedNodeId.size()); }
+    bool isEmpty() const { return m_vecSortedNodeId.empty(); }
+
+    // Returns identifiers of the tree nodes whose name matches 'pattern', at most 'maxCount' results
+    // are returned(no limit if negative)
+    std::vector<TreeNodeId> findNodes(const QString& pattern, int maxCount = -1) const;
+
+private:
+    using TrigramKey = uint64_t;
+    static std::vector<TrigramKey> trigramKeys(const QString& str);
+
+    bool isNameLess(TreeNodeId lhs, TreeNodeId rhs) const;
+
+    std::vector<QString> m_vecFoldedName; // Indexed with TreeNodeId
+    std::vector<bool> m_vecHasName; // Indexed with TreeNodeId
+    std::vector<TreeNodeId> m_vecSortedNodeId; // Sorted by names
+    std::unordered_map<TrigramKey, std::vector<TreeNodeId>> m_mapTrigramNodes;
+};
+
+} // namespace Mayo
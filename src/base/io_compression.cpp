@@ -0,0 +1,874 @@
+/****************************************************************************
+** Copyright (c) 2021, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#include "io_compression.h"
+
+#include "global.h"
+#include "tracing.h"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef HAVE_ZLIB
+#  include <zlib.h>
+#endif
+
+#ifdef HAVE_ZSTD
+#  include <zstd.h>
+#endif
+
+namespace Mayo {
+namespace IO {
+
+namespace {
+
+uint16_t readLE16(const char* bytes)
+{
+    const auto ubytes = reinterpret_cast<const uint8_t*>(bytes);
+    return uint16_t(ubytes[0] | (ubytes[1] << 8));
+}
+
+uint32_t readLE32(const char* bytes)
+{
+    const auto ubytes = reinterpret_cast<const uint8_t*>(bytes);
+    return uint32_t(ubytes[0])
+            | (uint32_t(ubytes[1]) << 8)
+            | (uint32_t(ubytes[2]) << 16)
+            | (uint32_t(ubytes[3]) << 24);
+}
+
+// Fields of interest of a zip "local file header", see APPNOTE.TXT section 4.3.7
+struct ZipLocalHeader {
+    enum Flag { Flag_Encrypted = 0x0001, Flag_DataDescriptor = 0x0008 };
+    enum Method { Method_Stored = 0, Method_Deflated = 8 };
+    uint16_t flags;
+    uint16_t method;
+    uint32_t compressedSize;
+    uint32_t uncompressedSize;
+    std::string filename;
+};
+
+// Reads the local header of the first zip entry, 'input' is then positioned at the entry data
+bool readZipLocalHeader(std::istream& input, ZipLocalHeader* header)
+{
+    std::array<char, 30> bytes;
+    input.read(bytes.data(), bytes.size());
+    if (input.gcount() != std::streamsize(bytes.size()) || readLE32(bytes.data()) != 0x04034b50)
+        return false;
+
+    header->flags = readLE16(bytes.data() + 6);
+    header->method = readLE16(bytes.data() + 8);
+    header->compressedSize = readLE32(bytes.data() + 18);
+    header->uncompressedSize = readLE32(bytes.data() + 22);
+    const uint16_t filenameLength = readLE16(bytes.data() + 26);
+    const uint16_t extraFieldLength = readLE16(bytes.data() + 28);
+    header->filename.resize(filenameLength);
+    input.read(header->filename.data(), filenameLength);
+    input.ignore(extraFieldLength);
+    return bool(input);
+}
+
+// Case-insensitive comparison of the extension of 'filepath' with 'strSuffix'(lowercase)
+bool filepathExtensionIs(const FilePath& filepath, std::string_view strSuffix)
+{
+    const std::string ext = filepath.extension().u8string();
+    return std::equal(ext.cbegin(), ext.cend(), strSuffix.cbegin(), strSuffix.cend(), [](char lhs, char rhs) {
+        return std::tolower(static_cast<unsigned char>(lhs)) == rhs;
+    });
+}
+
+// Accumulates decompressed bytes into fixed-size blocks, handed over to the consumer of the stream
+class BlockOutput {
+public:
+    using PushFunction = std::function<bool (std::vector<char>&&)>;
+
+    BlockOutput(size_t blockSize, const PushFunction& fnPush)
+        : m_blockSize(blockSize), m_fnPush(fnPush), m_block(blockSize)
+    {}
+
+    char* data() { return m_block.data() + m_blockUsedSize; }
+    size_t available() const { return m_block.size() - m_blockUsedSize; }
+
+    // Marks 'count' bytes as written into data(), the block is handed over when full
+    // Returns false if the consumer does not want more data
+    bool commit(size_t count) {
+        m_blockUsedSize += count;
+        return m_blockUsedSize < m_block.size() || this->flush();
+    }
+
+    bool flush() {
+        if (m_blockUsedSize == 0)
+            return true;
+
+        m_block.resize(m_blockUsedSize);
+        const bool ok = m_fnPush(std::move(m_block));
+        m_block = std::vector<char>(m_blockSize);
+        m_blockUsedSize = 0;
+        return ok;
+    }
+
+private:
+    const size_t m_blockSize;
+    PushFunction m_fnPush;
+    std::vector<char> m_block;
+    size_t m_blockUsedSize = 0;
+};
+
+constexpr size_t InputChunkSize = 64 * 1024;
+
+#ifdef HAVE_ZLIB
+// 'windowBits' is the zlib inflateInit2() parameter selecting the wrapper(gzip, raw deflate, ...)
+// 'isMultiMember' allows concatenated gzip members, as produced by parallel gzip tools
+bool zlibInflate(
+        std::istream& input, BlockOutput& output, int windowBits, bool isMultiMember, QString* errorString)
+{
+    z_stream zstream = {};
+    if (inflateInit2(&zstream, windowBits) != Z_OK) {
+        *errorString = DecompressionIStream::tr("zlib initialization failed");
+        return false;
+    }
+
+    std::vector<char> inputChunk(InputChunkSize);
+    int ret = Z_OK;
+    bool ok = true;
+    while (ok) {
+        if (zstream.avail_in == 0) {
+            input.read(inputChunk.data(), inputChunk.size());
+            zstream.next_in = reinterpret_cast<Bytef*>(inputChunk.data());
+            zstream.avail_in = uInt(input.gcount());
+            if (zstream.avail_in == 0)
+                break; // End of input
+        }
+
+        zstream.next_out = reinterpret_cast<Bytef*>(output.data());
+        zstream.avail_out = uInt(output.available());
+        ret = inflate(&zstream, Z_NO_FLUSH);
+        if (ret == Z_NEED_DICT || ret == Z_DATA_ERROR || ret == Z_MEM_ERROR) {
+            *errorString = DecompressionIStream::tr("Corrupted compressed data(%1)")
+                    .arg(zstream.msg ? zstream.msg : "zlib error");
+            ok = false;
+            break;
+        }
+
+        ok = output.commit(output.available() - zstream.avail_out);
+        if (ret == Z_STREAM_END) {
+            if (!isMultiMember || (zstream.avail_in == 0 && input.peek() == std::istream::traits_type::eof()))
+                break;
+
+            inflateReset(&zstream);
+        }
+    }
+
+    inflateEnd(&zstream);
+    if (ok && ret != Z_STREAM_END) {
+        *errorString = DecompressionIStream::tr("Unexpected end of compressed data");
+        ok = false;
+    }
+
+    return ok && output.flush();
+}
+#endif
+
+bool decompressGzip(std::istream& input, BlockOutput& output, QString* errorString)
+{
+#ifdef HAVE_ZLIB
+    return zlibInflate(input, output, 16 + MAX_WBITS, true, errorString);
+#else
+    MAYO_UNUSED(input);
+    MAYO_UNUSED(output);
+    MAYO_UNUSED(errorString);
+    return false;
+#endif
+}
+
+bool decompressZip(std::istream& input, BlockOutput& output, QString* errorString)
+{
+    ZipLocalHeader header = {};
+    if (!readZipLocalHeader(input, &header)) {
+        *errorString = DecompressionIStream::tr("Invalid zip archive");
+        return false;
+    }
+
+    if (header.flags & ZipLocalHeader::Flag_Encrypted) {
+        *errorString = DecompressionIStream::tr("Encrypted zip archives are not supported");
+        return false;
+    }
+
+#ifdef HAVE_ZLIB
+    if (header.method == ZipLocalHeader::Method_Deflated)
+        return zlibInflate(input, output, -MAX_WBITS, false, errorString);
+#endif
+
+    if (header.method == ZipLocalHeader::Method_Stored
+            && !(header.flags & ZipLocalHeader::Flag_DataDescriptor))
+    {
+        uint64_t remainingSize = header.compressedSize;
+        while (remainingSize > 0) {
+            const size_t count = size_t(std::min<uint64_t>(remainingSize, output.available()));
+            input.read(output.data(), count);
+            if (input.gcount() != std::streamsize(count)) {
+                *errorString = DecompressionIStream::tr("Unexpected end of compressed data");
+                return false;
+            }
+
+            remainingSize -= count;
+            if (!output.commit(count))
+                return false;
+        }
+
+        return output.flush();
+    }
+
+    *errorString = DecompressionIStream::tr("Unsupported zip compression method %1").arg(header.method);
+    return false;
+}
+
+bool decompressZstd(std::istream& input, BlockOutput& output, QString* errorString)
+{
+#ifdef HAVE_ZSTD
+    ZSTD_DStream* zstream = ZSTD_createDStream();
+    ZSTD_initDStream(zstream);
+    std::vector<char> inputChunk(InputChunkSize);
+    size_t ret = 0;
+    bool ok = true;
+    while (ok) {
+        input.read(inputChunk.data(), inputChunk.size());
+        ZSTD_inBuffer zinput = { inputChunk.data(), size_t(input.gcount()), 0 };
+        if (zinput.size == 0)
+            break; // End of input
+
+        bool isOutputFull = false;
+        while (ok && (zinput.pos < zinput.size || isOutputFull)) {
+            ZSTD_outBuffer zoutput = { output.data(), output.available(), 0 };
+            ret = ZSTD_decompressStream(zstream, &zoutput, &zinput);
+            if (ZSTD_isError(ret)) {
+                *errorString = DecompressionIStream::tr("Corrupted compressed data(%1)")
+                        .arg(ZSTD_getErrorName(ret));
+                ok = false;
+                break;
+            }
+
+            // Some decoded data might still be buffered by zstd if the output block was filled
+            isOutputFull = zoutput.pos == zoutput.size;
+            ok = output.commit(zoutput.pos);
+        }
+    }
+
+    ZSTD_freeDStream(zstream);
+    if (ok && ret != 0) {
+        *errorString = DecompressionIStream::tr("Unexpected end of compressed data");
+        ok = false;
+    }
+
+    return ok && output.flush();
+#else
+    MAYO_UNUSED(input);
+    MAYO_UNUSED(output);
+    MAYO_UNUSED(errorString);
+    return false;
+#endif
+}
+
+bool decompress(std::istream& input, Compression compression, BlockOutput& output, QString* errorString)
+{
+    switch (compression) {
+    case Compression::None:
+        return true;
+    case Compression::Gzip:
+        return decompressGzip(input, output, errorString);
+    case Compression::Zip:
+        return decompressZip(input, output, errorString);
+    case Compression::Zstd:
+        return decompressZstd(input, output, errorString);
+    }
+
+    return false;
+}
+
+// Compresses 'size' bytes of 'data' into a complete gzip member or zstd frame
+bool compressBlock(
+        Compression compression,
+        int level,
+        const char* data,
+        size_t size,
+        std::vector<char>* output,
+        QString* errorString)
+{
+    MAYO_TRACE_SCOPE("IO::CompressionOStream::compressBlock", "io");
+    switch (compression) {
+#ifdef HAVE_ZLIB
+    case Compression::Gzip: {
+        z_stream zstream = {};
+        const int zlevel = level >= 0 ? level : Z_DEFAULT_COMPRESSION;
+        if (deflateInit2(&zstream, zlevel, Z_DEFLATED, 16 + MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+            *errorString = CompressionOStream::tr("zlib initialization failed");
+            return false;
+        }
+
+        output->resize(deflateBound(&zstream, uLong(size)));
+        zstream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+        zstream.avail_in = uInt(size);
+        zstream.next_out = reinterpret_cast<Bytef*>(output->data());
+        zstream.avail_out = uInt(output->size());
+        const int ret = deflate(&zstream, Z_FINISH);
+        output->resize(zstream.total_out);
+        deflateEnd(&zstream);
+        if (ret != Z_STREAM_END) {
+            *errorString = CompressionOStream::tr("zlib compression failed");
+            return false;
+        }
+
+        return true;
+    }
+#endif
+#ifdef HAVE_ZSTD
+    case Compression::Zstd: {
+        output->resize(ZSTD_compressBound(size));
+        const int zlevel = level >= 0 ? level : 0; // Zero is the default level of zstd
+        const size_t ret = ZSTD_compress(output->data(), output->size(), data, size, zlevel);
+        if (ZSTD_isError(ret)) {
+            *errorString = CompressionOStream::tr("zstd compression failed(%1)").arg(ZSTD_getErrorName(ret));
+            return false;
+        }
+
+        output->resize(ret);
+        return true;
+    }
+#endif
+    default:
+        MAYO_UNUSED(level);
+        MAYO_UNUSED(data);
+        MAYO_UNUSED(size);
+        MAYO_UNUSED(output);
+        *errorString = CompressionOStream::tr("Compression not supported by this build");
+        return false;
+    }
+}
+
+} // namespace
+
+Compression probeCompression(const QByteArray& contentsBegin)
+{
+    if (contentsBegin.startsWith("\x1f\x8b"))
+        return Compression::Gzip;
+    else if (contentsBegin.startsWith("PK\x03\x04"))
+        return Compression::Zip;
+    else if (contentsBegin.startsWith("\x28\xb5\x2f\xfd"))
+        return Compression::Zstd;
+    else
+        return Compression::None;
+}
+
+bool isDecompressionSupported(Compression compression)
+{
+    switch (compression) {
+    case Compression::None:
+        return true;
+#ifdef HAVE_ZLIB
+    case Compression::Gzip:
+    case Compression::Zip:
+        return true;
+#endif
+#ifdef HAVE_ZSTD
+    case Compression::Zstd:
+        return true;
+#endif
+    default:
+        return false;
+    }
+}
+
+bool isCompressionSupported(Compression compression)
+{
+    switch (compression) {
+    case Compression::None:
+        return true;
+#ifdef HAVE_ZLIB
+    case Compression::Gzip:
+        return true;
+#endif
+#ifdef HAVE_ZSTD
+    case Compression::Zstd:
+        return true;
+#endif
+    default:
+        return false;
+    }
+}
+
+Compression compressionFromFilepathSuffix(const FilePath& filepath)
+{
+    if (filepathExtensionIs(filepath, ".gz") || filepathExtensionIs(filepath, ".stpz"))
+        return Compression::Gzip;
+    else if (filepathExtensionIs(filepath, ".zst"))
+        return Compression::Zstd;
+    else
+        return Compression::None;
+}
+
+FilePath stripCompressionSuffix(const FilePath& filepath)
+{
+    if (filepathExtensionIs(filepath, ".gz") || filepathExtensionIs(filepath, ".zst"))
+        return filepath.parent_path() / filepath.stem();
+
+    // ISO 10303-21 names gzip-compressed STEP files with the "stpZ" suffix
+    if (filepathExtensionIs(filepath, ".stpz"))
+        return FilePath(filepath).replace_extension(".stp");
+
+    return filepath;
+}
+
+CompressedFileInfo compressedFileInfo(const FilePath& filepath)
+{
+    CompressedFileInfo info;
+    info.innerFilepath = filepath;
+    std::ifstream file(filepath, std::ios::binary);
+    if (!file.is_open())
+        return info;
+
+    std::array<char, 32> bytes = {};
+    file.read(bytes.data(), bytes.size());
+    const std::streamsize bytesCount = file.gcount();
+    info.compression = probeCompression(QByteArray::fromRawData(bytes.data(), int(bytesCount)));
+    switch (info.compression) {
+    case Compression::None:
+        break;
+    case Compression::Gzip:
+        // Size is left unknown: trailing ISIZE field is the size of the last gzip member only,
+        // wrong for multi-member files(eg written by CompressionOStream). Telling a file is made
+        // of a single member requires to decompress it entirely
+        info.innerFilepath = stripCompressionSuffix(filepath);
+        break;
+    case Compression::Zip: {
+        file.clear();
+        file.seekg(0);
+        ZipLocalHeader header = {};
+        if (readZipLocalHeader(file, &header)) {
+            const FilePath entryFilepath = std::filesystem::u8path(header.filename);
+            info.innerFilepath = filepath.parent_path() / entryFilepath.filename();
+            // Sizes are zero when provided after the entry data(data descriptor)
+            if (!(header.flags & ZipLocalHeader::Flag_DataDescriptor) && header.uncompressedSize != UINT32_MAX)
+                info.uncompressedSize = header.uncompressedSize;
+        }
+        break;
+    }
+    case Compression::Zstd:
+        // Same as gzip: content size of the first frame is wrong for multi-frame files
+        info.innerFilepath = stripCompressionSuffix(filepath);
+        break;
+    } // endswitch
+
+    return info;
+}
+
+size_t decompressHead(const FilePath& filepath, Compression compression, char* buffer, size_t size)
+{
+    if (!buffer || size == 0 || !isDecompressionSupported(compression))
+        return 0;
+
+    std::ifstream file(filepath, std::ios::binary);
+    if (!file.is_open())
+        return 0;
+
+    // Single block output, decompression stops as soon as the block is full
+    size_t headSize = 0;
+    BlockOutput output(size, [&](std::vector<char>&& block) {
+        headSize = std::min(block.size(), size);
+        std::copy(block.cbegin(), block.cbegin() + headSize, buffer);
+        return false;
+    });
+    QString errorString;
+    decompress(file, compression, output, &errorString);
+    return headSize;
+}
+
+// Stream buffer filled by a decompression thread(producer) and read by the thread using the
+// stream(consumer). Both threads are synchronized with a bounded queue of blocks, the producer
+// waits when the queue is full so memory usage is capped whatever the size of the file
+class DecompressionIStream::Buffer : public std::streambuf {
+public:
+    Buffer(const FilePath& filepath, Compression compression)
+    {
+        m_thread = std::thread([=]{ this->run(filepath, compression); });
+    }
+
+    ~Buffer()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex); MAYO_UNUSED(lock);
+            m_isAbortRequested = true;
+        }
+
+        m_condition.notify_all();
+        m_thread.join();
+    }
+
+    QString errorString() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex); MAYO_UNUSED(lock);
+        return m_errorString;
+    }
+
+protected:
+    int_type underflow() override
+    {
+        if (this->gptr() < this->egptr())
+            return traits_type::to_int_type(*this->gptr());
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_condition.wait(lock, [=]{ return !m_queueBlock.empty() || m_isDecompressionDone; });
+        if (m_queueBlock.empty())
+            return traits_type::eof();
+
+        m_currentBlockPos += m_currentBlock.size();
+        m_currentBlock = std::move(m_queueBlock.front());
+        m_queueBlock.pop_front();
+        lock.unlock();
+        m_condition.notify_all(); // Queue has room for the producer
+
+        char* blockBegin = m_currentBlock.data();
+        this->setg(blockBegin, blockBegin, blockBegin + m_currentBlock.size());
+        return traits_type::to_int_type(*blockBegin);
+    }
+
+    // Only tellg() is supported, readers use it to report progress
+    pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override
+    {
+        if (off == 0 && dir == std::ios_base::cur && (which & std::ios_base::in))
+            return pos_type(off_type(m_currentBlockPos + (this->gptr() - this->eback())));
+
+        return pos_type(off_type(-1));
+    }
+
+private:
+    static constexpr size_t BlockSize = 256 * 1024;
+    static constexpr size_t MaxQueuedBlockCount = 8;
+
+    // Executed by the decompression thread
+    void run(const FilePath& filepath, Compression compression)
+    {
+        MAYO_TRACE_SCOPE("IO::DecompressionIStream::decompress", "io");
+        BlockOutput output(BlockSize, [=](std::vector<char>&& block) {
+            return this->pushBlock(std::move(block));
+        });
+        QString errorString;
+        std::ifstream file(filepath, std::ios::binary);
+        if (!file.is_open()) {
+            errorString = tr("Can't open file");
+        }
+        else if (!isDecompressionSupported(compression)) {
+            errorString = tr("Decompression not supported by this build");
+        }
+        else {
+            decompress(file, compression, output, &errorString);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex); MAYO_UNUSED(lock);
+            m_isDecompressionDone = true;
+            if (!m_isAbortRequested)
+                m_errorString = errorString;
+        }
+
+        m_condition.notify_all();
+    }
+
+    // Executed by the decompression thread, returns false if the stream is being destroyed
+    bool pushBlock(std::vector<char>&& block)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_condition.wait(lock, [=]{ return m_queueBlock.size() < MaxQueuedBlockCount || m_isAbortRequested; });
+        if (m_isAbortRequested)
+            return false;
+
+        m_queueBlock.push_back(std::move(block));
+        lock.unlock();
+        m_condition.notify_all();
+        return true;
+    }
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::deque<std::vector<char>> m_queueBlock;
+    bool m_isDecompressionDone = false;
+    bool m_isAbortRequested = false;
+    QString m_errorString;
+
+    // Accessed by consumer thread only
+    std::vector<char> m_currentBlock;
+    int64_t m_currentBlockPos = 0;
+
+    std::thread m_thread;
+};
+
+DecompressionIStream::DecompressionIStream(const FilePath& filepath, Compression compression)
+    : std::istream(nullptr),
+      m_buffer(std::make_unique<Buffer>(filepath, compression))
+{
+    this->rdbuf(m_buffer.get());
+}
+
+DecompressionIStream::~DecompressionIStream()
+{
+}
+
+QString DecompressionIStream::errorString() const
+{
+    return m_buffer->errorString();
+}
+
+// Stream buffer whose put area is a block of uncompressed data. Each full block is handed over to
+// a fixed set of worker threads compressing blocks independently of each other. Compressed blocks
+// are written to the file in submission order, the count of pending blocks is bounded so memory
+// usage is capped
+class CompressionOStream::Buffer : public std::streambuf {
+public:
+    Buffer(const FilePath& filepath, Compression compression, const CompressionOptions& options)
+        : m_compression(compression),
+          m_level(options.level),
+          m_blockSize(std::max<size_t>(options.blockSize, 4096)),
+          m_maxPendingBlockCount(options.maxConcurrentBlockCount)
+    {
+        if (m_maxPendingBlockCount <= 0)
+            m_maxPendingBlockCount = std::max(int(std::thread::hardware_concurrency()), 1);
+
+        if (!isCompressionSupported(compression) || compression == Compression::None)
+            m_errorString = tr("Compression not supported by this build");
+
+        m_file.open(filepath, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!m_file.is_open() && m_errorString.isEmpty())
+            m_errorString = tr("Can't open file");
+
+        this->resetPutArea();
+    }
+
+    ~Buffer()
+    {
+        this->close();
+    }
+
+    bool close()
+    {
+        if (!m_isOpen)
+            return m_errorString.isEmpty();
+
+        this->submitBlock();
+        // An empty input still has to produce a valid(empty) gzip member/zstd frame
+        if (!m_hasSubmittedBlocks)
+            this->submitBlock(true);
+
+        while (!m_queuePendingBlock.empty())
+            this->writeFrontBlock();
+
+        this->stopWorkers();
+        m_file.close();
+        if (m_file.fail() && m_errorString.isEmpty())
+            m_errorString = tr("Can't write file");
+
+        m_isOpen = false;
+        return m_errorString.isEmpty();
+    }
+
+    const QString& errorString() const { return m_errorString; }
+
+protected:
+    int_type overflow(int_type ch) override
+    {
+        if (!this->submitBlock())
+            return traits_type::eof();
+
+        if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+            *this->pptr() = traits_type::to_char_type(ch);
+            this->pbump(1);
+        }
+
+        return traits_type::not_eof(ch);
+    }
+
+    // Blocks are compressed only when full, flushing the stream(eg with std::endl) must not produce
+    // a flurry of tiny gzip members/zstd frames
+    int sync() override
+    {
+        return m_errorString.isEmpty() ? 0 : -1;
+    }
+
+private:
+    struct PendingBlock {
+        std::vector<char> input;
+        std::vector<char> output;
+        QString errorString;
+        bool ok = false;
+        bool isDone = false; // Guarded by 'm_mutex'
+    };
+
+    void resetPutArea()
+    {
+        m_currentBlock.resize(m_blockSize);
+        char* blockBegin = m_currentBlock.data();
+        this->setp(blockBegin, blockBegin + m_currentBlock.size());
+    }
+
+    // Submits the data of the put area to the worker threads, returns false on error
+    bool submitBlock(bool allowEmpty = false)
+    {
+        if (!m_isOpen || !m_errorString.isEmpty())
+            return false;
+
+        const size_t blockDataSize = this->pptr() - this->pbase();
+        if (blockDataSize == 0 && !allowEmpty)
+            return true;
+
+        while (int(m_queuePendingBlock.size()) >= m_maxPendingBlockCount)
+            this->writeFrontBlock();
+
+        m_currentBlock.resize(blockDataSize);
+        auto block = std::make_unique<PendingBlock>();
+        block->input = std::move(m_currentBlock);
+        {
+            std::lock_guard<std::mutex> lock(m_mutex); MAYO_UNUSED(lock);
+            m_queueBlockToCompress.push_back(block.get());
+        }
+
+        m_conditionBlockToCompress.notify_one();
+        m_queuePendingBlock.push_back(std::move(block));
+        // Workers are started on demand, so small outputs don't spawn useless threads
+        if (m_vecWorker.size() < m_queuePendingBlock.size())
+            m_vecWorker.emplace_back([=]{ this->runWorker(); });
+
+        m_hasSubmittedBlocks = true;
+        m_currentBlock = {};
+        this->resetPutArea();
+        return m_errorString.isEmpty();
+    }
+
+    // Waits for the oldest pending block to be compressed and writes its output
+    void writeFrontBlock()
+    {
+        std::unique_ptr<PendingBlock> block = std::move(m_queuePendingBlock.front());
+        m_queuePendingBlock.pop_front();
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_conditionBlockDone.wait(lock, [&]{ return block->isDone; });
+        }
+
+        if (!m_errorString.isEmpty())
+            return;
+
+        if (!block->ok) {
+            m_errorString = block->errorString;
+            return;
+        }
+
+        m_file.write(block->output.data(), block->output.size());
+        if (m_file.fail())
+            m_errorString = tr("Can't write file");
+    }
+
+    // Executed by worker threads, until stopWorkers() is called
+    void runWorker()
+    {
+        for (;;) {
+            PendingBlock* block = nullptr;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_conditionBlockToCompress.wait(lock, [=]{
+                    return !m_queueBlockToCompress.empty() || m_isStopRequested;
+                });
+                if (m_queueBlockToCompress.empty())
+                    return;
+
+                block = m_queueBlockToCompress.front();
+                m_queueBlockToCompress.pop_front();
+            }
+
+            block->ok = compressBlock(
+                        m_compression, m_level,
+                        block->input.data(), block->input.size(),
+                        &block->output, &block->errorString);
+            block->input = {}; // Release memory
+            {
+                std::lock_guard<std::mutex> lock(m_mutex); MAYO_UNUSED(lock);
+                block->isDone = true;
+            }
+
+            m_conditionBlockDone.notify_all();
+        }
+    }
+
+    // Pending blocks must have been written before
+    void stopWorkers()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex); MAYO_UNUSED(lock);
+            m_isStopRequested = true;
+        }
+
+        m_conditionBlockToCompress.notify_all();
+        for (std::thread& worker : m_vecWorker)
+            worker.join();
+
+        m_vecWorker.clear();
+    }
+
+    const Compression m_compression;
+    const int m_level;
+    const size_t m_blockSize;
+    int m_maxPendingBlockCount;
+    std::ofstream m_file;
+    std::vector<char> m_currentBlock;
+    std::deque<std::unique_ptr<PendingBlock>> m_queuePendingBlock; // In submission order
+    bool m_hasSubmittedBlocks = false;
+    bool m_isOpen = true;
+    QString m_errorString;
+
+    // Shared with worker threads
+    std::mutex m_mutex;
+    std::condition_variable m_conditionBlockToCompress;
+    std::condition_variable m_conditionBlockDone;
+    std::deque<PendingBlock*> m_queueBlockToCompress;
+    bool m_isStopRequested = false;
+    std::vector<std::thread> m_vecWorker; // Accessed by owner thread only
+};
+
+CompressionOStream::CompressionOStream(
+        const FilePath& filepath, Compression compression, const CompressionOptions& options)
+    : std::ostream(nullptr),
+      m_buffer(std::make_unique<Buffer>(filepath, compression, options))
+{
+    this->rdbuf(m_buffer.get());
+}
+
+CompressionOStream::~CompressionOStream()
+{
+}
+
+bool CompressionOStream::close()
+{
+    this->flush();
+    const bool ok = m_buffer->close();
+    if (!ok)
+        this->setstate(std::ios::badbit);
+
+    return ok;
+}
+
+QString CompressionOStream::errorString() const
+{
+    return m_buffer->errorString();
+}
+
+} // namespace IO
+} // namespace Mayo
@@ -0,0 +1,107 @@
+/****************************************************************************
+** Copyright (c) 2021, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#pragma once
+
+#include "filepath.h"
+
+#include <QtCore/QByteArray>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QString>
+#include <cstdint>
+#include <istream>
+#include <memory>
+
+namespace Mayo {
+namespace IO {
+
+// Container wrapping the contents of a compressed file
+enum class Compression {
+    None,
+    Gzip, // Requires zlib(HAVE_ZLIB)
+    Zip,  // Requires zlib(HAVE_ZLIB), only the first entry of the archive is read. Input only
+    Zstd  // Requires libzstd(HAVE_ZSTD)
+};
+
+// Identifies the compression container from the first bytes(magic number) of a file
+Compression probeCompression(const QByteArray& contentsBegin);
+
+// Whether the current build is able to decompress 'compression' containers
+bool isDecompressionSupported(Compression compression);
+
+// Whether the current build is able to write 'compression' containers
+bool isCompressionSupported(Compression compression);
+
+// Compression implied by the suffix of 'filepath': "gz" and "stpZ" for gzip, "zst" for zstd
+Compression compressionFromFilepathSuffix(const FilePath& filepath);
+
+// Returns 'filepath' without its compression suffix, eg "part.step.gz" -> "part.step"
+FilePath stripCompressionSuffix(const FilePath& filepath);
+
+struct CompressedFileInfo {
+    Compression compression = Compression::None;
+    // Path of the file before compression(eg "part.step" for "part.step.gz"), for zip archives
+    // this is the name of the first entry
+    FilePath innerFilepath;
+    uint64_t uncompressedSize = 0; // Zero if unknown, always the case for gzip and zstd
+};
+
+// Returns compression information about file 'filepath', Compression::None if not compressed
+CompressedFileInfo compressedFileInfo(const FilePath& filepath);
+
+// Decompresses the beginning of file 'filepath' into 'buffer', in the calling thread
+// Decompression stops once 'size' bytes are written, returns the count of bytes written
+// Cheaper than DecompressionIStream to read a few bytes(eg to probe the format of the contents)
+size_t decompressHead(const FilePath& filepath, Compression compression, char* buffer, size_t size);
+
+// Input stream providing the decompressed contents of a file
+// Decompression is performed by a separate thread that fills a bounded queue of blocks, so it
+// overlaps with the parsing done by the thread consuming the stream. No temporary file is created
+// Seeking is not supported, except tellg()
+class DecompressionIStream : public std::istream {
+    Q_DECLARE_TR_FUNCTIONS(Mayo::IO::DecompressionIStream)
+public:
+    DecompressionIStream(const FilePath& filepath, Compression compression);
+    ~DecompressionIStream();
+
+    // Error reported by the decompression thread, empty if none
+    QString errorString() const;
+
+private:
+    class Buffer;
+    std::unique_ptr<Buffer> m_buffer;
+};
+
+struct CompressionOptions {
+    int level = -1; // -1 means the default level of the compression library
+    size_t blockSize = 1024 * 1024; // Size of the uncompressed blocks
+    int maxConcurrentBlockCount = 0; // Zero means the count of hardware threads
+};
+
+// Output stream compressing the data written into it to file 'filepath'
+// Data is split into blocks compressed independently and concurrently(pigz-style), each block
+// being a gzip member or a zstd frame. Concatenated members/frames form a valid gzip/zstd file,
+// readable by any decoder. Blocks are written in order, the count of blocks in flight is bounded
+// Seeking is not supported
+class CompressionOStream : public std::ostream {
+    Q_DECLARE_TR_FUNCTIONS(Mayo::IO::CompressionOStream)
+public:
+    CompressionOStream(const FilePath& filepath, Compression compression, const CompressionOptions& options);
+    ~CompressionOStream();
+
+    // Compresses pending data and closes the file, returns false if an error occurred
+    bool close();
+
+    // Error reported by the compression of blocks or the file output, empty if none
+    QString errorString() const;
+
+private:
+    class Buffer;
+    std::unique_ptr<Buffer> m_buffer;
+};
+
+} // namespace IO
+} // namespace Mayo
@@ -11,6 +11,7 @@
 #include "io_format.h"
 #include "span.h"
 #include <TDF_LabelSequence.hxx>
+#include <istream>
 #include <memory>
 
 namespace Mayo {
@@ -24,6 +25,14 @@ class Reader {
 public:
     virtual ~Reader() = default;
     virtual bool readFile(const FilePath& fp, TaskProgress* progress) = 0;
+
+    // Reading from a stream is used for compressed files, which are decompressed on the fly
+    // 'fp' is the path of the file before compression(eg "part.step" for "part.step.gz")
+    virtual bool canReadStream() const { return false; }
+    virtual bool readStream(std::istream& /*istr*/, const FilePath& /*fp*/, TaskProgress* /*progress*/) {
+        return false;
+    }
+
     virtual TDF_LabelSequence transfer(DocumentPtr doc, TaskProgress* progress) = 0;
     virtual void applyProperties(const PropertyGroup* /*params*/) {}
 };
@@ -7,6 +7,7 @@
 #include "io_system.h"
 
 #include "document.h"
+#include "io_compression.h"
 #include "io_parameters_provider.h"
 #include "io_reader.h"
 #include "io_writer.h"
@@ -14,9 +15,12 @@
 #include "string_utils.h"
 #include "task_manager.h"
 #include "task_progress.h"
+#include "tracing.h"
 
 #include <algorithm>
 #include <array>
+#include <cmath>
+#include <cstring>
 #include <fstream>
 #include <future>
 #include <locale>
@@ -55,8 +59,11 @@ void System::addFormatProbe(const FormatProbe& probe)
 
 Format System::probeFormat(const FilePath& filepath) const
 {
+    // Compressed files are probed against their decompressed contents
+    // Suffix is also stripped for files not yet existing, eg export target "part.stl.gz"
+    FilePath contentsFilepath = stripCompressionSuffix(filepath);
     std::ifstream file;
-    file.open(filepath);
+    file.open(filepath, std::ios::binary);
     if (file.is_open()) {
         std::array<char, 2048> buff;
         buff.fill(0);
@@ -65,6 +72,20 @@ Format System::probeFormat(const FilePath& filepath) const
         probeInput.filepath = filepath;
         probeInput.contentsBegin = QByteArray::fromRawData(buff.data(), buff.size());
         probeInput.hintFullSize = std::filesystem::file_size(filepath);
+        const Compression compression = probeCompression(probeInput.contentsBegin);
+        if (compression != Compression::None) {
+            const CompressedFileInfo compressedInfo = compressedFileInfo(filepath);
+            contentsFilepath = compressedInfo.innerFilepath;
+            buff.fill(0);
+            const size_t headSize = decompressHead(filepath, compression, buff.data(), buff.size());
+
+            probeInput.filepath = contentsFilepath;
+            probeInput.hintFullSize = compressedInfo.uncompressedSize;
+            // Decompressed contents fitting entirely in the buffer give the exact size
+            if (headSize < buff.size())
+                probeInput.hintFullSize = headSize;
+        }
+
         for (const FormatProbe& fnProbe : m_vecFormatProbe) {
             const Format format = fnProbe(probeInput);
             if (format != Format_Unknown)
@@ -73,7 +94,7 @@ Format System::probeFormat(const FilePath& filepath) const
     }
 
     // Try to guess from file suffix
-    QString fileSuffix = filepathTo<QString>(filepath.extension());
+    QString fileSuffix = filepathTo<QString>(contentsFilepath.extension());
     if (fileSuffix.startsWith('.'))
         fileSuffix.remove(0, 1);
 
@@ -195,6 +216,7 @@ bool System::importInDocument(const Args_ImportInDocument& args)
     // Maybe STEP/IGES CAF ReadFile() can be run concurrently(they should)
     // But concurrent calls to Transfer() to the same target Document must be serialized
 
+    MAYO_TRACE_SCOPE("IO::System::importInDocument", "io");
     DocumentPtr doc = args.targetDocument;
     const auto listFilepath = args.filepaths;
     TaskProgress* rootProgress = args.progress ? args.progress : nullTaskProgress();
@@ -239,6 +261,7 @@ bool System::importInDocument(const Args_ImportInDocument& args)
             portionSize *= (100 - args.entityPostProcessProgressSize) / 100.;
 
         TaskProgress progress(taskData.progress, portionSize, tr("Reading file"));
+        MAYO_TRACE_SCOPE("IO::Reader::readFile", "io");
         taskData.reader = this->createReader(taskData.fileFormat);
         if (!taskData.reader)
             return fnReadFileError(taskData.filepath, tr("No supporting reader"));
@@ -248,8 +271,26 @@ bool System::importInDocument(const Args_ImportInDocument& args)
                         args.parametersProvider->findReaderParameters(taskData.fileFormat));
         }
 
-        if (!taskData.reader->readFile(taskData.filepath, &progress))
+        const CompressedFileInfo compressedInfo = compressedFileInfo(taskData.filepath);
+        if (compressedInfo.compression != Compression::None) {
+            // Decompression thread feeds the reader, no temporary file is created
+            if (!isDecompressionSupported(compressedInfo.compression))
+                return fnReadFileError(taskData.filepath, tr("Compression format not supported"));
+
+            if (!taskData.reader->canReadStream())
+                return fnReadFileError(taskData.filepath, tr("Reader does not support compressed files"));
+
+            DecompressionIStream istr(taskData.filepath, compressedInfo.compression);
+            const bool okRead = taskData.reader->readStream(istr, compressedInfo.innerFilepath, &progress);
+            if (!istr.errorString().isEmpty())
+                return fnReadFileError(taskData.filepath, istr.errorString());
+
+            if (!okRead)
+                return fnReadFileError(taskData.filepath, tr("File read problem"));
+        }
+        else if (!taskData.reader->readFile(taskData.filepath, &progress)) {
             return fnReadFileError(taskData.filepath, tr("File read problem"));
+        }
 
         return taskData.reader.get() != nullptr;
     };
@@ -259,6 +300,7 @@ bool System::importInDocument(const Args_ImportInDocument& args)
             portionSize *= (100 - args.entityPostProcessProgressSize) / 100.;
 
         TaskProgress progress(taskData.progress, portionSize, tr("Transferring file"));
+        MAYO_TRACE_SCOPE("IO::Reader::transfer", "io");
         if (taskData.reader && !TaskProgress::isAbortRequested(&progress)) {
             taskData.seqTransferredEntity = taskData.reader->transfer(doc, &progress);
             if (taskData.seqTransferredEntity.IsEmpty())
@@ -275,6 +317,7 @@ bool System::importInDocument(const Args_ImportInDocument& args)
                     taskData.progress,
                     args.entityPostProcessProgressSize,
                     args.entityPostProcessProgressStep);
+        MAYO_TRACE_SCOPE("IO::System::entityPostProcess", "io");
         const double subPortionSize = 100. / double(taskData.seqTransferredEntity.Size());
         for (const TDF_Label& labelEntity : taskData.seqTransferredEntity) {
             TaskProgress subProgress(&progress, subPortionSize);
@@ -346,6 +389,7 @@ System::Operation_ImportInDocument System::importInDocument() {
 
 bool System::exportApplicationItems(const Args_ExportApplicationItems& args)
 {
+    MAYO_TRACE_SCOPE("IO::System::exportApplicationItems", "io");
     TaskProgress* progress = args.progress ? args.progress : nullTaskProgress();
     Messenger* messenger = args.messenger ? args.messenger : nullMessenger();
     auto fnError = [=](const QString& errorMsg) {
@@ -361,13 +405,35 @@ bool System::exportApplicationItems(const Args_ExportApplicationItems& args)
     writer->applyProperties(args.parameters);
     {
         TaskProgress transferProgress(progress, 40, tr("Transfer"));
+        MAYO_TRACE_SCOPE("IO::Writer::transfer", "io");
         const bool okTransfer = writer->transfer(args.applicationItems, &transferProgress);
         if (!okTransfer)
             return fnError(tr("File transfer problem"));
     }
 
-    {
+    if (args.targetCompression != Compression::None) {
+        if (!isCompressionSupported(args.targetCompression))
+            return fnError(tr("Compression format not supported"));
+
+        if (!writer->canWriteStream())
+            return fnError(tr("Writer does not support compressed output"));
+
+        TaskProgress writeProgress(progress, 60, tr("Write"));
+        MAYO_TRACE_SCOPE("IO::Writer::writeStream", "io");
+        CompressionOptions options;
+        options.level = args.compressionLevel;
+        CompressionOStream ostr(args.targetFilepath, args.targetCompression, options);
+        const bool okWrite = writer->writeStream(ostr, &writeProgress);
+        const bool okClose = ostr.close();
+        if (!okClose)
+            return fnError(ostr.errorString());
+
+        if (!okWrite)
+            return fnError(tr("File write problem"));
+    }
+    else {
         TaskProgress writeProgress(progress, 60, tr("Write"));
+        MAYO_TRACE_SCOPE("IO::Writer::writeFile", "io");
         const bool okWriteFile = writer->writeFile(args.targetFilepath, &writeProgress);
         if (!okWriteFile)
             return fnError(tr("File write problem"));
@@ -400,6 +466,13 @@ System::Operation_ExportApplicationItems::withParameters(const PropertyGroup* pa
     return *this;
 }
 
+System::Operation_ExportApplicationItems&
+System::Operation_ExportApplicationItems::withCompression(Compression compression, int level) {
+    m_args.targetCompression = compression;
+    m_args.compressionLevel = level;
+    return *this;
+}
+
 System::Operation_ExportApplicationItems&
 System::Operation_ExportApplicationItems::withMessenger(Messenger* messenger) {
     m_args.messenger = messenger;
@@ -507,6 +580,45 @@ auto findFirstNonSpace(const QByteArray& str) {
     return std::find_if_not(str.cbegin(), str.cend(), isSpace);
 }
 
+float readLE32Float(const uint8_t* bytes) {
+    const uint32_t bits = bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | (uint32_t(bytes[3]) << 24);
+    float value;
+    std::memcpy(&value, &bits, sizeof(float));
+    return value;
+}
+
+// Checks the facets available in 'bytes' look like binary STL facets: finite coordinates, null or
+// unit normals, not all degenerated
+// Used when the full size of the contents is unknown, so it can't be checked against 'facetsCount'
+bool isBinaryStlFacets(const uint8_t* bytes, size_t size, uint32_t facetsCount) {
+    constexpr size_t facetSize = (sizeof(float) * 12) + sizeof(uint16_t);
+    const size_t facetsInSample = std::min<size_t>(facetsCount, size / facetSize);
+    if (facetsInSample == 0)
+        return false;
+
+    bool hasNonDegeneratedFacet = false;
+    for (size_t i = 0; i < facetsInSample; ++i) {
+        const uint8_t* facet = bytes + i * facetSize;
+        std::array<float, 12> coords;
+        for (size_t j = 0; j < coords.size(); ++j) {
+            coords.at(j) = readLE32Float(facet + j * sizeof(float));
+            if (!std::isfinite(coords.at(j)))
+                return false;
+        }
+
+        const float normalSqrLength = coords.at(0) * coords.at(0) + coords.at(1) * coords.at(1) + coords.at(2) * coords.at(2);
+        if (normalSqrLength != 0.f && std::abs(normalSqrLength - 1.f) > 1e-2f)
+            return false;
+
+        const bool isDegenerated =
+                std::equal(coords.cbegin() + 3, coords.cbegin() + 6, coords.cbegin() + 6)
+                && std::equal(coords.cbegin() + 3, coords.cbegin() + 6, coords.cbegin() + 9);
+        hasNonDegeneratedFacet = hasNonDegeneratedFacet || !isDegenerated;
+    }
+
+    return hasNonDegeneratedFacet;
+}
+
 } // namespace
 
 Format probeFormat_STEP(const System::FormatProbeInput& input)
@@ -576,8 +688,13 @@ Format probeFormat_STL(const System::FormatProbeInput& input)
                     | (bytes[offset+2] << 16)
                     | (bytes[offset+3] << 24);
             constexpr unsigned facetSize = (sizeof(float) * 12) + sizeof(uint16_t);
-            if ((facetSize * facetsCount + binaryStlHeaderSize) == input.hintFullSize)
+            if (input.hintFullSize != 0) {
+                if ((facetSize * facetsCount + binaryStlHeaderSize) == input.hintFullSize)
+                    return Format_STL;
+            }
+            else if (isBinaryStlFacets(bytes + binaryStlHeaderSize, sample.size() - binaryStlHeaderSize, facetsCount)) {
                 return Format_STL;
+            }
         }
     }
 
@@ -8,6 +8,7 @@
 
 #include "application_item.h"
 #include "filepath.h"
+#include "io_compression.h"
 #include "io_format.h"
 #include "io_reader.h"
 #include "io_writer.h"
@@ -37,7 +38,7 @@ public:
     struct FormatProbeInput {
         FilePath filepath;
         QByteArray contentsBegin; // Excerpt of the file(from start)
-        uint64_t hintFullSize; // Full file size in bytes
+        uint64_t hintFullSize; // Full file size in bytes, zero if unknown(eg gzip contents)
     };
     using FormatProbe = std::function<Format (const FormatProbeInput&)>;
     void addFormatProbe(const FormatProbe& probe);
@@ -77,6 +78,8 @@ public:
         Span<const ApplicationItem> applicationItems;
         FilePath targetFilepath;
         Format targetFormat = Format_Unknown;
+        Compression targetCompression = Compression::None;
+        int compressionLevel = -1; // -1 means the default level of the compression library
         const PropertyGroup* parameters = nullptr;
         Messenger* messenger = nullptr;
         TaskProgress* progress = nullptr;
@@ -117,6 +120,7 @@ public:
         Operation& targetFormat(const Format& format);
         Operation& withItems(Span<const ApplicationItem> appItems);
         Operation& withParameters(const PropertyGroup* parameters);
+        Operation& withCompression(Compression compression, int level = -1);
         Operation& withMessenger(Messenger* messenger);
         Operation& withTaskProgress(TaskProgress* progress);
         bool execute();
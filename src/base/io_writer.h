@@ -10,6 +10,7 @@
 #include "io_format.h"
 #include "span.h"
 #include <memory>
+#include <ostream>
 
 namespace Mayo {
 
@@ -24,6 +25,11 @@ public:
     virtual ~Writer() = default;
     virtual bool transfer(Span<const ApplicationItem> appItems, TaskProgress* progress) = 0;
     virtual bool writeFile(const FilePath& fp, TaskProgress* progress) = 0;
+
+    // Writing to a stream is used for compressed output, data is compressed on the fly
+    virtual bool canWriteStream() const { return false; }
+    virtual bool writeStream(std::ostream& /*ostr*/, TaskProgress* /*progress*/) { return false; }
+
     virtual void applyProperties(const PropertyGroup* /*params*/) {}
 };
 
@@ -29,6 +29,9 @@ public:
     bool nodeIsLeaf(TreeNodeId id) const;
     Span<const TreeNodeId> roots() const;
 
+    // Bytes allocated by the tree structure, excluding memory owned by node data
+    std::size_t memorySize() const;
+
     void clear();
     TreeNodeId appendChild(TreeNodeId parentId, const T& data);
     TreeNodeId appendChild(TreeNodeId parentId, T&& data);
@@ -218,6 +221,10 @@ template<typename T> Span<const TreeNodeId> Tree<T>::roots() const {
     return m_vecRoot;
 }
 
+template<typename T> std::size_t Tree<T>::memorySize() const {
+    return m_vecNode.capacity() * sizeof(TreeNode) + m_vecRoot.capacity() * sizeof(TreeNodeId);
+}
+
 template<typename T> TreeNodeId Tree<T>::lastNodeId() const {
     return static_cast<TreeNodeId>(m_vecNode.size());
 }
@@ -0,0 +1,259 @@
+/****************************************************************************
+** Copyright (c) 2021, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#include "mass_properties.h"
+
+#include "global.h"
+#include "math_utils.h"
+#include "task_progress.h"
+#include "xcaf.h"
+
+#include <BRepGProp.hxx>
+#include <GProp_GProps.hxx>
+#include <OSD_Parallel.hxx>
+#include <Precision.hxx>
+#include <math_Jacobi.hxx>
+#include <math_Matrix.hxx>
+#include <algorithm>
+#include <cmath>
+#include <unordered_set>
+#include <vector>
+
+namespace Mayo {
+
+namespace Internal {
+
+// Count of products computed between two progress/abort checks
+static constexpr int MassPropertiesChunkSize = 64;
+
+} // namespace Internal
+
+MassProperties MassProperties::compute(const TopoDS_Shape& shape)
+{
+    MassProperties props;
+    if (shape.IsNull())
+        return props;
+
+    GProp_GProps volumeProps;
+    BRepGProp::VolumeProperties(shape, volumeProps);
+    GProp_GProps surfaceProps;
+    BRepGProp::SurfaceProperties(shape, surfaceProps);
+    props.volume = QuantityVolume(std::abs(volumeProps.Mass()));
+    props.area = QuantityArea(surfaceProps.Mass());
+    // Centroid of volume isn't defined for open shapes(eg shells), fallback to properties of surface
+    if (props.isVolumeBased()) {
+        props.centroid = volumeProps.CentreOfMass();
+        props.inertia = volumeProps.MatrixOfInertia();
+        // Volume is negative when the shape is reversed
+        if (volumeProps.Mass() < 0)
+            props.inertia.Multiply(-1.);
+    }
+    else {
+        props.centroid = surfaceProps.CentreOfMass();
+        props.inertia = surfaceProps.MatrixOfInertia();
+    }
+
+    props.isValid = true;
+    return props;
+}
+
+bool MassProperties::isVolumeBased() const
+{
+    return this->volume.value() > Precision::Confusion();
+}
+
+MassProperties MassProperties::transformed(const gp_Trsf& trsf) const
+{
+    MassProperties props = *this;
+    if (!this->isValid || trsf.Form() == gp_Identity)
+        return props;
+
+    const double scale = std::abs(trsf.ScaleFactor());
+    const gp_Mat matRotation = trsf.HVectorialPart();
+    props.volume = this->volume * (scale * scale * scale);
+    props.area = this->area * (scale * scale);
+    props.centroid = this->centroid.Transformed(trsf);
+    // Inertia is the integral of squared distances over the volume(length^5) or the surface(length^4)
+    const double inertiaScale = std::pow(scale, this->isVolumeBased() ? 5 : 4);
+    props.inertia = matRotation * this->inertia * matRotation.Transposed() * inertiaScale;
+    return props;
+}
+
+MassProperties MassProperties::combined(Span<const MassProperties> spanProps)
+{
+    MassProperties result;
+    for (const MassProperties& props : spanProps) {
+        if (props.isValid) {
+            result.volume += props.volume;
+            result.area += props.area;
+            result.isValid = true;
+        }
+    }
+
+    // Weighting is consistent with MassProperties::compute(): by volume, or by area if no volume
+    const bool isVolumeBased = result.isVolumeBased();
+    auto fnWeight = [=](const MassProperties& props) {
+        return props.isValid ? (isVolumeBased ? props.volume.value() : props.area.value()) : 0.;
+    };
+    const double totalWeight = isVolumeBased ? result.volume.value() : result.area.value();
+    if (totalWeight <= 0.)
+        return result;
+
+    gp_XYZ sumCentroid;
+    for (const MassProperties& props : spanProps)
+        sumCentroid += fnWeight(props) * props.centroid.XYZ();
+
+    result.centroid = gp_Pnt(sumCentroid / totalWeight);
+    gp_Mat matIdentity;
+    matIdentity.SetIdentity();
+    for (const MassProperties& props : spanProps) {
+        const double weight = fnWeight(props);
+        if (weight <= 0.)
+            continue;
+
+        // Parallel axis theorem: I = Ic + m*(|d|²*E - d*dT)
+        const gp_XYZ d = props.centroid.XYZ() - result.centroid.XYZ();
+        const gp_Mat matOuter(d * d.X(), d * d.Y(), d * d.Z());
+        result.inertia += props.inertia + (matIdentity * d.SquareModulus() - matOuter) * weight;
+    }
+
+    return result;
+}
+
+std::array<double, 3> MassProperties::principalMoments() const
+{
+    math_Matrix mat(1, 3, 1, 3);
+    for (int row = 1; row <= 3; ++row) {
+        for (int col = 1; col <= 3; ++col)
+            mat(row, col) = this->inertia.Value(row, col);
+    }
+
+    std::array<double, 3> moments = {};
+    const math_Jacobi jacobi(mat);
+    if (jacobi.IsDone()) {
+        for (int i = 0; i < 3; ++i)
+            moments.at(i) = jacobi.Value(i + 1);
+
+        std::sort(moments.begin(), moments.end());
+    }
+
+    return moments;
+}
+
+MassProperties MassPropertiesCache::productProperties(const TDF_Label& productLabel)
+{
+    MassProperties props;
+    if (this->findProperties(productLabel, &props))
+        return props;
+
+    if (XCaf::isShapeAssembly(productLabel)) {
+        // Components are memoized too, so products shared by several assemblies are computed once
+        std::vector<MassProperties> vecComponentProps;
+        for (const TDF_Label& componentLabel : XCaf::shapeComponents(productLabel)) {
+            const TopLoc_Location loc = XCaf::shapeReferenceLocation(componentLabel);
+            const MassProperties referredProps = this->productProperties(XCaf::shapeReferred(componentLabel));
+            vecComponentProps.push_back(referredProps.transformed(loc.Transformation()));
+        }
+
+        props = MassProperties::combined(vecComponentProps);
+    }
+    else if (XCaf::isShape(productLabel)) {
+        props = MassProperties::compute(XCaf::shape(productLabel));
+    }
+
+    this->insertProperties(productLabel, props);
+    return props;
+}
+
+MassProperties MassPropertiesCache::treeNodeProperties(const Tree<TDF_Label>& modelTree, TreeNodeId nodeId)
+{
+    const TDF_Label& nodeLabel = modelTree.nodeData(nodeId);
+    const TDF_Label productLabel =
+            XCaf::isShapeReference(nodeLabel) ? XCaf::shapeReferred(nodeLabel) : nodeLabel;
+    const TopLoc_Location absoluteLoc = XCaf::shapeAbsoluteLocation(modelTree, nodeId);
+    return this->productProperties(productLabel).transformed(absoluteLoc.Transformation());
+}
+
+MassPropertiesCache::ProductShapes MassPropertiesCache::findProductsToCompute(Span<const TDF_Label> spanProductLabel) const
+{
+    ProductShapes products;
+    std::unordered_set<TDF_Label> setLabel;
+    for (const TDF_Label& itemLabel : spanProductLabel) {
+        // Instances are mapped to their product, so each product is computed once
+        const TDF_Label label = XCaf::isShapeReference(itemLabel) ? XCaf::shapeReferred(itemLabel) : itemLabel;
+        if (!setLabel.insert(label).second)
+            continue;
+
+        if (!XCaf::isShape(label) || XCaf::isShapeAssembly(label) || this->contains(label))
+            continue;
+
+        products.vecLabel.push_back(label);
+        products.vecShape.push_back(XCaf::shape(label));
+    }
+
+    return products;
+}
+
+void MassPropertiesCache::computeProducts(const ProductShapes& products, TaskProgress* progress)
+{
+    const int count = int(std::min(products.vecLabel.size(), products.vecShape.size()));
+    std::vector<MassProperties> vecProps(count);
+    for (int iFirst = 0; iFirst < count; iFirst += Internal::MassPropertiesChunkSize) {
+        if (TaskProgress::isAbortRequested(progress))
+            return;
+
+        const int iEnd = std::min(iFirst + Internal::MassPropertiesChunkSize, count);
+        OSD_Parallel::For(iFirst, iEnd, [&](int i) {
+            vecProps.at(i) = MassProperties::compute(products.vecShape.at(i));
+        });
+
+        // Chunk results are kept even if computation is aborted later on
+        {
+            std::lock_guard<std::mutex> lock(m_mutex); MAYO_UNUSED(lock);
+            for (int i = iFirst; i < iEnd; ++i)
+                m_mapProductProps.insert({ products.vecLabel.at(i), vecProps.at(i) });
+        }
+
+        if (progress)
+            progress->setValue(MathUtils::mappedValue(iEnd, 0, count, 0, 100));
+    }
+}
+
+void MassPropertiesCache::computeProducts(Span<const TDF_Label> spanProductLabel, TaskProgress* progress)
+{
+    this->computeProducts(this->findProductsToCompute(spanProductLabel), progress);
+}
+
+bool MassPropertiesCache::contains(const TDF_Label& productLabel) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex); MAYO_UNUSED(lock);
+    return m_mapProductProps.find(productLabel) != m_mapProductProps.cend();
+}
+
+void MassPropertiesCache::clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex); MAYO_UNUSED(lock);
+    m_mapProductProps.clear();
+}
+
+bool MassPropertiesCache::findProperties(const TDF_Label& productLabel, MassProperties* props) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex); MAYO_UNUSED(lock);
+    auto itFound = m_mapProductProps.find(productLabel);
+    if (itFound == m_mapProductProps.cend())
+        return false;
+
+    *props = itFound->second;
+    return true;
+}
+
+void MassPropertiesCache::insertProperties(const TDF_Label& productLabel, const MassProperties& props)
+{
+    std::lock_guard<std::mutex> lock(m_mutex); MAYO_UNUSED(lock);
+    m_mapProductProps.insert({ productLabel, props });
+}
+
+} // namespace Mayo
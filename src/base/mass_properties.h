@@ -0,0 +1,96 @@
+/****************************************************************************
+** Copyright (c) 2021, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#pragma once
+
+#include "caf_utils.h"
+#include "libtree.h"
+#include "quantity.h"
+#include "span.h"
+
+#include <TopoDS_Shape.hxx>
+#include <gp_Mat.hxx>
+#include <gp_Pnt.hxx>
+#include <gp_Trsf.hxx>
+#include <array>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace Mayo {
+
+class TaskProgress;
+
+// Exact geometric properties of a shape, computed with BRepGProp(unit density)
+// Centroid and inertia are volume-based, or surface-based if the shape has no volume(eg shells)
+struct MassProperties {
+    bool isValid = false;
+    QuantityVolume volume{0.};
+    QuantityArea area{0.};
+    gp_Pnt centroid;
+    gp_Mat inertia; // Matrix of inertia at centroid
+
+    static MassProperties compute(const TopoDS_Shape& shape);
+
+    // Whether centroid and inertia are volume-based, otherwise they are surface-based
+    bool isVolumeBased() const;
+
+    // Returns the properties of the shape moved by 'trsf'
+    MassProperties transformed(const gp_Trsf& trsf) const;
+
+    // Returns the combined properties of the shapes of 'spanProps'
+    // Inertia is transported to the combined centroid(parallel axis theorem)
+    static MassProperties combined(Span<const MassProperties> spanProps);
+
+    // Returns the eigenvalues of the inertia matrix, sorted in ascending order
+    std::array<double, 3> principalMoments() const;
+};
+
+// Computes and memoizes the mass properties of XCAF products(ie referred shapes)
+// Properties are stored in the product coordinate system, so a product is computed once whatever
+// its count of instances. Properties of an assembly are combined from its components
+// All functions are thread-safe
+class MassPropertiesCache {
+public:
+    // Returns properties of 'productLabel', computed on first call only
+    MassProperties productProperties(const TDF_Label& productLabel);
+
+    // Returns properties of tree node 'nodeId', expressed in the absolute coordinate system
+    // If tree node is an XCAF reference then the referred product is considered
+    MassProperties treeNodeProperties(const Tree<TDF_Label>& modelTree, TreeNodeId nodeId);
+
+    // Non-assembly products along with their shapes, labels are only used as keys of the cache
+    struct ProductShapes {
+        std::vector<TDF_Label> vecLabel;
+        std::vector<TopoDS_Shape> vecShape;
+    };
+
+    // Returns the non-assembly products not memoized yet, reading the document of the labels
+    // References in 'spanProductLabel' are mapped to their referred product
+    ProductShapes findProductsToCompute(Span<const TDF_Label> spanProductLabel) const;
+
+    // Computes in parallel the properties of 'products', document isn't accessed so this function
+    // can run in a worker thread
+    void computeProducts(const ProductShapes& products, TaskProgress* progress = nullptr);
+
+    // Same as computeProducts(findProductsToCompute(spanProductLabel), progress)
+    void computeProducts(Span<const TDF_Label> spanProductLabel, TaskProgress* progress = nullptr);
+
+    // Returns true and assigns 'props' if properties of 'productLabel' are memoized
+    // Document isn't accessed
+    bool findProperties(const TDF_Label& productLabel, MassProperties* props) const;
+
+    bool contains(const TDF_Label& productLabel) const;
+    void clear();
+
+private:
+    void insertProperties(const TDF_Label& productLabel, const MassProperties& props);
+
+    mutable std::mutex m_mutex;
+    std::unordered_map<TDF_Label, MassProperties> m_mapProductProps;
+};
+
+} // namespace Mayo
@@ -0,0 +1,363 @@
+/****************************************************************************
+** Copyright (c) 2021, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#include "memory_stats.h"
+
+#include "document.h"
+#include "math_utils.h"
+#include "task_progress.h"
+
+#include <BRep_CurveRepresentation.hxx>
+#include <BRep_TEdge.hxx>
+#include <BRep_TFace.hxx>
+#include <BRep_Tool.hxx>
+#include <Geom_BezierCurve.hxx>
+#include <Geom_BezierSurface.hxx>
+#include <Geom_BSplineCurve.hxx>
+#include <Geom_BSplineSurface.hxx>
+#include <Geom_OffsetCurve.hxx>
+#include <Geom_OffsetSurface.hxx>
+#include <Geom_RectangularTrimmedSurface.hxx>
+#include <Geom_SweptSurface.hxx>
+#include <Geom_TrimmedCurve.hxx>
+#include <Geom2d_BezierCurve.hxx>
+#include <Geom2d_BSplineCurve.hxx>
+#include <Geom2d_OffsetCurve.hxx>
+#include <Geom2d_TrimmedCurve.hxx>
+#include <Poly_Polygon3D.hxx>
+#include <Poly_PolygonOnTriangulation.hxx>
+#include <TDataStd_Name.hxx>
+#include <TDataXtd_Triangulation.hxx>
+#include <TDF_AttributeIterator.hxx>
+#include <TDF_ChildIterator.hxx>
+#include <TDF_Data.hxx>
+#include <TDF_LabelNode.hxx>
+#include <TNaming_NamedShape.hxx>
+#include <TopoDS.hxx>
+#include <TopoDS_Iterator.hxx>
+#include <QtCore/QtGlobal>
+#include <unordered_set>
+
+#if defined(Q_OS_WIN)
+#  ifndef NOMINMAX
+#    define NOMINMAX
+#  endif
+#  include <windows.h>
+#  include <psapi.h>
+#elif defined(Q_OS_UNIX)
+#  include <sys/resource.h>
+#  include <unistd.h>
+#  include <fstream>
+#endif
+
+namespace Mayo {
+
+namespace Internal {
+
+// Approximate memory taken by a node of a linked list(TopoDS_ListOfShape, ...) excluding its value
+static constexpr int64_t ListNodeOverheadBytes = 2 * sizeof(void*);
+
+static int64_t rttiSize(const Handle_Standard_Transient& object)
+{
+    return !object.IsNull() ? int64_t(object->DynamicType()->Size()) : 0;
+}
+
+template<typename POINT, typename BSPLINE_CURVE>
+static int64_t bsplineCurveArraysBytes(const BSPLINE_CURVE& curve)
+{
+    const int64_t poleBytes = sizeof(POINT) + (curve->IsRational() ? sizeof(double) : 0);
+    return curve->NbPoles() * poleBytes + curve->NbKnots() * int64_t(sizeof(double) + sizeof(int));
+}
+
+template<typename POINT, typename BEZIER_CURVE>
+static int64_t bezierCurveArraysBytes(const BEZIER_CURVE& curve)
+{
+    return curve->NbPoles() * int64_t(sizeof(POINT) + (curve->IsRational() ? sizeof(double) : 0));
+}
+
+// Accumulates sizes of document objects, shared objects being accounted only once
+class DocumentMemoryStatsBuilder {
+public:
+    DocumentMemoryStatsBuilder(DocumentMemoryStats* stats)
+        : m_stats(stats)
+    {}
+
+    void addShape(const TopoDS_Shape& shape)
+    {
+        if (shape.IsNull() || !m_setTShape.insert(shape.TShape().get()).second)
+            return;
+
+        ++m_stats->shapeCount;
+        m_stats->brepTopologyBytes += rttiSize(shape.TShape());
+        for (TopoDS_Iterator it(shape, false, false); it.More(); it.Next()) {
+            m_stats->brepTopologyBytes += sizeof(TopoDS_Shape) + ListNodeOverheadBytes;
+            this->addShape(it.Value());
+        }
+
+        if (shape.ShapeType() == TopAbs_FACE) {
+            auto tface = Handle_BRep_TFace::DownCast(shape.TShape());
+            if (!tface.IsNull())
+                this->addSurface(tface->Surface());
+
+            TopLoc_Location loc;
+            this->addTriangulation(BRep_Tool::Triangulation(TopoDS::Face(shape), loc));
+        }
+        else if (shape.ShapeType() == TopAbs_EDGE) {
+            auto tedge = Handle_BRep_TEdge::DownCast(shape.TShape());
+            if (!tedge.IsNull()) {
+                for (BRep_ListIteratorOfListOfCurveRepresentation it(tedge->Curves()); it.More(); it.Next())
+                    this->addCurveRepresentation(it.Value());
+            }
+        }
+    }
+
+    void addTriangulation(const Handle_Poly_Triangulation& polyTri)
+    {
+        if (polyTri.IsNull() || !m_setObject.insert(polyTri.get()).second)
+            return;
+
+        ++m_stats->triangulationCount;
+        m_stats->triangulationNodeCount += polyTri->NbNodes();
+        m_stats->triangulationTriangleCount += polyTri->NbTriangles();
+        m_stats->triangulationBytes += DocumentMemoryStats::estimateBytes(polyTri);
+    }
+
+private:
+    void addCurveRepresentation(const Handle_BRep_CurveRepresentation& curveRep)
+    {
+        m_stats->brepGeometryBytes += rttiSize(curveRep) + ListNodeOverheadBytes;
+        if (curveRep->IsCurve3D()) {
+            this->addCurve(curveRep->Curve3D());
+        }
+        else if (curveRep->IsCurveOnSurface()) {
+            this->addCurve2d(curveRep->PCurve());
+            if (curveRep->IsCurveOnClosedSurface())
+                this->addCurve2d(curveRep->PCurve2());
+        }
+        else if (curveRep->IsPolygon3D()) {
+            const Handle_Poly_Polygon3D& polygon = curveRep->Polygon3D();
+            if (!polygon.IsNull() && m_setObject.insert(polygon.get()).second) {
+                const int64_t nodeBytes = sizeof(gp_Pnt) + (polygon->HasParameters() ? sizeof(double) : 0);
+                m_stats->brepGeometryBytes += rttiSize(polygon) + polygon->NbNodes() * nodeBytes;
+            }
+        }
+        else if (curveRep->IsPolygonOnTriangulation()) {
+            auto fnAddPolygon = [=](const Handle_Poly_PolygonOnTriangulation& polygon) {
+                if (polygon.IsNull() || !m_setObject.insert(polygon.get()).second)
+                    return;
+
+                const int64_t nodeBytes = sizeof(int) + (polygon->HasParameters() ? sizeof(double) : 0);
+                m_stats->brepGeometryBytes += rttiSize(polygon) + polygon->NbNodes() * nodeBytes;
+            };
+            fnAddPolygon(curveRep->PolygonOnTriangulation());
+            if (curveRep->IsPolygonOnClosedTriangulation())
+                fnAddPolygon(curveRep->PolygonOnTriangulation2());
+        }
+    }
+
+    void addCurve(const Handle_Geom_Curve& curve)
+    {
+        if (curve.IsNull() || !m_setObject.insert(curve.get()).second)
+            return;
+
+        m_stats->brepGeometryBytes += rttiSize(curve);
+        if (auto bspline = Handle_Geom_BSplineCurve::DownCast(curve))
+            m_stats->brepGeometryBytes += bsplineCurveArraysBytes<gp_Pnt>(bspline);
+        else if (auto bezier = Handle_Geom_BezierCurve::DownCast(curve))
+            m_stats->brepGeometryBytes += bezierCurveArraysBytes<gp_Pnt>(bezier);
+        else if (auto trimmed = Handle_Geom_TrimmedCurve::DownCast(curve))
+            this->addCurve(trimmed->BasisCurve());
+        else if (auto offset = Handle_Geom_OffsetCurve::DownCast(curve))
+            this->addCurve(offset->BasisCurve());
+    }
+
+    void addCurve2d(const Handle_Geom2d_Curve& curve)
+    {
+        if (curve.IsNull() || !m_setObject.insert(curve.get()).second)
+            return;
+
+        m_stats->brepGeometryBytes += rttiSize(curve);
+        if (auto bspline = Handle_Geom2d_BSplineCurve::DownCast(curve))
+            m_stats->brepGeometryBytes += bsplineCurveArraysBytes<gp_Pnt2d>(bspline);
+        else if (auto bezier = Handle_Geom2d_BezierCurve::DownCast(curve))
+            m_stats->brepGeometryBytes += bezierCurveArraysBytes<gp_Pnt2d>(bezier);
+        else if (auto trimmed = Handle_Geom2d_TrimmedCurve::DownCast(curve))
+            this->addCurve2d(trimmed->BasisCurve());
+        else if (auto offset = Handle_Geom2d_OffsetCurve::DownCast(curve))
+            this->addCurve2d(offset->BasisCurve());
+    }
+
+    void addSurface(const Handle_Geom_Surface& surface)
+    {
+        if (surface.IsNull() || !m_setObject.insert(surface.get()).second)
+            return;
+
+        m_stats->brepGeometryBytes += rttiSize(surface);
+        if (auto bspline = Handle_Geom_BSplineSurface::DownCast(surface)) {
+            const bool isRational = bspline->IsURational() || bspline->IsVRational();
+            const int64_t poleBytes = sizeof(gp_Pnt) + (isRational ? sizeof(double) : 0);
+            const int64_t knotCount = bspline->NbUKnots() + bspline->NbVKnots();
+            m_stats->brepGeometryBytes +=
+                    bspline->NbUPoles() * bspline->NbVPoles() * poleBytes
+                    + knotCount * int64_t(sizeof(double) + sizeof(int));
+        }
+        else if (auto bezier = Handle_Geom_BezierSurface::DownCast(surface)) {
+            const bool isRational = bezier->IsURational() || bezier->IsVRational();
+            const int64_t poleBytes = sizeof(gp_Pnt) + (isRational ? sizeof(double) : 0);
+            m_stats->brepGeometryBytes += bezier->NbUPoles() * bezier->NbVPoles() * poleBytes;
+        }
+        else if (auto trimmed = Handle_Geom_RectangularTrimmedSurface::DownCast(surface)) {
+            this->addSurface(trimmed->BasisSurface());
+        }
+        else if (auto offset = Handle_Geom_OffsetSurface::DownCast(surface)) {
+            this->addSurface(offset->BasisSurface());
+        }
+        else if (auto swept = Handle_Geom_SweptSurface::DownCast(surface)) {
+            this->addCurve(swept->BasisCurve());
+        }
+    }
+
+    DocumentMemoryStats* m_stats = nullptr;
+    std::unordered_set<const TopoDS_TShape*> m_setTShape;
+    std::unordered_set<const Standard_Transient*> m_setObject; // Geometries, triangulations, ...
+};
+
+} // namespace Internal
+
+int64_t DocumentMemoryStats::totalBytes() const
+{
+    return this->brepTopologyBytes
+            + this->brepGeometryBytes
+            + this->triangulationBytes
+            + this->ocafBytes
+            + this->modelTreeBytes;
+}
+
+QJsonObject DocumentMemoryStats::toJson() const
+{
+    QJsonObject jsonStats;
+    jsonStats.insert("brepTopologyBytes", double(this->brepTopologyBytes));
+    jsonStats.insert("brepGeometryBytes", double(this->brepGeometryBytes));
+    jsonStats.insert("triangulationBytes", double(this->triangulationBytes));
+    jsonStats.insert("ocafBytes", double(this->ocafBytes));
+    jsonStats.insert("modelTreeBytes", double(this->modelTreeBytes));
+    jsonStats.insert("totalBytes", double(this->totalBytes()));
+    jsonStats.insert("shapeCount", double(this->shapeCount));
+    jsonStats.insert("triangulationCount", double(this->triangulationCount));
+    jsonStats.insert("triangulationNodeCount", double(this->triangulationNodeCount));
+    jsonStats.insert("triangulationTriangleCount", double(this->triangulationTriangleCount));
+    return jsonStats;
+}
+
+DocumentMemoryStats::Snapshot DocumentMemoryStats::snapshot(const DocumentPtr& doc)
+{
+    Snapshot snapshot;
+    if (!doc || doc->GetData().IsNull())
+        return snapshot;
+
+    auto fnAddLabel = [&](const TDF_Label& label) {
+        snapshot.ocafBytes += sizeof(TDF_LabelNode);
+        for (TDF_AttributeIterator it(label); it.More(); it.Next()) {
+            const Handle_TDF_Attribute& attr = it.Value();
+            snapshot.ocafBytes += Internal::rttiSize(attr);
+            if (attr->IsKind(STANDARD_TYPE(TNaming_NamedShape))) {
+                snapshot.vecShape.push_back(Handle_TNaming_NamedShape::DownCast(attr)->Get());
+            }
+            else if (attr->IsKind(STANDARD_TYPE(TDataXtd_Triangulation))) {
+                snapshot.vecTriangulation.push_back(Handle_TDataXtd_Triangulation::DownCast(attr)->Get());
+            }
+            else if (attr->IsKind(STANDARD_TYPE(TDataStd_Name))) {
+                const TCollection_ExtendedString& name = Handle_TDataStd_Name::DownCast(attr)->Get();
+                snapshot.ocafBytes += name.Length() * int64_t(sizeof(Standard_ExtCharacter));
+            }
+        }
+    };
+
+    const TDF_Label labelRoot = doc->GetData()->Root();
+    fnAddLabel(labelRoot);
+    for (TDF_ChildIterator it(labelRoot, true/*allLevels*/); it.More(); it.Next())
+        fnAddLabel(it.Value());
+
+    snapshot.modelTreeBytes = doc->modelTree().memorySize();
+    return snapshot;
+}
+
+DocumentMemoryStats DocumentMemoryStats::compute(const Snapshot& snapshot, TaskProgress* progress)
+{
+    DocumentMemoryStats stats;
+    stats.ocafBytes = snapshot.ocafBytes;
+    stats.modelTreeBytes = snapshot.modelTreeBytes;
+    Internal::DocumentMemoryStatsBuilder builder(&stats);
+    for (const Handle_Poly_Triangulation& polyTri : snapshot.vecTriangulation)
+        builder.addTriangulation(polyTri);
+
+    const int shapeCount = int(snapshot.vecShape.size());
+    for (int i = 0; i < shapeCount; ++i) {
+        if (TaskProgress::isAbortRequested(progress))
+            return stats;
+
+        builder.addShape(snapshot.vecShape.at(i));
+        if (progress)
+            progress->setValue(MathUtils::mappedValue(i + 1, 0, shapeCount, 0, 100));
+    }
+
+    return stats;
+}
+
+DocumentMemoryStats DocumentMemoryStats::compute(const DocumentPtr& doc, TaskProgress* progress)
+{
+    return DocumentMemoryStats::compute(DocumentMemoryStats::snapshot(doc), progress);
+}
+
+int64_t DocumentMemoryStats::estimateBytes(const Handle_Poly_Triangulation& polyTri)
+{
+    if (polyTri.IsNull())
+        return 0;
+
+    int64_t nodeBytes = sizeof(gp_Pnt);
+    if (polyTri->HasUVNodes())
+        nodeBytes += sizeof(gp_Pnt2d);
+
+    if (polyTri->HasNormals())
+        nodeBytes += 3 * sizeof(Standard_ShortReal);
+
+    return Internal::rttiSize(polyTri)
+            + polyTri->NbNodes() * nodeBytes
+            + polyTri->NbTriangles() * int64_t(sizeof(Poly_Triangle));
+}
+
+ProcessMemoryStats ProcessMemoryStats::current()
+{
+    ProcessMemoryStats stats;
+#if defined(Q_OS_WIN)
+    PROCESS_MEMORY_COUNTERS counters = {};
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        stats.residentBytes = counters.WorkingSetSize;
+        stats.peakResidentBytes = counters.PeakWorkingSetSize;
+    }
+#elif defined(Q_OS_UNIX)
+    struct rusage usage = {};
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+#  if defined(Q_OS_MACOS)
+        stats.peakResidentBytes = usage.ru_maxrss; // Bytes on macOS
+#  else
+        stats.peakResidentBytes = int64_t(usage.ru_maxrss) * 1024; // Kilobytes on Linux/BSD
+#  endif
+    }
+
+#  if defined(Q_OS_LINUX)
+    // Second field of /proc/self/statm is the resident set size, in pages
+    std::ifstream fileStatm("/proc/self/statm");
+    long long pageCount = 0;
+    long long residentPageCount = 0;
+    if (fileStatm >> pageCount >> residentPageCount)
+        stats.residentBytes = residentPageCount * sysconf(_SC_PAGESIZE);
+#  endif
+#endif
+    return stats;
+}
+
+} // namespace Mayo
@@ -0,0 +1,71 @@
+/****************************************************************************
+** Copyright (c) 2021, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#pragma once
+
+#include "document_ptr.h"
+
+#include <Poly_Triangulation.hxx>
+#include <TopoDS_Shape.hxx>
+#include <QtCore/QJsonObject>
+#include <cstdint>
+#include <vector>
+
+namespace Mayo {
+
+class TaskProgress;
+
+// Estimated memory held by the data of a Document, in bytes
+// Object sizes are the ones reported by OpenCascade RTTI(Standard_Type::Size()), completed with
+// the sizes of their arrays(poles, nodes, ...). Data shared by several shapes or labels is
+// accounted once. Allocator overhead is ignored, so actual memory usage is somewhat higher
+struct DocumentMemoryStats {
+    int64_t brepTopologyBytes = 0; // Vertices, edges, faces, ... and their sub-shape lists
+    int64_t brepGeometryBytes = 0; // Curves, surfaces and polygons attached to edges
+    int64_t triangulationBytes = 0; // Poly_Triangulation nodes, triangles, normals and UV nodes
+    int64_t ocafBytes = 0; // Labels and attributes(names, colors, layers, ...), except shapes
+    int64_t modelTreeBytes = 0;
+
+    int64_t shapeCount = 0; // Count of distinct TopoDS_TShape objects
+    int64_t triangulationCount = 0;
+    int64_t triangulationNodeCount = 0;
+    int64_t triangulationTriangleCount = 0;
+
+    int64_t totalBytes() const;
+    QJsonObject toJson() const;
+
+    // Document data needed to compute the statistics, read in the thread owning the document
+    // OCAF labels and attributes are accounted here, shapes and triangulations are only collected
+    struct Snapshot {
+        int64_t ocafBytes = 0;
+        int64_t modelTreeBytes = 0;
+        std::vector<TopoDS_Shape> vecShape;
+        std::vector<Handle_Poly_Triangulation> vecTriangulation;
+    };
+
+    static Snapshot snapshot(const DocumentPtr& doc);
+
+    // Computes statistics of 'snapshot' without document access, so it can run in a worker thread
+    // Statistics are incomplete if 'progress' was aborted
+    static DocumentMemoryStats compute(const Snapshot& snapshot, TaskProgress* progress = nullptr);
+
+    // Same as compute(snapshot(doc), progress), document must be owned by the calling thread
+    static DocumentMemoryStats compute(const DocumentPtr& doc, TaskProgress* progress = nullptr);
+
+    // Estimated bytes held by 'polyTri', zero if null
+    static int64_t estimateBytes(const Handle_Poly_Triangulation& polyTri);
+};
+
+// Physical memory used by the current process, in bytes. Values are -1 if not supported on the
+// current platform
+struct ProcessMemoryStats {
+    int64_t residentBytes = -1;
+    int64_t peakResidentBytes = -1;
+
+    static ProcessMemoryStats current();
+};
+
+} // namespace Mayo
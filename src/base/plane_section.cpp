@@ -0,0 +1,91 @@
+/****************************************************************************
+** Copyright (c) 2021, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#include "plane_section.h"
+
+#include "bnd_utils.h"
+#include "task_progress.h"
+
+#include <BRepAlgoAPI_Common.hxx>
+#include <BRepAlgoAPI_Section.hxx>
+#include <BRepBndLib.hxx>
+#include <BRepBuilderAPI_MakeFace.hxx>
+#include <BRepGProp.hxx>
+#include <BRep_Builder.hxx>
+#include <ElSLib.hxx>
+#include <GProp_GProps.hxx>
+#include <TopExp_Explorer.hxx>
+#include <TopoDS_Compound.hxx>
+#include <cmath>
+
+namespace Mayo {
+
+PlaneSection PlaneSection::compute(const TopoDS_Shape& shape, const gp_Pln& plane, TaskProgress* progress)
+{
+    PlaneSection section;
+    if (shape.IsNull())
+        return section;
+
+    Bnd_Box bndBox;
+    BRepBndLib::Add(shape, bndBox);
+    if (bndBox.IsVoid() || bndBox.IsOut(plane))
+        return section;
+
+    BRepAlgoAPI_Section algoSection(shape, plane, false);
+    algoSection.Approximation(true);
+    algoSection.Build();
+    if (!algoSection.IsDone() || !TopExp_Explorer(algoSection.Shape(), TopAbs_EDGE).More())
+        return section;
+
+    if (TaskProgress::isAbortRequested(progress))
+        return section;
+
+    GProp_GProps linearProps;
+    BRepGProp::LinearProperties(algoSection.Shape(), linearProps);
+    const double perimeter = linearProps.Mass();
+
+    // Area: common part of the solids with a planar face large enough to cross them entirely
+    TopoDS_Compound compSolid;
+    BRep_Builder builder;
+    builder.MakeCompound(compSolid);
+    bool hasSolid = false;
+    for (TopExp_Explorer expl(shape, TopAbs_SOLID); expl.More(); expl.Next()) {
+        builder.Add(compSolid, expl.Current());
+        hasSolid = true;
+    }
+
+    TopoDS_Shape faces;
+    double area = 0.;
+    if (hasSolid) {
+        const gp_Pnt bndCenter = BndBoxCoords::get(bndBox).center();
+        double u, v;
+        ElSLib::Parameters(plane, bndCenter, u, v);
+        const double halfSize = std::sqrt(bndBox.SquareExtent());
+        const TopoDS_Face planeFace = BRepBuilderAPI_MakeFace(
+                    plane, u - halfSize, u + halfSize, v - halfSize, v + halfSize);
+        if (TaskProgress::isAbortRequested(progress))
+            return section;
+
+        BRepAlgoAPI_Common algoCommon(compSolid, planeFace);
+        if (algoCommon.IsDone()) {
+            faces = algoCommon.Shape();
+            GProp_GProps surfaceProps;
+            BRepGProp::SurfaceProperties(faces, surfaceProps);
+            area = surfaceProps.Mass();
+        }
+    }
+
+    if (TaskProgress::isAbortRequested(progress))
+        return section;
+
+    section.curves = algoSection.Shape();
+    section.faces = faces;
+    section.area = area;
+    section.perimeter = perimeter;
+    return section;
+}
+
+} // namespace Mayo
@@ -0,0 +1,30 @@
+/****************************************************************************
+** Copyright (c) 2021, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#pragma once
+
+#include <TopoDS_Shape.hxx>
+#include <gp_Pln.hxx>
+
+namespace Mayo {
+
+class TaskProgress;
+
+// Exact cross-section of a BRep shape by a plane
+struct PlaneSection {
+    TopoDS_Shape curves; // Compound of the section edges
+    TopoDS_Shape faces; // Compound of the planar faces cut within solids, null if shape has no solid
+    double area = 0.; // Area of 'faces', in squared millimeters
+    double perimeter = 0.; // Length of 'curves', in millimeters
+
+    bool isEmpty() const { return this->curves.IsNull(); }
+
+    // Returns an empty section if 'shape' doesn't cross 'plane' or computation was aborted
+    static PlaneSection compute(
+            const TopoDS_Shape& shape, const gp_Pln& plane, TaskProgress* progress = nullptr);
+};
+
+} // namespace Mayo
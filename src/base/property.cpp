@@ -7,6 +7,7 @@
 #include "property.h"
 
 #include "property_enumeration.h"
+#include <algorithm>
 #include <cassert>
 
 namespace Mayo {
@@ -25,12 +26,53 @@ void PropertyGroup::restoreDefaults()
 {
 }
 
+void PropertyGroup::beginChangeTransaction()
+{
+    ++m_changeTransactionDepth;
+}
+
+void PropertyGroup::commitChangeTransaction()
+{
+    Expects(m_changeTransactionDepth > 0);
+    if (--m_changeTransactionDepth > 0)
+        return;
+
+    std::vector<Property*> vecProp = std::move(m_vecTransactionChangedProperty);
+    m_vecTransactionChangedProperty.clear();
+    // Dispatch to the owner groups, in order of first change
+    while (!vecProp.empty()) {
+        PropertyGroup* group = vecProp.front()->group();
+        auto itGroupEnd = std::stable_partition(vecProp.begin(), vecProp.end(), [=](const Property* prop) {
+            return prop->group() == group;
+        });
+        const std::vector<Property*> vecGroupProp(vecProp.begin(), itGroupEnd);
+        vecProp.erase(vecProp.begin(), itGroupEnd);
+        group->onPropertiesChanged(vecGroupProp);
+    }
+}
+
+bool PropertyGroup::isChangeTransactionActive() const
+{
+    for (const PropertyGroup* group = this; group; group = group->m_parentGroup) {
+        if (group->m_changeTransactionDepth > 0)
+            return true;
+    }
+
+    return false;
+}
+
 void PropertyGroup::onPropertyChanged(Property* prop)
 {
     if (m_parentGroup)
         m_parentGroup->onPropertyChanged(prop);
 }
 
+void PropertyGroup::onPropertiesChanged(Span<Property* const> spanProp)
+{
+    for (Property* prop : spanProp)
+        this->onPropertyChanged(prop);
+}
+
 void PropertyGroup::onPropertyEnabled(Property* prop, bool on)
 {
     if (m_parentGroup)
@@ -66,6 +108,18 @@ void PropertyGroup::removeProperty(Property* prop)
         m_properties.erase(it);
 }
 
+// Returns the outermost group(this one or an ancestor) having an active change transaction
+PropertyGroup* PropertyGroup::findChangeTransactionGroup()
+{
+    PropertyGroup* transactionGroup = nullptr;
+    for (PropertyGroup* group = this; group; group = group->m_parentGroup) {
+        if (group->m_changeTransactionDepth > 0)
+            transactionGroup = group;
+    }
+
+    return transactionGroup;
+}
+
 const TextId& Property::name() const
 {
     return m_name;
@@ -94,8 +148,18 @@ Property::Property(PropertyGroup* group, const TextId& name)
 
 void Property::notifyChanged()
 {
-    if (m_group && !m_group->isPropertyChangedBlocked())
+    if (!m_group || m_group->isPropertyChangedBlocked())
+        return;
+
+    PropertyGroup* transactionGroup = m_group->findChangeTransactionGroup();
+    if (transactionGroup) {
+        std::vector<Property*>& vecProp = transactionGroup->m_vecTransactionChangedProperty;
+        if (std::find(vecProp.cbegin(), vecProp.cend(), this) == vecProp.cend())
+            vecProp.push_back(this);
+    }
+    else {
         m_group->onPropertyChanged(this);
+    }
 }
 
 void Property::notifyEnabled(bool on)
@@ -132,6 +196,20 @@ PropertyChangedBlocker::~PropertyChangedBlocker()
 }
 
 
+PropertyChangeTransaction::PropertyChangeTransaction(PropertyGroup* group)
+    : m_group(group)
+{
+    if (m_group)
+        m_group->beginChangeTransaction();
+}
+
+PropertyChangeTransaction::~PropertyChangeTransaction()
+{
+    if (m_group)
+        m_group->commitChangeTransaction();
+}
+
+
 PropertyGroupSignals::PropertyGroupSignals(QObject* parent)
     : QObject(parent)
 {
@@ -33,10 +33,23 @@ public:
     // Reinitialize properties to their default values
     virtual void restoreDefaults();
 
+    // Starts a property change transaction, it applies to this group and all its child groups
+    // Until the outermost transaction is committed, onPropertyChanged() isn't called: changed
+    // properties are recorded(once each) and then notified in a batch with onPropertiesChanged()
+    // Transactions can be nested
+    void beginChangeTransaction();
+    void commitChangeTransaction();
+    bool isChangeTransactionActive() const;
+
 protected:
     // Callback executed when Property value was changed
     virtual void onPropertyChanged(Property* prop);
 
+    // Callback executed when a change transaction is committed, 'spanProp' contains the properties
+    // of this group changed during the transaction, in order of first change
+    // Default implementation calls onPropertyChanged() for each property
+    virtual void onPropertiesChanged(Span<Property* const> spanProp);
+
     // Callback executed when Property "enabled" status was changed
     virtual void onPropertyEnabled(Property* prop, bool on);
 
@@ -51,9 +64,13 @@ protected:
 private:
     friend class Property;
     friend struct PropertyChangedBlocker;
+    PropertyGroup* findChangeTransactionGroup();
+
     PropertyGroup* m_parentGroup = nullptr;
     std::vector<Property*> m_properties; // TODO Replace by QVarLengthArray<Property*> ?
     bool m_propertyChangedBlocked = false;
+    int m_changeTransactionDepth = 0;
+    std::vector<Property*> m_vecTransactionChangedProperty;
 };
 
 // Exception-safe wrapper around PropertyGroup::blockPropertyChanged()
@@ -69,6 +86,18 @@ struct PropertyChangedBlocker {
             Mayo::PropertyChangedBlocker __Mayo_PropertyChangedBlocker(group); \
             Q_UNUSED(__Mayo_PropertyChangedBlocker);
 
+// Exception-safe wrapper around PropertyGroup::beginChangeTransaction()
+// It begins a change transaction in its constructor and commits it in the destructor
+struct PropertyChangeTransaction {
+    PropertyChangeTransaction(PropertyGroup* group);
+    ~PropertyChangeTransaction();
+    PropertyGroup* const m_group = nullptr;
+};
+
+#define Mayo_PropertyChangeTransaction(group) \
+            Mayo::PropertyChangeTransaction __Mayo_PropertyChangeTransaction(group); \
+            Q_UNUSED(__Mayo_PropertyChangeTransaction);
+
 class Property {
 public:
     Property(PropertyGroup* group, const TextId& name);
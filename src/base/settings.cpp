@@ -6,9 +6,13 @@
 
 #include "settings.h"
 
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDataStream>
 #include <QtCore/QSettings>
 #include <gsl/util>
+#include <memory>
 #include <regex>
+#include <utility>
 
 namespace Mayo {
 
@@ -16,12 +20,16 @@ namespace {
 
 struct Settings_Setting {
     Property* property;
+    // Value explicitly changed while the section was not loaded yet, it takes precedence over the
+    // value in application storage
+    bool isStorageOverriden;
 };
 
 struct Settings_Section {
     TextId identifier; // Must be unique in the context of the parent group
     QString overridenTitle;
     bool isDefault; // Default section in parent group
+    bool isStoragePending; // Values not yet read from application storage(lazy loading)
     std::vector<Settings_Setting> vecSetting;
 };
 
@@ -41,6 +49,40 @@ static bool isValidIdentifier(const QByteArray& identifier)
     return !identifier.isEmpty() && !identifier.simplified().isEmpty();
 }
 
+// Header of binary storage files, also used as format version
+static constexpr quint32 BinaryStorageMagic = 0x4d594f31; // "MYO1"
+
+static bool readBinaryStorage(QIODevice& device, QSettings::SettingsMap& map)
+{
+    if (device.atEnd())
+        return true; // Storage not created yet
+
+    QDataStream stream(&device);
+    stream.setVersion(QDataStream::Qt_5_6);
+    quint32 magic = 0;
+    stream >> magic;
+    if (magic != BinaryStorageMagic)
+        return false;
+
+    stream >> map;
+    return stream.status() == QDataStream::Ok;
+}
+
+static bool writeBinaryStorage(QIODevice& device, const QSettings::SettingsMap& map)
+{
+    QDataStream stream(&device);
+    stream.setVersion(QDataStream::Qt_5_6);
+    stream << BinaryStorageMagic << map;
+    return stream.status() == QDataStream::Ok;
+}
+
+static QSettings::Format binaryStorageQSettingsFormat()
+{
+    static const QSettings::Format format =
+            QSettings::registerFormat("mayobin", &readBinaryStorage, &writeBinaryStorage);
+    return format;
+}
+
 } // namespace
 
 class Settings::Private {
@@ -67,6 +109,40 @@ public:
         return this->sectionPath(this->group(index.group()), this->section(index));
     }
 
+    std::pair<Settings_Section*, Settings_Setting*> findSetting(const Property* property) {
+        for (Settings_Group& group : m_vecGroup) {
+            for (Settings_Section& section : group.vecSection) {
+                for (Settings_Setting& setting : section.vecSetting) {
+                    if (setting.property == property)
+                        return { &section, &setting };
+                }
+            }
+        }
+
+        return {};
+    }
+
+    Settings_Section newSection() const {
+        Settings_Section section = {};
+        section.isStoragePending = m_isStorageLoadRequested;
+        return section;
+    }
+
+    void loadSectionFromStorage(const Settings_Group& group, Settings_Section& section)
+    {
+        if (!section.isStoragePending)
+            return;
+
+        section.isStoragePending = false;
+        const QString sectionPath = this->sectionPath(group, section);
+        for (Settings_Setting& setting : section.vecSetting) {
+            if (!setting.isStorageOverriden)
+                this->loadPropertyFrom(*m_ptrStorage, sectionPath, setting.property);
+
+            setting.isStorageOverriden = false;
+        }
+    }
+
     void loadPropertyFrom(const QSettings& source, const QString& sectionPath, Property* property)
     {
         if (!property)
@@ -80,7 +156,9 @@ public:
         }
     }
 
-    QSettings m_settings;
+    std::unique_ptr<QSettings> m_ptrStorage;
+    Settings::StorageFormat m_storageFormat = Settings::StorageFormat::Native;
+    bool m_isStorageLoadRequested = false;
     QLocale m_locale;
     std::vector<Settings_Group> m_vecGroup;
     std::vector<SectionResetFunction> m_vecSectionResetFn;
@@ -92,6 +170,7 @@ Settings::Settings(QObject* parent)
     : QObject(parent),
       d(new Private)
 {
+    d->m_ptrStorage = std::make_unique<QSettings>();
 }
 
 Settings::~Settings()
@@ -101,13 +180,53 @@ Settings::~Settings()
 
 void Settings::load()
 {
-    this->loadFrom(d->m_settings);
+    d->m_isStorageLoadRequested = true;
+    for (Settings_Group& group : d->m_vecGroup) {
+        for (Settings_Section& section : group.vecSection) {
+            section.isStoragePending = true;
+            for (Settings_Setting& setting : section.vecSetting)
+                setting.isStorageOverriden = false;
+        }
+    }
+}
+
+void Settings::loadGroup(GroupIndex index)
+{
+    Mayo_PropertyChangeTransaction(this);
+    Settings_Group& group = d->group(index);
+    for (Settings_Section& section : group.vecSection)
+        d->loadSectionFromStorage(group, section);
+}
+
+void Settings::loadSection(SectionIndex index)
+{
+    Mayo_PropertyChangeTransaction(this);
+    d->loadSectionFromStorage(d->group(index.group()), d->section(index));
+}
+
+void Settings::loadAll()
+{
+    Mayo_PropertyChangeTransaction(this);
+    for (Settings_Group& group : d->m_vecGroup) {
+        for (Settings_Section& section : group.vecSection)
+            d->loadSectionFromStorage(group, section);
+    }
+}
+
+bool Settings::isSectionLoaded(SectionIndex index) const
+{
+    return !d->section(index).isStoragePending;
 }
 
 void Settings::loadFrom(const QSettings& source, const ExcludePropertyPredicate& fnExclude)
 {
+    Mayo_PropertyChangeTransaction(this);
     for (const Settings_Group& group : d->m_vecGroup) {
-        for (const Settings_Section& section : group.vecSection) {
+        for (Settings_Section& section : group.vecSection) {
+            section.isStoragePending = false; // Values from 'source' take precedence
+            for (Settings_Setting& setting : section.vecSetting)
+                setting.isStorageOverriden = false;
+
             const QString sectionPath = d->sectionPath(group, section);
             for (const Settings_Setting& setting : section.vecSetting) {
                 if (!fnExclude || !fnExclude(*setting.property))
@@ -119,7 +238,7 @@ void Settings::loadFrom(const QSettings& source, const ExcludePropertyPredicate&
 
 void Settings::loadProperty(Settings::SettingIndex index)
 {
-    this->loadPropertyFrom(d->m_settings, index);
+    this->loadPropertyFrom(*d->m_ptrStorage, index);
 }
 
 void Settings::loadPropertyFrom(const QSettings& source, SettingIndex index)
@@ -133,13 +252,15 @@ void Settings::loadPropertyFrom(const QSettings& source, SettingIndex index)
 
 QVariant Settings::findValueFromKey(const QString& strKey) const
 {
-    return d->m_settings.value(strKey);
+    return d->m_ptrStorage->value(strKey);
 }
 
 void Settings::save()
 {
-    this->saveAs(&d->m_settings);
-    d->m_settings.sync();
+    // Settings of sections not loaded yet are skipped(unless explicitly changed), their values in
+    // storage are left untouched
+    this->saveAs(d->m_ptrStorage.get());
+    d->m_ptrStorage->sync();
 }
 
 void Settings::saveAs(QSettings* target, const ExcludePropertyPredicate& fnExclude)
@@ -147,10 +268,17 @@ void Settings::saveAs(QSettings* target, const ExcludePropertyPredicate& fnExclu
     if (!target)
         return;
 
+    const bool isStorageTarget = target == d->m_ptrStorage.get();
+    if (!isStorageTarget)
+        this->loadAll();
+
     for (const Settings_Group& group : d->m_vecGroup) {
         for (const Settings_Section& section : group.vecSection) {
             const QString sectionPath = d->sectionPath(group, section);
             for (const Settings_Setting& setting : section.vecSetting) {
+                if (section.isStoragePending && !setting.isStorageOverriden)
+                    continue;
+
                 Property* prop = setting.property;
                 if (!fnExclude || !fnExclude(*prop)) {
                     const QByteArray propKey = prop->name().key;
@@ -162,6 +290,46 @@ void Settings::saveAs(QSettings* target, const ExcludePropertyPredicate& fnExclu
     } // endfor(groups)
 }
 
+Settings::StorageFormat Settings::storageFormat() const
+{
+    return d->m_storageFormat;
+}
+
+void Settings::setStorageFormat(StorageFormat format)
+{
+    if (format == d->m_storageFormat)
+        return;
+
+    std::unique_ptr<QSettings> ptrStorage;
+    switch (format) {
+    case StorageFormat::Native:
+        ptrStorage = std::make_unique<QSettings>();
+        break;
+    case StorageFormat::Binary:
+        ptrStorage = std::make_unique<QSettings>(
+                    binaryStorageQSettingsFormat(),
+                    QSettings::UserScope,
+                    QCoreApplication::organizationName(),
+                    QCoreApplication::applicationName());
+        break;
+    }
+
+    // First use of the new format: values are migrated from the previous storage
+    if (ptrStorage->allKeys().isEmpty()) {
+        for (const QString& key : d->m_ptrStorage->allKeys())
+            ptrStorage->setValue(key, d->m_ptrStorage->value(key));
+    }
+
+    this->setStorage(std::move(ptrStorage));
+    d->m_storageFormat = format;
+}
+
+void Settings::setStorage(std::unique_ptr<QSettings> ptrStorage)
+{
+    Expects(ptrStorage != nullptr);
+    d->m_ptrStorage = std::move(ptrStorage);
+}
+
 const PropertyValueConversion& Settings::propertyValueConversion() const
 {
     return *(d->m_propValueConverter);
@@ -208,7 +376,7 @@ Settings::GroupIndex Settings::addGroup(QByteArray identifier)
     Settings_Group& group = d->m_vecGroup.back();
     group.identifier.key = identifier;
 
-    Settings_Section defaultSection;
+    Settings_Section defaultSection = d->newSection();
     defaultSection.isDefault = true;
     group.vecSection.push_back(std::move(defaultSection));
 
@@ -269,7 +437,7 @@ Settings::SectionIndex Settings::addSection(GroupIndex index, QByteArray identif
     // TODO Check identifier is unique
 
     Settings_Group& group = d->group(index);
-    group.vecSection.push_back({});
+    group.vecSection.push_back(d->newSection());
     Settings_Section& section = group.vecSection.back();
     section.identifier.key = identifier;
     return SectionIndex(index, int(group.vecSection.size()) - 1);
@@ -287,7 +455,10 @@ int Settings::settingCount(SectionIndex index) const
 
 Property* Settings::property(SettingIndex index) const
 {
-    return d->section(index.section()).vecSetting.at(index.get()).property;
+    // First access to the section triggers its loading
+    const SectionIndex sectionIndex = index.section();
+    d->loadSectionFromStorage(d->group(sectionIndex.group()), d->section(sectionIndex));
+    return d->section(sectionIndex).vecSetting.at(index.get()).property;
 }
 
 Settings::SettingIndex Settings::findProperty(const Property* property) const
@@ -321,7 +492,7 @@ Settings::SettingIndex Settings::addSetting(Property* property, GroupIndex group
             sectionDefault = &group.vecSection.front();
         }
         else {
-            group.vecSection.insert(group.vecSection.begin(), {});
+            group.vecSection.insert(group.vecSection.begin(), d->newSection());
             sectionDefault = &group.vecSection.front();
         }
     }
@@ -345,12 +516,14 @@ Settings::SettingIndex Settings::addSetting(Property* property, SectionIndex ind
 
 void Settings::resetAll()
 {
+    Mayo_PropertyChangeTransaction(this);
     for (const SectionResetFunction& sectionResetFn : d->m_vecSectionResetFn)
         sectionResetFn.fnReset();
 }
 
 void Settings::resetGroup(GroupIndex index)
 {
+    Mayo_PropertyChangeTransaction(this);
     for (const SectionResetFunction& sectionResetFn : d->m_vecSectionResetFn) {
         if (sectionResetFn.sectionId.group() == index)
             sectionResetFn.fnReset();
@@ -359,6 +532,7 @@ void Settings::resetGroup(GroupIndex index)
 
 void Settings::resetSection(SectionIndex index)
 {
+    Mayo_PropertyChangeTransaction(this);
     for (const SectionResetFunction& sectionResetFn : d->m_vecSectionResetFn) {
         if (sectionResetFn.sectionId == index)
             sectionResetFn.fnReset();
@@ -388,6 +562,15 @@ void Settings::setLocale(const QLocale& locale)
 
 void Settings::onPropertyChanged(Property* prop)
 {
+    if (d->m_isStorageLoadRequested) {
+        // Value explicitly changed, it takes precedence over the one in storage
+        // Other settings of the section are still pending, they must not be overwritten in storage
+        // with their current(default) values
+        const auto [section, setting] = d->findSetting(prop);
+        if (section && section->isStoragePending)
+            setting->isStorageOverriden = true;
+    }
+
     PropertyGroup::onPropertyChanged(prop);
     emit this->changed(prop);
 }
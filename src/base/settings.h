@@ -13,6 +13,7 @@
 #include <QtCore/QLocale>
 #include <QtCore/QObject>
 #include <functional>
+#include <memory>
 class QSettings;
 
 namespace Mayo {
@@ -29,12 +30,30 @@ public:
     Settings(QObject* parent = nullptr);
     ~Settings();
 
+    enum class StorageFormat {
+        Native, // Platform format used by QSettings(eg registry on Windows)
+        Binary  // Compact binary file, avoids parsing of text/registry entries
+    };
+    StorageFormat storageFormat() const;
+    // Values are migrated from the current storage if the one of 'format' is empty(first use)
+    void setStorageFormat(StorageFormat format);
+    // Replaces the application storage, useful to work on a specific settings file
+    void setStorage(std::unique_ptr<QSettings> ptrStorage);
+
+    // Requests loading of settings from application storage
+    // Loading is lazy: values of a section are actually read on its first access with loadGroup(),
+    // loadSection(), loadAll() or property(). Sections not loaded are skipped by save()
     void load();
+    void loadGroup(GroupIndex index);
+    void loadSection(SectionIndex index);
+    void loadAll();
+    bool isSectionLoaded(SectionIndex index) const;
     void loadProperty(SettingIndex index);
     QVariant findValueFromKey(const QString& strKey) const;
     void save();
 
     void loadPropertyFrom(const QSettings& source, SettingIndex index);
+    // Notifications of changed settings are batched, see PropertyGroup::beginChangeTransaction()
     void loadFrom(const QSettings& source, const ExcludePropertyPredicate& fnExclude = nullptr);
     void saveAs(QSettings* target, const ExcludePropertyPredicate& fnExclude = nullptr);
 
@@ -65,6 +84,7 @@ public:
     SettingIndex addSetting(Property* property, GroupIndex index);
     SettingIndex addSetting(Property* property, SectionIndex index);
 
+    // Notifications of changed settings are batched, see PropertyGroup::beginChangeTransaction()
     void resetAll();
     void resetGroup(GroupIndex index);
     void resetSection(SectionIndex index);
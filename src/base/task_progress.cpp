@@ -75,6 +75,11 @@ void TaskProgress::setTask(const Task* task)
     m_task = task;
 }
 
+bool TaskProgress::isAbortRequested() const
+{
+    return m_isAbortRequested || (m_parent && m_parent->isAbortRequested());
+}
+
 bool TaskProgress::isAbortRequested(const TaskProgress* progress)
 {
     return progress ? progress->isAbortRequested() : false;
@@ -35,7 +35,8 @@ public:
     const TaskProgress* parent() const { return m_parent; }
     TaskProgress* parent() { return m_parent; }
 
-    bool isAbortRequested() const { return m_isAbortRequested; }
+    // Abort request of the root progress is propagated to all its children
+    bool isAbortRequested() const;
     static bool isAbortRequested(const TaskProgress* progress);
 
     // Disable copy
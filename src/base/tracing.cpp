@@ -0,0 +1,317 @@
+/****************************************************************************
+** Copyright (c) 2021, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#include "tracing.h"
+
+#include "global.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QFile>
+#include <QtCore/QTextStream>
+#include <QtCore/QThread>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace Mayo {
+
+namespace Internal {
+
+struct TraceEvent {
+    const char* name;
+    const char* category; // Null for counters
+    int64_t timestampUs;
+    int64_t durationUs;
+    double counterValue;
+};
+
+// Fixed-size block of events, a thread buffer is a linked list of such chunks
+// Events are published to readers by the release store of 'count', so they're never moved
+struct TraceEventChunk {
+    static constexpr int Capacity = 1024;
+    std::array<TraceEvent, Capacity> events;
+    std::atomic<int> count = {};
+    std::atomic<TraceEventChunk*> next = {};
+};
+
+// Events recorded by a single thread, appending is wait-free as only the owner thread writes
+class TraceThreadBuffer {
+public:
+    TraceThreadBuffer(int threadIndex, bool isMainThread)
+        : m_threadIndex(threadIndex),
+          m_isMainThread(isMainThread),
+          m_firstChunk(new TraceEventChunk),
+          m_lastChunk(m_firstChunk)
+    {}
+
+    ~TraceThreadBuffer()
+    {
+        TraceEventChunk* chunk = m_firstChunk;
+        while (chunk) {
+            TraceEventChunk* nextChunk = chunk->next.load(std::memory_order_relaxed);
+            delete chunk;
+            chunk = nextChunk;
+        }
+    }
+
+    int threadIndex() const { return m_threadIndex; }
+    bool isMainThread() const { return m_isMainThread; }
+
+    void append(const TraceEvent& event)
+    {
+        int count = m_lastChunk->count.load(std::memory_order_relaxed);
+        if (count == TraceEventChunk::Capacity) {
+            auto newChunk = new TraceEventChunk;
+            m_lastChunk->next.store(newChunk, std::memory_order_release);
+            m_lastChunk = newChunk;
+            count = 0;
+        }
+
+        m_lastChunk->events[count] = event;
+        m_lastChunk->count.store(count + 1, std::memory_order_release);
+    }
+
+    // Calls 'fn' for each event published so far, can be called from any thread
+    // Caller must hold the lock of TraceRegistry, as clear() could run concurrently
+    template<typename FUNCTION>
+    void foreachEvent(FUNCTION fn) const
+    {
+        const TraceEventChunk* chunk = m_firstChunk;
+        int first = m_firstEventIndex;
+        while (chunk) {
+            const int count = chunk->count.load(std::memory_order_acquire);
+            for (int i = first; i < count; ++i)
+                fn(chunk->events[i]);
+
+            chunk = chunk->next.load(std::memory_order_acquire);
+            first = 0;
+        }
+    }
+
+    // Deletes all chunks but the last one, whose events published so far are skipped
+    // A chunk followed by another one is never accessed again by the owner thread, so it can be
+    // deleted while the owner is appending. Caller must hold the lock of TraceRegistry
+    void clear()
+    {
+        TraceEventChunk* nextChunk = m_firstChunk->next.load(std::memory_order_acquire);
+        while (nextChunk) {
+            delete m_firstChunk;
+            m_firstChunk = nextChunk;
+            nextChunk = m_firstChunk->next.load(std::memory_order_acquire);
+        }
+
+        m_firstEventIndex = m_firstChunk->count.load(std::memory_order_acquire);
+    }
+
+private:
+    const int m_threadIndex;
+    const bool m_isMainThread;
+    TraceEventChunk* m_firstChunk; // Guarded by the lock of TraceRegistry
+    int m_firstEventIndex = 0; // Index in 'm_firstChunk' of the first event not cleared
+    TraceEventChunk* m_lastChunk; // Accessed by owner thread only
+};
+
+// Owns the buffers of all threads that recorded events. Buffers outlive their thread so events
+// of ended threads(eg. from thread pools) are kept until the trace is written
+struct TraceRegistry {
+    std::atomic<bool> enabled = {};
+    const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+    std::mutex mutex;
+    std::vector<std::unique_ptr<TraceThreadBuffer>> vecThreadBuffer;
+
+    static TraceRegistry& instance() {
+        static TraceRegistry registry;
+        return registry;
+    }
+};
+
+static thread_local TraceThreadBuffer* threadTraceBuffer = nullptr;
+
+// Lock is taken only once per thread, at its first recorded event
+static TraceThreadBuffer* currentThreadTraceBuffer()
+{
+    if (!threadTraceBuffer) {
+        auto qtApp = QCoreApplication::instance();
+        const bool isMainThread = qtApp && QThread::currentThread() == qtApp->thread();
+        TraceRegistry& registry = TraceRegistry::instance();
+        std::lock_guard<std::mutex> lock(registry.mutex); MAYO_UNUSED(lock);
+        const int threadIndex = int(registry.vecThreadBuffer.size()) + 1;
+        registry.vecThreadBuffer.push_back(std::make_unique<TraceThreadBuffer>(threadIndex, isMainThread));
+        threadTraceBuffer = registry.vecThreadBuffer.back().get();
+    }
+
+    return threadTraceBuffer;
+}
+
+// Names are literals provided by the code, only quotes and backslashes could break the JSON output
+static void writeJsonString(QTextStream& ostr, const char* str)
+{
+    ostr << '"';
+    for (const char* it = str; *it != '\0'; ++it) {
+        if (*it == '"' || *it == '\\')
+            ostr << '\\';
+
+        ostr << *it;
+    }
+
+    ostr << '"';
+}
+
+} // namespace Internal
+
+bool Tracing::isEnabled()
+{
+    return Internal::TraceRegistry::instance().enabled.load(std::memory_order_relaxed);
+}
+
+void Tracing::setEnabled(bool on)
+{
+    Internal::TraceRegistry::instance().enabled.store(on, std::memory_order_relaxed);
+}
+
+int64_t Tracing::nowMicroseconds()
+{
+    const auto duration = std::chrono::steady_clock::now() - Internal::TraceRegistry::instance().epoch;
+    return std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+}
+
+void Tracing::recordSpan(const char* name, const char* category, int64_t startUs, int64_t durationUs)
+{
+    if (Tracing::isEnabled())
+        Internal::currentThreadTraceBuffer()->append({ name, category, startUs, durationUs, 0. });
+}
+
+void Tracing::recordCounter(const char* name, double value)
+{
+    if (Tracing::isEnabled())
+        Internal::currentThreadTraceBuffer()->append({ name, nullptr, Tracing::nowMicroseconds(), 0, value });
+}
+
+void Tracing::clear()
+{
+    auto& registry = Internal::TraceRegistry::instance();
+    std::lock_guard<std::mutex> lock(registry.mutex); MAYO_UNUSED(lock);
+    for (const auto& ptrBuffer : registry.vecThreadBuffer)
+        ptrBuffer->clear();
+}
+
+int64_t Tracing::eventCount()
+{
+    auto& registry = Internal::TraceRegistry::instance();
+    std::lock_guard<std::mutex> lock(registry.mutex); MAYO_UNUSED(lock);
+    int64_t count = 0;
+    for (const auto& ptrBuffer : registry.vecThreadBuffer)
+        ptrBuffer->foreachEvent([&](const Internal::TraceEvent&) { ++count; });
+
+    return count;
+}
+
+std::vector<Tracing::SpanStatistics> Tracing::spanStatistics()
+{
+    // Same name can be provided by distinct string literals, so grouping compares contents
+    std::unordered_map<std::string, SpanStatistics> mapNameStats;
+    {
+        auto& registry = Internal::TraceRegistry::instance();
+        std::lock_guard<std::mutex> lock(registry.mutex); MAYO_UNUSED(lock);
+        for (const auto& ptrBuffer : registry.vecThreadBuffer) {
+            ptrBuffer->foreachEvent([&](const Internal::TraceEvent& event) {
+                if (!event.category)
+                    return; // Counter
+
+                SpanStatistics& stats = mapNameStats[event.name];
+                if (stats.count == 0) {
+                    stats.name = event.name;
+                    stats.category = event.category;
+                }
+
+                ++stats.count;
+                stats.totalUs += event.durationUs;
+                stats.maxUs = std::max(stats.maxUs, event.durationUs);
+            });
+        }
+    }
+
+    std::vector<SpanStatistics> vecStats;
+    for (auto& mapPair : mapNameStats)
+        vecStats.push_back(std::move(mapPair.second));
+
+    std::sort(vecStats.begin(), vecStats.end(), [](const SpanStatistics& lhs, const SpanStatistics& rhs) {
+        return lhs.totalUs > rhs.totalUs;
+    });
+    return vecStats;
+}
+
+bool Tracing::writeChromeTrace(QIODevice* device)
+{
+    if (!device)
+        return false;
+
+    auto& registry = Internal::TraceRegistry::instance();
+    std::lock_guard<std::mutex> lock(registry.mutex); MAYO_UNUSED(lock);
+    const qint64 pid = QCoreApplication::applicationPid();
+    QTextStream ostr(device);
+    ostr.setRealNumberPrecision(15);
+    ostr << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+    bool isFirstEvent = true;
+    auto fnBeginEvent = [&]{
+        ostr << (isFirstEvent ? "\n" : ",\n");
+        isFirstEvent = false;
+    };
+    for (const auto& ptrBuffer : registry.vecThreadBuffer) {
+        const int tid = ptrBuffer->threadIndex();
+        fnBeginEvent();
+        ostr << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": " << pid << ", \"tid\": " << tid
+             << ", \"args\": {\"name\": \""
+             << (ptrBuffer->isMainThread() ? QStringLiteral("Main") : QStringLiteral("Worker %1").arg(tid))
+             << "\"}}";
+        ptrBuffer->foreachEvent([&](const Internal::TraceEvent& event) {
+            fnBeginEvent();
+            ostr << "{\"name\": ";
+            Internal::writeJsonString(ostr, event.name);
+            if (event.category) {
+                ostr << ", \"cat\": ";
+                Internal::writeJsonString(ostr, event.category);
+                ostr << ", \"ph\": \"X\", \"ts\": " << event.timestampUs << ", \"dur\": " << event.durationUs;
+            }
+            else {
+                ostr << ", \"ph\": \"C\", \"ts\": " << event.timestampUs
+                     << ", \"args\": {\"value\": " << event.counterValue << "}";
+            }
+
+            ostr << ", \"pid\": " << pid << ", \"tid\": " << tid << "}";
+        });
+    }
+
+    ostr << "\n]}\n";
+    ostr.flush();
+    return ostr.status() == QTextStream::Ok;
+}
+
+bool Tracing::writeChromeTrace(const QString& filepath)
+{
+    QFile file(filepath);
+    return file.open(QIODevice::WriteOnly) && Tracing::writeChromeTrace(&file);
+}
+
+TraceSpan::TraceSpan(const char* name, const char* category)
+    : m_name(name),
+      m_category(category),
+      m_startUs(Tracing::isEnabled() ? Tracing::nowMicroseconds() : -1)
+{
+}
+
+TraceSpan::~TraceSpan()
+{
+    if (m_startUs >= 0)
+        Tracing::recordSpan(m_name, m_category, m_startUs, Tracing::nowMicroseconds() - m_startUs);
+}
+
+} // namespace Mayo
@@ -0,0 +1,83 @@
+/****************************************************************************
+** Copyright (c) 2021, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QString>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class QIODevice;
+
+namespace Mayo {
+
+// Records timed spans and counters of the application phases(I/O, meshing, graphics, ...)
+// Events are appended to buffers owned by each thread, so recording never takes a lock. They
+// are written in Chrome trace format(JSON) which can be opened with chrome://tracing or Perfetto
+// Tracing is disabled by default, then recording an event is just a check of an atomic flag
+// Names and categories must be string literals(or have static storage), they're stored as is
+class Tracing {
+public:
+    static bool isEnabled();
+    static void setEnabled(bool on);
+
+    // Microseconds elapsed since the tracing epoch(first use of Tracing)
+    static int64_t nowMicroseconds();
+
+    static void recordSpan(const char* name, const char* category, int64_t startUs, int64_t durationUs);
+    static void recordCounter(const char* name, double value);
+
+    // Discards the events recorded so far, can be called while other threads are recording
+    // Memory of thread buffers is released, except the last chunk of each buffer
+    static void clear();
+
+    // Count of events recorded so far, over all threads
+    static int64_t eventCount();
+
+    struct SpanStatistics {
+        std::string name;
+        std::string category;
+        int64_t count = 0;
+        int64_t totalUs = 0; // Summed over all threads, so can exceed elapsed time
+        int64_t maxUs = 0;
+    };
+
+    // Returns statistics of recorded spans grouped by name, by decreasing total duration
+    static std::vector<SpanStatistics> spanStatistics();
+
+    // Writes all recorded events into 'device' as a Chrome trace JSON document
+    // Can be called while other threads are recording, their events not yet published are ignored
+    static bool writeChromeTrace(QIODevice* device);
+    static bool writeChromeTrace(const QString& filepath);
+
+private:
+    Tracing() = default;
+};
+
+// Records a span of the Tracing facility over the lifetime of the object
+class TraceSpan {
+public:
+    TraceSpan(const char* name, const char* category);
+    ~TraceSpan();
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+private:
+    const char* m_name = nullptr;
+    const char* m_category = nullptr;
+    int64_t m_startUs = -1; // Negative if tracing was disabled at construction
+};
+
+} // namespace Mayo
+
+#define MAYO_TRACE_CONCAT_IMPL(a, b) a##b
+#define MAYO_TRACE_CONCAT(a, b) MAYO_TRACE_CONCAT_IMPL(a, b)
+
+// Records a span covering the rest of the enclosing scope
+#define MAYO_TRACE_SCOPE(name, category) \
+    Mayo::TraceSpan MAYO_TRACE_CONCAT(traceSpan_, __LINE__)(name, category)
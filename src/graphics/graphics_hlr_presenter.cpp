@@ -0,0 +1,284 @@
+/****************************************************************************
+** Copyright (c) 2021, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#include "graphics_hlr_presenter.h"
+
+#include "../base/bnd_utils.h"
+#include "../base/task_manager.h"
+#include "graphics_object_driver.h"
+#include "graphics_scene.h"
+#include "graphics_utils.h"
+
+#include <BRep_Builder.hxx>
+#include <Bnd_Box.hxx>
+#include <Graphic3d_Camera.hxx>
+#include <HLRAlgo_Projector.hxx>
+#include <HLRBRep_PolyAlgo.hxx>
+#include <HLRBRep_PolyHLRToShape.hxx>
+#include <TopoDS_Compound.hxx>
+#include <gp_Ax3.hxx>
+#include <QtCore/QTimer>
+#include <algorithm>
+#include <cmath>
+
+namespace Mayo {
+
+namespace Internal {
+
+// Maximum count of HLR results kept in cache
+static constexpr int HlrCacheMaxSize = 8;
+
+// Resolution of view direction quantization
+static constexpr double HlrViewKeyResolution = 1000.;
+
+// Computes visible sharp edges and outlines of 'shape' projected along the Z axis of 'projectorAxes'
+// Resulting lines are expressed in world coordinates, lying in the plane defined by 'projectorAxes'
+static TopoDS_Shape computeHlrLines(const TopoDS_Shape& shape, const gp_Ax2& projectorAxes)
+{
+    Handle_HLRBRep_PolyAlgo algo = new HLRBRep_PolyAlgo;
+    algo->Load(shape);
+    algo->Projector(HLRAlgo_Projector(projectorAxes));
+    algo->Update();
+
+    HLRBRep_PolyHLRToShape hlrToShape;
+    hlrToShape.Update(algo);
+    TopoDS_Compound compLines;
+    BRep_Builder builder;
+    builder.MakeCompound(compLines);
+    for (const TopoDS_Shape& lines : { hlrToShape.VCompound(), hlrToShape.OutLineVCompound() }) {
+        if (!lines.IsNull())
+            builder.Add(compLines, lines);
+    }
+
+    // Lines are computed in the projector coordinate system, move them back to world
+    gp_Trsf trsfWorld;
+    trsfWorld.SetTransformation(gp_Ax3(projectorAxes));
+    trsfWorld.Invert();
+    return compLines.Moved(TopLoc_Location(trsfWorld));
+}
+
+} // namespace Internal
+
+struct GraphicsHlrPresenter::Job {
+    TaskId taskId = 0;
+    int revision = 0;
+    ViewKey key = {};
+    gp_Ax2 projectorAxes;
+    TopoDS_Compound input;
+    TopoDS_Shape result;
+};
+
+GraphicsHlrPresenter::GraphicsHlrPresenter(
+        GraphicsScene* scene, const Handle_V3d_View& view, QObject* parent)
+    : QObject(parent),
+      m_scene(scene),
+      m_view(view),
+      m_timer(new QTimer(this)),
+      m_taskMgr(new TaskManager(this))
+{
+    m_timer->setInterval(100);
+    QObject::connect(m_timer, &QTimer::timeout, this, &GraphicsHlrPresenter::onTimeout);
+    // Signal TaskManager::ended is emitted from worker thread, so connection is queued
+    QObject::connect(m_taskMgr, &TaskManager::ended, this, &GraphicsHlrPresenter::onTaskEnded);
+}
+
+GraphicsHlrPresenter::~GraphicsHlrPresenter()
+{
+    // Pending task(if any) is waited by TaskManager destructor, its result is simply discarded
+    QObject::disconnect(m_taskMgr, nullptr, this, nullptr);
+}
+
+void GraphicsHlrPresenter::setEnabled(bool on)
+{
+    if (on == m_isEnabled)
+        return;
+
+    m_isEnabled = on;
+    if (on) {
+        m_hasCurrentViewKey = false;
+        m_timer->start();
+    }
+    else {
+        m_timer->stop();
+        this->showEntry(nullptr);
+        m_scene->redraw();
+    }
+}
+
+void GraphicsHlrPresenter::invalidate()
+{
+    ++m_revision;
+    this->showEntry(nullptr);
+    m_vecCacheEntry.clear();
+    m_hasCurrentViewKey = false;
+    if (m_job)
+        m_taskMgr->requestAbort(m_job->taskId);
+}
+
+bool GraphicsHlrPresenter::findCurrentViewKey(ViewKey* key) const
+{
+    const Handle_Graphic3d_Camera& camera = m_view->Camera();
+    if (!camera->IsOrthographic())
+        return false;
+
+    const gp_Dir dir = camera->Direction();
+    auto fnQuantize = [](double v) { return int(std::lround(v * Internal::HlrViewKeyResolution)); };
+    *key = { fnQuantize(dir.X()), fnQuantize(dir.Y()), fnQuantize(dir.Z()) };
+    return true;
+}
+
+const GraphicsHlrPresenter::CacheEntry* GraphicsHlrPresenter::findCacheEntry(const ViewKey& key) const
+{
+    auto itFound = std::find_if(
+                m_vecCacheEntry.cbegin(),
+                m_vecCacheEntry.cend(),
+                [&](const CacheEntry& entry) { return entry.key == key; });
+    return itFound != m_vecCacheEntry.cend() ? &(*itFound) : nullptr;
+}
+
+std::vector<GraphicsObjectPtr> GraphicsHlrPresenter::shapeObjects() const
+{
+    std::vector<GraphicsObjectPtr> vecObject;
+    m_scene->foreachDisplayedObject([&](const GraphicsObjectPtr& object) {
+        const GraphicsObjectDriverPtr driver = GraphicsObjectDriver::get(object);
+        if (driver && driver->IsKind(STANDARD_TYPE(GraphicsShapeObjectDriver)))
+            vecObject.push_back(object);
+    });
+    return vecObject;
+}
+
+void GraphicsHlrPresenter::onTimeout()
+{
+    ViewKey key;
+    if (!this->findCurrentViewKey(&key)) {
+        // Perspective projection: fallback to regular presentation
+        if (m_aisLinesShown) {
+            this->showEntry(nullptr);
+            m_scene->redraw();
+        }
+
+        m_hasCurrentViewKey = false;
+        return;
+    }
+
+    if (!m_hasCurrentViewKey || key != m_currentViewKey) {
+        m_currentViewKey = key;
+        m_hasCurrentViewKey = true;
+        m_chronoViewIdle.start();
+        const CacheEntry* entry = this->findCacheEntry(key);
+        if (entry || m_aisLinesShown) {
+            this->showEntry(entry);
+            m_scene->redraw();
+        }
+
+        return;
+    }
+
+    const CacheEntry* entry = this->findCacheEntry(key);
+    if (entry) {
+        if (entry->aisLines != m_aisLinesShown) {
+            this->showEntry(entry);
+            m_scene->redraw();
+        }
+    }
+    else if (!m_job && m_chronoViewIdle.elapsed() >= m_idleDelay) {
+        this->startJob(key);
+    }
+}
+
+void GraphicsHlrPresenter::onTaskEnded(TaskId taskId)
+{
+    if (!m_job || m_job->taskId != taskId)
+        return;
+
+    const std::shared_ptr<Job> job = std::move(m_job);
+    if (job->revision != m_revision || job->result.IsNull())
+        return; // Outdated or aborted
+
+    if (int(m_vecCacheEntry.size()) >= Internal::HlrCacheMaxSize) {
+        // Evict oldest entry, but not the one currently shown
+        auto itEvict = m_vecCacheEntry.begin();
+        if (itEvict->aisLines == m_aisLinesShown)
+            ++itEvict;
+
+        m_vecCacheEntry.erase(itEvict);
+    }
+
+    Handle_AIS_Shape aisLines = new AIS_Shape(job->result);
+    aisLines->SetDisplayMode(AIS_WireFrame);
+    aisLines->SetColor(Quantity_NOC_BLACK);
+    m_vecCacheEntry.push_back({ job->key, aisLines });
+    if (m_isEnabled && m_hasCurrentViewKey && m_currentViewKey == job->key) {
+        this->showEntry(&m_vecCacheEntry.back());
+        m_scene->redraw();
+    }
+}
+
+void GraphicsHlrPresenter::startJob(const ViewKey& key)
+{
+    auto job = std::make_shared<Job>();
+    job->revision = m_revision;
+    job->key = key;
+
+    // Snapshot of the shapes to be processed, in world coordinates
+    Bnd_Box bndBox;
+    BRep_Builder builder;
+    builder.MakeCompound(job->input);
+    for (const GraphicsObjectPtr& object : this->shapeObjects()) {
+        const TopoDS_Shape shape = GraphicsUtils::AisObject_shape(object);
+        if (!shape.IsNull()) {
+            builder.Add(job->input, shape);
+            bndBox.Add(GraphicsUtils::AisObject_boundingBox(object));
+        }
+    }
+
+    if (bndBox.IsVoid())
+        return;
+
+    // Projection plane goes through the center of the shapes so the resulting lines aren't clipped
+    // by the near/far planes of the camera
+    const gp_Pnt center = BndBoxCoords::get(bndBox).center();
+    const Handle_Graphic3d_Camera& camera = m_view->Camera();
+    const gp_Dir dirNormal = camera->Direction().Reversed();
+    const gp_Dir dirX = camera->Up().Crossed(dirNormal);
+    job->projectorAxes = gp_Ax2(center, dirNormal, dirX);
+
+    m_job = job;
+    m_job->taskId = m_taskMgr->newTask([=](TaskProgress* progress) {
+        const TopoDS_Shape result = Internal::computeHlrLines(job->input, job->projectorAxes);
+        if (!progress->isAbortRequested())
+            job->result = result;
+    });
+    m_taskMgr->run(m_job->taskId);
+}
+
+void GraphicsHlrPresenter::showEntry(const CacheEntry* entry)
+{
+    const Handle_AIS_Shape aisLines = entry ? entry->aisLines : Handle_AIS_Shape();
+    if (aisLines == m_aisLinesShown)
+        return;
+
+    if (m_aisLinesShown)
+        m_scene->eraseObject(m_aisLinesShown);
+
+    m_aisLinesShown = aisLines;
+    if (aisLines) {
+        m_scene->addObject(aisLines, GraphicsScene::AddObjectDisableSelection);
+        if (m_vecObjectHidden.empty()) {
+            m_vecObjectHidden = this->shapeObjects();
+            for (const GraphicsObjectPtr& object : m_vecObjectHidden)
+                m_scene->setObjectVisibleInView(object, m_view, false);
+        }
+    }
+    else {
+        for (const GraphicsObjectPtr& object : m_vecObjectHidden)
+            m_scene->setObjectVisibleInView(object, m_view, true);
+
+        m_vecObjectHidden.clear();
+    }
+}
+
+} // namespace Mayo
@@ -0,0 +1,81 @@
+/****************************************************************************
+** Copyright (c) 2021, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#pragma once
+
+#include "../base/task_common.h"
+#include "graphics_object_ptr.h"
+
+#include <AIS_Shape.hxx>
+#include <V3d_View.hxx>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QObject>
+#include <array>
+#include <memory>
+#include <vector>
+class QTimer;
+
+namespace Mayo {
+
+class GraphicsScene;
+class TaskManager;
+
+// Provides hidden-line-removal(HLR) presentation of the shapes in a GraphicsScene for a V3d_View
+// HLR is computed in a background task once the camera of the view stays idle. While computation
+// is running, the shapes are displayed with their regular(shaded) presentation. Results are cached
+// per view direction, so moving back to a previous orientation doesn't require new computation
+// Only orthographic projection is supported, shapes are displayed shaded with perspective projection
+class GraphicsHlrPresenter : public QObject {
+    Q_OBJECT
+public:
+    GraphicsHlrPresenter(GraphicsScene* scene, const Handle_V3d_View& view, QObject* parent = nullptr);
+    ~GraphicsHlrPresenter();
+
+    bool isEnabled() const { return m_isEnabled; }
+    void setEnabled(bool on);
+
+    // Discards all cached results, to be called when shapes of the scene are changed(added, erased,
+    // moved, hidden, ...)
+    void invalidate();
+
+    // Delay(in milliseconds) the camera must stay idle before HLR computation starts
+    int idleDelay() const { return m_idleDelay; }
+    void setIdleDelay(int msecs) { m_idleDelay = msecs; }
+
+private:
+    using ViewKey = std::array<int, 3>; // Quantized view direction
+    struct CacheEntry {
+        ViewKey key;
+        Handle_AIS_Shape aisLines;
+    };
+
+    struct Job;
+
+    bool findCurrentViewKey(ViewKey* key) const;
+    const CacheEntry* findCacheEntry(const ViewKey& key) const;
+    std::vector<GraphicsObjectPtr> shapeObjects() const;
+    void onTimeout();
+    void onTaskEnded(TaskId taskId);
+    void startJob(const ViewKey& key);
+    void showEntry(const CacheEntry* entry);
+
+    GraphicsScene* m_scene = nullptr;
+    Handle_V3d_View m_view;
+    bool m_isEnabled = false;
+    int m_idleDelay = 300;
+    QTimer* m_timer = nullptr;
+    TaskManager* m_taskMgr = nullptr;
+    std::shared_ptr<Job> m_job;
+    std::vector<CacheEntry> m_vecCacheEntry;
+    Handle_AIS_Shape m_aisLinesShown;
+    std::vector<GraphicsObjectPtr> m_vecObjectHidden;
+    ViewKey m_currentViewKey = {};
+    bool m_hasCurrentViewKey = false;
+    QElapsedTimer m_chronoViewIdle;
+    int m_revision = 0;
+};
+
+} // namespace Mayo
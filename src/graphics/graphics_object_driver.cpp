@@ -12,6 +12,7 @@
 #include "graphics_object_base_property_group.h"
 #include "graphics_mesh_data_source.h"
 #include "graphics_scene.h"
+#include "graphics_shape_object.h"
 #include "graphics_utils.h"
 
 #include <AIS_ConnectedInteractive.hxx>
@@ -27,11 +28,24 @@
 #include <V3d_View.hxx>
 #include <V3d_Viewer.hxx>
 #include <TDataXtd_Triangulation.hxx>
-#include <XCAFPrs_AISObject.hxx>
 #include <stdexcept>
 
 namespace Mayo {
 
+namespace Internal {
+
+// Returns the product graphics object of 'object', which can be the product itself or an instance
+static Handle_GraphicsShapeObject graphicsShapeObject(const GraphicsObjectPtr& object)
+{
+    auto aisLink = Handle_AIS_ConnectedInteractive::DownCast(object);
+    if (aisLink && aisLink->HasConnection())
+        return Handle_GraphicsShapeObject::DownCast(aisLink->ConnectedTo());
+
+    return Handle_GraphicsShapeObject::DownCast(object);
+}
+
+} // namespace Internal
+
 namespace { struct GraphicsObjectDriverI18N { MAYO_DECLARE_TEXT_ID_FUNCTIONS(Mayo::GraphicsObjectDriver) }; }
 
 GraphicsObjectDriverPtr GraphicsObjectDriver::get(const GraphicsObjectPtr& object)
@@ -104,9 +118,8 @@ GraphicsObjectPtr GraphicsShapeObjectDriver::createObject(const TDF_Label& label
 {
     if (XCaf::isShape(label)) {
 //        Handle_AIS_Shape object = new AIS_Shape(XCaf::shape(label));
-        Handle_XCAFPrs_AISObject object = new XCAFPrs_AISObject(label);
+        Handle_GraphicsShapeObject object = new GraphicsShapeObject(label);
         object->SetDisplayMode(AIS_Shaded);
-        object->Attributes()->SetFaceBoundaryDraw(true);
         object->Attributes()->SetFaceBoundaryAspect(
                     new Prs3d_LineAspect(Quantity_NOC_BLACK, Aspect_TOL_SOLID, 1.));
         object->Attributes()->SetIsoOnTriangulation(true);
@@ -131,40 +144,31 @@ void GraphicsShapeObjectDriver::applyDisplayMode(GraphicsObjectPtr object, Enume
     if (!context)
         return;
 
-    auto fnSetViewComputedMode = [=](bool on) {
-        V3d_ListOfViewIterator viewIter = context->CurrentViewer()->DefinedViewIterator();
-        while (viewIter.More()) {
-            viewIter.Value()->SetComputedMode(on);
-            viewIter.Next();
-        }
-    };
+    // HLR presentation isn't computed by OpenCascade(view computed mode) as it blocks the GUI on
+    // each camera change, see GraphicsHlrPresenter
+    V3d_ListOfViewIterator viewIter = context->CurrentViewer()->DefinedViewIterator();
+    while (viewIter.More()) {
+        viewIter.Value()->SetComputedMode(false);
+        viewIter.Next();
+    }
 
-    if (mode == DisplayMode_HiddenLineRemoval) {
-        context->DefaultDrawer()->SetTypeOfHLR(Prs3d_TOH_PolyAlgo);
+    context->DefaultDrawer()->SetTypeOfHLR(Prs3d_TOH_NotSet);
+    // Objects are displayed shaded while HLR presentation isn't available
+    if (mode == DisplayMode_HiddenLineRemoval)
         context->DefaultDrawer()->EnableDrawHiddenLine();
-        fnSetViewComputedMode(true);
-    }
-    else {
-        context->DefaultDrawer()->SetTypeOfHLR(Prs3d_TOH_NotSet);
+    else
         context->DefaultDrawer()->DisableDrawHiddenLine();
-        fnSetViewComputedMode(false);
-        const AIS_DisplayMode aisDispMode = mode == DisplayMode_Wireframe ? AIS_WireFrame : AIS_Shaded;
-        const bool showFaceBounds = mode == DisplayMode_ShadedWithFaceBoundary;
-        if (object->DisplayMode() != aisDispMode)
-            context->SetDisplayMode(object, aisDispMode, false);
-
-        if (object->Attributes()->FaceBoundaryDraw() != showFaceBounds) {
-            object->Attributes()->SetFaceBoundaryDraw(showFaceBounds);
-            auto aisLink = Handle_AIS_ConnectedInteractive::DownCast(object);
-            if (aisLink && aisLink->HasConnection()) {
-                aisLink->ConnectedTo()->Attributes()->SetFaceBoundaryDraw(showFaceBounds);
-                aisLink->ConnectedTo()->Redisplay(true);
-            }
-            else {
-                object->Redisplay(true);
-            }
-        }
-    }
+
+    const AIS_DisplayMode aisDispMode = mode == DisplayMode_Wireframe ? AIS_WireFrame : AIS_Shaded;
+    const bool showFaceBounds =
+            mode == DisplayMode_ShadedWithFaceBoundary || mode == DisplayMode_HiddenLineRemoval;
+    if (object->DisplayMode() != aisDispMode)
+        context->SetDisplayMode(object, aisDispMode, false);
+
+    // Instances share the presentation of the product, no need to recompute anything
+    auto shapeObject = Internal::graphicsShapeObject(object);
+    if (shapeObject)
+        shapeObject->setFaceBoundaryVisible(showFaceBounds);
 
     // context->UpdateCurrentViewer();
 }
@@ -180,7 +184,8 @@ Enumeration::Value GraphicsShapeObjectDriver::currentDisplayMode(const GraphicsO
         return DisplayMode_Wireframe;
 
     if (displayMode == AIS_Shaded) {
-        return object->Attributes()->FaceBoundaryDraw() ?
+        auto shapeObject = Internal::graphicsShapeObject(object);
+        return shapeObject && shapeObject->isFaceBoundaryVisible() ?
                     DisplayMode_ShadedWithFaceBoundary :
                     DisplayMode_Shaded;
     }
@@ -74,6 +74,8 @@ public:
         DisplayMode_Shaded,
         DisplayMode_ShadedWithFaceBoundary
     };
+
+    DEFINE_STANDARD_RTTI_INLINE(GraphicsShapeObjectDriver, GraphicsObjectDriver)
 };
 
 class GraphicsMeshObjectDriver : public GraphicsObjectDriver {
@@ -96,6 +98,8 @@ public:
     static const DefaultValues& defaultValues();
     static void setDefaultValues(const DefaultValues& values);
 
+    DEFINE_STANDARD_RTTI_INLINE(GraphicsMeshObjectDriver, GraphicsObjectDriver)
+
 private:
     class ObjectProperties;
 };
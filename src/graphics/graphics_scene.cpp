@@ -9,19 +9,21 @@
 #include "../base/tkernel_utils.h"
 #include "graphics_utils.h"
 
+#include <Bnd_Box.hxx>
 #include <Graphic3d_GraphicDriver.hxx>
+#include <gp_Lin.hxx>
 #include <V3d_TypeOfOrientation.hxx>
 #include <QtCore/QPoint>
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
 
 namespace Mayo {
 namespace Internal {
 
-// Defined in graphics_create_driver.cpp
-Handle_Graphic3d_GraphicDriver createGfxDriver();
-
-static Handle_V3d_Viewer createOccViewer()
+static Handle_V3d_Viewer createOccViewer(const Handle_Graphic3d_GraphicDriver& gfxDriver)
 {
-    Handle_V3d_Viewer viewer = new V3d_Viewer(createGfxDriver());
+    Handle_V3d_Viewer viewer = new V3d_Viewer(gfxDriver);
     viewer->SetDefaultViewSize(1000.);
     viewer->SetDefaultViewProj(V3d_XposYnegZpos);
     viewer->SetComputedMode(true);
@@ -49,6 +51,114 @@ public:
 
 DEFINE_STANDARD_HANDLE(InteractiveContext, AIS_InteractiveContext)
 
+// Coarse bounding volume hierarchy over the world bounding boxes of graphics objects
+// Used as broad-phase to find the objects possibly under the cursor
+class ObjectBoxTree {
+public:
+    struct Item {
+        Bnd_Box box;
+        GraphicsObjectPtr object;
+    };
+
+    void build(std::vector<Item>&& items)
+    {
+        m_items = std::move(items);
+        m_nodes.clear();
+        if (!m_items.empty())
+            this->buildNode(0, int(m_items.size()));
+    }
+
+    void clear()
+    {
+        m_items.clear();
+        m_nodes.clear();
+    }
+
+    // Calls 'fn' for each object whose box(enlarged by 'tolerance') is crossed by line 'lin'
+    template<typename FUNCTION>
+    void traverse(const gp_Lin& lin, double tolerance, FUNCTION fn) const
+    {
+        if (m_nodes.empty())
+            return;
+
+        auto fnIsOut = [=](Bnd_Box box) {
+            box.Enlarge(tolerance);
+            return box.IsOut(lin);
+        };
+        std::vector<int> stackNodeId = { 0 };
+        while (!stackNodeId.empty()) {
+            const Node& node = m_nodes.at(stackNodeId.back());
+            stackNodeId.pop_back();
+            if (fnIsOut(node.box))
+                continue;
+
+            if (node.isLeaf()) {
+                for (int i = node.itemFirst; i < node.itemLast; ++i) {
+                    if (!fnIsOut(m_items.at(i).box))
+                        fn(m_items.at(i).object);
+                }
+            }
+            else {
+                stackNodeId.push_back(node.childLeft);
+                stackNodeId.push_back(node.childRight);
+            }
+        }
+    }
+
+private:
+    struct Node {
+        Bnd_Box box;
+        int itemFirst = 0;
+        int itemLast = 0; // Past-the-end
+        int childLeft = -1;
+        int childRight = -1;
+        bool isLeaf() const { return this->childLeft < 0; }
+    };
+
+    static constexpr int MaxLeafItemCount = 8;
+
+    int buildNode(int itemFirst, int itemLast)
+    {
+        const int nodeId = int(m_nodes.size());
+        m_nodes.emplace_back();
+        Node node;
+        node.itemFirst = itemFirst;
+        node.itemLast = itemLast;
+        for (int i = itemFirst; i < itemLast; ++i)
+            node.box.Add(m_items.at(i).box);
+
+        if (itemLast - itemFirst > MaxLeafItemCount && !node.box.IsVoid()) {
+            // Median split along the largest axis of the node box
+            double xMin, yMin, zMin, xMax, yMax, zMax;
+            node.box.Get(xMin, yMin, zMin, xMax, yMax, zMax);
+            const double extents[] = { xMax - xMin, yMax - yMin, zMax - zMin };
+            const int axis = int(std::max_element(std::begin(extents), std::end(extents)) - std::begin(extents));
+            auto fnCenter = [=](const Item& item) {
+                if (item.box.IsVoid())
+                    return 0.;
+
+                double xMin, yMin, zMin, xMax, yMax, zMax;
+                item.box.Get(xMin, yMin, zMin, xMax, yMax, zMax);
+                const double min[] = { xMin, yMin, zMin };
+                const double max[] = { xMax, yMax, zMax };
+                return (min[axis] + max[axis]) / 2.;
+            };
+            const int itemMid = (itemFirst + itemLast) / 2;
+            std::nth_element(
+                        m_items.begin() + itemFirst, m_items.begin() + itemMid, m_items.begin() + itemLast,
+                        [=](const Item& lhs, const Item& rhs) { return fnCenter(lhs) < fnCenter(rhs); });
+            node.childLeft = this->buildNode(itemFirst, itemMid);
+            node.childRight = this->buildNode(itemMid, itemLast);
+        }
+
+        m_nodes.at(nodeId) = node;
+        return nodeId;
+    }
+
+    std::vector<Item> m_items;
+    std::vector<Node> m_nodes;
+};
+
 } // namespace
 
 class GraphicsScene::Private {
@@ -56,16 +166,55 @@ public:
     Handle_V3d_Viewer m_v3dViewer;
     Handle_InteractiveContext m_aisContext;
     std::unordered_set<const AIS_InteractiveObject*> m_setClipPlaneSensitive;
+    std::unordered_set<const AIS_InteractiveObject*> m_setSelectionDisabled;
     bool m_isRedrawBlocked = false;
     SelectionMode m_selectionMode = SelectionMode::Single;
+
+    // Objects whose selection activation is deferred, mapped to their default selection mode
+    std::unordered_map<const AIS_InteractiveObject*, int> m_mapDeferredSelectionObject;
+    ObjectBoxTree m_deferredSelectionTree;
+    bool m_isDeferredSelectionTreeDirty = false;
+
+    void activateDeferredSelection(const GraphicsObjectPtr& object)
+    {
+        auto itFound = m_mapDeferredSelectionObject.find(object.get());
+        if (itFound != m_mapDeferredSelectionObject.end()) {
+            const int selectionMode = itFound->second;
+            m_mapDeferredSelectionObject.erase(itFound);
+            m_aisContext->Activate(object, selectionMode);
+        }
+    }
+
+    void updateDeferredSelectionTree()
+    {
+        if (!m_isDeferredSelectionTreeDirty)
+            return;
+
+        std::vector<ObjectBoxTree::Item> vecItem;
+        vecItem.reserve(m_mapDeferredSelectionObject.size());
+        AIS_ListOfInteractive listObject;
+        m_aisContext->DisplayedObjects(listObject);
+        for (const GraphicsObjectPtr& object : listObject) {
+            if (m_mapDeferredSelectionObject.find(object.get()) == m_mapDeferredSelectionObject.cend())
+                continue; // Skip
+
+            const Bnd_Box box = GraphicsUtils::AisObject_boundingBox(object);
+            vecItem.push_back({ box.Transformed(m_aisContext->Location(object)), object });
+        }
+
+        m_deferredSelectionTree.build(std::move(vecItem));
+        m_isDeferredSelectionTreeDirty = false;
+    }
 };
 
-GraphicsScene::GraphicsScene(QObject* parent)
+GraphicsScene::GraphicsScene(const Handle_Graphic3d_GraphicDriver& gfxDriver, QObject* parent)
     : QObject(parent),
       d(new Private)
 {
-    d->m_v3dViewer = Internal::createOccViewer();
+    d->m_v3dViewer = Internal::createOccViewer(gfxDriver);
     d->m_aisContext = new InteractiveContext(d->m_v3dViewer);
+    // Selection of objects is activated on demand, see GraphicsScene::addObject()
+    d->m_aisContext->SetAutoActivateSelection(false);
 }
 
 GraphicsScene::~GraphicsScene()
@@ -98,16 +247,36 @@ bool GraphicsScene::hiddenLineDrawingOn() const
     return d->m_aisContext->DrawHiddenLine();
 }
 
-void GraphicsScene::addObject(const GraphicsObjectPtr& object)
+void GraphicsScene::addObject(const GraphicsObjectPtr& object, AddObjectFlags flags)
 {
-    if (object)
-        d->m_aisContext->Display(object, false);
+    if (!object)
+        return;
+
+    d->m_aisContext->Display(object, false);
+    if ((flags & AddObjectDisableSelection) != 0) {
+        d->m_setSelectionDisabled.insert(object.get());
+        return;
+    }
+
+    // Objects with transform persistence(eg view cube) can't be located by their world box
+    const bool deferSelection =
+            (flags & AddObjectDeferSelection) != 0 && object->TransformPersistence().IsNull();
+    if (deferSelection) {
+        d->m_mapDeferredSelectionObject.insert({ object.get(), object->GlobalSelectionMode() });
+        d->m_isDeferredSelectionTreeDirty = true;
+    }
+    else {
+        d->m_aisContext->Activate(object, object->GlobalSelectionMode());
+    }
 }
 
 void GraphicsScene::eraseObject(const GraphicsObjectPtr& object)
 {
     GraphicsUtils::AisContext_eraseObject(d->m_aisContext, object);
     d->m_setClipPlaneSensitive.erase(object.get());
+    d->m_setSelectionDisabled.erase(object.get());
+    if (d->m_mapDeferredSelectionObject.erase(object.get()) != 0)
+        d->m_isDeferredSelectionTreeDirty = true;
 }
 
 void GraphicsScene::redraw()
@@ -133,11 +302,13 @@ void GraphicsScene::recomputeObjectPresentation(const GraphicsObjectPtr& object)
 
 void GraphicsScene::activateObjectSelection(const GraphicsObjectPtr& object, int mode)
 {
+    d->activateDeferredSelection(object);
     d->m_aisContext->Activate(object, mode);
 }
 
 void GraphicsScene::deactivateObjectSelection(const Mayo::GraphicsObjectPtr &object, int mode)
 {
+    d->activateDeferredSelection(object);
     d->m_aisContext->Deactivate(object, mode);
 }
 
@@ -188,6 +359,23 @@ bool GraphicsScene::isObjectVisible(const GraphicsObjectPtr& object) const
 void GraphicsScene::setObjectVisible(const GraphicsObjectPtr& object, bool on)
 {
     GraphicsUtils::AisContext_setObjectVisible(d->m_aisContext, object, on);
+    const bool isSelectionDeferred =
+            d->m_mapDeferredSelectionObject.find(object.get()) != d->m_mapDeferredSelectionObject.cend();
+    const bool isSelectionDisabled =
+            d->m_setSelectionDisabled.find(object.get()) != d->m_setSelectionDisabled.cend();
+    if (on && object && !isSelectionDeferred && !isSelectionDisabled)
+        d->m_aisContext->Activate(object, object->GlobalSelectionMode());
+
+    // Deferred selection tree only indexes displayed objects
+    if (isSelectionDeferred)
+        d->m_isDeferredSelectionTreeDirty = true;
+}
+
+void GraphicsScene::setObjectVisibleInView(
+        const GraphicsObjectPtr& object, const Handle_V3d_View& view, bool on)
+{
+    if (object && view)
+        d->m_aisContext->SetViewAffinity(object, view, on);
 }
 
 gp_Trsf GraphicsScene::objectTransformation(const GraphicsObjectPtr& object) const
@@ -198,6 +386,8 @@ gp_Trsf GraphicsScene::objectTransformation(const GraphicsObjectPtr& object) con
 void GraphicsScene::setObjectTransformation(const GraphicsObjectPtr &object, const gp_Trsf &trsf)
 {
     d->m_aisContext->SetLocation(object, trsf);
+    if (d->m_mapDeferredSelectionObject.find(object.get()) != d->m_mapDeferredSelectionObject.cend())
+        d->m_isDeferredSelectionTreeDirty = true;
 }
 
 GraphicsOwnerPtr GraphicsScene::firstSelectedOwner() const
@@ -215,11 +405,32 @@ void GraphicsScene::clearSelection()
     d->m_aisContext->ClearSelected(false);
 }
 
+void GraphicsScene::highlightObject(const GraphicsObjectPtr& object, const Handle_Prs3d_Drawer& style)
+{
+    if (object && style)
+        d->m_aisContext->HilightWithColor(object, style, false);
+}
+
+void GraphicsScene::unhighlightObject(const GraphicsObjectPtr& object)
+{
+    if (object)
+        d->m_aisContext->Unhilight(object, false);
+}
+
 AIS_InteractiveContext* GraphicsScene::aisContextPtr() const
 {
     return d->m_aisContext.get();
 }
 
+void GraphicsScene::toggleObjectSelection(const GraphicsObjectPtr& object)
+{
+    if (!object)
+        return;
+
+    d->activateDeferredSelection(object);
+    this->toggleOwnerSelection(object->GlobalSelOwner());
+}
+
 void GraphicsScene::toggleOwnerSelection(const GraphicsOwnerPtr& gfxOwner)
 {
     auto gfxObject = GraphicsObjectPtr::DownCast(
@@ -230,9 +441,38 @@ void GraphicsScene::toggleOwnerSelection(const GraphicsOwnerPtr& gfxOwner)
 
 void GraphicsScene::highlightAt(const QPoint& pos, const Handle_V3d_View& view)
 {
+    this->activateSelectionAt(pos, view);
     d->m_aisContext->MoveTo(pos.x(), pos.y(), view, true);
 }
 
+void GraphicsScene::activateSelectionAt(const QPoint& pos, const Handle_V3d_View& view)
+{
+    if (d->m_mapDeferredSelectionObject.empty())
+        return;
+
+    double eyeX, eyeY, eyeZ;
+    double dirX, dirY, dirZ;
+    view->ConvertWithProj(pos.x(), pos.y(), eyeX, eyeY, eyeZ, dirX, dirY, dirZ);
+    const gp_Lin lineOfSight(gp_Pnt(eyeX, eyeY, eyeZ), gp_Dir(dirX, dirY, dirZ));
+    // Pick tolerance of AIS_InteractiveContext is a few pixels, use a wider margin to be safe
+    constexpr int pixelTolerance = 8;
+    this->activateSelectionAlong(lineOfSight, view->Convert(pixelTolerance));
+}
+
+void GraphicsScene::activateSelectionAlong(const gp_Lin& lineOfSight, double tolerance)
+{
+    if (d->m_mapDeferredSelectionObject.empty())
+        return;
+
+    d->updateDeferredSelectionTree();
+    std::vector<GraphicsObjectPtr> vecObjectToActivate;
+    d->m_deferredSelectionTree.traverse(lineOfSight, tolerance, [&](const GraphicsObjectPtr& object) {
+        vecObjectToActivate.push_back(object);
+    });
+    for (const GraphicsObjectPtr& object : vecObjectToActivate)
+        d->activateDeferredSelection(object);
+}
+
 void GraphicsScene::select()
 {
     if (d->m_selectionMode == SelectionMode::None)
@@ -10,10 +10,12 @@
 #include "graphics_owner_ptr.h"
 
 #include <AIS_InteractiveContext.hxx>
+#include <Graphic3d_GraphicDriver.hxx>
 #include <V3d_Viewer.hxx>
 #include <V3d_View.hxx>
 #include <QtCore/QObject>
 #include <unordered_set>
+class gp_Lin;
 class QPoint;
 
 namespace Mayo {
@@ -23,7 +25,8 @@ namespace Mayo {
 class GraphicsScene : public QObject {
     Q_OBJECT
 public:
-    GraphicsScene(QObject* parent = nullptr);
+    // Scenes created with the same 'gfxDriver' share OpenGL resources(shader programs, textures, ...)
+    GraphicsScene(const Handle_Graphic3d_GraphicDriver& gfxDriver, QObject* parent = nullptr);
     ~GraphicsScene();
 
     opencascade::handle<V3d_View> createV3dView();
@@ -33,7 +36,17 @@ public:
     const opencascade::handle<StdSelect_ViewerSelector3d>& mainSelector() const;
     bool hiddenLineDrawingOn() const;
 
-    void addObject(const GraphicsObjectPtr& object);
+    enum AddObjectFlag {
+        AddObjectDefault = 0,
+        // Sensitive entities of the object are built only once it's under the cursor(or explicitly
+        // selected). This saves memory and time for large scenes where only few objects get picked
+        AddObjectDeferSelection = 0x01,
+        // Object is never selectable(eg helper presentations)
+        AddObjectDisableSelection = 0x02
+    };
+    using AddObjectFlags = unsigned;
+
+    void addObject(const GraphicsObjectPtr& object, AddObjectFlags flags = AddObjectDefault);
     void eraseObject(const GraphicsObjectPtr& object);
 
     void redraw();
@@ -56,6 +69,8 @@ public:
 
     bool isObjectVisible(const GraphicsObjectPtr& object) const;
     void setObjectVisible(const GraphicsObjectPtr& object, bool on);
+    // Shows/hides 'object' in 'view' only, object keeps its visible state in other views
+    void setObjectVisibleInView(const GraphicsObjectPtr& object, const Handle_V3d_View& view, bool on);
 
     gp_Trsf objectTransformation(const GraphicsObjectPtr& object) const;
     void setObjectTransformation(const GraphicsObjectPtr& object, const gp_Trsf& trsf);
@@ -68,14 +83,24 @@ public:
 
     const GraphicsOwnerPtr& currentHighlightedOwner() const;
     void highlightAt(const QPoint& pos, const Handle_V3d_View& view);
+    // Activates deferred selection of the objects possibly located at 'pos' in 'view'
+    // Called by highlightAt(), useful before using directly mainSelector()
+    void activateSelectionAt(const QPoint& pos, const Handle_V3d_View& view);
+    // Activates deferred selection of the objects whose box(enlarged by 'tolerance') is crossed by 'lineOfSight'
+    void activateSelectionAlong(const gp_Lin& lineOfSight, double tolerance);
     void select();
 
     int selectedCount() const;
 
     GraphicsOwnerPtr firstSelectedOwner() const;
     void toggleOwnerSelection(const GraphicsOwnerPtr& owner);
+    void toggleObjectSelection(const GraphicsObjectPtr& object);
     void clearSelection();
 
+    // Highlights 'object' with 'style', independently of the selection and dynamic highlighting
+    void highlightObject(const GraphicsObjectPtr& object, const Handle_Prs3d_Drawer& style);
+    void unhighlightObject(const GraphicsObjectPtr& object);
+
     template<typename FUNCTION>
     void foreachDisplayedObject(FUNCTION fn) const;
 
@@ -0,0 +1,149 @@
+/****************************************************************************
+** Copyright (c) 2021, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#include "graphics_shape_object.h"
+
+#include <AIS_DisplayMode.hxx>
+#include <BRep_Tool.hxx>
+#include <OSD_Parallel.hxx>
+#include <Poly_PolygonOnTriangulation.hxx>
+#include <Poly_Triangulation.hxx>
+#include <Prs3d_LineAspect.hxx>
+#include <TopExp.hxx>
+#include <TopoDS.hxx>
+#include <TopTools_IndexedDataMapOfShapeListOfShape.hxx>
+#include <vector>
+
+namespace Mayo {
+
+namespace Internal {
+
+// Extracts the polylines of the shape edges from the polygons on triangulation of adjacent faces
+// Each edge is processed once even if shared by several faces
+static Handle_Graphic3d_ArrayOfSegments computeFaceBoundarySegments(const TopoDS_Shape& shape)
+{
+    TopTools_IndexedDataMapOfShapeListOfShape mapEdgeFaces;
+    TopExp::MapShapesAndAncestors(shape, TopAbs_EDGE, TopAbs_FACE, mapEdgeFaces);
+    std::vector<std::vector<gp_Pnt>> vecPolyline(mapEdgeFaces.Extent());
+    OSD_Parallel::For(0, mapEdgeFaces.Extent(), [&](int i) {
+        const TopoDS_Edge& edge = TopoDS::Edge(mapEdgeFaces.FindKey(i + 1));
+        if (BRep_Tool::Degenerated(edge))
+            return;
+
+        for (const TopoDS_Shape& face : mapEdgeFaces.FindFromIndex(i + 1)) {
+            TopLoc_Location loc;
+            const Handle_Poly_Triangulation& triangulation = BRep_Tool::Triangulation(TopoDS::Face(face), loc);
+            if (triangulation.IsNull())
+                continue;
+
+            const Handle_Poly_PolygonOnTriangulation& polygon =
+                    BRep_Tool::PolygonOnTriangulation(edge, triangulation, loc);
+            if (polygon.IsNull())
+                continue;
+
+            const TColStd_Array1OfInteger& vecNodeId = polygon->Nodes();
+            const TColgp_Array1OfPnt& vecNode = triangulation->Nodes();
+            const gp_Trsf& trsf = loc.Transformation();
+            std::vector<gp_Pnt>& polyline = vecPolyline.at(i);
+            polyline.reserve(vecNodeId.Length());
+            for (int j = vecNodeId.Lower(); j <= vecNodeId.Upper(); ++j)
+                polyline.push_back(vecNode.Value(vecNodeId.Value(j)).Transformed(trsf));
+
+            break;
+        }
+    });
+
+    int vertexCount = 0;
+    int edgeCount = 0;
+    for (const std::vector<gp_Pnt>& polyline : vecPolyline) {
+        if (polyline.size() >= 2) {
+            vertexCount += int(polyline.size());
+            edgeCount += 2 * int(polyline.size() - 1);
+        }
+    }
+
+    if (vertexCount == 0)
+        return {};
+
+    Handle_Graphic3d_ArrayOfSegments segments = new Graphic3d_ArrayOfSegments(vertexCount, edgeCount);
+    for (const std::vector<gp_Pnt>& polyline : vecPolyline) {
+        if (polyline.size() < 2)
+            continue;
+
+        const int firstVertexId = segments->VertexNumber() + 1;
+        for (const gp_Pnt& pnt : polyline)
+            segments->AddVertex(pnt);
+
+        for (int j = 0; j < int(polyline.size()) - 1; ++j) {
+            segments->AddEdge(firstVertexId + j);
+            segments->AddEdge(firstVertexId + j + 1);
+        }
+    }
+
+    return segments;
+}
+
+} // namespace Internal
+
+GraphicsShapeObject::GraphicsShapeObject(const TDF_Label& label)
+    : XCAFPrs_AISObject(label)
+{
+    // Built-in face boundaries are replaced by the group provided in Compute()
+    myDrawer->SetFaceBoundaryDraw(false);
+}
+
+void GraphicsShapeObject::setFaceBoundaryVisible(bool on)
+{
+    if (on == m_isFaceBoundaryVisible)
+        return;
+
+    m_isFaceBoundaryVisible = on;
+    if (m_faceBoundaryGroup)
+        this->fillFaceBoundaryGroup();
+}
+
+void GraphicsShapeObject::Compute(
+        const opencascade::handle<PrsMgr_PresentationManager3d>& pm,
+        const opencascade::handle<Prs3d_Presentation>& pres,
+        const int mode)
+{
+    XCAFPrs_AISObject::Compute(pm, pres, mode);
+    if (mode == AIS_Shaded) {
+        // Shaded presentation is recomputed when the shape or its triangulation changed(eg new
+        // meshing parameters), so boundaries previously extracted may be stale
+        m_isFaceBoundarySegmentsBuilt = false;
+        m_faceBoundarySegments.Nullify();
+        // Group is created even if boundaries are hidden so it can be filled later on
+        m_faceBoundaryGroup = pres->NewGroup();
+        this->fillFaceBoundaryGroup();
+    }
+}
+
+const Handle_Graphic3d_ArrayOfSegments& GraphicsShapeObject::faceBoundarySegments()
+{
+    if (!m_isFaceBoundarySegmentsBuilt) {
+        // Triangulation is available at this point, computed by the shaded presentation
+        m_faceBoundarySegments = Internal::computeFaceBoundarySegments(this->Shape());
+        m_isFaceBoundarySegmentsBuilt = true;
+    }
+
+    return m_faceBoundarySegments;
+}
+
+void GraphicsShapeObject::fillFaceBoundaryGroup()
+{
+    m_faceBoundaryGroup->Clear();
+    if (!m_isFaceBoundaryVisible)
+        return;
+
+    const Handle_Graphic3d_ArrayOfSegments& segments = this->faceBoundarySegments();
+    if (segments) {
+        m_faceBoundaryGroup->SetGroupPrimitivesAspect(myDrawer->FaceBoundaryAspect()->Aspect());
+        m_faceBoundaryGroup->AddPrimitiveArray(segments);
+    }
+}
+
+} // namespace Mayo
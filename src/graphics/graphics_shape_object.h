@@ -0,0 +1,50 @@
+/****************************************************************************
+** Copyright (c) 2021, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#pragma once
+
+#include <Graphic3d_ArrayOfSegments.hxx>
+#include <Graphic3d_Group.hxx>
+#include <Prs3d_Presentation.hxx>
+#include <PrsMgr_PresentationManager3d.hxx>
+#include <XCAFPrs_AISObject.hxx>
+
+namespace Mayo {
+
+// Graphics object of a product shape(XDE label)
+// Face boundaries are drawn by a dedicated group of the shaded presentation instead of the built-in
+// Prs3d_Drawer::FaceBoundaryDraw() mechanism. Boundary polylines are extracted(in parallel) from
+// the polygons on triangulation of the shape edges once per computation of the shaded presentation
+// and then kept, so showing/hiding them doesn't recompute the shaded presentation
+// Instances(AIS_ConnectedInteractive) share the presentation of the product, hence its boundaries
+class GraphicsShapeObject : public XCAFPrs_AISObject {
+public:
+    GraphicsShapeObject(const TDF_Label& label);
+
+    bool isFaceBoundaryVisible() const { return m_isFaceBoundaryVisible; }
+    void setFaceBoundaryVisible(bool on);
+
+    DEFINE_STANDARD_RTTI_INLINE(GraphicsShapeObject, XCAFPrs_AISObject)
+
+protected:
+    void Compute(
+            const opencascade::handle<PrsMgr_PresentationManager3d>& pm,
+            const opencascade::handle<Prs3d_Presentation>& pres,
+            const int mode) override;
+
+private:
+    const Handle_Graphic3d_ArrayOfSegments& faceBoundarySegments();
+    void fillFaceBoundaryGroup();
+
+    bool m_isFaceBoundaryVisible = true;
+    bool m_isFaceBoundarySegmentsBuilt = false;
+    Handle_Graphic3d_ArrayOfSegments m_faceBoundarySegments;
+    Handle_Graphic3d_Group m_faceBoundaryGroup;
+};
+
+DEFINE_STANDARD_HANDLE(GraphicsShapeObject, XCAFPrs_AISObject)
+
+} // namespace Mayo
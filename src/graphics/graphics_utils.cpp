@@ -10,6 +10,8 @@
 #include "../base/tkernel_utils.h"
 
 #include <algorithm>
+#include <AIS_ConnectedInteractive.hxx>
+#include <AIS_Shape.hxx>
 #include <Bnd_Box.hxx>
 #include <ElSLib.hxx>
 #include <ProjLib.hxx>
@@ -145,6 +147,19 @@ Bnd_Box GraphicsUtils::AisObject_boundingBox(const GraphicsObjectPtr& object)
     return box;
 }
 
+TopoDS_Shape GraphicsUtils::AisObject_shape(const GraphicsObjectPtr& object)
+{
+    Handle_AIS_Shape aisShape = Handle_AIS_Shape::DownCast(object);
+    auto aisLink = Handle_AIS_ConnectedInteractive::DownCast(object);
+    if (aisLink && aisLink->HasConnection())
+        aisShape = Handle_AIS_Shape::DownCast(aisLink->ConnectedTo());
+
+    if (!aisShape || aisShape->Shape().IsNull())
+        return {};
+
+    return aisShape->Shape().Moved(TopLoc_Location(object->LocalTransformation()));
+}
+
 int GraphicsUtils::AspectWindow_width(const Handle_Aspect_Window& wnd)
 {
     if (wnd.IsNull())
@@ -34,6 +34,8 @@ struct GraphicsUtils {
     static bool AisObject_isVisible(const GraphicsObjectPtr& object);
     static void AisObject_setVisible(const GraphicsObjectPtr& object, bool on);
     static Bnd_Box AisObject_boundingBox(const GraphicsObjectPtr& object);
+    // Returns the shape presented by 'object'(AIS_Shape or connected to AIS_Shape) in world coordinates
+    static TopoDS_Shape AisObject_shape(const GraphicsObjectPtr& object);
 
     static int AspectWindow_width(const Handle_Aspect_Window& wnd);
     static int AspectWindow_height(const Handle_Aspect_Window& wnd);
@@ -8,14 +8,24 @@
 
 #include <QtCore/QDebug>
 #include <QtCore/QRect>
+#include <QtCore/QTimer>
 #include <V3d_View.hxx>
 
 namespace Mayo {
 
 V3dViewController::V3dViewController(const Handle_V3d_View& view, QObject* parent)
     : QObject(parent),
-      m_view(view)
+      m_view(view),
+      m_timerMouseMoved(new QTimer(this))
 {
+    m_timerMouseMoved->setSingleShot(true);
+    m_timerMouseMoved->setTimerType(Qt::PreciseTimer);
+    m_timerMouseMoved->setInterval(16);
+    QObject::connect(m_timerMouseMoved, &QTimer::timeout, this, [=]{
+        // Camera is moving, hover position is no more relevant
+        if (!this->hasCurrentDynamicAction())
+            emit mouseMoved(m_posMouseMoved);
+    });
 }
 
 V3dViewController::~V3dViewController()
@@ -35,6 +45,23 @@ void V3dViewController::zoomOut()
     emit viewScaled();
 }
 
+int V3dViewController::mouseMovedInterval() const
+{
+    return m_timerMouseMoved->interval();
+}
+
+void V3dViewController::setMouseMovedInterval(int msecs)
+{
+    m_timerMouseMoved->setInterval(msecs);
+}
+
+void V3dViewController::notifyMouseMoved(const QPoint& pos)
+{
+    m_posMouseMoved = pos;
+    if (!m_timerMouseMoved->isActive())
+        m_timerMouseMoved->start();
+}
+
 void V3dViewController::startDynamicAction(DynamicAction dynAction)
 {
     if (dynAction == DynamicAction::None)
@@ -43,6 +70,7 @@ void V3dViewController::startDynamicAction(DynamicAction dynAction)
     if (m_dynamicAction != DynamicAction::None)
         return;
 
+    m_timerMouseMoved->stop();
     m_dynamicAction = dynAction;
     emit dynamicActionStarted(dynAction);
 }
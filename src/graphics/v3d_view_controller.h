@@ -10,6 +10,7 @@
 #include <V3d_View.hxx>
 #include <QtCore/QObject>
 #include <QtCore/QPoint>
+class QTimer;
 
 namespace Mayo {
 
@@ -42,15 +43,26 @@ public:
     double instantZoomFactor() const { return m_instantZoomFactor; }
     void setInstantZoomFactor(double factor) { m_instantZoomFactor = factor; }
 
+    // Minimum interval(in milliseconds) between two emissions of signal mouseMoved()
+    // Default matches a 60Hz display refresh
+    int mouseMovedInterval() const;
+    void setMouseMovedInterval(int msecs);
+
 signals:
     void dynamicActionStarted(DynamicAction dynAction);
     void dynamicActionEnded(DynamicAction dynAction);
     void viewScaled();
 
+    // Emitted when the mouse moves over the view without any dynamic action in progress
+    // Notifications are coalesced: intermediate positions are dropped so signal is emitted at most
+    // once per refresh interval(see mouseMovedInterval()) with the latest position
     void mouseMoved(const QPoint& posMouseInView);
     void mouseClicked(Qt::MouseButton btn);
 
 protected:
+    // Schedules emission of signal mouseMoved() for position 'pos'
+    void notifyMouseMoved(const QPoint& pos);
+
     void startDynamicAction(DynamicAction dynAction);
     void stopDynamicAction();
 
@@ -74,6 +86,8 @@ private:
     AbstractRubberBand* m_rubberBand = nullptr;
     double m_instantZoomFactor = 5.;
     Handle_Graphic3d_Camera m_cameraBackup;
+    QTimer* m_timerMouseMoved = nullptr;
+    QPoint m_posMouseMoved;
 };
 
 } // namespace Mayo
@@ -9,18 +9,30 @@
 #include "../base/application.h"
 #include "../base/application_item_selection_model.h"
 #include "../base/document.h"
+#include "../base/tkernel_utils.h"
 #include "gui_document.h"
 
+#include <Graphic3d_Texture2Dmanual.hxx>
+#include <Image_AlienPixMap.hxx>
+#include <QtCore/QFile>
 #include <unordered_set>
 
 namespace Mayo {
 
+namespace Internal {
+
+// Defined in gui_create_gfx_driver.cpp
+Handle_Graphic3d_GraphicDriver createGfxDriver();
+
+} // namespace Internal
+
 GuiApplication::GuiApplication(const ApplicationPtr& app)
     : QObject(app.get()),
       m_app(app),
       m_selectionModel(new ApplicationItemSelectionModel(this)),
       m_gfxObjectDriverTable(new GraphicsObjectDriverTable),
-      m_gfxTreeNodeMappingDriverTable(new GraphicsTreeNodeMappingDriverTable)
+      m_gfxTreeNodeMappingDriverTable(new GraphicsTreeNodeMappingDriverTable),
+      m_renderStats(new GuiRenderStats)
 {
     QObject::connect(
                 app.get(), &Application::documentAdded,
@@ -62,6 +74,38 @@ GraphicsTreeNodeMappingDriverTable* GuiApplication::graphicsTreeNodeMappingDrive
     return m_gfxTreeNodeMappingDriverTable.get();
 }
 
+const Handle_Graphic3d_GraphicDriver& GuiApplication::graphicDriver() const
+{
+    if (m_gfxDriver.IsNull())
+        m_gfxDriver = Internal::createGfxDriver();
+
+    return m_gfxDriver;
+}
+
+const Handle_Graphic3d_TextureMap& GuiApplication::clipPlaneCappingTexture() const
+{
+    if (!m_textureClipPlaneCapping.IsNull())
+        return m_textureClipPlaneCapping;
+
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 4, 0)
+    QFile file(":/images/graphics/opencascade_hatch_1.png");
+    if (file.open(QIODevice::ReadOnly)) {
+        const QByteArray fileContents = file.readAll();
+        const QByteArray filenameUtf8 = file.fileName().toUtf8();
+        auto fileContentsData = reinterpret_cast<const Standard_Byte*>(fileContents.constData());
+        Handle_Image_AlienPixMap imageCapping = new Image_AlienPixMap;
+        imageCapping->Load(fileContentsData, fileContents.size(), filenameUtf8.constData());
+        m_textureClipPlaneCapping = new Graphic3d_Texture2Dmanual(imageCapping);
+        m_textureClipPlaneCapping->EnableModulate();
+        m_textureClipPlaneCapping->EnableRepeat();
+        m_textureClipPlaneCapping->GetParams()->SetScale(Graphic3d_Vec2(0.05f, -0.05f));
+    }
+#else
+    // TODO Copy the image resource to a temporary file and call Image_AlienPixMap::Load(tempFilePath)
+#endif
+    return m_textureClipPlaneCapping;
+}
+
 void GuiApplication::onDocumentAdded(const DocumentPtr& doc)
 {
     m_vecGuiDocument.push_back(new GuiDocument(doc, this));
@@ -12,7 +12,10 @@
 #include "../graphics/graphics_object_driver_table.h"
 #include "../graphics/graphics_tree_node_mapping_driver_table.h"
 #include "gui_document.h"
+#include "gui_render_stats.h"
 
+#include <Graphic3d_GraphicDriver.hxx>
+#include <Graphic3d_TextureMap.hxx>
 #include <QtCore/QObject>
 #include <memory>
 
@@ -37,6 +40,18 @@ public:
     GraphicsObjectDriverTable* graphicsObjectDriverTable() const;
     GraphicsTreeNodeMappingDriverTable* graphicsTreeNodeMappingDriverTable() const;
 
+    // Rendering statistics collected over all GuiDocument objects
+    GuiRenderStats* renderStats() const { return m_renderStats.get(); }
+
+    // Graphic driver shared by the graphics scenes of all GuiDocument objects
+    // This way a single OpenGL context is used application-wide, so shader programs, fonts and
+    // textures are created once and not for each document
+    const Handle_Graphic3d_GraphicDriver& graphicDriver() const;
+
+    // Hatch texture applied to capping of clip planes, shared by all GuiDocument objects
+    // Null if not supported by OpenCascade version
+    const Handle_Graphic3d_TextureMap& clipPlaneCappingTexture() const;
+
 signals:
     void guiDocumentAdded(Mayo::GuiDocument* guiDoc);
     void guiDocumentErased(Mayo::GuiDocument* guiDoc);
@@ -57,7 +72,10 @@ private:
     ApplicationItemSelectionModel* m_selectionModel = nullptr;
     std::unique_ptr<GraphicsObjectDriverTable> m_gfxObjectDriverTable;
     std::unique_ptr<GraphicsTreeNodeMappingDriverTable> m_gfxTreeNodeMappingDriverTable;
+    std::unique_ptr<GuiRenderStats> m_renderStats;
     QMetaObject::Connection m_connApplicationItemSelectionChanged;
+    mutable Handle_Graphic3d_GraphicDriver m_gfxDriver;
+    mutable Handle_Graphic3d_TextureMap m_textureClipPlaneCapping;
 };
 
 } // namespace Mayo
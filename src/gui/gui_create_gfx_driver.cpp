@@ -10,10 +10,26 @@
 // <X.h> #defines constants like "None" which causes name clash with GuiDocument::ViewTrihedronMode::None
 // --
 
+#include "../base/tkernel_utils.h"
+#include "gui_render_stats.h"
+
 #include <Aspect_DisplayConnection.hxx>
+#include <OpenGl_Context.hxx>
 #include <OpenGl_GraphicDriver.hxx>
+#include <OpenGl_View.hxx>
+#include <OpenGl_Window.hxx>
 #include <QtCore/QtGlobal>
 
+#if defined(Q_OS_WIN)
+#  include <windows.h>
+#  include <WNT_WClass.hxx>
+#  include <WNT_Window.hxx>
+#elif defined(Q_OS_MAC) && !defined(MACOSX_USE_GLX)
+#  include <Cocoa_Window.hxx>
+#else
+#  include <Xw_Window.hxx>
+#endif
+
 namespace Mayo {
 namespace Internal {
 
@@ -27,5 +43,63 @@ Handle_Graphic3d_GraphicDriver createGfxDriver()
     return gfxDriver;
 }
 
+// Creates a "virtual" native window, never shown on screen
+// A V3d_View bound to such window can be rendered into offscreen framebuffers with V3d_View::ToPixMap()
+Handle_Aspect_Window createOffscreenWindow(
+        const Handle_Graphic3d_GraphicDriver& gfxDriver, int width, int height)
+{
+    Handle_Aspect_Window wnd;
+#if defined(Q_OS_WIN)
+    Q_UNUSED(gfxDriver);
+    static Handle_WNT_WClass wndClass;
+    if (wndClass.IsNull()) {
+        wndClass = new WNT_WClass(
+                    "Mayo_OffscreenWindowClass",
+                    reinterpret_cast<Standard_Address>(DefWindowProcW),
+                    CS_OWNDC);
+    }
+
+    wnd = new WNT_Window("Mayo", wndClass, WS_POPUP, 0, 0, width, height);
+#elif defined(Q_OS_MAC) && !defined(MACOSX_USE_GLX)
+    Q_UNUSED(gfxDriver);
+    wnd = new Cocoa_Window("Mayo", 0, 0, width, height);
+#else
+    wnd = new Xw_Window(gfxDriver->GetDisplayConnection(), "Mayo", 0, 0, width, height);
+#endif
+    wnd->SetVirtual(true);
+    return wnd;
+}
+
+// Reads counters of the last frame rendered in 'view'
+// Frame stats are held by the OpenGL context of the view window, not the shared context of the driver
+bool readFrameCounters(const Handle_V3d_View& view, GuiRenderStats::FrameCounters* counters)
+{
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 4, 0)
+    auto glView = Handle_OpenGl_View::DownCast(view ? view->View() : Handle_Graphic3d_CView());
+    const Handle_OpenGl_Window glWindow = glView ? glView->GlWindow() : Handle_OpenGl_Window();
+    const Handle_OpenGl_Context glContext = glWindow ? glWindow->GetGlContext() : Handle_OpenGl_Context();
+    if (!glContext || !glContext->FrameStats())
+        return false;
+
+    const Graphic3d_FrameStatsData& frameData = glContext->FrameStats()->LastDataFrame();
+    auto fnCounter = [&](Graphic3d_FrameStatsCounter counter) {
+        return int64_t(frameData.CounterValue(counter));
+    };
+    counters->layerCount = fnCounter(Graphic3d_FrameStatsCounter_NbLayersNotCulled);
+    counters->structureCount = fnCounter(Graphic3d_FrameStatsCounter_NbStructsNotCulled);
+    counters->elementCount = fnCounter(Graphic3d_FrameStatsCounter_NbElemsNotCulled);
+    counters->triangleCount = fnCounter(Graphic3d_FrameStatsCounter_NbTrianglesNotCulled);
+    counters->pointCount = fnCounter(Graphic3d_FrameStatsCounter_NbPointsNotCulled);
+    counters->gpuMemoryGeometry = fnCounter(Graphic3d_FrameStatsCounter_EstimatedBytesGeom);
+    counters->gpuMemoryTextures = fnCounter(Graphic3d_FrameStatsCounter_EstimatedBytesTextures);
+    counters->gpuMemoryFrameBuffers = fnCounter(Graphic3d_FrameStatsCounter_EstimatedBytesFbos);
+    return true;
+#else
+    Q_UNUSED(view);
+    Q_UNUSED(counters);
+    return false;
+#endif
+}
+
 } // namespace Internal
 } // namespace Mayo
@@ -9,33 +9,42 @@
 #include "../app/theme.h" // TODO Remove this dependency
 #include "../base/application_item.h"
 #include "../base/bnd_utils.h"
+#include "../base/brep_utils.h"
 #include "../base/caf_utils.h"
 #include "../base/cpp_utils.h"
 #include "../base/document.h"
 #include "../base/tkernel_utils.h"
+#include "../base/tracing.h"
 #include "../gui/gui_application.h"
 #include "../gui/qtgui_utils.h"
+#include "../graphics/graphics_hlr_presenter.h"
 #include "../graphics/graphics_object_driver_table.h"
 #include "../graphics/graphics_utils.h"
 #include "../graphics/v3d_view_camera_animation.h"
 
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QtDebug>
 #if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 4, 0)
 #  include <AIS_ViewCube.hxx>
 #endif
 #include <AIS_ConnectedInteractive.hxx>
 #include <AIS_Trihedron.hxx>
+#include <BRep_Tool.hxx>
 #include <Geom_Axis2Placement.hxx>
 #include <Graphic3d_GraphicDriver.hxx>
+#include <Graphic3d_Vec3.hxx>
+#include <Prs3d_Drawer.hxx>
+#include <SelectMgr_Selection.hxx>
+#include <SelectMgr_SensitiveEntity.hxx>
+#include <TDataXtd_Triangulation.hxx>
+#include <TopoDS.hxx>
 #include <V3d_TypeOfOrientation.hxx>
+#include <unordered_set>
 
 namespace Mayo {
 
 namespace Internal {
 
-// Defined in gui_create_gfx_driver.cpp
-Handle_Graphic3d_GraphicDriver createGfxDriver();
-
 static Handle_AIS_Trihedron createOriginTrihedron()
 {
     Handle_Geom_Axis2Placement axis = new Geom_Axis2Placement(gp::XOY());
@@ -60,16 +69,73 @@ static Handle_AIS_Trihedron createOriginTrihedron()
     return aisTrihedron;
 }
 
+// Shaded presentations hold vertex positions and normals, plus triangle indices
+static constexpr int64_t PresentationBytesPerNode = 2 * sizeof(Graphic3d_Vec3);
+static constexpr int64_t PresentationBytesPerTriangle = 3 * sizeof(int);
+// Index of a sensitive sub-element(eg triangle) and its share of the BVH nodes
+static constexpr int64_t SelectionBytesPerSubElement = 32;
+
+// Estimated bytes of the primitive arrays built for the shaded presentation of 'productLabel'
+static int64_t presentationArraysBytes(const TDF_Label& productLabel)
+{
+    int64_t nodeCount = 0;
+    int64_t triangleCount = 0;
+    auto fnAddTriangulation = [&](const Handle_Poly_Triangulation& polyTri) {
+        if (!polyTri.IsNull()) {
+            nodeCount += polyTri->NbNodes();
+            triangleCount += polyTri->NbTriangles();
+        }
+    };
+    if (XCaf::isShape(productLabel)) {
+        BRepUtils::forEachSubFace(XCaf::shape(productLabel), [&](const TopoDS_Face& face) {
+            TopLoc_Location loc;
+            fnAddTriangulation(BRep_Tool::Triangulation(face, loc));
+        });
+    }
+    else {
+        auto attrTriangulation = CafUtils::findAttribute<TDataXtd_Triangulation>(productLabel);
+        if (!attrTriangulation.IsNull())
+            fnAddTriangulation(attrTriangulation->Get());
+    }
+
+    return nodeCount * PresentationBytesPerNode + triangleCount * PresentationBytesPerTriangle;
+}
+
+// Estimated bytes of the sensitive entities computed for the selection modes of 'object'
+static int64_t selectionBytes(const GraphicsObjectPtr& object)
+{
+    int64_t bytes = 0;
+    auto fnAddSensitive = [&](const Handle_SelectMgr_SensitiveEntity& entity) {
+        const Handle_Select3D_SensitiveEntity& sensitive = entity->BaseSensitive();
+        bytes += entity->DynamicType()->Size();
+        if (!sensitive.IsNull())
+            bytes += sensitive->DynamicType()->Size() + sensitive->NbSubElements() * SelectionBytesPerSubElement;
+    };
+    for (SelectMgr_SequenceOfSelection::Iterator it(object->Selections()); it.More(); it.Next()) {
+        const Handle_SelectMgr_Selection& selection = it.Value();
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 4, 0)
+        for (const Handle_SelectMgr_SensitiveEntity& entity : selection->Entities())
+            fnAddSensitive(entity);
+#else
+        for (selection->Init(); selection->More(); selection->Next())
+            fnAddSensitive(selection->Sensitive());
+#endif
+    }
+
+    return bytes;
+}
+
 } // namespace Internal
 
 GuiDocument::GuiDocument(const DocumentPtr& doc, GuiApplication* guiApp)
     : QObject(guiApp),
       m_guiApp(guiApp),
       m_document(doc),
-      m_gfxScene(this),
+      m_gfxScene(guiApp->graphicDriver(), this),
       m_v3dView(m_gfxScene.createV3dView()),
       m_aisOriginTrihedron(Internal::createOriginTrihedron()),
-      m_cameraAnimation(new V3dViewCameraAnimation(m_v3dView, this))
+      m_cameraAnimation(new V3dViewCameraAnimation(m_v3dView, this)),
+      m_hlrPresenter(new GraphicsHlrPresenter(&m_gfxScene, m_v3dView, this))
 {
     Expects(!doc.IsNull());
 
@@ -158,7 +224,7 @@ void GuiDocument::toggleItemSelected(const ApplicationItem& appItem)
         traverseTree(docTreeNode.id(), doc->modelTree(), [=](TreeNodeId id) {
             GraphicsObjectPtr gfxObject = CppUtils::findValue(id, gfxEntity->mapTreeNodeGfxObject);
             if (gfxObject)
-                m_gfxScene.toggleOwnerSelection(gfxObject->GlobalSelOwner());
+                m_gfxScene.toggleObjectSelection(gfxObject);
         });
     }
 }
@@ -190,6 +256,65 @@ void GuiDocument::setActiveDisplayMode(const GraphicsObjectDriverPtr& driver, in
                 driver->applyDisplayMode(object, mode);
         });
     }
+
+    if (driver->IsKind(STANDARD_TYPE(GraphicsShapeObjectDriver)))
+        m_hlrPresenter->setEnabled(mode == GraphicsShapeObjectDriver::DisplayMode_HiddenLineRemoval);
+}
+
+void GuiDocument::setHighlightedNodes(Span<const TreeNodeId> spanNodeId)
+{
+    if (spanNodeId.empty() && m_vecHighlightedGfxObject.empty())
+        return;
+
+    for (const GraphicsObjectPtr& gfxObject : m_vecHighlightedGfxObject)
+        m_gfxScene.unhighlightObject(gfxObject);
+
+    m_vecHighlightedGfxObject.clear();
+    if (!m_highlightedNodesStyle) {
+        m_highlightedNodesStyle = new Prs3d_Drawer;
+        m_highlightedNodesStyle->SetMethod(Aspect_TOHM_COLOR);
+        m_highlightedNodesStyle->SetColor(Quantity_NOC_RED);
+    }
+
+    for (TreeNodeId nodeId : spanNodeId) {
+        this->foreachGraphicsObject(nodeId, [=](GraphicsObjectPtr gfxObject) {
+            m_gfxScene.highlightObject(gfxObject, m_highlightedNodesStyle);
+            m_vecHighlightedGfxObject.push_back(gfxObject);
+        });
+    }
+
+    m_gfxScene.redraw();
+}
+
+GuiDocument::GraphicsMemoryStats GuiDocument::graphicsMemoryStats() const
+{
+    GraphicsMemoryStats stats;
+    const Tree<TDF_Label>& modelTree = m_document->modelTree();
+    std::unordered_set<GraphicsObjectPtr> setGfxProduct;
+    std::unordered_set<TDF_Label> setProductLabel;
+    for (const GraphicsEntity& gfxEntity : m_vecGraphicsEntity) {
+        for (const auto& [gfxObject, nodeId] : gfxEntity.mapGfxObjectTreeNode) {
+            ++stats.objectCount;
+            stats.presentationBytes += gfxObject->DynamicType()->Size();
+            stats.selectionBytes += Internal::selectionBytes(gfxObject);
+
+            // Instances are connected to the graphics object of their product, which holds the
+            // primitive arrays. So these arrays are accounted once per product
+            auto gfxInstance = Handle_AIS_ConnectedInteractive::DownCast(gfxObject);
+            if (!gfxInstance.IsNull() && setGfxProduct.insert(gfxInstance->ConnectedTo()).second) {
+                stats.presentationBytes += gfxInstance->ConnectedTo()->DynamicType()->Size();
+                stats.selectionBytes += Internal::selectionBytes(gfxInstance->ConnectedTo());
+            }
+
+            const TDF_Label& nodeLabel = modelTree.nodeData(nodeId);
+            const TDF_Label productLabel =
+                    XCaf::isShapeReference(nodeLabel) ? XCaf::shapeReferred(nodeLabel) : nodeLabel;
+            if (setProductLabel.insert(productLabel).second)
+                stats.presentationBytes += Internal::presentationArraysBytes(productLabel);
+        }
+    }
+
+    return stats;
 }
 
 Qt::CheckState GuiDocument::nodeVisibleState(TreeNodeId nodeId) const
@@ -227,6 +352,7 @@ void GuiDocument::setNodeVisible(TreeNodeId nodeId, bool on)
     traverseTree(nodeId, docModelTree , [=](TreeNodeId id) {
         fnSetNodeVisibleState(id, nodeVisibleState);
     });
+    m_hlrPresenter->invalidate();
     this->foreachGraphicsObject(nodeId, [=](GraphicsObjectPtr gfxObject){
         GraphicsUtils::AisObject_setVisible(gfxObject, on);
     });
@@ -288,6 +414,7 @@ void GuiDocument::setNodeVisible(TreeNodeId nodeId, bool on)
 void GuiDocument::setExplodingFactor(double t)
 {
     m_explodingFactor = t;
+    m_hlrPresenter->invalidate();
     for (const GraphicsEntity& entity : m_vecGraphicsEntity) {
         const gp_Pnt entityCenter = BndBoxCoords::get(entity.bndBox).center();
         for (const GraphicsEntity::Object& object : entity.vecObject) {
@@ -467,6 +594,7 @@ void GuiDocument::onDocumentEntityAdded(TreeNodeId entityTreeNodeId)
 
 void GuiDocument::onDocumentEntityAboutToBeDestroyed(TreeNodeId entityTreeNodeId)
 {
+    this->setHighlightedNodes({});
     this->unmapEntity(entityTreeNodeId);
     // Recompute bounding box
     m_gfxBoundingBox.SetVoid();
@@ -517,6 +645,7 @@ void GuiDocument::onGraphicsSelectionChanged()
 
 void GuiDocument::mapEntity(TreeNodeId entityTreeNodeId)
 {
+    MAYO_TRACE_SCOPE("GuiDocument::mapEntity", "graphics");
     const Tree<TDF_Label>& docModelTree = m_document->modelTree();
     GraphicsEntity gfxEntity;
     gfxEntity.treeNodeId = entityTreeNodeId;
@@ -538,7 +667,6 @@ void GuiDocument::mapEntity(TreeNodeId entityTreeNodeId)
                 Handle_AIS_ConnectedInteractive gfxInstance = new AIS_ConnectedInteractive;
                 gfxInstance->Connect(gfxProduct, XCaf::shapeAbsoluteLocation(docModelTree, id));
                 gfxInstance->SetDisplayMode(gfxProduct->DisplayMode());
-                gfxInstance->Attributes()->SetFaceBoundaryDraw(gfxProduct->Attributes()->FaceBoundaryDraw());
                 gfxInstance->SetOwner(gfxProduct->GetOwner());
                 gfxEntity.vecObject.push_back(GraphicsObjectPtr(gfxInstance));
                 if (XCaf::isShapeReference(docModelTree.nodeData(docModelTree.nodeParent(id))))
@@ -554,11 +682,18 @@ void GuiDocument::mapEntity(TreeNodeId entityTreeNodeId)
         }
     });
 
+    Tracing::recordCounter("GuiDocument graphics objects", double(gfxEntity.vecObject.size()));
     for (const GraphicsEntity::Object& object : gfxEntity.vecObject) {
-        m_gfxScene.addObject(object.ptr);
+        MAYO_TRACE_SCOPE("GuiDocument::mapEntity addObject+presentation", "graphics");
+        QElapsedTimer chrono;
+        chrono.start();
+        m_gfxScene.addObject(object.ptr, GraphicsScene::AddObjectDeferSelection);
         auto driver = GraphicsObjectDriver::get(object.ptr);
-        if (driver)
+        if (driver) {
             driver->applyDisplayMode(object.ptr, this->activeDisplayMode(driver));
+            const double buildTimeMs = chrono.nsecsElapsed() / 1000000.;
+            m_guiApp->renderStats()->recordPresentationBuild(driver->DynamicType()->Name(), buildTimeMs);
+        }
     }
 
     for (GraphicsEntity::Object& object : gfxEntity.vecObject) {
@@ -575,6 +710,7 @@ void GuiDocument::mapEntity(TreeNodeId entityTreeNodeId)
 
     GraphicsUtils::V3dView_fitAll(m_v3dView);
     m_vecGraphicsEntity.push_back(std::move(gfxEntity));
+    m_hlrPresenter->invalidate();
 }
 
 void GuiDocument::unmapEntity(TreeNodeId entityTreeNodeId)
@@ -584,6 +720,7 @@ void GuiDocument::unmapEntity(TreeNodeId entityTreeNodeId)
         if (!ptrItem)
             return;
 
+        m_hlrPresenter->invalidate();
         for (const GraphicsEntity::Object& object : ptrItem->vecObject)
             m_gfxScene.eraseObject(object.ptr);
 
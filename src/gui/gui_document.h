@@ -7,6 +7,7 @@
 #pragma once
 
 #include "../base/document.h"
+#include "../base/span.h"
 #include "../base/tkernel_utils.h"
 #include "../graphics/graphics_object_driver.h"
 #include "../graphics/graphics_scene.h"
@@ -22,6 +23,7 @@
 namespace Mayo {
 
 class ApplicationItem;
+class GraphicsHlrPresenter;
 class GuiApplication;
 class V3dViewCameraAnimation;
 
@@ -60,6 +62,19 @@ public:
     Qt::CheckState nodeVisibleState(TreeNodeId nodeId) const;
     void setNodeVisible(TreeNodeId nodeId, bool on);
 
+    // -- Highlighting of tree nodes, independent of the selection(eg clash detection results)
+    // Replaces the currently highlighted nodes, empty 'spanNodeId' clears highlighting
+    void setHighlightedNodes(Span<const TreeNodeId> spanNodeId);
+
+    // -- Estimated memory held by graphics objects(CPU side, GPU memory is reported by GuiRenderStats)
+    struct GraphicsMemoryStats {
+        int64_t presentationBytes = 0; // Graphics objects and their primitive arrays
+        int64_t selectionBytes = 0; // Sensitive entities and their BVH
+        int64_t objectCount = 0;
+        int64_t totalBytes() const { return presentationBytes + selectionBytes; }
+    };
+    GraphicsMemoryStats graphicsMemoryStats() const;
+
     // -- Exploding
     double explodingFactor() const { return m_explodingFactor; }
     void setExplodingFactor(double t); // Must be in [0,1]
@@ -131,6 +146,7 @@ private:
     Handle_AIS_InteractiveObject m_aisOriginTrihedron;
 
     V3dViewCameraAnimation* m_cameraAnimation;
+    GraphicsHlrPresenter* m_hlrPresenter;
     ViewTrihedronMode m_viewTrihedronMode = ViewTrihedronMode::None;
     Qt::Corner m_viewTrihedronCorner = Qt::BottomLeftCorner;
     Handle_AIS_InteractiveObject m_aisViewCube;
@@ -141,6 +157,9 @@ private:
     std::unordered_map<GraphicsObjectDriverPtr, int> m_mapGfxDriverDisplayMode;
     std::unordered_map<TreeNodeId, Qt::CheckState> m_mapTreeNodeCheckState;
 
+    std::vector<GraphicsObjectPtr> m_vecHighlightedGfxObject;
+    Handle_Prs3d_Drawer m_highlightedNodesStyle;
+
     double m_explodingFactor = 0.;
 };
 
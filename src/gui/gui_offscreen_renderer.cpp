@@ -0,0 +1,143 @@
+/****************************************************************************
+** Copyright (c) 2021, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#include "gui_offscreen_renderer.h"
+
+#include "../graphics/graphics_utils.h"
+#include "gui_application.h"
+#include "gui_document.h"
+#include "qtgui_utils.h"
+
+#include <Aspect_GradientBackground.hxx>
+#include <Graphic3d_GraphicDriver.hxx>
+#include <QtCore/QElapsedTimer>
+#include <gsl/util>
+
+namespace Mayo {
+
+namespace Internal {
+
+// Defined in gui_create_gfx_driver.cpp
+Handle_Aspect_Window createOffscreenWindow(
+        const Handle_Graphic3d_GraphicDriver& gfxDriver, int width, int height);
+
+} // namespace Internal
+
+GuiOffscreenRenderer::~GuiOffscreenRenderer()
+{
+    this->releaseView();
+}
+
+bool GuiOffscreenRenderer::render(GuiDocument* guiDoc, const Parameters& params, Image_PixMap* img)
+{
+    if (!guiDoc || !img || params.size.isEmpty())
+        return false;
+
+    GraphicsScene* gfxScene = guiDoc->graphicsScene();
+    if (guiDoc != m_viewGuiDoc || params.size != m_viewSize) {
+        this->releaseView();
+        m_view = gfxScene->createV3dView();
+        const Handle_Aspect_Window wnd = Internal::createOffscreenWindow(
+                    gfxScene->v3dViewer()->Driver(), params.size.width(), params.size.height());
+        m_view->SetWindow(wnd);
+        m_viewer = gfxScene->v3dViewer();
+        m_viewGuiDoc = guiDoc;
+        m_viewSize = params.size;
+    }
+
+    const GuiDocument::ViewTrihedronMode onEntryTrihedronMode = guiDoc->viewTrihedronMode();
+    const bool onEntryOriginTrihedronVisible = guiDoc->isOriginTrihedronVisible();
+    auto _ = gsl::finally([=]{
+        guiDoc->setViewTrihedronMode(onEntryTrihedronMode);
+        if (guiDoc->isOriginTrihedronVisible() != onEntryOriginTrihedronVisible)
+            guiDoc->toggleOriginTrihedronVisibility();
+    });
+
+    gfxScene->clearSelection();
+    guiDoc->setViewTrihedronMode(GuiDocument::ViewTrihedronMode::None);
+    if (guiDoc->isOriginTrihedronVisible())
+        guiDoc->toggleOriginTrihedronVisibility();
+
+    const Handle_V3d_View& view = m_view;
+    view->ChangeRenderingParams().IsAntialiasingEnabled = params.msaaSampleCount > 0;
+    view->ChangeRenderingParams().NbMsaaSamples = params.msaaSampleCount;
+    view->ChangeRenderingParams().CollectedStats =
+            params.collectStats ? Graphic3d_RenderingParams::PerfCounters_Extended
+                                : Graphic3d_RenderingParams::PerfCounters_NONE;
+    view->ChangeRenderingParams().ToShowStats = false;
+    if (params.backgroundColor.isValid()) {
+        view->SetBgGradientStyle(Aspect_GFM_NONE, false);
+        view->SetBackgroundColor(QtGuiUtils::toPreferredColorSpace(params.backgroundColor));
+    }
+    else {
+        const Aspect_GradientBackground bkg = guiDoc->v3dView()->GradientBackground();
+        Quantity_Color bkgColorStart;
+        Quantity_Color bkgColorEnd;
+        bkg.Colors(bkgColorStart, bkgColorEnd);
+        view->SetBgGradientColors(bkgColorStart, bkgColorEnd, bkg.BgGradientFillMethod());
+    }
+
+    view->SetProj(params.viewOrientation);
+    GraphicsUtils::V3dView_fitAll(view);
+
+    img->SetTopDown(true);
+    V3d_ImageDumpOptions dumpOptions;
+    dumpOptions.BufferType = Graphic3d_BT_RGB;
+    dumpOptions.Width = params.size.width();
+    dumpOptions.Height = params.size.height();
+    QElapsedTimer chrono;
+    chrono.start();
+    const bool ok = view->ToPixMap(*img, dumpOptions);
+    if (ok && params.collectStats)
+        guiDoc->guiApplication()->renderStats()->recordFrame(view, chrono.nsecsElapsed() / 1000000.);
+
+    return ok;
+}
+
+QImage GuiOffscreenRenderer::renderImage(GuiDocument* guiDoc, const Parameters& params)
+{
+    Image_PixMap img;
+    if (!this->render(guiDoc, params, &img))
+        return QImage();
+
+    return GuiOffscreenRenderer::toQImage(img);
+}
+
+void GuiOffscreenRenderer::releaseView()
+{
+    if (!m_view.IsNull()) {
+        m_viewer->SetViewOff(m_view);
+        m_view->Remove();
+        m_view.Nullify();
+        m_viewer.Nullify();
+    }
+
+    m_viewGuiDoc = nullptr;
+    m_viewSize = QSize();
+}
+
+QImage GuiOffscreenRenderer::toQImage(const Image_PixMap& img)
+{
+    QImage::Format format = QImage::Format_Invalid;
+    switch (img.Format()) {
+    case Image_Format_RGB: format = QImage::Format_RGB888; break;
+    case Image_Format_RGBA: format = QImage::Format_RGBA8888; break;
+    case Image_Format_Gray: format = QImage::Format_Grayscale8; break;
+    default: break;
+    }
+
+    if (format == QImage::Format_Invalid || img.IsEmpty())
+        return QImage();
+
+    const QImage qtImg(img.Data(),
+                       int(img.Width()),
+                       int(img.Height()),
+                       int(img.SizeRowBytes()),
+                       format);
+    return qtImg.copy(); // Detach from 'img' data
+}
+
+} // namespace Mayo
@@ -0,0 +1,65 @@
+/****************************************************************************
+** Copyright (c) 2021, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#pragma once
+
+#include <Image_PixMap.hxx>
+#include <V3d_TypeOfOrientation.hxx>
+#include <V3d_View.hxx>
+#include <QtCore/QSize>
+#include <QtGui/QColor>
+#include <QtGui/QImage>
+
+namespace Mayo {
+
+class GuiDocument;
+
+// Renders the 3D scene of GuiDocument objects into images, without the need of a visible window
+// Rendering is done by a V3d_View bound to a "virtual" window, the image is then drawn into an
+// offscreen framebuffer(FBO). All graphics scenes share the same graphic driver so a batch of
+// documents is rendered with a single OpenGL context
+// The offscreen V3d_View is kept and reused by subsequent render operations of the same GuiDocument
+class GuiOffscreenRenderer {
+public:
+    GuiOffscreenRenderer() = default;
+    ~GuiOffscreenRenderer();
+
+    struct Parameters {
+        QSize size = { 1024, 768 };
+        V3d_TypeOfOrientation viewOrientation = V3d_XposYnegZpos;
+        int msaaSampleCount = 4;
+        // Invalid color means same background as the main 3D view of the GuiDocument
+        QColor backgroundColor;
+        // Collect rendering performance counters(not drawn in the image), see GuiRenderStats
+        bool collectStats = false;
+    };
+
+    // Renders 'guiDoc' into 'img', returns 'true' on success
+    // Trihedrons and current selection of 'guiDoc' are not visible in the rendered image
+    bool render(GuiDocument* guiDoc, const Parameters& params, Image_PixMap* img);
+
+    // Convenience function, returns null QImage on failure
+    QImage renderImage(GuiDocument* guiDoc, const Parameters& params);
+
+    // Releases the offscreen V3d_View currently kept(the V3d_Viewer owning it is kept alive until then)
+    void releaseView();
+    GuiDocument* viewGuiDocument() const { return m_viewGuiDoc; }
+
+    // Returns deep copy of 'img' as a QImage object
+    static QImage toQImage(const Image_PixMap& img);
+
+    // Disable copy
+    GuiOffscreenRenderer(const GuiOffscreenRenderer&) = delete;
+    GuiOffscreenRenderer& operator=(const GuiOffscreenRenderer&) = delete;
+
+private:
+    GuiDocument* m_viewGuiDoc = nullptr;
+    QSize m_viewSize;
+    Handle_V3d_Viewer m_viewer;
+    Handle_V3d_View m_view;
+};
+
+} // namespace Mayo
@@ -0,0 +1,124 @@
+/****************************************************************************
+** Copyright (c) 2021, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#include "gui_render_stats.h"
+
+#include <QtCore/QFile>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <algorithm>
+
+namespace Mayo {
+
+namespace Internal {
+
+// Defined in gui_create_gfx_driver.cpp
+bool readFrameCounters(const Handle_V3d_View& view, GuiRenderStats::FrameCounters* counters);
+
+static QJsonObject toJson(const GuiRenderStats::Duration& duration)
+{
+    QJsonObject jsonDuration;
+    jsonDuration.insert("count", double(duration.count));
+    jsonDuration.insert("totalMs", duration.totalMs);
+    jsonDuration.insert("minMs", duration.minMs);
+    jsonDuration.insert("maxMs", duration.maxMs);
+    jsonDuration.insert("averageMs", duration.averageMs());
+    return jsonDuration;
+}
+
+static QJsonObject toJson(const GuiRenderStats::FrameCounters& counters)
+{
+    QJsonObject jsonCounters;
+    jsonCounters.insert("layers", double(counters.layerCount));
+    jsonCounters.insert("structures", double(counters.structureCount));
+    jsonCounters.insert("elements", double(counters.elementCount));
+    jsonCounters.insert("triangles", double(counters.triangleCount));
+    jsonCounters.insert("points", double(counters.pointCount));
+    jsonCounters.insert("gpuMemoryGeometry", double(counters.gpuMemoryGeometry));
+    jsonCounters.insert("gpuMemoryTextures", double(counters.gpuMemoryTextures));
+    jsonCounters.insert("gpuMemoryFrameBuffers", double(counters.gpuMemoryFrameBuffers));
+    return jsonCounters;
+}
+
+} // namespace Internal
+
+void GuiRenderStats::Duration::add(double ms)
+{
+    this->minMs = this->count > 0 ? std::min(this->minMs, ms) : ms;
+    this->maxMs = this->count > 0 ? std::max(this->maxMs, ms) : ms;
+    this->totalMs += ms;
+    ++this->count;
+}
+
+void GuiRenderStats::recordFrame(const Handle_V3d_View& view, double frameTimeMs)
+{
+    m_frameTime.add(frameTimeMs);
+    auto itBound = std::lower_bound(FrameTimeBucketBounds.cbegin(), FrameTimeBucketBounds.cend(), frameTimeMs);
+    ++m_frameTimeHistogram.at(itBound - FrameTimeBucketBounds.cbegin());
+
+    if (view.IsNull())
+        return;
+
+    FrameCounters counters;
+    if (Internal::readFrameCounters(view, &counters)) {
+        m_lastFrameCounters = counters;
+        auto fnPeak = [](int64_t& peak, int64_t value) { peak = std::max(peak, value); };
+        fnPeak(m_peakFrameCounters.layerCount, counters.layerCount);
+        fnPeak(m_peakFrameCounters.structureCount, counters.structureCount);
+        fnPeak(m_peakFrameCounters.elementCount, counters.elementCount);
+        fnPeak(m_peakFrameCounters.triangleCount, counters.triangleCount);
+        fnPeak(m_peakFrameCounters.pointCount, counters.pointCount);
+        fnPeak(m_peakFrameCounters.gpuMemoryGeometry, counters.gpuMemoryGeometry);
+        fnPeak(m_peakFrameCounters.gpuMemoryTextures, counters.gpuMemoryTextures);
+        fnPeak(m_peakFrameCounters.gpuMemoryFrameBuffers, counters.gpuMemoryFrameBuffers);
+    }
+}
+
+void GuiRenderStats::recordPresentationBuild(const std::string& driverName, double durationMs)
+{
+    m_mapDriverBuildTime[driverName].add(durationMs);
+}
+
+void GuiRenderStats::reset()
+{
+    *this = GuiRenderStats();
+}
+
+QJsonObject GuiRenderStats::toJson() const
+{
+    QJsonArray jsonHistogram;
+    for (unsigned i = 0; i < m_frameTimeHistogram.size(); ++i) {
+        QJsonObject jsonBucket;
+        if (i < FrameTimeBucketBounds.size())
+            jsonBucket.insert("upperBoundMs", FrameTimeBucketBounds.at(i));
+
+        jsonBucket.insert("count", double(m_frameTimeHistogram.at(i)));
+        jsonHistogram.append(jsonBucket);
+    }
+
+    QJsonObject jsonBuildTimes;
+    for (const auto& [driverName, duration] : m_mapDriverBuildTime)
+        jsonBuildTimes.insert(QString::fromStdString(driverName), Internal::toJson(duration));
+
+    QJsonObject jsonStats;
+    jsonStats.insert("frameTime", Internal::toJson(m_frameTime));
+    jsonStats.insert("frameTimeHistogram", jsonHistogram);
+    jsonStats.insert("lastFrame", Internal::toJson(m_lastFrameCounters));
+    jsonStats.insert("peakFrame", Internal::toJson(m_peakFrameCounters));
+    jsonStats.insert("presentationBuildTimes", jsonBuildTimes);
+    return jsonStats;
+}
+
+bool GuiRenderStats::writeJson(const QString& filepath) const
+{
+    QFile file(filepath);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+
+    return file.write(QJsonDocument(this->toJson()).toJson()) != -1;
+}
+
+} // namespace Mayo
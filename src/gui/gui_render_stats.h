@@ -0,0 +1,76 @@
+/****************************************************************************
+** Copyright (c) 2021, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#pragma once
+
+#include "../base/span.h"
+
+#include <V3d_View.hxx>
+#include <QtCore/QJsonObject>
+#include <array>
+#include <cstdint>
+#include <map>
+#include <string>
+
+namespace Mayo {
+
+// Collects 3D rendering statistics: frame times, elements drawn, GPU memory and build time of
+// graphics presentations per GraphicsObjectDriver
+// Statistics are gathered application-wide, ie over the 3D views of all GuiDocument objects
+// Element and memory counters are provided by OpenCascade frame statistics(requires OpenCascade >= 7.4)
+class GuiRenderStats {
+public:
+    struct Duration {
+        int64_t count = 0;
+        double totalMs = 0.;
+        double minMs = 0.;
+        double maxMs = 0.;
+        double averageMs() const { return count > 0 ? totalMs / count : 0.; }
+        void add(double ms);
+    };
+
+    struct FrameCounters {
+        int64_t layerCount = 0;
+        int64_t structureCount = 0;
+        int64_t elementCount = 0;
+        int64_t triangleCount = 0;
+        int64_t pointCount = 0;
+        int64_t gpuMemoryGeometry = 0; // Bytes
+        int64_t gpuMemoryTextures = 0; // Bytes
+        int64_t gpuMemoryFrameBuffers = 0; // Bytes
+        int64_t gpuMemory() const { return gpuMemoryGeometry + gpuMemoryTextures + gpuMemoryFrameBuffers; }
+    };
+
+    // Upper bounds(in milliseconds) of frame time histogram buckets, an additional bucket holds
+    // frames exceeding the last bound
+    static constexpr std::array<double, 7> FrameTimeBucketBounds = { 4, 8, 16, 33, 66, 133, 266 };
+
+    // Records a frame just rendered by 'view', that took 'frameTimeMs' milliseconds
+    void recordFrame(const Handle_V3d_View& view, double frameTimeMs);
+
+    // Records time spent to build graphics presentations with GraphicsObjectDriver 'driverName'
+    void recordPresentationBuild(const std::string& driverName, double durationMs);
+
+    void reset();
+
+    const Duration& frameTime() const { return m_frameTime; }
+    Span<const int64_t> frameTimeHistogram() const { return m_frameTimeHistogram; }
+    const FrameCounters& lastFrameCounters() const { return m_lastFrameCounters; }
+    const FrameCounters& peakFrameCounters() const { return m_peakFrameCounters; }
+    const std::map<std::string, Duration>& presentationBuildTimes() const { return m_mapDriverBuildTime; }
+
+    QJsonObject toJson() const;
+    bool writeJson(const QString& filepath) const;
+
+private:
+    Duration m_frameTime;
+    std::array<int64_t, FrameTimeBucketBounds.size() + 1> m_frameTimeHistogram = {};
+    FrameCounters m_lastFrameCounters;
+    FrameCounters m_peakFrameCounters;
+    std::map<std::string, Duration> m_mapDriverBuildTime;
+};
+
+} // namespace Mayo
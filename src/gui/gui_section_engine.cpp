@@ -0,0 +1,166 @@
+/****************************************************************************
+** Copyright (c) 2021, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#include "gui_section_engine.h"
+
+#include "../base/task_manager.h"
+#include "../graphics/graphics_object_driver.h"
+#include "../graphics/graphics_utils.h"
+#include "gui_document.h"
+
+#include <Bnd_Box.hxx>
+#include <BRep_Builder.hxx>
+#include <TopoDS_Compound.hxx>
+#include <cmath>
+
+namespace Mayo {
+
+struct GuiSectionEngine::Job {
+    TaskId taskId = 0;
+    gp_Pln plane;
+    TopoDS_Compound input;
+    PlaneSection result;
+    bool isCancelled = false;
+};
+
+GuiSectionEngine::Properties::Properties(QObject* parent)
+    : PropertyGroupSignals(parent)
+{
+    this->area.setUserReadOnly(true);
+    this->perimeter.setUserReadOnly(true);
+}
+
+GuiSectionEngine::GuiSectionEngine(GuiDocument* guiDoc, QObject* parent)
+    : QObject(parent),
+      m_guiDoc(guiDoc),
+      m_taskMgr(new TaskManager(this)),
+      m_properties(new Properties(this))
+{
+    // Signal TaskManager::ended is emitted from worker thread, so connection is queued
+    QObject::connect(m_taskMgr, &TaskManager::ended, this, &GuiSectionEngine::onTaskEnded);
+}
+
+GuiSectionEngine::~GuiSectionEngine()
+{
+    // Pending task(if any) is waited by TaskManager destructor, its result is simply discarded
+    QObject::disconnect(m_taskMgr, nullptr, this, nullptr);
+    if (m_aisCurves && m_guiDoc)
+        m_guiDoc->graphicsScene()->eraseObject(m_aisCurves);
+}
+
+void GuiSectionEngine::requestSection(const gp_Pln& plane)
+{
+    if (m_job) {
+        this->cancelJob();
+        m_ptrPendingPlane = std::make_unique<gp_Pln>(plane);
+    }
+    else {
+        this->startJob(plane);
+    }
+}
+
+void GuiSectionEngine::clear()
+{
+    if (m_job)
+        this->cancelJob();
+
+    m_ptrPendingPlane.reset();
+    this->showSection(PlaneSection(), gp_Pln());
+}
+
+void GuiSectionEngine::setCurvesColor(const Quantity_Color& color)
+{
+    m_curvesColor = color;
+    if (m_aisCurves && m_guiDoc) {
+        m_aisCurves->SetColor(color);
+        m_guiDoc->graphicsScene()->redraw();
+    }
+}
+
+void GuiSectionEngine::startJob(const gp_Pln& plane)
+{
+    if (!m_guiDoc)
+        return;
+
+    auto job = std::make_shared<Job>();
+    job->plane = plane;
+
+    // Snapshot of the shapes currently displayed, in world coordinates
+    BRep_Builder builder;
+    builder.MakeCompound(job->input);
+    m_guiDoc->graphicsScene()->foreachDisplayedObject([&](const GraphicsObjectPtr& object) {
+        const GraphicsObjectDriverPtr driver = GraphicsObjectDriver::get(object);
+        if (driver && driver->IsKind(STANDARD_TYPE(GraphicsShapeObjectDriver))) {
+            const TopoDS_Shape shape = GraphicsUtils::AisObject_shape(object);
+            if (!shape.IsNull())
+                builder.Add(job->input, shape);
+        }
+    });
+
+    m_job = job;
+    m_job->taskId = m_taskMgr->newTask([=](TaskProgress* progress) {
+        job->result = PlaneSection::compute(job->input, job->plane, progress);
+    });
+    m_taskMgr->run(m_job->taskId);
+}
+
+void GuiSectionEngine::cancelJob()
+{
+    m_job->isCancelled = true;
+    m_taskMgr->requestAbort(m_job->taskId);
+}
+
+void GuiSectionEngine::onTaskEnded(TaskId taskId)
+{
+    if (!m_job || m_job->taskId != taskId)
+        return;
+
+    const std::shared_ptr<Job> job = std::move(m_job);
+    if (m_ptrPendingPlane) {
+        // Result is outdated, process latest request
+        const gp_Pln plane = *m_ptrPendingPlane;
+        m_ptrPendingPlane.reset();
+        this->startJob(plane);
+    }
+    else if (!job->isCancelled) {
+        this->showSection(job->result, job->plane);
+    }
+}
+
+void GuiSectionEngine::showSection(const PlaneSection& section, const gp_Pln& plane)
+{
+    if (!m_guiDoc)
+        return;
+
+    GraphicsScene* gfxScene = m_guiDoc->graphicsScene();
+    if (m_aisCurves) {
+        gfxScene->eraseObject(m_aisCurves);
+        m_aisCurves.Nullify();
+    }
+
+    m_section = section;
+    m_properties->area.setQuantity(section.area * Quantity_SquaredMillimeter);
+    m_properties->perimeter.setQuantity(section.perimeter * Quantity_Millimeter);
+    if (!section.isEmpty()) {
+        // Curves lie on the section plane which is typically a clip plane, so they are slightly
+        // moved on the "visible" side of the plane to not get clipped
+        const Bnd_Box bndBox = m_guiDoc->graphicsBoundingBox();
+        const double offset = bndBox.IsVoid() ? 1e-3 : 1e-4 * std::sqrt(bndBox.SquareExtent());
+        gp_Trsf trsfOffset;
+        trsfOffset.SetTranslation(offset * gp_Vec(plane.Axis().Direction()));
+        m_aisCurves = new AIS_Shape(section.curves);
+        m_aisCurves->SetDisplayMode(AIS_WireFrame);
+        m_aisCurves->SetColor(m_curvesColor);
+        m_aisCurves->SetWidth(2.5);
+        m_aisCurves->SetLocalTransformation(trsfOffset);
+        gfxScene->addObject(m_aisCurves, GraphicsScene::AddObjectDisableSelection);
+    }
+
+    gfxScene->redraw();
+    emit this->sectionChanged();
+}
+
+} // namespace Mayo
@@ -0,0 +1,78 @@
+/****************************************************************************
+** Copyright (c) 2021, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#pragma once
+
+#include "../base/plane_section.h"
+#include "../base/property_builtins.h"
+#include "../base/task_common.h"
+
+#include <AIS_Shape.hxx>
+#include <Quantity_Color.hxx>
+#include <QtCore/QObject>
+#include <QtCore/QPointer>
+#include <memory>
+
+namespace Mayo {
+
+class GuiDocument;
+class TaskManager;
+
+// Computes exact cross-sections of the shapes displayed in a GuiDocument, typically at the position
+// of a clip plane
+// Computation runs on a worker thread. Requesting a new section while computing aborts the current
+// one, only the latest request is processed so the engine can be fed as the plane is moved
+// Resulting section curves are displayed in the 3D scene of the GuiDocument
+class GuiSectionEngine : public QObject {
+    Q_OBJECT
+public:
+    class Properties : public PropertyGroupSignals {
+        MAYO_DECLARE_TEXT_ID_FUNCTIONS(Mayo::GuiSectionEngine::Properties)
+    public:
+        Properties(QObject* parent = nullptr);
+        PropertyArea area{ this, textId("area") };
+        PropertyLength perimeter{ this, textId("perimeter") };
+    };
+
+    GuiSectionEngine(GuiDocument* guiDoc, QObject* parent = nullptr);
+    ~GuiSectionEngine();
+
+    void requestSection(const gp_Pln& plane);
+    // Cancels any pending computation and hides section curves
+    void clear();
+
+    bool isComputing() const { return m_job != nullptr; }
+
+    // Last computed section
+    const PlaneSection& section() const { return m_section; }
+    // Area and perimeter of the last computed section
+    Properties* properties() const { return m_properties; }
+
+    const Quantity_Color& curvesColor() const { return m_curvesColor; }
+    void setCurvesColor(const Quantity_Color& color);
+
+signals:
+    void sectionChanged();
+
+private:
+    struct Job;
+
+    void startJob(const gp_Pln& plane);
+    void cancelJob();
+    void onTaskEnded(TaskId taskId);
+    void showSection(const PlaneSection& section, const gp_Pln& plane);
+
+    QPointer<GuiDocument> m_guiDoc; // GuiDocument might be destroyed before the engine
+    TaskManager* m_taskMgr = nullptr;
+    Properties* m_properties = nullptr;
+    std::shared_ptr<Job> m_job;
+    std::unique_ptr<gp_Pln> m_ptrPendingPlane;
+    PlaneSection m_section;
+    Handle_AIS_Shape m_aisCurves;
+    Quantity_Color m_curvesColor = Quantity_NOC_BLACK;
+};
+
+} // namespace Mayo
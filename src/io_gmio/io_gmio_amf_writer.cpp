@@ -148,6 +148,13 @@ public:
         this->useZip64.setDescription(
                     textIdTr("Use the ZIP64 format extensions.\n"
                              "Only applicable if option `%1` is on").arg(this->createZipArchive.label()));
+
+        this->zlibCompressionLevel.setConstraintsEnabled(true);
+        this->zlibCompressionLevel.setRange(0, 9);
+        this->zlibCompressionLevel.setDescription(
+                    textIdTr("zlib compression level of the ZIP archive, from 1(best speed) to 9(best size). "
+                             "Zero selects the zlib default level.\n"
+                             "Only applicable if option `%1` is on").arg(this->createZipArchive.label()));
     }
 
     void restoreDefaults() override {
@@ -157,9 +164,11 @@ public:
         this->createZipArchive.setValue(params.createZipArchive);
         this->zipEntryFilename.setValue(QString::fromStdString(params.zipEntryFilename));
         this->useZip64.setValue(params.useZip64);
+        this->zlibCompressionLevel.setValue(params.zlibCompressionLevel);
 
         this->zipEntryFilename.setEnabled(this->createZipArchive);
         this->useZip64.setEnabled(this->createZipArchive);
+        this->zlibCompressionLevel.setEnabled(this->createZipArchive);
     }
 
     void onPropertyChanged(Property* prop) override
@@ -167,6 +176,7 @@ public:
         if (prop == &this->createZipArchive) {
             this->zipEntryFilename.setEnabled(this->createZipArchive);
             this->useZip64.setEnabled(this->createZipArchive);
+            this->zlibCompressionLevel.setEnabled(this->createZipArchive);
         }
 
         PropertyGroup::onPropertyChanged(prop);
@@ -177,6 +187,7 @@ public:
     PropertyBool createZipArchive{ this, textId("createZipArchive") };
     PropertyQString zipEntryFilename{ this, textId("zipEntryFilename") };
     PropertyBool useZip64{ this, textId("useZip64") };
+    PropertyInt zlibCompressionLevel{ this, textId("zlibCompressionLevel") };
 };
 
 bool GmioAmfWriter::transfer(Span<const ApplicationItem> spanAppItem, TaskProgress* progress)
@@ -282,7 +293,8 @@ bool GmioAmfWriter::writeFile(const FilePath& filepath, TaskProgress* progress)
     amfOptions.dont_use_zip64_extensions = !m_params.useZip64;
     amfOptions.zip_entry_filename = m_params.zipEntryFilename.c_str();
     amfOptions.zip_entry_filename_len = m_params.zipEntryFilename.size();
-    // TODO Handle gmio_amf_write_options::z_compress_options
+    amfOptions.z_compress_options.level =
+            static_cast<gmio_zlib_compress_level>(m_params.zlibCompressionLevel);
     const int error = gmio_amf_write_file(filepath.u8string().c_str(), &amfDoc, &amfOptions);
     return gmio_no_error(error);
 }
@@ -301,6 +313,7 @@ void GmioAmfWriter::applyProperties(const PropertyGroup* group)
         m_params.createZipArchive = ptr->createZipArchive;
         m_params.zipEntryFilename = ptr->zipEntryFilename.value().toStdString();
         m_params.useZip64 = ptr->useZip64;
+        m_params.zlibCompressionLevel = ptr->zlibCompressionLevel;
     }
 }
 
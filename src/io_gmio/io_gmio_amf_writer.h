@@ -45,6 +45,7 @@ public:
         bool createZipArchive = false;
         bool useZip64 = true;
         std::string zipEntryFilename; // UTF8
+        int zlibCompressionLevel = 0; // 0: zlib default, 1(best speed) .. 9(best size)
     };
     Parameters& parameters() { return m_params; }
     const Parameters& constParameters() const { return m_params; }
@@ -33,6 +33,16 @@ bool OccBRepReader::readFile(const FilePath& filepath, TaskProgress* progress)
                 TKernelUtils::start(indicator));
 }
 
+bool OccBRepReader::readStream(std::istream& istr, const FilePath& filepath, TaskProgress* progress)
+{
+    m_shape.Nullify();
+    m_baseFilename = filepath.stem();
+    BRep_Builder brepBuilder;
+    Handle_Message_ProgressIndicator indicator = new OccProgressIndicator(progress);
+    BRepTools::Read(m_shape, istr, brepBuilder, TKernelUtils::start(indicator));
+    return !m_shape.IsNull();
+}
+
 TDF_LabelSequence OccBRepReader::transfer(DocumentPtr doc, TaskProgress* /*progress*/)
 {
     if (m_shape.IsNull())
@@ -84,5 +94,12 @@ bool OccBRepWriter::writeFile(const FilePath& filepath, TaskProgress* progress)
     return BRepTools::Write(m_shape, filepath.u8string().c_str(), TKernelUtils::start(indicator));
 }
 
+bool OccBRepWriter::writeStream(std::ostream& ostr, TaskProgress* progress)
+{
+    Handle_Message_ProgressIndicator indicator = new OccProgressIndicator(progress);
+    BRepTools::Write(m_shape, ostr, TKernelUtils::start(indicator));
+    return ostr.good();
+}
+
 } // namespace IO
 } // namespace Mayo
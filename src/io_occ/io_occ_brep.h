@@ -17,6 +17,8 @@ namespace IO {
 class OccBRepReader : public Reader {
 public:
     bool readFile(const FilePath& filepath, TaskProgress* progress) override;
+    bool canReadStream() const override { return true; }
+    bool readStream(std::istream& istr, const FilePath& filepath, TaskProgress* progress) override;
     TDF_LabelSequence transfer(DocumentPtr doc, TaskProgress* progress) override;
 
 private:
@@ -29,6 +31,8 @@ class OccBRepWriter : public Writer {
 public:
     bool transfer(Span<const ApplicationItem> appItems, TaskProgress* progress) override;
     bool writeFile(const FilePath& filepath, TaskProgress* progress) override;
+    bool canWriteStream() const override { return true; }
+    bool writeStream(std::ostream& ostr, TaskProgress* progress) override;
 
 private:
     TopoDS_Shape m_shape;
@@ -6,6 +6,7 @@
 
 #include "io_occ_step.h"
 #include "io_occ_caf.h"
+#include "../base/global.h"
 #include "../base/occ_static_variables_rollback.h"
 #include "../base/property_builtins.h"
 #include "../base/property_enumeration.h"
@@ -141,6 +142,32 @@ bool OccStepReader::readFile(const FilePath& filepath, TaskProgress* progress)
     return Private::cafReadFile(*m_reader, filepath, progress);
 }
 
+bool OccStepReader::canReadStream() const
+{
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 7, 0)
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool OccStepReader::readStream(std::istream& istr, const FilePath& filepath, TaskProgress* progress)
+{
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 7, 0)
+    MayoIO_CafGlobalScopedLock(cafLock);
+    OccStaticVariablesRollback rollback;
+    this->changeStaticVariables(&rollback);
+    MAYO_UNUSED(progress);
+    const IFSelect_ReturnStatus error = m_reader->ReadStream(filepath.u8string().c_str(), istr);
+    return error == IFSelect_RetDone;
+#else
+    MAYO_UNUSED(istr);
+    MAYO_UNUSED(filepath);
+    MAYO_UNUSED(progress);
+    return false;
+#endif
+}
+
 TDF_LabelSequence OccStepReader::transfer(DocumentPtr doc, TaskProgress* progress)
 {
     MayoIO_CafGlobalScopedLock(cafLock);
@@ -316,19 +343,35 @@ bool OccStepWriter::writeFile(const FilePath& filepath, TaskProgress* /*progress
     MayoIO_CafGlobalScopedLock(cafLock);
     OccStaticVariablesRollback rollback;
     this->changeStaticVariables(&rollback);
+    this->applyHeaderParameters();
+    const IFSelect_ReturnStatus err = m_writer->Write(filepath.u8string().c_str());
+    return err == IFSelect_RetDone;
+}
 
-    APIHeaderSection_MakeHeader makeHeader(m_writer->ChangeWriter().Model());
-    makeHeader.SetAuthorValue(
-                1, StringUtils::toUtf8<Handle_TCollection_HAsciiString>(m_params.headerAuthor));
-    makeHeader.SetOrganizationValue(
-                1, StringUtils::toUtf8<Handle_TCollection_HAsciiString>(m_params.headerOrganization));
-    makeHeader.SetOriginatingSystem(
-                StringUtils::toUtf8<Handle_TCollection_HAsciiString>(m_params.headerOriginatingSystem));
-    makeHeader.SetDescriptionValue(
-                1, StringUtils::toUtf8<Handle_TCollection_HAsciiString>(m_params.headerDescription));
+bool OccStepWriter::canWriteStream() const
+{
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 7, 0)
+    return true;
+#else
+    return false;
+#endif
+}
 
-    const IFSelect_ReturnStatus err = m_writer->Write(filepath.u8string().c_str());
+bool OccStepWriter::writeStream(std::ostream& ostr, TaskProgress* progress)
+{
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 7, 0)
+    MayoIO_CafGlobalScopedLock(cafLock);
+    OccStaticVariablesRollback rollback;
+    this->changeStaticVariables(&rollback);
+    this->applyHeaderParameters();
+    MAYO_UNUSED(progress);
+    const IFSelect_ReturnStatus err = m_writer->ChangeWriter().WriteStream(ostr);
     return err == IFSelect_RetDone;
+#else
+    MAYO_UNUSED(ostr);
+    MAYO_UNUSED(progress);
+    return false;
+#endif
 }
 
 std::unique_ptr<PropertyGroup> OccStepWriter::createProperties(PropertyGroup* parentGroup)
@@ -371,5 +414,18 @@ void OccStepWriter::changeStaticVariables(OccStaticVariablesRollback* rollback)
     rollback->change("write.stepcaf.subshapes.name", int(m_params.writeSubShapesNames ? 1 : 0));
 }
 
+void OccStepWriter::applyHeaderParameters()
+{
+    APIHeaderSection_MakeHeader makeHeader(m_writer->ChangeWriter().Model());
+    makeHeader.SetAuthorValue(
+                1, StringUtils::toUtf8<Handle_TCollection_HAsciiString>(m_params.headerAuthor));
+    makeHeader.SetOrganizationValue(
+                1, StringUtils::toUtf8<Handle_TCollection_HAsciiString>(m_params.headerOrganization));
+    makeHeader.SetOriginatingSystem(
+                StringUtils::toUtf8<Handle_TCollection_HAsciiString>(m_params.headerOriginatingSystem));
+    makeHeader.SetDescriptionValue(
+                1, StringUtils::toUtf8<Handle_TCollection_HAsciiString>(m_params.headerDescription));
+}
+
 } // namespace IO
 } // namespace Mayo
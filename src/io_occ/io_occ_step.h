@@ -28,6 +28,8 @@ public:
     ~OccStepReader();
 
     bool readFile(const FilePath& filepath, TaskProgress* progress) override;
+    bool canReadStream() const override;
+    bool readStream(std::istream& istr, const FilePath& filepath, TaskProgress* progress) override;
     TDF_LabelSequence transfer(DocumentPtr doc, TaskProgress* progress) override;
 
     // Parameters
@@ -112,6 +114,8 @@ public:
 
     bool transfer(Span<const ApplicationItem> appItems, TaskProgress* progress) override;
     bool writeFile(const FilePath& filepath, TaskProgress* progress) override;
+    bool canWriteStream() const override;
+    bool writeStream(std::ostream& ostr, TaskProgress* progress) override;
 
     // Parameters
 
@@ -152,6 +156,7 @@ public:
 
 private:
     void changeStaticVariables(OccStaticVariablesRollback* rollback);
+    void applyHeaderParameters();
 
     class Properties;
     STEPCAFControl_Writer* m_writer = nullptr;
@@ -21,8 +21,20 @@
 #include <BRepTools.hxx>
 #include <RWStl.hxx>
 #include <StlAPI_Writer.hxx>
+#include <gp.hxx>
 #include <TDataXtd_Triangulation.hxx>
 #include <TopoDS_Compound.hxx>
+#include <TopoDS_Face.hxx>
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 5, 0)
+#  include <RWStl_Reader.hxx>
+#  include <Standard_ReadLineBuffer.hxx>
+#endif
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <istream>
+#include <vector>
 
 namespace Mayo {
 namespace IO {
@@ -49,6 +61,159 @@ static TopoDS_Shape asShape(const DocumentPtr& doc)
     return shape;
 }
 
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 5, 0)
+// Builds a single triangulation from the nodes and triangles parsed by RWStl_Reader, like the
+// reader internally used by RWStl::ReadFile()
+class StlTriangulationReader : public RWStl_Reader {
+public:
+    Standard_Integer AddNode(const gp_XYZ& pnt) override {
+        m_vecNode.emplace_back(pnt);
+        return Standard_Integer(m_vecNode.size());
+    }
+
+    void AddTriangle(Standard_Integer n1, Standard_Integer n2, Standard_Integer n3) override {
+        m_vecTriangle.emplace_back(n1, n2, n3);
+    }
+
+    Handle_Poly_Triangulation triangulation() const {
+        if (m_vecTriangle.empty())
+            return {};
+
+        Handle_Poly_Triangulation mesh = new Poly_Triangulation(
+                    Standard_Integer(m_vecNode.size()), Standard_Integer(m_vecTriangle.size()), false);
+        for (size_t i = 0; i < m_vecNode.size(); ++i) {
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 6, 0)
+            mesh->SetNode(Standard_Integer(i + 1), m_vecNode.at(i));
+#else
+            mesh->ChangeNode(Standard_Integer(i + 1)) = m_vecNode.at(i);
+#endif
+        }
+
+        for (size_t i = 0; i < m_vecTriangle.size(); ++i) {
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 6, 0)
+            mesh->SetTriangle(Standard_Integer(i + 1), m_vecTriangle.at(i));
+#else
+            mesh->ChangeTriangle(Standard_Integer(i + 1)) = m_vecTriangle.at(i);
+#endif
+        }
+
+        return mesh;
+    }
+
+private:
+    std::vector<gp_Pnt> m_vecNode;
+    std::vector<Poly_Triangle> m_vecTriangle;
+};
+#endif
+
+// Triangulation to be written in STL output, with the placement of its owner face
+struct StlMeshPart {
+    Handle_Poly_Triangulation mesh;
+    gp_Trsf trsf;
+    bool isReversed = false;
+};
+
+static std::vector<StlMeshPart> stlMeshParts(const TopoDS_Shape& shape)
+{
+    std::vector<StlMeshPart> vecPart;
+    BRepUtils::forEachSubFace(shape, [&](const TopoDS_Face& face) {
+        TopLoc_Location loc;
+        const Handle_Poly_Triangulation& mesh = BRep_Tool::Triangulation(face, loc);
+        if (!mesh.IsNull())
+            vecPart.push_back({ mesh, loc.Transformation(), face.Orientation() == TopAbs_REVERSED });
+    });
+    return vecPart;
+}
+
+static void writeStlFloat32(char* buffer, double value)
+{
+    const float fvalue = static_cast<float>(value);
+    uint32_t bits;
+    std::memcpy(&bits, &fvalue, sizeof(bits));
+    for (int i = 0; i < 4; ++i)
+        buffer[i] = static_cast<char>((bits >> (8 * i)) & 0xFF); // STL is little-endian
+}
+
+// RWStl and StlAPI_Writer can only write to a file path, this is the stream counterpart used for
+// compressed output
+static bool writeStlStream(
+        std::ostream& ostr,
+        OccStlWriter::Format format,
+        Span<const StlMeshPart> spanPart,
+        TaskProgress* progress)
+{
+    uint64_t triangleCount = 0;
+    for (const StlMeshPart& part : spanPart)
+        triangleCount += part.mesh->NbTriangles();
+
+    if (format == OccStlWriter::Format::Binary) {
+        if (triangleCount > UINT32_MAX)
+            return false;
+
+        char header[84] = {};
+        std::strcpy(header, "STL binary file exported by Mayo");
+        for (int i = 0; i < 4; ++i)
+            header[80 + i] = static_cast<char>((triangleCount >> (8 * i)) & 0xFF);
+
+        ostr.write(header, sizeof(header));
+    }
+    else {
+        ostr << "solid\n";
+    }
+
+    uint64_t writtenTriangleCount = 0;
+    for (const StlMeshPart& part : spanPart) {
+        const TColgp_Array1OfPnt& vecNode = part.mesh->Nodes();
+        for (const Poly_Triangle& tri : part.mesh->Triangles()) {
+            int n1, n2, n3;
+            tri.Get(n1, n2, n3);
+            if (part.isReversed)
+                std::swap(n2, n3);
+
+            gp_XYZ pnts[3] = { vecNode.Value(n1).XYZ(), vecNode.Value(n2).XYZ(), vecNode.Value(n3).XYZ() };
+            for (gp_XYZ& pnt : pnts)
+                part.trsf.Transforms(pnt);
+
+            gp_XYZ normal = (pnts[1] - pnts[0]).Crossed(pnts[2] - pnts[0]);
+            const double normalModulus = normal.Modulus();
+            normal = normalModulus > gp::Resolution() ? normal / normalModulus : gp_XYZ();
+            if (format == OccStlWriter::Format::Binary) {
+                char record[50] = {};
+                const gp_XYZ* vecCoords[] = { &normal, &pnts[0], &pnts[1], &pnts[2] };
+                for (int i = 0; i < 4; ++i) {
+                    for (int j = 0; j < 3; ++j)
+                        writeStlFloat32(record + 12 * i + 4 * j, vecCoords[i]->Coord(j + 1));
+                }
+
+                ostr.write(record, sizeof(record));
+            }
+            else {
+                char line[256];
+                std::snprintf(line, sizeof(line), " facet normal %12e %12e %12e\n  outer loop\n",
+                              normal.X(), normal.Y(), normal.Z());
+                ostr << line;
+                for (const gp_XYZ& pnt : pnts) {
+                    std::snprintf(line, sizeof(line), "   vertex %12e %12e %12e\n", pnt.X(), pnt.Y(), pnt.Z());
+                    ostr << line;
+                }
+
+                ostr << "  endloop\n endfacet\n";
+            }
+
+            ++writtenTriangleCount;
+        }
+
+        progress->setValue(int(100 * writtenTriangleCount / std::max<uint64_t>(triangleCount, 1)));
+        if (TaskProgress::isAbortRequested(progress) || !ostr.good())
+            return false;
+    }
+
+    if (format == OccStlWriter::Format::Ascii)
+        ostr << "endsolid\n";
+
+    return ostr.good();
+}
+
 } // namespace
 
 class OccStlWriter::Properties : public PropertyGroup {
@@ -75,6 +240,51 @@ bool OccStlReader::readFile(const FilePath& filepath, TaskProgress* progress)
     return !m_mesh.IsNull();
 }
 
+bool OccStlReader::canReadStream() const
+{
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 5, 0)
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool OccStlReader::readStream(std::istream& istr, const FilePath& filepath, TaskProgress* progress)
+{
+    m_mesh.Nullify();
+    m_baseFilename = filepath.stem();
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 5, 0)
+    Handle_Message_ProgressIndicator indicator = new OccProgressIndicator(progress);
+    opencascade::handle<StlTriangulationReader> reader = new StlTriangulationReader;
+    // Stream can't seek, so the bytes read to detect ASCII contents are put back(unget), they are
+    // all located in the first block of the stream buffer
+    bool ok = false;
+    if (reader->IsAscii(istr, false/*!isSeekgAvailable*/)) {
+        Standard_ReadLineBuffer lineBuffer(64 * 1024);
+        // End position is unknown, but ReadAscii() uses it only to split progress into steps:
+        // reading of a solid stops at "endsolid"(or premature end of stream)
+        // Solids are read in sequence like RWStl_Reader::Read() does, until end of stream
+        while (istr.good() && reader->ReadAscii(istr, lineBuffer, std::streampos(0), TKernelUtils::start(indicator))) {
+            ok = true;
+            istr >> std::ws; // Skip any white space after "endsolid"
+        }
+
+        ok = ok && !TaskProgress::isAbortRequested(progress);
+    }
+    else {
+        ok = reader->ReadBinary(istr, TKernelUtils::start(indicator));
+    }
+
+    if (ok)
+        m_mesh = reader->triangulation();
+#else
+    Q_UNUSED(istr);
+    Q_UNUSED(progress);
+#endif
+
+    return !m_mesh.IsNull();
+}
+
 TDF_LabelSequence OccStlReader::transfer(DocumentPtr doc, TaskProgress* /*progress*/)
 {
     if (m_mesh.IsNull())
@@ -150,6 +360,20 @@ bool OccStlWriter::writeFile(const FilePath& filepath, TaskProgress* progress)
     return false;
 }
 
+bool OccStlWriter::writeStream(std::ostream& ostr, TaskProgress* progress)
+{
+    if (!m_shape.IsNull()) {
+        const std::vector<StlMeshPart> vecPart = stlMeshParts(m_shape);
+        return writeStlStream(ostr, m_params.format, vecPart, progress);
+    }
+    else if (!m_mesh.IsNull()) {
+        const StlMeshPart part = { m_mesh, gp_Trsf(), false };
+        return writeStlStream(ostr, m_params.format, Span<const StlMeshPart>(&part, 1), progress);
+    }
+
+    return false;
+}
+
 std::unique_ptr<PropertyGroup> OccStlWriter::createProperties(PropertyGroup* parentGroup)
 {
     return std::make_unique<Properties>(parentGroup);
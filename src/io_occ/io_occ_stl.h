@@ -18,6 +18,8 @@ namespace IO {
 class OccStlReader : public Reader {
 public:
     bool readFile(const FilePath& filepath, TaskProgress* progress) override;
+    bool canReadStream() const override;
+    bool readStream(std::istream& istr, const FilePath& filepath, TaskProgress* progress) override;
     TDF_LabelSequence transfer(DocumentPtr doc, TaskProgress* progress) override;
 
 private:
@@ -30,6 +32,8 @@ class OccStlWriter : public Writer {
 public:
     bool transfer(Span<const ApplicationItem> appItems, TaskProgress* progress) override;
     bool writeFile(const FilePath& filepath, TaskProgress* progress) override;
+    bool canWriteStream() const override { return true; }
+    bool writeStream(std::ostream& ostr, TaskProgress* progress) override;
 
     static std::unique_ptr<PropertyGroup> createProperties(PropertyGroup* parentGroup);
     void applyProperties(const PropertyGroup* params) override;
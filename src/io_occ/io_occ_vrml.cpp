@@ -87,6 +87,15 @@ bool OccVrmlWriter::writeFile(const FilePath& filepath, TaskProgress*)
     return false;
 }
 
+bool OccVrmlWriter::writeStream(std::ostream& ostr, TaskProgress*)
+{
+    if (!m_scene)
+        return false;
+
+    ostr << *m_scene;
+    return ostr.good();
+}
+
 std::unique_ptr<PropertyGroup> OccVrmlWriter::createProperties(PropertyGroup* parentGroup)
 {
     return std::make_unique<Properties>(parentGroup);
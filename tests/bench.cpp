@@ -0,0 +1,460 @@
+/****************************************************************************
+** Copyright (c) 2021, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+// Need to include this first because of MSVC conflicts with M_E, M_LOG2, ...
+#include <BRepPrimAPI_MakeBox.hxx>
+
+#include "bench.h"
+#include "../src/base/application.h"
+#include "../src/base/brep_utils.h"
+#include "../src/base/document.h"
+#include "../src/base/filepath.h"
+#include "../src/base/io_system.h"
+#include "../src/base/libtree.h"
+#include "../src/base/mesh_utils.h"
+#include "../src/base/property_builtins.h"
+#include "../src/base/property_enumeration.h"
+#include "../src/base/property_value_conversion.h"
+#include "../src/base/string_utils.h"
+#include "../src/base/task_progress.h"
+#include "../src/base/unit.h"
+#include "../src/base/unit_system.h"
+#include "../src/base/xcaf.h"
+
+#include <BRep_Tool.hxx>
+#include <BRepMesh_IncrementalMesh.hxx>
+#include <BRepPrimAPI_MakeSphere.hxx>
+#include <XCAFDoc_ShapeTool.hxx>
+#include <gp_Trsf.hxx>
+#include <QtCore/QFile>
+#include <QtCore/QVariant>
+#include <gsl/util>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+Q_DECLARE_METATYPE(Mayo::IO::Format)
+
+namespace Mayo {
+
+namespace {
+
+// Tree where node #i is a child of node #((i - 1) / fanout), so a breadth-first layout
+Tree<int> makeTree(int nodeCount, int fanout)
+{
+    Tree<int> tree;
+    std::vector<TreeNodeId> vecNodeId;
+    vecNodeId.reserve(nodeCount);
+    for (int i = 0; i < nodeCount; ++i) {
+        const TreeNodeId parentId = i != 0 ? vecNodeId.at((i - 1) / fanout) : 0;
+        vecNodeId.push_back(tree.appendChild(parentId, i));
+    }
+
+    return tree;
+}
+
+// Triangulation of a sphere face, node count increases as 'deflection' decreases
+Handle_Poly_Triangulation makeSphereTriangulation(double deflection)
+{
+    const TopoDS_Shape shapeSphere = BRepPrimAPI_MakeSphere(10.);
+    BRepMesh_IncrementalMesh mesher(shapeSphere, deflection);
+    Handle_Poly_Triangulation polyTri;
+    BRepUtils::forEachSubFace(shapeSphere, [&](const TopoDS_Face& face) {
+        TopLoc_Location loc;
+        polyTri = BRep_Tool::Triangulation(face, loc);
+    });
+    return polyTri;
+}
+
+struct VectorPolyline2d : public MeshUtils::AdaptorPolyline2d {
+    gp_Pnt2d pointAt(int index) const override { return vecPoint.at(index); }
+    int pointCount() const override { return int(vecPoint.size()); }
+    std::vector<gp_Pnt2d> vecPoint;
+};
+
+} // namespace
+
+void Bench::IO_probeFormat_bench()
+{
+    QFETCH(QString, strFilePath);
+    QFETCH(IO::Format, expectedFormat);
+
+    // Same input as built by IO::System::probeFormat()
+    QFile file(strFilePath);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QByteArray contentsBegin = file.read(2048);
+    contentsBegin.append(2048 - contentsBegin.size(), '\0');
+    IO::System::FormatProbeInput probeInput = {};
+    probeInput.filepath = filepathFrom(strFilePath);
+    probeInput.contentsBegin = contentsBegin;
+    probeInput.hintFullSize = file.size();
+
+    // Probes are tried in the order registered by IO::addPredefinedFormatProbes(), so rejection
+    // paths of the probes coming before the matching one are measured too
+    using FormatProbeFunction = IO::Format (*)(const IO::System::FormatProbeInput&);
+    const FormatProbeFunction arrayProbe[] = {
+        IO::probeFormat_STEP,
+        IO::probeFormat_IGES,
+        IO::probeFormat_OCCBREP,
+        IO::probeFormat_STL,
+        IO::probeFormat_OBJ
+    };
+    IO::Format format = IO::Format_Unknown;
+    QBENCHMARK {
+        for (FormatProbeFunction fnProbe : arrayProbe) {
+            format = fnProbe(probeInput);
+            if (format != IO::Format_Unknown)
+                break;
+        }
+    }
+
+    QCOMPARE(format, expectedFormat);
+}
+
+void Bench::IO_probeFormat_bench_data()
+{
+    QTest::addColumn<QString>("strFilePath");
+    QTest::addColumn<IO::Format>("expectedFormat");
+
+    QTest::newRow("cube.step") << "inputs/cube.step" << IO::Format_STEP;
+    QTest::newRow("cube.iges") << "inputs/cube.iges" << IO::Format_IGES;
+    QTest::newRow("cube.brep") << "inputs/cube.brep" << IO::Format_OCCBREP;
+    QTest::newRow("cube.stla") << "inputs/cube.stla" << IO::Format_STL;
+    QTest::newRow("cube.stlb") << "inputs/cube.stlb" << IO::Format_STL;
+    QTest::newRow("cube.obj") << "inputs/cube.obj" << IO::Format_OBJ;
+}
+
+void Bench::MeshUtils_triangulationVolume_bench()
+{
+    QFETCH(double, deflection);
+
+    const Handle_Poly_Triangulation polyTri = makeSphereTriangulation(deflection);
+    QVERIFY(!polyTri.IsNull());
+    double volume = 0.;
+    QBENCHMARK {
+        volume = MeshUtils::triangulationVolume(polyTri);
+    }
+
+    QVERIFY(volume > 0.);
+}
+
+void Bench::MeshUtils_triangulationVolume_bench_data()
+{
+    QTest::addColumn<double>("deflection");
+    QTest::newRow("deflection=0.1") << 0.1;
+    QTest::newRow("deflection=0.01") << 0.01;
+    QTest::newRow("deflection=0.001") << 0.001;
+}
+
+void Bench::MeshUtils_triangulationArea_bench()
+{
+    QFETCH(double, deflection);
+
+    const Handle_Poly_Triangulation polyTri = makeSphereTriangulation(deflection);
+    QVERIFY(!polyTri.IsNull());
+    double area = 0.;
+    QBENCHMARK {
+        area = MeshUtils::triangulationArea(polyTri);
+    }
+
+    QVERIFY(area > 0.);
+}
+
+void Bench::MeshUtils_triangulationArea_bench_data()
+{
+    this->MeshUtils_triangulationVolume_bench_data();
+}
+
+void Bench::MeshUtils_orientation_bench()
+{
+    QFETCH(int, pointCount);
+
+    // Counter-clockwise circle
+    VectorPolyline2d polyline;
+    for (int i = 0; i < pointCount; ++i) {
+        const double angle = (2 * M_PI * i) / pointCount;
+        polyline.vecPoint.emplace_back(10. * std::cos(angle), 10. * std::sin(angle));
+    }
+
+    MeshUtils::Orientation orientation = MeshUtils::Orientation::Unknown;
+    QBENCHMARK {
+        orientation = MeshUtils::orientation(polyline);
+    }
+
+    QCOMPARE(orientation, MeshUtils::Orientation::CounterClockwise);
+}
+
+void Bench::MeshUtils_orientation_bench_data()
+{
+    QTest::addColumn<int>("pointCount");
+    QTest::newRow("100") << 100;
+    QTest::newRow("10000") << 10000;
+    QTest::newRow("1000000") << 1000000;
+}
+
+void Bench::PropertyValueConversion_bench()
+{
+    QFETCH(QString, strPropertyName);
+    QFETCH(QVariant, variantValue);
+
+    enum class MayoBench_Color { Bleu, Blanc, Rouge };
+    std::unique_ptr<Property> prop;
+    if (strPropertyName == PropertyBool::TypeName)
+        prop.reset(new PropertyBool(nullptr, {}));
+    else if (strPropertyName == PropertyInt::TypeName)
+        prop.reset(new PropertyInt(nullptr, {}));
+    else if (strPropertyName == PropertyDouble::TypeName)
+        prop.reset(new PropertyDouble(nullptr, {}));
+    else if (strPropertyName == PropertyQString::TypeName)
+        prop.reset(new PropertyQString(nullptr, {}));
+    else if (strPropertyName == PropertyOccColor::TypeName)
+        prop.reset(new PropertyOccColor(nullptr, {}));
+    else if (strPropertyName == PropertyEnumeration::TypeName)
+        prop.reset(new PropertyEnum<MayoBench_Color>(nullptr, {}));
+
+    QVERIFY(prop);
+
+    // Round-trip, as done when properties are saved then restored from settings
+    PropertyValueConversion conv;
+    bool ok = true;
+    QVariant variantResult;
+    QBENCHMARK {
+        ok = conv.fromVariant(prop.get(), variantValue) && ok;
+        variantResult = conv.toVariant(*prop.get());
+    }
+
+    QVERIFY(ok);
+    QCOMPARE(variantResult, variantValue);
+}
+
+void Bench::PropertyValueConversion_bench_data()
+{
+    QTest::addColumn<QString>("strPropertyName");
+    QTest::addColumn<QVariant>("variantValue");
+    QTest::newRow("bool") << PropertyBool::TypeName << QVariant(true);
+    QTest::newRow("int") << PropertyInt::TypeName << QVariant(1979);
+    QTest::newRow("double") << PropertyDouble::TypeName << QVariant(3.1415926535);
+    QTest::newRow("QString") << PropertyQString::TypeName << QVariant("test");
+    QTest::newRow("OccColor") << PropertyOccColor::TypeName << QVariant("#BB0000");
+    QTest::newRow("Enumeration") << PropertyEnumeration::TypeName << QVariant("Blanc");
+}
+
+void Bench::StringUtils_text_bench()
+{
+    QFETCH(QString, strValueType);
+    QFETCH(QLocale, locale);
+
+    const StringUtils::TextOptions opts = { locale, UnitSystem::SI, 2 };
+    gp_Trsf trsf;
+    trsf.SetRotation(gp::OZ(), 0.75);
+    trsf.SetTranslationPart(gp_Vec(0.55, 4.8977, 15.1445));
+    QString str;
+    if (strValueType == "double") {
+        QBENCHMARK { str = StringUtils::text(1.4995, opts); }
+    }
+    else if (strValueType == "gp_Pnt") {
+        QBENCHMARK { str = StringUtils::text(gp_Pnt(0.55, 4.8977, 15.1445), opts); }
+    }
+    else if (strValueType == "gp_Dir") {
+        QBENCHMARK { str = StringUtils::text(gp_Dir(1., 1., 1.), opts); }
+    }
+    else if (strValueType == "gp_Trsf") {
+        QBENCHMARK { str = StringUtils::text(trsf, opts); }
+    }
+
+    QVERIFY(!str.isEmpty());
+}
+
+void Bench::StringUtils_text_bench_data()
+{
+    QTest::addColumn<QString>("strValueType");
+    QTest::addColumn<QLocale>("locale");
+
+    const QLocale localeFr(QLocale::French, QLocale::France);
+    QTest::newRow("c_double") << "double" << QLocale::c();
+    QTest::newRow("fr_double") << "double" << localeFr;
+    QTest::newRow("c_gp_Pnt") << "gp_Pnt" << QLocale::c();
+    QTest::newRow("c_gp_Dir") << "gp_Dir" << QLocale::c();
+    QTest::newRow("c_gp_Trsf") << "gp_Trsf" << QLocale::c();
+}
+
+void Bench::TaskProgress_setValue_bench()
+{
+    QFETCH(int, nestingDepth);
+
+    // Chain of sub-progresses, value changes of the deepest one are propagated up to the root
+    std::vector<std::unique_ptr<TaskProgress>> vecProgress;
+    vecProgress.push_back(std::make_unique<TaskProgress>());
+    for (int i = 0; i < nestingDepth; ++i)
+        vecProgress.push_back(std::make_unique<TaskProgress>(vecProgress.back().get(), 50.));
+
+    TaskProgress* progress = vecProgress.back().get();
+    QBENCHMARK {
+        for (int pct = 0; pct <= 100; ++pct)
+            progress->setValue(pct);
+    }
+
+    QCOMPARE(progress->value(), 100);
+}
+
+void Bench::TaskProgress_setValue_bench_data()
+{
+    QTest::addColumn<int>("nestingDepth");
+    QTest::newRow("root") << 0;
+    QTest::newRow("depth=1") << 1;
+    QTest::newRow("depth=4") << 4;
+}
+
+void Bench::Tree_appendChild_bench()
+{
+    QFETCH(int, nodeCount);
+    QFETCH(int, fanout);
+
+    std::size_t treeMemorySize = 0;
+    QBENCHMARK {
+        const Tree<int> tree = makeTree(nodeCount, fanout);
+        treeMemorySize = tree.memorySize();
+    }
+
+    QVERIFY(treeMemorySize > 0);
+}
+
+void Bench::Tree_appendChild_bench_data()
+{
+    QTest::addColumn<int>("nodeCount");
+    QTest::addColumn<int>("fanout");
+    QTest::newRow("1k_fanout=4") << 1000 << 4;
+    QTest::newRow("100k_fanout=4") << 100000 << 4;
+    QTest::newRow("100k_fanout=64") << 100000 << 64;
+}
+
+void Bench::Tree_traverse_bench()
+{
+    QFETCH(int, nodeCount);
+    QFETCH(int, fanout);
+    QFETCH(QString, strOrder);
+
+    const Tree<int> tree = makeTree(nodeCount, fanout);
+    int64_t sum = 0;
+    auto fnVisit = [&](TreeNodeId id) { sum += tree.nodeData(id); };
+    if (strOrder == "unorder") {
+        QBENCHMARK { traverseTree_unorder(tree, fnVisit); }
+    }
+    else if (strOrder == "preOrder") {
+        QBENCHMARK { traverseTree_preOrder(tree, fnVisit); }
+    }
+    else if (strOrder == "postOrder") {
+        QBENCHMARK { traverseTree_postOrder(tree, fnVisit); }
+    }
+
+    QVERIFY(sum > 0);
+}
+
+void Bench::Tree_traverse_bench_data()
+{
+    QTest::addColumn<int>("nodeCount");
+    QTest::addColumn<int>("fanout");
+    QTest::addColumn<QString>("strOrder");
+    for (const char* order : { "unorder", "preOrder", "postOrder" }) {
+        QTest::newRow(qPrintable(QStringLiteral("%1_100k_fanout=4").arg(order)))
+                << 100000 << 4 << QString(order);
+        QTest::newRow(qPrintable(QStringLiteral("%1_100k_fanout=64").arg(order)))
+                << 100000 << 64 << QString(order);
+    }
+}
+
+void Bench::UnitSystem_parseQuantity_bench()
+{
+    QFETCH(QString, strQuantity);
+
+    const std::string strUtf8 = strQuantity.toStdString();
+    UnitSystem::TranslateResult result = {};
+    QBENCHMARK {
+        result = UnitSystem::parseQuantity(strUtf8);
+    }
+
+    QVERIFY(result.factor > 0.);
+}
+
+void Bench::UnitSystem_parseQuantity_bench_data()
+{
+    QTest::addColumn<QString>("strQuantity");
+    QTest::newRow("no_unit") << "25.4";
+    QTest::newRow("mm") << "25.4mm";
+    QTest::newRow("deg") << "90deg";
+    QTest::newRow("in") << "1.5in";
+    QTest::newRow("in/min") << "12in/min";
+}
+
+void Bench::UnitSystem_translate_bench()
+{
+    QFETCH(double, value);
+    QFETCH(int, unit);
+    QFETCH(int, schema);
+
+    UnitSystem::TranslateResult result = {};
+    QBENCHMARK {
+        result = UnitSystem::translate(UnitSystem::Schema(schema), value, Unit(unit));
+    }
+
+    QVERIFY(result.factor > 0.);
+}
+
+void Bench::UnitSystem_translate_bench_data()
+{
+    QTest::addColumn<double>("value");
+    QTest::addColumn<int>("unit");
+    QTest::addColumn<int>("schema");
+    QTest::newRow("SI_length") << 80. << int(Unit::Length) << int(UnitSystem::SI);
+    QTest::newRow("SI_area") << 50. << int(Unit::Area) << int(UnitSystem::SI);
+    QTest::newRow("SI_angle") << 3.14 << int(Unit::Angle) << int(UnitSystem::SI);
+    QTest::newRow("ImperialUK_length") << 80. << int(Unit::Length) << int(UnitSystem::ImperialUK);
+    QTest::newRow("ImperialUK_volume") << 1e6 << int(Unit::Volume) << int(UnitSystem::ImperialUK);
+}
+
+void Bench::XCaf_shapeAbsoluteLocation_bench()
+{
+    QFETCH(int, assemblyDepth);
+
+    auto app = Application::instance();
+    DocumentPtr doc = app->newDocument();
+    auto _ = gsl::finally([=]{ app->closeDocument(doc); });
+
+    // Part nested in 'assemblyDepth' assemblies, level #i translates its component by (i+1) along X
+    Handle_XCAFDoc_ShapeTool shapeTool = doc->xcaf().shapeTool();
+    const TDF_Label labelPart = shapeTool->AddShape(BRepPrimAPI_MakeBox(10, 10, 10), false);
+    TDF_Label labelComponent = labelPart;
+    for (int i = 0; i < assemblyDepth; ++i) {
+        const TDF_Label labelAsm = shapeTool->NewShape();
+        gp_Trsf trsf;
+        trsf.SetTranslation(gp_Vec(i + 1, 0, 0));
+        shapeTool->AddComponent(labelAsm, labelComponent, TopLoc_Location(trsf));
+        labelComponent = labelAsm;
+    }
+
+    shapeTool->UpdateAssemblies();
+    doc->addEntityTreeNode(labelComponent);
+    QCOMPARE(int(doc->treeNodes(labelPart).size()), 1);
+
+    const TreeNodeId partNodeId = doc->treeNodes(labelPart).front();
+    TopLoc_Location loc;
+    QBENCHMARK {
+        loc = XCaf::shapeAbsoluteLocation(doc->modelTree(), partNodeId);
+    }
+
+    const double expectedX = assemblyDepth * (assemblyDepth + 1) / 2.;
+    QCOMPARE(loc.Transformation().TranslationPart().X(), expectedX);
+}
+
+void Bench::XCaf_shapeAbsoluteLocation_bench_data()
+{
+    QTest::addColumn<int>("assemblyDepth");
+    QTest::newRow("depth=1") << 1;
+    QTest::newRow("depth=4") << 4;
+    QTest::newRow("depth=16") << 16;
+}
+
+} // namespace Mayo
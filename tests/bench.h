@@ -0,0 +1,53 @@
+/****************************************************************************
+** Copyright (c) 2021, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QObject>
+#include <QtTest/QtTest>
+
+namespace Mayo {
+
+// Micro-benchmarks of core data structures and kernels
+// Run with "mayo_tests --bench", each benchmark is then repeated and the median is reported(see
+// QtTest option -median)
+class Bench : public QObject {
+    Q_OBJECT
+private slots:
+    void IO_probeFormat_bench();
+    void IO_probeFormat_bench_data();
+
+    void MeshUtils_triangulationVolume_bench();
+    void MeshUtils_triangulationVolume_bench_data();
+    void MeshUtils_triangulationArea_bench();
+    void MeshUtils_triangulationArea_bench_data();
+    void MeshUtils_orientation_bench();
+    void MeshUtils_orientation_bench_data();
+
+    void PropertyValueConversion_bench();
+    void PropertyValueConversion_bench_data();
+
+    void StringUtils_text_bench();
+    void StringUtils_text_bench_data();
+
+    void TaskProgress_setValue_bench();
+    void TaskProgress_setValue_bench_data();
+
+    void Tree_appendChild_bench();
+    void Tree_appendChild_bench_data();
+    void Tree_traverse_bench();
+    void Tree_traverse_bench_data();
+
+    void UnitSystem_parseQuantity_bench();
+    void UnitSystem_parseQuantity_bench_data();
+    void UnitSystem_translate_bench();
+    void UnitSystem_translate_bench_data();
+
+    void XCaf_shapeAbsoluteLocation_bench();
+    void XCaf_shapeAbsoluteLocation_bench_data();
+};
+
+} // namespace Mayo
@@ -4,18 +4,46 @@
 ** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
 ****************************************************************************/
 
+#include "bench.h"
 #include "test.h"
 
+#include <algorithm>
+#include <cstring>
 #include <memory>
 #include <vector>
 
 int main(int argc, char** argv)
 {
+    // Option "--bench" runs the micro-benchmarks instead of the unit tests. It's not a QtTest
+    // option, so it has to be removed from the arguments passed to QTest::qExec()
+    std::vector<char*> vecArg(argv, argv + argc);
+    auto fnFindArg = [&](const char* arg) {
+        return std::find_if(vecArg.begin(), vecArg.end(), [=](const char* str) {
+            return std::strcmp(str, arg) == 0;
+        });
+    };
+    auto itArgBench = fnFindArg("--bench");
+    const bool isBenchRun = itArgBench != vecArg.end();
+    if (isBenchRun)
+        vecArg.erase(itArgBench);
+
+    // Benchmarks are repeated so the median of the runs is reported, unless specified otherwise
+    static char argMedian[] = "-median";
+    static char argMedianCount[] = "5";
+    if (isBenchRun && fnFindArg(argMedian) == vecArg.end()) {
+        vecArg.push_back(argMedian);
+        vecArg.push_back(argMedianCount);
+    }
+
     int retcode = 0;
     std::vector<std::unique_ptr<QObject>> vecTest;
-    vecTest.emplace_back(new Mayo::Test);
+    if (isBenchRun)
+        vecTest.emplace_back(new Mayo::Bench);
+    else
+        vecTest.emplace_back(new Mayo::Test);
+
     for (const std::unique_ptr<QObject>& test : vecTest)
-        retcode += QTest::qExec(test.get(), argc, argv);
+        retcode += QTest::qExec(test.get(), int(vecArg.size()), vecArg.data());
 
     return retcode;
 }
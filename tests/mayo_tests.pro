@@ -8,21 +8,35 @@ QT += testlib
 *msvc*:QMAKE_CXXFLAGS += /std:c++17
 *g++*:QMAKE_CXXFLAGS += -std=c++17
 
+*win* {
+    # For GetProcessMemoryInfo()
+    LIBS += -lPsapi
+}
+
 INCLUDEPATH += \
     ../src/3rdparty
 
 HEADERS += \
     test.h \
+    bench.h \
     $$files(../src/base/*.h) \
     $$files(../src/io_occ/*.h) \
+    ../src/graphics/graphics_object_ptr.h \
+    ../src/graphics/graphics_owner_ptr.h \
+    ../src/graphics/graphics_scene.h \
+    ../src/graphics/graphics_utils.h \
     ../src/gui/qtgui_utils.h \
 
 SOURCES += \
     test.cpp \
+    bench.cpp \
     main.cpp \
+    test_gfx_driver.cpp \
     \
     $$files(../src/base/*.cpp) \
     $$files(../src/io_occ/*.cpp) \
+    ../src/graphics/graphics_scene.cpp \
+    ../src/graphics/graphics_utils.cpp \
     ../src/gui/qtgui_utils.cpp \
 
 CONFIG += file_copies
@@ -32,7 +46,9 @@ MayoInputs.path = $$OUT_PWD/inputs
 
 # OpenCascade
 include(../opencascade.pri)
-LIBS += -lTKernel -lTKMath -lTKBRep -lTKGeomBase -lTKTopAlgo -lTKPrim -lTKMesh -lTKG3d
+LIBS += -lTKernel -lTKMath -lTKBRep -lTKGeomBase -lTKGeomAlgo -lTKTopAlgo -lTKPrim -lTKMesh -lTKG3d
+LIBS += -lTKBO -lTKBool
+LIBS += -lTKService -lTKV3d -lTKOpenGl
 LIBS += -lTKXSBase
 LIBS += -lTKLCAF -lTKXCAF -lTKCAF
 LIBS += -lTKCDF -lTKBin -lTKBinL -lTKBinXCAF -lTKXml -lTKXmlL -lTKXmlXCAF
@@ -57,3 +73,6 @@ minOpenCascadeVersion(7, 4, 0) {
 }
 # -- VRML support
 LIBS += -lTKVRML
+
+# Compressed input files
+include(../compression.pri)
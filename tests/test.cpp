@@ -9,36 +9,58 @@
 
 #include "test.h"
 #include "../src/base/application.h"
+#include "../src/base/bom_report.h"
 #include "../src/base/brep_utils.h"
 #include "../src/base/caf_utils.h"
+#include "../src/base/clash_detection.h"
+#include "../src/base/document_name_index.h"
 #include "../src/base/filepath.h"
 #include "../src/base/geom_utils.h"
+#include "../src/base/io_compression.h"
 #include "../src/base/io_system.h"
 #include "../src/base/occ_static_variables_rollback.h"
 #include "../src/base/libtree.h"
+#include "../src/base/mass_properties.h"
+#include "../src/base/memory_stats.h"
 #include "../src/base/mesh_utils.h"
 #include "../src/base/meta_enum.h"
+#include "../src/base/plane_section.h"
 #include "../src/base/property_builtins.h"
 #include "../src/base/property_enumeration.h"
 #include "../src/base/property_value_conversion.h"
 #include "../src/base/result.h"
+#include "../src/base/settings.h"
 #include "../src/base/string_utils.h"
 #include "../src/base/task_manager.h"
 #include "../src/base/tkernel_utils.h"
+#include "../src/base/tracing.h"
 #include "../src/base/unit.h"
 #include "../src/base/unit_system.h"
 #include "../src/io_occ/io_occ.h"
+#include "../src/graphics/graphics_scene.h"
 #include "../src/gui/qtgui_utils.h"
 
 #include <BRep_Tool.hxx>
 #include <BRepAdaptor_Curve.hxx>
+#include <BRepBuilderAPI_Transform.hxx>
+#include <AIS_Shape.hxx>
 #include <BRepMesh_IncrementalMesh.hxx>
 #include <GCPnts_TangentialDeflection.hxx>
 #include <Interface_ParamType.hxx>
 #include <Interface_Static.hxx>
+#include <Precision.hxx>
 #include <TopAbs_ShapeEnum.hxx>
+#include <TColStd_ListOfInteger.hxx>
+#include <gp_Lin.hxx>
+#include <gp_Trsf.hxx>
 #include <QtCore/QtDebug>
+#include <QtCore/QBuffer>
 #include <QtCore/QFile>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QSettings>
+#include <QtCore/QTemporaryDir>
 #include <QtCore/QVariant>
 #include <QtTest/QSignalSpy>
 #include <gsl/util>
@@ -46,8 +68,10 @@
 #include <cmath>
 #include <cstring>
 #include <iostream>
+#include <iterator>
 #include <memory>
 #include <sstream>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -60,6 +84,66 @@ Q_DECLARE_METATYPE(Mayo::MeshUtils::Orientation)
 
 namespace Mayo {
 
+namespace Internal {
+
+// Defined in test_gfx_driver.cpp
+Handle_Graphic3d_GraphicDriver createHeadlessGfxDriver();
+
+// New document with a single assembly entity made of instances of parts
+// Document is closed on destruction
+class TestAssembly {
+public:
+    struct Part {
+        TopoDS_Shape shape;
+        std::vector<gp_Trsf> vecTrsf; // Location of each instance
+    };
+
+    TestAssembly(std::initializer_list<Part> parts)
+        : doc(Application::instance()->newDocument())
+    {
+        Handle_XCAFDoc_ShapeTool shapeTool = this->doc->xcaf().shapeTool();
+        for (const Part& part : parts)
+            this->vecPartLabel.push_back(shapeTool->AddShape(part.shape, false));
+
+        this->labelAsm = shapeTool->NewShape();
+        auto itPartLabel = this->vecPartLabel.cbegin();
+        for (const Part& part : parts) {
+            for (const gp_Trsf& trsf : part.vecTrsf) {
+                const TDF_Label labelInstance =
+                        shapeTool->AddComponent(this->labelAsm, *itPartLabel, TopLoc_Location(trsf));
+                this->vecInstanceLabel.push_back(labelInstance);
+            }
+
+            ++itPartLabel;
+        }
+
+        shapeTool->UpdateAssemblies();
+        this->doc->addEntityTreeNode(this->labelAsm);
+    }
+
+    ~TestAssembly()
+    {
+        Application::instance()->closeDocument(this->doc);
+    }
+
+    TestAssembly(const TestAssembly&) = delete;
+    TestAssembly& operator=(const TestAssembly&) = delete;
+
+    static gp_Trsf translation(double x, double y, double z)
+    {
+        gp_Trsf trsf;
+        trsf.SetTranslation(gp_Vec(x, y, z));
+        return trsf;
+    }
+
+    DocumentPtr doc;
+    TDF_Label labelAsm;
+    std::vector<TDF_Label> vecPartLabel; // Same order as the parts
+    std::vector<TDF_Label> vecInstanceLabel; // Instances of all parts, same order as the locations
+};
+
+} // namespace Internal
+
 // For the sake of QCOMPARE()
 static bool operator==(
         const UnitSystem::TranslateResult& lhs,
@@ -162,6 +246,70 @@ void Test::FilePath_test()
     }
 }
 
+void Test::PropertyGroup_changeTransaction_test()
+{
+    struct TestGroup : public PropertyGroup {
+        TestGroup(PropertyGroup* parentGroup = nullptr) : PropertyGroup(parentGroup) {}
+        void onPropertyChanged(Property* prop) override {
+            vecChanged.push_back(prop);
+            PropertyGroup::onPropertyChanged(prop);
+        }
+        void onPropertiesChanged(Span<Property* const> spanProp) override {
+            ++batchCount;
+            PropertyGroup::onPropertiesChanged(spanProp);
+        }
+        std::vector<Property*> vecChanged;
+        int batchCount = 0;
+    };
+
+    TestGroup parentGroup;
+    TestGroup childGroup(&parentGroup);
+    PropertyInt propInt(&childGroup, {});
+    PropertyBool propBool(&childGroup, {});
+    PropertyDouble propDouble(&parentGroup, {});
+
+    // No transaction: immediate notification
+    propInt.setValue(1);
+    QCOMPARE(int(childGroup.vecChanged.size()), 1);
+    QCOMPARE(int(parentGroup.vecChanged.size()), 1);
+    childGroup.vecChanged.clear();
+    parentGroup.vecChanged.clear();
+
+    // Transaction on parent group applies to child group, nested transactions are merged
+    {
+        Mayo_PropertyChangeTransaction(&parentGroup);
+        QVERIFY(childGroup.isChangeTransactionActive());
+        propInt.setValue(2);
+        propBool.setValue(true);
+        {
+            Mayo_PropertyChangeTransaction(&childGroup);
+            propInt.setValue(3);
+        }
+
+        propDouble.setValue(5.);
+        propInt.setValue(4);
+        QVERIFY(childGroup.vecChanged.empty());
+        QVERIFY(parentGroup.vecChanged.empty());
+    }
+
+    QVERIFY(!childGroup.isChangeTransactionActive());
+    QCOMPARE(childGroup.batchCount, 1);
+    QCOMPARE(parentGroup.batchCount, 1);
+    QCOMPARE(childGroup.vecChanged, std::vector<Property*>({ &propInt, &propBool }));
+    QCOMPARE(parentGroup.vecChanged, std::vector<Property*>({ &propInt, &propBool, &propDouble }));
+    QCOMPARE(propInt.value(), 4);
+
+    // Blocked group isn't recorded by the transaction
+    childGroup.vecChanged.clear();
+    parentGroup.beginChangeTransaction();
+    {
+        Mayo_PropertyChangedBlocker(&childGroup);
+        propInt.setValue(5);
+    }
+    parentGroup.commitChangeTransaction();
+    QVERIFY(childGroup.vecChanged.empty());
+}
+
 void Test::PropertyValueConversion_test()
 {
     QFETCH(QString, strPropertyName);
@@ -329,6 +477,286 @@ void Test::IO_OccStaticVariablesRollback_test_data()
     QTest::newRow("var_str2") << "mayo.test.variable_str2" << QVariant("foo") << QVariant("blah");
 }
 
+void Test::IO_compressedInput_test()
+{
+    QFETCH(QString, strFilePath);
+    QFETCH(QString, strUncompressedFilePath);
+    QFETCH(int, expectedCompression);
+    QFETCH(IO::Format, expectedFormat);
+
+    const FilePath filepath = filepathFrom(strFilePath);
+    const IO::CompressedFileInfo compressedInfo = IO::compressedFileInfo(filepath);
+    QCOMPARE(int(compressedInfo.compression), expectedCompression);
+    QCOMPARE(compressedInfo.innerFilepath.filename(), filepathFrom(strUncompressedFilePath).filename());
+    if (!IO::isDecompressionSupported(compressedInfo.compression))
+        QSKIP("Decompression not supported by this build");
+
+    // Decompressed contents
+    QFile fileUncompressed(strUncompressedFilePath);
+    QVERIFY(fileUncompressed.open(QIODevice::ReadOnly));
+    const QByteArray expectedContents = fileUncompressed.readAll();
+    // Size of gzip contents is unknown as the file might be made of several members
+    if (compressedInfo.compression == IO::Compression::Gzip)
+        QCOMPARE(compressedInfo.uncompressedSize, uint64_t(0));
+    else
+        QCOMPARE(compressedInfo.uncompressedSize, uint64_t(expectedContents.size()));
+
+    {
+        IO::DecompressionIStream istr(filepath, compressedInfo.compression);
+        const std::string contents{
+            std::istreambuf_iterator<char>(istr), std::istreambuf_iterator<char>() };
+        QVERIFY(istr.errorString().isEmpty());
+        QCOMPARE(QByteArray::fromStdString(contents), expectedContents);
+    }
+
+    // Decompressed head, also when the buffer is bigger than the contents
+    {
+        std::vector<char> head(100);
+        QCOMPARE(IO::decompressHead(filepath, compressedInfo.compression, head.data(), head.size()), head.size());
+        QCOMPARE(QByteArray(head.data(), int(head.size())), expectedContents.left(int(head.size())));
+        head.resize(expectedContents.size() + 100);
+        const size_t headSize = IO::decompressHead(filepath, compressedInfo.compression, head.data(), head.size());
+        QCOMPARE(QByteArray(head.data(), int(headSize)), expectedContents);
+    }
+
+    // Probe and import
+    auto app = Application::instance();
+    IO::System* ioSystem = app->ioSystem();
+    QCOMPARE(ioSystem->probeFormat(filepath), expectedFormat);
+    if (!ioSystem->createReader(expectedFormat)->canReadStream())
+        QSKIP("Reader does not support stream input with this OpenCascade version");
+
+    DocumentPtr doc = app->newDocument();
+    auto _ = gsl::finally([=]{ app->closeDocument(doc); });
+    const bool okImport = ioSystem->importInDocument()
+            .targetDocument(doc)
+            .withFilepath(filepath)
+            .execute();
+    QVERIFY(okImport);
+    QCOMPARE(doc->entityCount(), 1);
+}
+
+void Test::IO_compressedInput_test_data()
+{
+    QTest::addColumn<QString>("strFilePath");
+    QTest::addColumn<QString>("strUncompressedFilePath");
+    QTest::addColumn<int>("expectedCompression");
+    QTest::addColumn<IO::Format>("expectedFormat");
+
+    QTest::newRow("cube.brep.gz")
+            << "inputs/cube.brep.gz" << "inputs/cube.brep"
+            << int(IO::Compression::Gzip) << IO::Format_OCCBREP;
+    QTest::newRow("cube.stlb.gz")
+            << "inputs/cube.stlb.gz" << "inputs/cube.stlb"
+            << int(IO::Compression::Gzip) << IO::Format_STL;
+    QTest::newRow("cube_stla.zip")
+            << "inputs/cube_stla.zip" << "inputs/cube.stla"
+            << int(IO::Compression::Zip) << IO::Format_STL;
+}
+
+void Test::IO_compressedOutput_test()
+{
+    QFETCH(int, compression);
+    QFETCH(QString, strTargetFilename);
+
+    if (!IO::isCompressionSupported(IO::Compression(compression)))
+        QSKIP("Compression not supported by this build");
+
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const FilePath targetFilepath = filepathFrom(tempDir.filePath(strTargetFilename));
+    QCOMPARE(int(IO::compressionFromFilepathSuffix(targetFilepath)), compression);
+
+    // Round-trip of contents spanning many blocks, more blocks than concurrent tasks
+    {
+        std::string contents;
+        for (int i = 0; i < 100000; ++i)
+            contents += std::to_string(i) + '\n';
+
+        IO::CompressionOptions options;
+        options.blockSize = 16 * 1024;
+        options.maxConcurrentBlockCount = 2;
+        IO::CompressionOStream ostr(targetFilepath, IO::Compression(compression), options);
+        ostr << contents << std::endl;
+        QVERIFY(ostr.close());
+        QVERIFY(ostr.errorString().isEmpty());
+
+        IO::DecompressionIStream istr(targetFilepath, IO::Compression(compression));
+        const std::string decompressedContents{
+            std::istreambuf_iterator<char>(istr), std::istreambuf_iterator<char>() };
+        QVERIFY(istr.errorString().isEmpty());
+        QVERIFY(decompressedContents == contents + '\n');
+    }
+
+    auto app = Application::instance();
+    IO::System* ioSystem = app->ioSystem();
+    // Binary STL made of several members/frames and bigger than the probed head, so its size is
+    // unknown: format has to be found from the facets, file suffix "stlb" isn't recognized
+    {
+        QFile fileStl("inputs/cube.stlb");
+        QVERIFY(fileStl.open(QIODevice::ReadOnly));
+        const QByteArray cubeStl = fileStl.readAll();
+        constexpr int headerSize = 80 + 4;
+        constexpr int facetSize = 50;
+        constexpr uint32_t facetsCount = 100;
+        const int cubeFacetsCount = (cubeStl.size() - headerSize) / facetSize;
+        std::string contents(cubeStl.constData(), 80);
+        for (int i = 0; i < 4; ++i)
+            contents += char((facetsCount >> (8 * i)) & 0xFF);
+
+        for (uint32_t i = 0; i < facetsCount; ++i)
+            contents.append(cubeStl.constData() + headerSize + (i % cubeFacetsCount) * facetSize, facetSize);
+
+        const FilePath stlFilepath = targetFilepath.parent_path() / ("mesh.stlb" + targetFilepath.extension().u8string());
+        IO::CompressionOptions options;
+        options.blockSize = 512;
+        IO::CompressionOStream ostr(stlFilepath, IO::Compression(compression), options);
+        ostr << contents;
+        QVERIFY(ostr.close());
+        QCOMPARE(IO::compressedFileInfo(stlFilepath).uncompressedSize, uint64_t(0));
+        QCOMPARE(ioSystem->probeFormat(stlFilepath), IO::Format_STL);
+    }
+
+    // Export then import back
+    QCOMPARE(ioSystem->probeFormat(targetFilepath), IO::Format_OCCBREP);
+    DocumentPtr doc = app->newDocument();
+    auto _ = gsl::finally([=]{ app->closeDocument(doc); });
+    QVERIFY(ioSystem->importInDocument().targetDocument(doc).withFilepath("inputs/cube.brep").execute());
+    const ApplicationItem appItems[] = { doc };
+    const bool okExport = ioSystem->exportApplicationItems()
+            .targetFile(targetFilepath)
+            .targetFormat(IO::Format_OCCBREP)
+            .withItems(appItems)
+            .withCompression(IO::Compression(compression))
+            .execute();
+    QVERIFY(okExport);
+    QCOMPARE(int(IO::compressedFileInfo(targetFilepath).compression), compression);
+
+    DocumentPtr docImport = app->newDocument();
+    auto _2 = gsl::finally([=]{ app->closeDocument(docImport); });
+    QVERIFY(ioSystem->importInDocument().targetDocument(docImport).withFilepath(targetFilepath).execute());
+    QCOMPARE(docImport->entityCount(), 1);
+}
+
+void Test::IO_compressedOutput_test_data()
+{
+    QTest::addColumn<int>("compression");
+    QTest::addColumn<QString>("strTargetFilename");
+
+    QTest::newRow("gzip") << int(IO::Compression::Gzip) << "cube.brep.gz";
+    QTest::newRow("zstd") << int(IO::Compression::Zstd) << "cube.brep.zst";
+}
+
+void Test::BomReport_test()
+{
+    // Assembly with three instances of a box and a single instance of a cube
+    using TestAssembly = Internal::TestAssembly;
+    const TestAssembly testAsm({
+        { BRepPrimAPI_MakeBox(10, 20, 30), {
+              TestAssembly::translation(0, 0, 0),
+              TestAssembly::translation(50, 0, 0),
+              TestAssembly::translation(100, 0, 0) } },
+        { BRepPrimAPI_MakeBox(5, 5, 5), { gp_Trsf() } }
+    });
+    const DocumentPtr& doc = testAsm.doc;
+    const TDF_Label& labelAsm = testAsm.labelAsm;
+    const TDF_Label& labelBox = testAsm.vecPartLabel.at(0);
+    const TDF_Label& labelCube = testAsm.vecPartLabel.at(1);
+    doc->setLabelName(labelAsm, "Asm");
+    doc->setLabelName(labelBox, "Box");
+    doc->setLabelName(labelCube, "Cube, small");
+
+    // Products are deduplicated, instances are counted
+    const std::vector<BomReport::Row> vecRow = BomReport::compute(doc);
+    QCOMPARE(int(vecRow.size()), 3);
+    auto fnFindRow = [&](const TDF_Label& label) {
+        return std::find_if(vecRow.cbegin(), vecRow.cend(), [&](const BomReport::Row& row) {
+            return row.product == label;
+        });
+    };
+    QVERIFY(fnFindRow(labelAsm) != vecRow.cend());
+    QVERIFY(fnFindRow(labelAsm)->isAssembly);
+    QCOMPARE(fnFindRow(labelAsm)->instanceCount, 1);
+    QVERIFY(!fnFindRow(labelAsm)->massProperties.isValid);
+    QVERIFY(fnFindRow(labelBox) != vecRow.cend());
+    QCOMPARE(fnFindRow(labelBox)->name, QStringLiteral("Box"));
+    QCOMPARE(fnFindRow(labelBox)->instanceCount, 3);
+    QVERIFY(fnFindRow(labelBox)->massProperties.isValid);
+    QVERIFY(std::abs(fnFindRow(labelBox)->massProperties.volume.value() - 6000.) < 1e-6);
+    QVERIFY(fnFindRow(labelCube) != vecRow.cend());
+    QCOMPARE(fnFindRow(labelCube)->instanceCount, 1);
+
+    // Format lookup
+    QVERIFY(BomReport::findFormat("bom.csv") == BomReport::Format::Csv);
+    QVERIFY(BomReport::findFormat("path/to/bom.JSON") == BomReport::Format::Json);
+    QVERIFY(BomReport::findFormat("bom.txt") == BomReport::Format::None);
+    QVERIFY(BomReport::findFormat("bom") == BomReport::Format::None);
+
+    BomReport::WriteOptions options;
+    options.schema = UnitSystem::SI;
+    options.decimalCount = 1;
+
+    // CSV output
+    {
+        QBuffer buffer;
+        buffer.open(QIODevice::WriteOnly);
+        QVERIFY(BomReport::write(&buffer, BomReport::Format::Csv, vecRow, options));
+        const QStringList lines = QString::fromUtf8(buffer.data()).trimmed().split('\n');
+        QCOMPARE(lines.size(), 4);
+        QVERIFY(lines.at(0).startsWith(QString::fromUtf8("Name,Assembly,Instances,Volume(mm³),Area(mm²)")));
+        QVERIFY(lines.contains(QStringLiteral("Asm,yes,1,,,,,,,,,,,,,,,")));
+        const auto itLineBox = std::find_if(lines.cbegin(), lines.cend(), [](const QString& line) {
+            return line.startsWith("Box,");
+        });
+        QVERIFY(itLineBox != lines.cend());
+        QVERIFY(itLineBox->startsWith("Box,no,3,6000.0,2200.0,5.0,10.0,15.0,"));
+        // Name containing a comma is quoted
+        QVERIFY(std::any_of(lines.cbegin(), lines.cend(), [](const QString& line) {
+            return line.startsWith("\"Cube, small\",no,1,125.0,150.0,");
+        }));
+    }
+
+    // JSON output
+    {
+        QBuffer buffer;
+        buffer.open(QIODevice::WriteOnly);
+        QVERIFY(BomReport::write(&buffer, BomReport::Format::Json, vecRow, options));
+        QJsonParseError jsonError;
+        const QJsonDocument jsonDoc = QJsonDocument::fromJson(buffer.data(), &jsonError);
+        QCOMPARE(jsonError.error, QJsonParseError::NoError);
+        QCOMPARE(jsonDoc.object().value("units").toObject().value("length").toString(), QStringLiteral("mm"));
+        const QJsonArray jsonProducts = jsonDoc.object().value("products").toArray();
+        QCOMPARE(jsonProducts.size(), 3);
+        int productCheckCount = 0;
+        for (const QJsonValue& jsonValue : jsonProducts) {
+            const QJsonObject jsonProduct = jsonValue.toObject();
+            const QString name = jsonProduct.value("name").toString();
+            if (name == "Asm") {
+                QVERIFY(jsonProduct.value("assembly").toBool());
+                QVERIFY(!jsonProduct.contains("volume"));
+                ++productCheckCount;
+            }
+            else if (name == "Box") {
+                QVERIFY(!jsonProduct.value("assembly").toBool());
+                QCOMPARE(jsonProduct.value("instanceCount").toInt(), 3);
+                QCOMPARE(jsonProduct.value("volume").toDouble(), 6000.);
+                QCOMPARE(jsonProduct.value("area").toDouble(), 2200.);
+                const QJsonArray jsonCentroid = jsonProduct.value("centroid").toArray();
+                QCOMPARE(jsonCentroid.size(), 3);
+                QCOMPARE(jsonCentroid.at(2).toDouble(), 15.);
+                ++productCheckCount;
+            }
+            else if (name == "Cube, small") {
+                QCOMPARE(jsonProduct.value("instanceCount").toInt(), 1);
+                QCOMPARE(jsonProduct.value("volume").toDouble(), 125.);
+                ++productCheckCount;
+            }
+        }
+
+        QCOMPARE(productCheckCount, 3);
+    }
+}
+
 void Test::BRepUtils_test()
 {
     QVERIFY(BRepUtils::moreComplex(TopAbs_COMPOUND, TopAbs_SOLID));
@@ -352,6 +780,217 @@ void Test::CafUtils_test()
     // TODO Add CafUtils::labelTag() test for multi-threaded safety
 }
 
+void Test::ClashDetection_test()
+{
+    // Three instances of the same box: first and second ones are crossing(2mm along X), second
+    // and third ones are 5mm apart
+    using TestAssembly = Internal::TestAssembly;
+    const TestAssembly testAsm({
+        { BRepPrimAPI_MakeBox(10, 10, 10), {
+              TestAssembly::translation(0, 0, 0),
+              TestAssembly::translation(8, 3, 3),
+              TestAssembly::translation(23, 3, 3) } }
+    });
+    const DocumentPtr& doc = testAsm.doc;
+    const std::vector<TreeNodeId> vecInstanceId = ClashDetection::instanceTreeNodes(doc);
+    QCOMPARE(int(vecInstanceId.size()), 3);
+
+    ClashDetection::Options options;
+    options.fnComputeMesh = [](const TopoDS_Shape& shape, TaskProgress*) {
+        BRepMesh_IncrementalMesh mesher(shape, 0.1);
+    };
+    auto fnIsPair = [&](const ClashDetection::Clash& clash, int i1, int i2) {
+        const TreeNodeId id1 = vecInstanceId.at(i1);
+        const TreeNodeId id2 = vecInstanceId.at(i2);
+        return (clash.instance1 == id1 && clash.instance2 == id2)
+                || (clash.instance1 == id2 && clash.instance2 == id1);
+    };
+
+    // Interferences only
+    {
+        const std::vector<ClashDetection::Clash> vecClash = ClashDetection::compute(doc, options);
+        QCOMPARE(int(vecClash.size()), 1);
+        const ClashDetection::Clash& clash = vecClash.front();
+        QCOMPARE(clash.type, ClashDetection::Type::Interference);
+        QVERIFY(fnIsPair(clash, 0, 1));
+        QVERIFY(std::abs(clash.penetrationDepth - 2.) < 1e-6);
+    }
+
+    // Interferences and clearance violations
+    {
+        options.clearance = 10.;
+        const std::vector<ClashDetection::Clash> vecClash = ClashDetection::compute(doc, options);
+        QCOMPARE(int(vecClash.size()), 2);
+        QCOMPARE(vecClash.at(0).type, ClashDetection::Type::Interference);
+        QVERIFY(fnIsPair(vecClash.at(0), 0, 1));
+        QCOMPARE(vecClash.at(1).type, ClashDetection::Type::Clearance);
+        QVERIFY(fnIsPair(vecClash.at(1), 1, 2));
+        QVERIFY(std::abs(vecClash.at(1).distance - 5.) < 1e-6);
+    }
+
+    // Contained and coincident instances, no triangles are crossing
+    {
+        const TestAssembly testInnerAsm({
+            { BRepPrimAPI_MakeBox(10, 10, 10), { gp_Trsf(), gp_Trsf() } },
+            { BRepPrimAPI_MakeBox(2, 3, 4), { TestAssembly::translation(4, 4, 4) } }
+        });
+        const DocumentPtr& docInner = testInnerAsm.doc;
+        QCOMPARE(int(ClashDetection::instanceTreeNodes(docInner).size()), 3);
+
+        options.clearance = 0.;
+        const std::vector<ClashDetection::Clash> vecClash = ClashDetection::compute(docInner, options);
+        QCOMPARE(int(vecClash.size()), 3);
+        for (const ClashDetection::Clash& clash : vecClash)
+            QCOMPARE(clash.type, ClashDetection::Type::Interference);
+
+        // Coincident instances are the deepest ones, then depth is the smallest extent of inner box
+        QVERIFY(std::abs(vecClash.at(0).penetrationDepth - 10.) < 1e-6);
+        QVERIFY(std::abs(vecClash.at(1).penetrationDepth - 2.) < 1e-6);
+        QVERIFY(std::abs(vecClash.at(2).penetrationDepth - 2.) < 1e-6);
+    }
+}
+
+void Test::Document_productInstances_test()
+{
+    // Assembly with two instances of the same part
+    using TestAssembly = Internal::TestAssembly;
+    const TestAssembly testAsm({
+        { BRepPrimAPI_MakeBox(10, 10, 10), { gp_Trsf(), TestAssembly::translation(20, 0, 0) } }
+    });
+    const DocumentPtr& doc = testAsm.doc;
+    const TDF_Label& labelAsm = testAsm.labelAsm;
+    const TDF_Label& labelPart = testAsm.vecPartLabel.at(0);
+    const TDF_Label& labelInstance1 = testAsm.vecInstanceLabel.at(0);
+    const TDF_Label& labelInstance2 = testAsm.vecInstanceLabel.at(1);
+    QCOMPARE(doc->entityCount(), 1);
+
+    const Tree<TDF_Label>& modelTree = doc->modelTree();
+    const std::vector<TreeNodeId> vecInstanceId = doc->productInstanceTreeNodes(labelPart);
+    QCOMPARE(int(vecInstanceId.size()), 2);
+    QCOMPARE(modelTree.nodeData(vecInstanceId.at(0)), labelInstance1);
+    QCOMPARE(modelTree.nodeData(vecInstanceId.at(1)), labelInstance2);
+    QCOMPARE(int(doc->treeNodes(labelPart).size()), 2);
+    for (TreeNodeId partId : doc->treeNodes(labelPart))
+        QCOMPARE(modelTree.nodeData(partId), labelPart);
+
+    QCOMPARE(int(doc->treeNodes(labelAsm).size()), 1);
+    QCOMPARE(doc->treeNodes(labelAsm).front(), doc->entityTreeNodeId(0));
+    QVERIFY(doc->productInstanceTreeNodes(labelAsm).empty());
+
+    // Rename product
+    QSignalSpy sigSpy_labelNameChanged(doc.get(), &Document::labelNameChanged);
+    doc->setLabelName(labelPart, "Part");
+    QCOMPARE(sigSpy_labelNameChanged.count(), 1);
+    QCOMPARE(CafUtils::labelAttrStdName(labelPart), QStringLiteral("Part"));
+
+    // Destroy entity
+    doc->destroyEntity(doc->entityTreeNodeId(0));
+    QCOMPARE(doc->entityCount(), 0);
+    QVERIFY(doc->productInstanceTreeNodes(labelPart).empty());
+    QVERIFY(doc->treeNodes(labelPart).empty());
+}
+
+void Test::DocumentMemoryStats_test()
+{
+    // Assembly with two instances of the same meshed box
+    const TopoDS_Shape shapeBox = BRepPrimAPI_MakeBox(10, 20, 30);
+    BRepMesh_IncrementalMesh mesher(shapeBox, 0.1);
+    using TestAssembly = Internal::TestAssembly;
+    const TestAssembly testAsm({ { shapeBox, { gp_Trsf(), TestAssembly::translation(100, 0, 0) } } });
+    const DocumentPtr& doc = testAsm.doc;
+
+    // Box topology is shared by instances: 1 solid, 1 shell, 6 faces, 6 wires, 12 edges, 8 vertices
+    // Assembly compound is the only additional shape
+    const DocumentMemoryStats stats = DocumentMemoryStats::compute(doc);
+    QCOMPARE(stats.shapeCount, int64_t(34 + 1));
+    QCOMPARE(stats.triangulationCount, int64_t(6));
+    int64_t nodeCount = 0;
+    int64_t triangleCount = 0;
+    int64_t triangulationBytes = 0;
+    BRepUtils::forEachSubFace(shapeBox, [&](const TopoDS_Face& face) {
+        TopLoc_Location loc;
+        const Handle_Poly_Triangulation& polyTri = BRep_Tool::Triangulation(face, loc);
+        nodeCount += polyTri->NbNodes();
+        triangleCount += polyTri->NbTriangles();
+        triangulationBytes += DocumentMemoryStats::estimateBytes(polyTri);
+    });
+    QCOMPARE(stats.triangulationNodeCount, nodeCount);
+    QCOMPARE(stats.triangulationTriangleCount, triangleCount);
+    QCOMPARE(stats.triangulationBytes, triangulationBytes);
+    QVERIFY(triangulationBytes >= nodeCount * int64_t(sizeof(gp_Pnt)) + triangleCount * int64_t(sizeof(Poly_Triangle)));
+    QVERIFY(stats.brepTopologyBytes > 0);
+    QVERIFY(stats.brepGeometryBytes > 0);
+    QVERIFY(stats.ocafBytes > 0);
+    QVERIFY(stats.modelTreeBytes > 0);
+    QCOMPARE(stats.totalBytes(),
+             stats.brepTopologyBytes + stats.brepGeometryBytes + stats.triangulationBytes
+             + stats.ocafBytes + stats.modelTreeBytes);
+
+    // Shapes of the snapshot aren't browsed once abort is requested, OCAF data is already accounted
+    const DocumentMemoryStats::Snapshot snapshot = DocumentMemoryStats::snapshot(doc);
+    QVERIFY(!snapshot.vecShape.empty());
+    TaskManager taskMgr;
+    DocumentMemoryStats abortedStats;
+    const TaskId taskId = taskMgr.newTask([&](TaskProgress* progress) {
+        taskMgr.requestAbort(progress->taskId());
+        abortedStats = DocumentMemoryStats::compute(snapshot, progress);
+    });
+    taskMgr.exec(taskId);
+    QCOMPARE(abortedStats.shapeCount, int64_t(0));
+    QCOMPARE(abortedStats.ocafBytes, stats.ocafBytes);
+
+    const ProcessMemoryStats processStats = ProcessMemoryStats::current();
+    if (processStats.residentBytes != -1 && processStats.peakResidentBytes != -1)
+        QVERIFY(processStats.peakResidentBytes >= processStats.residentBytes);
+}
+
+void Test::DocumentNameIndex_test()
+{
+    DocumentNameIndex index;
+    index.build({
+                    { 1, "Engine" }, { 2, "Piston" }, { 3, "piston ring" },
+                    { 4, "Crankshaft" }, { 5, "Bolt M8" }, { 6, "bolt M10" }
+                });
+    QCOMPARE(index.size(), 6);
+    QVERIFY(index.contains(3));
+    QVERIFY(!index.contains(7));
+
+    auto fnFindNodes = [&](const QString& pattern, int maxCount = -1) {
+        std::vector<TreeNodeId> vecNodeId = index.findNodes(pattern, maxCount);
+        std::sort(vecNodeId.begin(), vecNodeId.end());
+        return vecNodeId;
+    };
+
+    // Prefix lookup
+    QCOMPARE(fnFindNodes("p"), std::vector<TreeNodeId>({ 2, 3 }));
+    QCOMPARE(fnFindNodes("BO"), std::vector<TreeNodeId>({ 5, 6 }));
+    QCOMPARE(fnFindNodes("ng"), std::vector<TreeNodeId>());
+
+    // Substring lookup
+    QCOMPARE(fnFindNodes("ston"), std::vector<TreeNodeId>({ 2, 3 }));
+    QCOMPARE(fnFindNodes("RING"), std::vector<TreeNodeId>({ 3 }));
+    QCOMPARE(fnFindNodes("shaft"), std::vector<TreeNodeId>({ 4 }));
+    QCOMPARE(fnFindNodes("m1"), std::vector<TreeNodeId>());
+    QCOMPARE(fnFindNodes("t m"), std::vector<TreeNodeId>({ 5, 6 }));
+    QCOMPARE(fnFindNodes("gearbox"), std::vector<TreeNodeId>());
+    QCOMPARE(fnFindNodes(""), std::vector<TreeNodeId>());
+    QCOMPARE(index.findNodes("bolt", 1).size(), size_t(1));
+
+    // Rename
+    index.setName(2, "Rod");
+    QCOMPARE(fnFindNodes("ston"), std::vector<TreeNodeId>({ 3 }));
+    QCOMPARE(fnFindNodes("p"), std::vector<TreeNodeId>({ 3 }));
+    QCOMPARE(fnFindNodes("r"), std::vector<TreeNodeId>({ 2 }));
+    index.setName(2, "Piston");
+    QCOMPARE(fnFindNodes("ist"), std::vector<TreeNodeId>({ 2, 3 }));
+
+    // New entry
+    index.setName(10, "Piston pin");
+    QCOMPARE(index.size(), 7);
+    QCOMPARE(fnFindNodes("piston"), std::vector<TreeNodeId>({ 2, 3, 10 }));
+    QCOMPARE(fnFindNodes("pi"), std::vector<TreeNodeId>({ 2, 3, 10 }));
+}
+
 void Test::MeshUtils_orientation_test()
 {
     struct BasicPolyline2d : public Mayo::MeshUtils::AdaptorPolyline2d {
@@ -443,6 +1082,106 @@ void Test::MetaEnum_test()
     QCOMPARE(MetaEnum::nameWithoutPrefix(TopAbs_VERTEX, ""), "TopAbs_VERTEX");
 }
 
+void Test::GraphicsScene_deferredSelection_test()
+{
+    GraphicsScene scene(Internal::createHeadlessGfxDriver());
+    const GraphicsObjectPtr gfxObject = new AIS_Shape(BRepPrimAPI_MakeBox(10, 10, 10));
+    scene.addObject(gfxObject, GraphicsScene::AddObjectDeferSelection);
+    auto fnIsSelectionActivated = [&]{
+        TColStd_ListOfInteger listMode;
+        scene.aisContextPtr()->ActivatedModes(gfxObject, listMode);
+        return !listMode.IsEmpty();
+    };
+    QVERIFY(!fnIsSelectionActivated());
+
+    const gp_Lin lineOfSight(gp_Pnt(5, 5, -100), gp_Dir(0, 0, 1));
+    const gp_Lin lineOfSightOut(gp_Pnt(50, 50, -100), gp_Dir(0, 0, 1));
+    // Hidden object must not be picked, deferred selection tree gets rebuilt without it
+    scene.setObjectVisible(gfxObject, false);
+    scene.activateSelectionAlong(lineOfSight, 1.);
+    QVERIFY(!fnIsSelectionActivated());
+
+    // Object shown again must be back in the deferred selection tree
+    scene.setObjectVisible(gfxObject, true);
+    scene.activateSelectionAlong(lineOfSightOut, 1.);
+    QVERIFY(!fnIsSelectionActivated());
+    scene.activateSelectionAlong(lineOfSight, 1.);
+    QVERIFY(fnIsSelectionActivated());
+}
+
+void Test::MassProperties_test()
+{
+    // Assembly with two instances of the same part, second one is rotated and translated
+    gp_Trsf trsf;
+    trsf.SetRotation(gp::OZ(), M_PI / 2.);
+    trsf.SetTranslationPart(gp_Vec(100, 0, 0));
+    const Internal::TestAssembly testAsm({ { BRepPrimAPI_MakeBox(10, 20, 30), { gp_Trsf(), trsf } } });
+    const DocumentPtr& doc = testAsm.doc;
+    const TDF_Label& labelAsm = testAsm.labelAsm;
+    const TDF_Label& labelPart = testAsm.vecPartLabel.at(0);
+
+    // Product properties
+    MassPropertiesCache& cache = doc->massPropertiesCache();
+    QVERIFY(!cache.contains(labelPart));
+    cache.computeProducts(std::vector<TDF_Label>{ labelPart, labelAsm });
+    QVERIFY(cache.contains(labelPart));
+    QVERIFY(!cache.contains(labelAsm)); // Assemblies are combined on demand
+    const MassProperties partProps = cache.productProperties(labelPart);
+    QVERIFY(partProps.isValid);
+    QCOMPARE(partProps.volume.value(), 6000.);
+    QCOMPARE(partProps.area.value(), 2200.);
+    QVERIFY(partProps.centroid.IsEqual(gp_Pnt(5, 10, 15), Precision::Confusion()));
+
+    // Instance properties
+    const Tree<TDF_Label>& modelTree = doc->modelTree();
+    const std::vector<TreeNodeId> vecInstanceId = doc->productInstanceTreeNodes(labelPart);
+    QCOMPARE(int(vecInstanceId.size()), 2);
+    const MassProperties instanceProps = cache.treeNodeProperties(modelTree, vecInstanceId.at(1));
+    QVERIFY(std::abs(instanceProps.volume.value() - 6000.) < Precision::Confusion());
+    QVERIFY(instanceProps.centroid.IsEqual(gp_Pnt(5, 10, 15).Transformed(trsf), Precision::Confusion()));
+    const std::array<double, 3> partMoments = partProps.principalMoments();
+    const std::array<double, 3> instanceMoments = instanceProps.principalMoments();
+    for (int i = 0; i < 3; ++i)
+        QVERIFY(std::abs(partMoments.at(i) - instanceMoments.at(i)) < 1e-6 * partMoments.at(i));
+
+    // Combined assembly properties must match direct computation on the assembly compound
+    const MassProperties asmProps = cache.productProperties(labelAsm);
+    const MassProperties asmDirectProps = MassProperties::compute(XCaf::shape(labelAsm));
+    QVERIFY(cache.contains(labelAsm));
+    QVERIFY(std::abs(asmProps.volume.value() - 12000.) < Precision::Confusion());
+    QVERIFY(asmProps.centroid.IsEqual(asmDirectProps.centroid, Precision::Confusion()));
+    for (int row = 1; row <= 3; ++row) {
+        for (int col = 1; col <= 3; ++col) {
+            const double expected = asmDirectProps.inertia.Value(row, col);
+            QVERIFY(std::abs(asmProps.inertia.Value(row, col) - expected) < 1e-6 * (1 + std::abs(expected)));
+        }
+    }
+
+    // Scaled properties must match direct computation on the scaled shape, inertia scales with
+    // length^5 for volume-based properties and length^4 for surface-based ones
+    gp_Trsf trsfScale;
+    trsfScale.SetScale(gp_Pnt(1, 2, 3), 2.);
+    for (const TopoDS_Shape& shape : { TopoDS_Shape(BRepPrimAPI_MakeBox(10, 20, 30).Solid()),
+                                       TopoDS_Shape(BRepPrimAPI_MakeBox(10, 20, 30).Shell()) })
+    {
+        const MassProperties scaledProps = MassProperties::compute(shape).transformed(trsfScale);
+        const MassProperties scaledDirectProps =
+                MassProperties::compute(BRepBuilderAPI_Transform(shape, trsfScale, true).Shape());
+        QCOMPARE(scaledProps.isVolumeBased(), shape.ShapeType() == TopAbs_SOLID);
+        QVERIFY(scaledProps.centroid.IsEqual(scaledDirectProps.centroid, Precision::Confusion()));
+        for (int row = 1; row <= 3; ++row) {
+            for (int col = 1; col <= 3; ++col) {
+                const double expected = scaledDirectProps.inertia.Value(row, col);
+                QVERIFY(std::abs(scaledProps.inertia.Value(row, col) - expected) < 1e-6 * (1 + std::abs(expected)));
+            }
+        }
+    }
+
+    // Cache is cleared when an entity is destroyed
+    doc->destroyEntity(doc->entityTreeNodeId(0));
+    QVERIFY(!cache.contains(labelPart));
+}
+
 void Test::MeshUtils_test()
 {
     // Create box
@@ -514,6 +1253,36 @@ void Test::MeshUtils_test_data()
     QTest::newRow("case4") << 40. << 50. << 70.;
 }
 
+void Test::PlaneSection_test()
+{
+    const TopoDS_Shape box = BRepPrimAPI_MakeBox(20, 30, 40);
+
+    {   // Plane crossing the box
+        const PlaneSection section = PlaneSection::compute(box, gp_Pln(gp_Pnt(0, 0, 10), gp::DZ()));
+        QVERIFY(!section.isEmpty());
+        QVERIFY(std::abs(section.area - 20 * 30) < 1e-6);
+        QVERIFY(std::abs(section.perimeter - 2 * (20 + 30)) < 1e-6);
+    }
+
+    {   // Plane outside the box
+        const PlaneSection section = PlaneSection::compute(box, gp_Pln(gp_Pnt(0, 0, 50), gp::DZ()));
+        QVERIFY(section.isEmpty());
+        QCOMPARE(section.area, 0.);
+        QCOMPARE(section.perimeter, 0.);
+    }
+
+    {   // Shell shape: section curves but no area
+        TopoDS_Shape shell;
+        for (TopExp_Explorer expl(box, TopAbs_SHELL); expl.More() && shell.IsNull(); expl.Next())
+            shell = expl.Current();
+
+        const PlaneSection section = PlaneSection::compute(shell, gp_Pln(gp_Pnt(10, 0, 0), gp::DX()));
+        QVERIFY(!section.isEmpty());
+        QCOMPARE(section.area, 0.);
+        QVERIFY(std::abs(section.perimeter - 2 * (30 + 40)) < 1e-6);
+    }
+}
+
 void Test::Quantity_test()
 {
     const QuantityArea area = (10 * Quantity_Millimeter) * (5 * Quantity_Centimeter);
@@ -575,6 +1344,94 @@ void Test::Result_test()
     }
 }
 
+namespace Settings_test {
+
+// Settings with group "grp" made of sections "sec1"(settings a, b) and "sec2"(setting c)
+// Storage file 'strStoragePath' is first written with a=10, b=20, c=30
+class Fixture {
+public:
+    Fixture(const QString& strStoragePath)
+    {
+        {
+            QSettings storage(strStoragePath, QSettings::IniFormat);
+            storage.setValue("grp/sec1/a", 10);
+            storage.setValue("grp/sec1/b", 20);
+            storage.setValue("grp/sec2/c", 30);
+        }
+
+        this->settings.setStorage(std::make_unique<QSettings>(strStoragePath, QSettings::IniFormat));
+        const Settings::GroupIndex groupId = this->settings.addGroup(QByteArray("grp"));
+        this->sectionId1 = this->settings.addSection(groupId, QByteArray("sec1"));
+        this->sectionId2 = this->settings.addSection(groupId, QByteArray("sec2"));
+        this->settings.addSetting(&this->propA, this->sectionId1);
+        this->settings.addSetting(&this->propB, this->sectionId1);
+        this->settingIdC = this->settings.addSetting(&this->propC, this->sectionId2);
+    }
+
+    Settings settings;
+    PropertyInt propA{ &settings, MAYO_TEXT_ID("Mayo::Test", "a") };
+    PropertyInt propB{ &settings, MAYO_TEXT_ID("Mayo::Test", "b") };
+    PropertyInt propC{ &settings, MAYO_TEXT_ID("Mayo::Test", "c") };
+    Settings::SectionIndex sectionId1;
+    Settings::SectionIndex sectionId2;
+    Settings::SettingIndex settingIdC;
+};
+
+} // namespace Settings_test
+
+void Test::Settings_lazyLoad_test()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    Settings_test::Fixture fixture(tempDir.filePath("settings.ini"));
+    Settings& settings = fixture.settings;
+
+    // Nothing is read until first access of a section
+    settings.load();
+    QVERIFY(!settings.isSectionLoaded(fixture.sectionId1));
+    QVERIFY(!settings.isSectionLoaded(fixture.sectionId2));
+    QCOMPARE(fixture.propA.value(), 0);
+    settings.loadSection(fixture.sectionId1);
+    QVERIFY(settings.isSectionLoaded(fixture.sectionId1));
+    QCOMPARE(fixture.propA.value(), 10);
+    QCOMPARE(fixture.propB.value(), 20);
+    QVERIFY(!settings.isSectionLoaded(fixture.sectionId2));
+    QCOMPARE(fixture.propC.value(), 0);
+
+    // Access with Settings::property() loads the section
+    QCOMPARE(settings.property(fixture.settingIdC), &fixture.propC);
+    QVERIFY(settings.isSectionLoaded(fixture.sectionId2));
+    QCOMPARE(fixture.propC.value(), 30);
+}
+
+void Test::Settings_partialSectionSave_test()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString strStoragePath = tempDir.filePath("settings.ini");
+    {
+        Settings_test::Fixture fixture(strStoragePath);
+        Settings& settings = fixture.settings;
+        settings.load();
+
+        // Change a single setting of a section not loaded yet
+        fixture.propB.setValue(25);
+        QVERIFY(!settings.isSectionLoaded(fixture.sectionId1));
+        settings.save();
+
+        // Other settings of the section are loaded from storage, the changed one is kept
+        settings.loadSection(fixture.sectionId1);
+        QCOMPARE(fixture.propA.value(), 10);
+        QCOMPARE(fixture.propB.value(), 25);
+    }
+
+    // Storage contains the changed setting, other settings are left untouched
+    QSettings storage(strStoragePath, QSettings::IniFormat);
+    QCOMPARE(storage.value("grp/sec1/a").toInt(), 10);
+    QCOMPARE(storage.value("grp/sec1/b").toInt(), 25);
+    QCOMPARE(storage.value("grp/sec2/c").toInt(), 30);
+}
+
 void Test::StringUtils_append_test()
 {
     QFETCH(QString, strExpected);
@@ -710,6 +1567,86 @@ void Test::TKernelUtils_colorFromHex_test_data()
     QTest::newRow("RGB(100,150,200)") << 100 << 150 << 200 << "#6496C8";
 }
 
+void Test::Tracing_test()
+{
+    auto _ = gsl::finally([]{ Tracing::setEnabled(false); });
+
+    // Nothing is recorded while tracing is disabled
+    const int64_t eventCountStart = Tracing::eventCount();
+    Tracing::setEnabled(false);
+    {
+        MAYO_TRACE_SCOPE("Tracing_test_disabled", "test");
+        Tracing::recordCounter("Tracing_test_disabled", 1.);
+    }
+    QCOMPARE(Tracing::eventCount(), eventCountStart);
+
+    // Record spans and counters from several threads, more than a buffer chunk per thread
+    Tracing::setEnabled(true);
+    constexpr int threadCount = 4;
+    constexpr int spanCountPerThread = 1500;
+    std::vector<std::thread> vecThread;
+    for (int i = 0; i < threadCount; ++i) {
+        vecThread.emplace_back([]{
+            for (int j = 0; j < spanCountPerThread; ++j) {
+                MAYO_TRACE_SCOPE("Tracing_test_span", "test");
+            }
+
+            Tracing::recordCounter("Tracing_test_counter", 42.);
+        });
+    }
+
+    for (std::thread& thread : vecThread)
+        thread.join();
+
+    QCOMPARE(Tracing::eventCount(), eventCountStart + threadCount * (spanCountPerThread + 1));
+
+    // Check written Chrome trace
+    QBuffer buffer;
+    QVERIFY(buffer.open(QIODevice::WriteOnly));
+    QVERIFY(Tracing::writeChromeTrace(&buffer));
+    QJsonParseError jsonError;
+    const QJsonDocument jsonDoc = QJsonDocument::fromJson(buffer.data(), &jsonError);
+    QCOMPARE(jsonError.error, QJsonParseError::NoError);
+    int spanCount = 0;
+    int counterCount = 0;
+    for (const QJsonValue& jsonEvent : jsonDoc.object().value("traceEvents").toArray()) {
+        const QJsonObject jsonObject = jsonEvent.toObject();
+        const QString name = jsonObject.value("name").toString();
+        const QString phase = jsonObject.value("ph").toString();
+        if (name == "Tracing_test_span" && phase == "X") {
+            QCOMPARE(jsonObject.value("cat").toString(), QString("test"));
+            QVERIFY(jsonObject.value("dur").toDouble() >= 0);
+            ++spanCount;
+        }
+        else if (name == "Tracing_test_counter" && phase == "C") {
+            QCOMPARE(jsonObject.value("args").toObject().value("value").toDouble(), 42.);
+            ++counterCount;
+        }
+    }
+
+    QCOMPARE(spanCount, threadCount * spanCountPerThread);
+    QCOMPARE(counterCount, threadCount);
+
+    // Spans are aggregated by name
+    const std::vector<Tracing::SpanStatistics> vecSpanStats = Tracing::spanStatistics();
+    auto itSpanStats = std::find_if(vecSpanStats.cbegin(), vecSpanStats.cend(), [](const auto& stats) {
+        return stats.name == "Tracing_test_span";
+    });
+    QVERIFY(itSpanStats != vecSpanStats.cend());
+    QCOMPARE(itSpanStats->category, std::string("test"));
+    QCOMPARE(itSpanStats->count, int64_t(threadCount * spanCountPerThread));
+    QVERIFY(itSpanStats->maxUs <= itSpanStats->totalUs);
+
+    // Recorded events are discarded, recording goes on after clear
+    Tracing::clear();
+    QCOMPARE(Tracing::eventCount(), int64_t(0));
+    QVERIFY(Tracing::spanStatistics().empty());
+    {
+        MAYO_TRACE_SCOPE("Tracing_test_span", "test");
+    }
+    QCOMPARE(Tracing::eventCount(), int64_t(1));
+}
+
 void Test::UnitSystem_test()
 {
     QFETCH(UnitSystem::TranslateResult, trResultActual);
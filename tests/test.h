@@ -20,6 +20,8 @@ private slots:
 
     void FilePath_test();
 
+    void PropertyGroup_changeTransaction_test();
+
     void PropertyValueConversion_test();
     void PropertyValueConversion_test_data();
     void PropertyQuantityValueConversion_test();
@@ -29,11 +31,28 @@ private slots:
     void IO_test_data();
     void IO_OccStaticVariablesRollback_test();
     void IO_OccStaticVariablesRollback_test_data();
+    void IO_compressedInput_test();
+    void IO_compressedInput_test_data();
+    void IO_compressedOutput_test();
+    void IO_compressedOutput_test_data();
+
+    void BomReport_test();
 
     void BRepUtils_test();
 
     void CafUtils_test();
 
+    void ClashDetection_test();
+
+    void Document_productInstances_test();
+    void DocumentMemoryStats_test();
+
+    void DocumentNameIndex_test();
+
+    void GraphicsScene_deferredSelection_test();
+
+    void MassProperties_test();
+
     void MeshUtils_test();
     void MeshUtils_test_data();
     void MeshUtils_orientation_test();
@@ -41,10 +60,15 @@ private slots:
 
     void MetaEnum_test();
 
+    void PlaneSection_test();
+
     void Quantity_test();
 
     void Result_test();
 
+    void Settings_lazyLoad_test();
+    void Settings_partialSectionSave_test();
+
     void StringUtils_append_test();
     void StringUtils_append_test_data();
     void StringUtils_text_test();
@@ -56,6 +80,8 @@ private slots:
     void TKernelUtils_colorFromHex_test();
     void TKernelUtils_colorFromHex_test_data();
 
+    void Tracing_test();
+
     void UnitSystem_test();
     void UnitSystem_test_data();
 
@@ -0,0 +1,26 @@
+/****************************************************************************
+** Copyright (c) 2021, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+// --
+// NOTE
+// This file isolates inclusion of <OpenGl_GraphicDriver.hxx> which is problematic on X11/Linux
+// <X.h> #defines constants like "None" which causes name clash with BomReport::Format::None
+// --
+
+#include <OpenGl_GraphicDriver.hxx>
+
+namespace Mayo {
+namespace Internal {
+
+// Creates a graphics driver not connected to any display and without OpenGL context
+// Enough to display objects in a GraphicsScene and compute their selection, but not to render
+Handle_Graphic3d_GraphicDriver createHeadlessGfxDriver()
+{
+    return new OpenGl_GraphicDriver(Handle_Aspect_DisplayConnection(), false/*dontInitialize*/);
+}
+
+} // namespace Internal
+} // namespace Mayo